@@ -0,0 +1,261 @@
+// Copyright (c) 2016 ucclkp <ucclkp@gmail.com>.
+// This file is part of necro project.
+//
+// This program is licensed under GPLv3 license that can be
+// found in the LICENSE file.
+
+#ifndef NECRO_LAYOUT_BINARY_H_
+#define NECRO_LAYOUT_BINARY_H_
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+/**
+ * 二进制布局文件格式。
+ * 由 necro 在处理布局 XML 时生成，运行时直接映射后创建 View，无需解析 XML。
+ * 所有整数均为大端序。
+ *
+ * 文件头（32 字节）：
+ *   char[4] magic        "ULYB"
+ *   u16     version
+ *   u16     reserved
+ *   u32     string_count
+ *   u32     string_offset  字符串表的位置
+ *   u32     node_count
+ *   u32     node_offset    节点表的位置
+ *   u32     attr_count
+ *   u32     attr_offset    属性表的位置
+ *
+ * 字符串表：string_count 项，每项为 { u32 offset, u32 length }，offset 为相对文件头的偏移。
+ *   字符串为 UTF-8 编码，其后跟一个 0 字节，length 不含该字节。
+ *   View 类型名、属性名和属性值都保存在字符串表中，相同的字符串只保存一次。
+ *
+ * 节点表：按先序排列的元素，每项为 { u32 type, u32 attr_start, u32 attr_count, u32 child_count }。
+ *   type 为类型名在字符串表中的下标；节点的子节点紧随其后。
+ *
+ * 属性表：每项为 { u32 key, u8 type, u8 unit, u16 reserved, u32 raw, u32 value }。
+ *   key 和 raw 分别为属性名和属性原文在字符串表中的下标；
+ *   type 为 AttrValueType，value 为预先解析的值。
+ */
+
+
+namespace necro {
+
+    const char kLayoutBinaryMagic[4] = { 'U', 'L', 'Y', 'B' };
+    const uint16_t kLayoutBinaryVersion = 1;
+    const char16_t kLayoutBinaryExt[] = u".ulb";
+
+    const size_t kLayoutBinaryHeaderSize = 32;
+    const size_t kLayoutBinaryStringSize = 8;
+    const size_t kLayoutBinaryNodeSize = 16;
+    const size_t kLayoutBinaryAttrSize = 16;
+
+    enum class AttrValueType : uint8_t {
+        // 只有原文
+        STRING = 0,
+        // value 为 int32
+        INT,
+        // value 为 float 的位模式
+        FLOAT,
+        // value 为 float 的位模式，unit 为 DimUnit
+        DIMENSION,
+        // value 为 0 或 1
+        BOOL,
+        // value 为 0xAARRGGBB
+        COLOR,
+    };
+
+    enum class DimUnit : uint8_t {
+        DP = 0,
+        PX,
+    };
+
+    struct AttrValue {
+        AttrValueType type = AttrValueType::STRING;
+        DimUnit unit = DimUnit::DP;
+        uint32_t value = 0;
+    };
+
+    namespace internal {
+
+        inline bool isLitEqualNoCase(const std::string_view& s1, const char* s2) {
+            size_t len = std::strlen(s2);
+            if (s1.size() != len) {
+                return false;
+            }
+            for (size_t i = 0; i < len; ++i) {
+                char c = s1[i];
+                if (c >= 'A' && c <= 'Z') {
+                    c = c - 'A' + 'a';
+                }
+                if (c != s2[i]) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        inline int hexValue(char c) {
+            if (c >= '0' && c <= '9') return c - '0';
+            if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+            if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+            return -1;
+        }
+
+        inline bool parseInt(const std::string_view& text, int32_t* out) {
+            if (text.empty()) {
+                return false;
+            }
+
+            size_t i = 0;
+            bool neg = false;
+            if (text[0] == '+' || text[0] == '-') {
+                neg = text[0] == '-';
+                ++i;
+            }
+            if (i == text.size()) {
+                return false;
+            }
+
+            int64_t val = 0;
+            for (; i < text.size(); ++i) {
+                if (text[i] < '0' || text[i] > '9') {
+                    return false;
+                }
+                val = val * 10 + (text[i] - '0');
+                if (val > int64_t(INT32_MAX) + 1) {
+                    return false;
+                }
+            }
+
+            val = neg ? -val : val;
+            if (val > INT32_MAX) {
+                return false;
+            }
+            *out = int32_t(val);
+            return true;
+        }
+
+        inline bool parseFloat(const std::string_view& text, float* out) {
+            // 只接受普通的十进制小数，不接受 inf、nan 和十六进制浮点数
+            if (text.empty() || text.size() > 63) {
+                return false;
+            }
+            bool has_digit = false;
+            for (char c : text) {
+                if (c >= '0' && c <= '9') {
+                    has_digit = true;
+                } else if (c != '.' && c != '+' && c != '-' && c != 'e' && c != 'E') {
+                    return false;
+                }
+            }
+            if (!has_digit) {
+                return false;
+            }
+
+            char buf[64];
+            std::memcpy(buf, text.data(), text.size());
+            buf[text.size()] = 0;
+
+            char* end;
+            float val = std::strtof(buf, &end);
+            if (end != buf + text.size()) {
+                return false;
+            }
+            *out = val;
+            return true;
+        }
+
+        inline uint32_t floatBits(float val) {
+            uint32_t bits;
+            std::memcpy(&bits, &val, 4);
+            return bits;
+        }
+
+    }
+
+    /**
+     * 预先解析属性原文。
+     * 规则与运行时的 attr_utils 一致：无单位的数字可作为 dp 使用，
+     * 布尔值不区分大小写，颜色为 #RGB、#ARGB、#RRGGBB 或 #AARRGGBB。
+     * 无法识别时为 STRING。
+     */
+    inline AttrValue classifyAttrValue(const std::string_view& text) {
+        using namespace internal;
+
+        AttrValue val;
+        if (text.empty()) {
+            return val;
+        }
+
+        int32_t i_val;
+        if (parseInt(text, &i_val)) {
+            val.type = AttrValueType::INT;
+            val.value = uint32_t(i_val);
+            return val;
+        }
+
+        float f_val;
+        if (parseFloat(text, &f_val)) {
+            val.type = AttrValueType::FLOAT;
+            val.value = floatBits(f_val);
+            return val;
+        }
+
+        if (text.size() > 2) {
+            auto suffix = text.substr(text.size() - 2);
+            bool is_dp = isLitEqualNoCase(suffix, "dp");
+            bool is_px = isLitEqualNoCase(suffix, "px");
+            if ((is_dp || is_px) && parseFloat(text.substr(0, text.size() - 2), &f_val)) {
+                val.type = AttrValueType::DIMENSION;
+                val.unit = is_dp ? DimUnit::DP : DimUnit::PX;
+                val.value = floatBits(f_val);
+                return val;
+            }
+        }
+
+        if (isLitEqualNoCase(text, "true") || isLitEqualNoCase(text, "false")) {
+            val.type = AttrValueType::BOOL;
+            val.value = isLitEqualNoCase(text, "true") ? 1 : 0;
+            return val;
+        }
+
+        if (text[0] == '#') {
+            auto hex = text.substr(1);
+            size_t n = hex.size();
+            if (n != 3 && n != 4 && n != 6 && n != 8) {
+                return val;
+            }
+
+            uint32_t comps[4] = { 0xFF, 0, 0, 0 };
+            size_t comp_count = (n == 3 || n == 6) ? 3 : 4;
+            size_t digits = (n <= 4) ? 1 : 2;
+            for (size_t i = 0; i < comp_count; ++i) {
+                uint32_t c = 0;
+                for (size_t j = 0; j < digits; ++j) {
+                    int h = hexValue(hex[i * digits + j]);
+                    if (h < 0) {
+                        return val;
+                    }
+                    c = c * 16 + h;
+                }
+                if (digits == 1) {
+                    c = c * 16 + c;
+                }
+                comps[4 - comp_count + i] = c;
+            }
+
+            val.type = AttrValueType::COLOR;
+            val.value = (comps[0] << 24) | (comps[1] << 16) | (comps[2] << 8) | comps[3];
+            return val;
+        }
+
+        return val;
+    }
+
+}
+
+#endif  // NECRO_LAYOUT_BINARY_H_
@@ -0,0 +1,161 @@
+// Copyright (c) 2016 ucclkp <ucclkp@gmail.com>.
+// This file is part of necro project.
+//
+// This program is licensed under GPLv3 license that can be
+// found in the LICENSE file.
+
+#include "necro/layout_binary_writer.h"
+
+#include "utils/log.h"
+
+#include "necro/layout_binary.h"
+
+
+namespace {
+
+    void appendU16(std::string* out, uint16_t val) {
+        out->push_back(char(val >> 8));
+        out->push_back(char(val));
+    }
+
+    void appendU32(std::string* out, uint32_t val) {
+        out->push_back(char(val >> 24));
+        out->push_back(char(val >> 16));
+        out->push_back(char(val >> 8));
+        out->push_back(char(val));
+    }
+
+}
+
+namespace necro {
+
+    LayoutBinaryWriter::LayoutBinaryWriter() {}
+
+    bool LayoutBinaryWriter::write(const utl::xml::Element& root, std::string* out) {
+        string_map_.clear();
+        strings_.clear();
+        nodes_.clear();
+        attrs_.clear();
+
+        if (!traverse(root)) {
+            return false;
+        }
+
+        // 计算各部分的位置
+        size_t string_offset = kLayoutBinaryHeaderSize;
+        size_t node_offset = string_offset + strings_.size() * kLayoutBinaryStringSize;
+        size_t attr_offset = node_offset + nodes_.size() * kLayoutBinaryNodeSize;
+        size_t data_offset = attr_offset + attrs_.size() * kLayoutBinaryAttrSize;
+
+        size_t total = data_offset;
+        for (auto str : strings_) {
+            total += str->size() + 1;
+        }
+        if (total > UINT32_MAX) {
+            LOG(Log::ERR) << "The layout is too large.";
+            return false;
+        }
+
+        out->clear();
+        out->reserve(total);
+
+        // 文件头
+        out->append(kLayoutBinaryMagic, 4);
+        appendU16(out, kLayoutBinaryVersion);
+        appendU16(out, 0);
+        appendU32(out, uint32_t(strings_.size()));
+        appendU32(out, uint32_t(string_offset));
+        appendU32(out, uint32_t(nodes_.size()));
+        appendU32(out, uint32_t(node_offset));
+        appendU32(out, uint32_t(attrs_.size()));
+        appendU32(out, uint32_t(attr_offset));
+
+        // 字符串表
+        size_t cur_offset = data_offset;
+        for (auto str : strings_) {
+            appendU32(out, uint32_t(cur_offset));
+            appendU32(out, uint32_t(str->size()));
+            cur_offset += str->size() + 1;
+        }
+
+        // 节点表
+        for (const auto& node : nodes_) {
+            appendU32(out, node.type);
+            appendU32(out, node.attr_start);
+            appendU32(out, node.attr_count);
+            appendU32(out, node.child_count);
+        }
+
+        // 属性表
+        for (const auto& attr : attrs_) {
+            appendU32(out, attr.key);
+            out->push_back(char(attr.type));
+            out->push_back(char(attr.unit));
+            appendU16(out, 0);
+            appendU32(out, attr.raw);
+            appendU32(out, attr.value);
+        }
+
+        // 字符串数据
+        for (auto str : strings_) {
+            out->append(*str);
+            out->push_back(0);
+        }
+
+        return true;
+    }
+
+    uint32_t LayoutBinaryWriter::intern(const std::string& str) {
+        auto it = string_map_.find(str);
+        if (it != string_map_.end()) {
+            return it->second;
+        }
+
+        auto index = uint32_t(strings_.size());
+        auto result = string_map_.insert({ str, index });
+        strings_.push_back(&result.first->first);
+        return index;
+    }
+
+    bool LayoutBinaryWriter::traverse(const utl::xml::Element& element) {
+        if (element.tag_name.empty()) {
+            LOG(Log::ERR) << "Empty element name.";
+            return false;
+        }
+
+        auto node_index = nodes_.size();
+        Node node;
+        node.type = intern(element.tag_name);
+        node.attr_start = uint32_t(attrs_.size());
+        node.attr_count = uint32_t(element.attrs.size());
+        node.child_count = 0;
+        nodes_.push_back(node);
+
+        for (const auto& pair : element.attrs) {
+            auto val = classifyAttrValue(pair.second);
+
+            Attr attr;
+            attr.key = intern(pair.first);
+            attr.type = uint8_t(val.type);
+            attr.unit = uint8_t(val.unit);
+            attr.raw = intern(pair.second);
+            attr.value = val.value;
+            attrs_.push_back(attr);
+        }
+
+        uint32_t child_count = 0;
+        for (const auto& content : element.contents) {
+            if (content.type != utl::xml::Content::Type::Element) {
+                continue;
+            }
+            if (!content.element || !traverse(*content.element)) {
+                return false;
+            }
+            ++child_count;
+        }
+
+        nodes_[node_index].child_count = child_count;
+        return true;
+    }
+
+}
@@ -0,0 +1,56 @@
+// Copyright (c) 2016 ucclkp <ucclkp@gmail.com>.
+// This file is part of necro project.
+//
+// This program is licensed under GPLv3 license that can be
+// found in the LICENSE file.
+
+#ifndef NECRO_LAYOUT_BINARY_WRITER_H_
+#define NECRO_LAYOUT_BINARY_WRITER_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "utils/xml/xml_structs.h"
+
+
+namespace necro {
+
+    /**
+     * 将处理后的布局 XML 树写为二进制布局。
+     * 格式见 layout_binary.h。
+     */
+    class LayoutBinaryWriter {
+    public:
+        LayoutBinaryWriter();
+
+        bool write(const utl::xml::Element& root, std::string* out);
+
+    private:
+        struct Node {
+            uint32_t type;
+            uint32_t attr_start;
+            uint32_t attr_count;
+            uint32_t child_count;
+        };
+
+        struct Attr {
+            uint32_t key;
+            uint8_t type;
+            uint8_t unit;
+            uint32_t raw;
+            uint32_t value;
+        };
+
+        uint32_t intern(const std::string& str);
+        bool traverse(const utl::xml::Element& element);
+
+        std::map<std::string, uint32_t, std::less<>> string_map_;
+        std::vector<const std::string*> strings_;
+        std::vector<Node> nodes_;
+        std::vector<Attr> attrs_;
+    };
+
+}
+
+#endif  // NECRO_LAYOUT_BINARY_WRITER_H_
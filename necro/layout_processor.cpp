@@ -6,7 +6,13 @@
 
 #include "necro/layout_processor.h"
 
+#include <algorithm>
+#include <atomic>
 #include <fstream>
+#include <iterator>
+#include <set>
+#include <sstream>
+#include <thread>
 
 #include "utils/endian.hpp"
 #include "utils/log.h"
@@ -15,18 +21,150 @@
 #include "utils/xml/xml_parser.h"
 #include "utils/xml/xml_writer.h"
 
-#include "necro/layout_constants.h"
+#include "necro/layout_binary.h"
+#include "necro/layout_binary_writer.h"
 
 
+namespace {
+
+    // 历史文件格式的版本，其中包含标识，以便与早期的格式区分
+    const uint32_t kLayoutHistoryVersion = 0x4E4C4802;  // "NLH" 2
+
+    uint64_t hashContent(const std::string& content) {
+        // FNV-1a
+        uint64_t hash = 14695981039346656037ull;
+        for (char c : content) {
+            hash ^= uint8_t(c);
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    uint64_t getWriteTime(const std::filesystem::directory_entry& entry) {
+        std::error_code ec;
+        auto time = entry.last_write_time(ec);
+        if (ec) {
+            return 0;
+        }
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            time.time_since_epoch()).count();
+    }
+
+    /**
+     * 在多个线程上对 [0, count) 中的每个下标调用 func。
+     */
+    template <typename Func>
+    void runParallel(size_t count, Func&& func) {
+        if (count == 0) {
+            return;
+        }
+
+        size_t thread_count = (std::max)(std::thread::hardware_concurrency(), 1u);
+        thread_count = (std::min)(thread_count, count);
+
+        std::atomic<size_t> next(0);
+        auto worker = [&]() {
+            for (;;) {
+                size_t i = next.fetch_add(1);
+                if (i >= count) {
+                    break;
+                }
+                func(i);
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (size_t i = 1; i < thread_count; ++i) {
+            threads.emplace_back(worker);
+        }
+        worker();
+
+        for (auto& t : threads) {
+            t.join();
+        }
+    }
+
+    template <typename T>
+    void writeBE(std::ostream& s, T val) {
+        val = utl::fromToBE(val);
+        s.write(reinterpret_cast<const char*>(&val), sizeof(T));
+    }
+
+    template <typename T>
+    bool readBE(std::istream& s, T* val) {
+        s.read(reinterpret_cast<char*>(val), sizeof(T));
+        if (!s.good()) {
+            return false;
+        }
+        *val = utl::fromToBE(*val);
+        return true;
+    }
+
+    void writeString(std::ostream& s, const std::string& str) {
+        s.write(str.data(), str.size());
+        s.put(0);
+    }
+
+    bool readString(std::istream& s, std::string* str) {
+        str->clear();
+        for (;;) {
+            char buf;
+            s.read(&buf, 1);
+            if (!s.good()) {
+                return false;
+            }
+            if (buf == 0) {
+                return true;
+            }
+            str->push_back(buf);
+        }
+    }
+
+    bool readIdMap(std::istream& s, necro::LayoutProcessor::IdMap* map) {
+        uint32_t count;
+        if (!readBE(s, &count)) {
+            return false;
+        }
+        for (uint32_t i = 0; i < count; ++i) {
+            std::string name;
+            int64_t id;
+            if (!readString(s, &name) || !readBE(s, &id)) {
+                return false;
+            }
+            (*map)[name] = id;
+        }
+        return true;
+    }
+
+    void writeIdMap(std::ostream& s, const necro::LayoutProcessor::IdMap& map) {
+        writeBE(s, utl::num_cast<uint32_t>(map.size()));
+        for (const auto& pair : map) {
+            writeString(s, pair.first);
+            writeBE(s, int64_t(pair.second));
+        }
+    }
+
+}
+
 namespace necro {
 
-    LayoutProcessor::LayoutProcessor()
-        : need_second_(false),
-          cur_view_id_(kXmlLayoutIdStart),
-          cur_layout_id_(kXmlLayoutIdStart) {}
+    struct LayoutProcessor::FileTask {
+        fs::path path;
+        std::string name;
+        uint64_t ts = 0;
+        uint64_t hash = 0;
+
+        // 内容有改动，需要重新生成输出文件
+        bool changed = false;
+        ElementPtr root;
+        std::vector<std::string> ids;
+        std::string err;
+    };
+
+    LayoutProcessor::LayoutProcessor() {}
 
     bool LayoutProcessor::process(
-        const fs::path& res_dir, const fs::path& out_dir, bool* changed)
+        const fs::path& res_dir, const fs::path& out_dir, bool* ids_changed)
     {
         std::error_code ec;
         std::vector<fs::directory_entry> xml_files;
@@ -49,162 +187,154 @@ namespace necro {
             });
         }
 
-        // 从文件中读出历史
-        std::vector<History> histories;
-        readHistory(out_dir, &histories);
-
-        // 看看历史中有没有相同记录
-        *changed = false;
-        for (const auto& xml_file : xml_files) {
-            bool hit = false;
-            for (auto it = histories.begin(); it != histories.end(); ++it) {
-                if (it->xml_path == xml_file.path()) {
-                    uint64_t last_write = std::chrono::duration_cast<std::chrono::microseconds>(
-                        xml_file.last_write_time(ec).time_since_epoch()).count();
-                    if (!ec && it->ts == last_write)
-                    {
-                        hit = true;
-                        histories.erase(it);
-                        break;
-                    }
-                }
-            }
-            if (!hit) {
-                *changed = true;
-                break;
-            }
-        }
-        if (!histories.empty()) {
-            *changed = true;
+        // 从文件中读出历史。上次未完整结束时，只沿用已分配的 id
+        History history;
+        readHistory(out_dir, &history);
+        if (!history.available) {
+            history.files.clear();
         }
 
-        // 所有 XML 文件都没有改动，就直接返回
-        if (!*changed) {
-            std::vector<fs::directory_entry> out_xml_files;
-            for (auto& f : fs::directory_iterator(out_dir, ec)) {
-                if (!f.is_directory(ec) && utl::isLitEqual(f.path().extension().u16string(), u".xml")) {
-                    out_xml_files.push_back(f);
-                }
-            }
-
-            for (const auto& xml_file : xml_files) {
-                for (auto it = out_xml_files.begin(); it != out_xml_files.end(); ++it) {
-                    if (it->path().filename() == xml_file.path().filename()) {
-                        out_xml_files.erase(it);
-                        break;
-                    }
-                }
-            }
-
-            for (const auto& xml_file : out_xml_files) {
-                fs::remove(xml_file.path(), ec);
-            }
+        std::vector<FileTask> tasks(xml_files.size());
+        for (size_t i = 0; i < xml_files.size(); ++i) {
+            auto& task = tasks[i];
+            task.path = xml_files[i].path();
 
-            LOG(Log::INFO) << "No xml files were changed.";
-            return true;
+            // 直到 C++ 20 足够普及为止，这里先这样写
+            auto name_u8 = task.path.filename().u8string();
+            task.name.assign(name_u8.begin(), name_u8.end());
+            task.ts = getWriteTime(xml_files[i]);
         }
 
-        fs::remove(out_dir, ec);
+        // 并行读取文件并计算哈希，只解析有改动的文件
+        runParallel(tasks.size(), [&](size_t i) {
+            auto it = history.files.find(tasks[i].name);
+            loadFile(&tasks[i], it == history.files.end() ? nullptr : &it->second, out_dir);
+        });
 
-        // 处理 XML 文件
-        for (const auto& xml_file : xml_files) {
-            jour_i("Processing xml file: %s", xml_file.path());
-
-            std::ifstream reader(xml_file.path(), std::ios::binary);
-            if (!reader) {
-                jour_e("Cannot open xml file: %s", xml_file.path().filename());
+        size_t changed_count = 0;
+        for (const auto& task : tasks) {
+            if (!task.err.empty()) {
+                LOG(Log::ERR) << task.err;
                 return false;
             }
-
-            utl::XMLParser xml_parser;
-            std::shared_ptr<utl::xml::Element> root;
-            if (!xml_parser.parse(reader, &root)) {
-                auto& pedometer = xml_parser.getPedometer();
-                jour_e(
-                    "Failed to parse xml file: %s line: %d col: %d",
-                    xml_file.path().filename(), pedometer.getCurRow(), pedometer.getCurCol());
-                return false;
+            if (task.changed) {
+                ++changed_count;
             }
+        }
 
-            IdMap cur_map;
-            if (!traverseTree(root, true, &cur_map)) {
-                jour_e("Failed to traverse xml file: %s", xml_file.path().filename());
-                return false;
+        // 分配 id。已有的 id 保持不变，新的 id 从上次的最大值之后开始分配
+        std::map<std::string, const std::string*> id_owners;
+        for (auto& task : tasks) {
+            if (!task.changed) {
+                task.ids = history.files[task.name].ids;
             }
 
-            if (need_second_) {
-                if (!traverseTree(root, false, &cur_map)) {
-                    jour_e("Failed to traverse xml file: %s", xml_file.path().filename());
+            for (const auto& id : task.ids) {
+                auto result = id_owners.insert({ id, &task.name });
+                if (!result.second) {
+                    LOG(Log::ERR) << "The id: " << id << " in file: " << task.name
+                        << " is duplicated in file: " << *result.first->second;
                     return false;
                 }
-            }
 
-            for (const auto& cur : cur_map) {
-                view_id_map_.insert(cur);
+                auto old_it = history.view_ids.find(id);
+                if (old_it != history.view_ids.end()) {
+                    view_id_map_[id] = old_it->second;
+                } else {
+                    view_id_map_[id] = history.next_view_id++;
+                }
             }
-            cur_map.clear();
 
-            std::string xml_str;
-            utl::XMLWriter xml_writer;
-            if (!xml_writer.write(*root, &xml_str)) {
-                jour_e("Failed to write xml file: %s", xml_file.path().filename());
-                return false;
+            auto old_it = history.layout_ids.find(task.name);
+            if (old_it != history.layout_ids.end()) {
+                layout_id_map_[task.name] = old_it->second;
+            } else {
+                layout_id_map_[task.name] = history.next_layout_id++;
             }
+        }
+
+        *ids_changed = !history.available ||
+            view_id_map_ != history.view_ids ||
+            layout_id_map_ != history.layout_ids;
+
+        if (changed_count > 0) {
+            LOG(Log::INFO) << changed_count << " xml file(s) changed";
 
-            fs::path new_file = out_dir / xml_file.path().filename();
             if (!fs::create_directories(out_dir, ec) && ec) {
                 jour_e("Failed to make dir: %s", out_dir);
                 return false;
             }
-            std::ofstream writer(new_file, std::ios::binary | std::ios::ate);
-            if (!writer) {
-                jour_e("Cannot open file: %s", new_file);
-                return false;
-            }
 
-            writer.write(xml_str.data(), xml_str.length());
+            runParallel(tasks.size(), [&](size_t i) {
+                if (tasks[i].changed) {
+                    writeFile(&tasks[i], view_id_map_, out_dir);
+                }
+            });
 
-            // 直到 C++ 20 足够普及为止，这里先这样写
-            auto xml_file_name_u8 = xml_file.path().filename().u8string();
-            std::string xml_file_name(xml_file_name_u8.begin(), xml_file_name_u8.end());
-            if (!xml_file_name.empty()) {
-                layout_id_map_[xml_file_name] = cur_layout_id_;
-                ++cur_layout_id_;
+            for (const auto& task : tasks) {
+                if (!task.err.empty()) {
+                    LOG(Log::ERR) << task.err;
+                    return false;
+                }
             }
+        } else {
+            LOG(Log::INFO) << "No xml files were changed.";
         }
 
-        LOG(Log::INFO) << "Generating layout id file...";
-
-        // 生成包含布局 id 和文件名对应关系的记录文件
-        if (!layout_id_map_.empty()) {
-            std::string out_map_str;
-            for (const auto& pair : layout_id_map_) {
-                out_map_str.append(std::to_string(pair.second))
-                    .append("=").append(pair.first).append("\n");
+        // 删除已不存在的 XML 文件对应的输出
+        std::set<fs::path> out_names;
+        for (const auto& task : tasks) {
+            auto name = task.path.filename();
+            out_names.insert(name);
+            out_names.insert(name.replace_extension(kLayoutBinaryExt));
+        }
+        for (auto& f : fs::directory_iterator(out_dir, ec)) {
+            if (f.is_directory(ec)) {
+                continue;
             }
-            std::ofstream writer(out_dir / kLayoutIdFileName, std::ios::binary | std::ios::ate);
-            writer.write(out_map_str.data(), out_map_str.length());
-            if (!writer) {
-                LOG(Log::ERR) << "Failed to write layout id file.";
-                return false;
+            auto ext = f.path().extension().u16string();
+            if (utl::isLitEqual(ext, u".xml") || utl::isLitEqual(ext, kLayoutBinaryExt)) {
+                if (out_names.find(f.path().filename()) == out_names.end()) {
+                    fs::remove(f.path(), ec);
+                }
             }
-        } else {
-            LOG(Log::INFO) << "Layout id map is empty, no file generated";
-        }
-
-        // 生成历史，写入文件
-        histories.clear();
-        for (const auto& xml_file : xml_files) {
-            uint64_t last_write = std::chrono::duration_cast<std::chrono::microseconds>(
-                xml_file.last_write_time(ec).time_since_epoch()).count();
-            if (!ec) {
-                History his;
-                his.xml_path = xml_file;
-                his.ts = last_write;
-                histories.push_back(std::move(his));
+        }
+
+        // 生成包含布局 id 和文件名对应关系的记录文件
+        if (*ids_changed || changed_count > 0 || !fs::exists(out_dir / kLayoutIdFileName, ec)) {
+            LOG(Log::INFO) << "Generating layout id file...";
+
+            if (!layout_id_map_.empty()) {
+                std::string out_map_str;
+                for (const auto& pair : layout_id_map_) {
+                    out_map_str.append(std::to_string(pair.second))
+                        .append("=").append(pair.first).append("\n");
+                }
+                std::ofstream writer(out_dir / kLayoutIdFileName, std::ios::binary | std::ios::trunc);
+                writer.write(out_map_str.data(), out_map_str.length());
+                if (!writer) {
+                    LOG(Log::ERR) << "Failed to write layout id file.";
+                    return false;
+                }
+            } else {
+                LOG(Log::INFO) << "Layout id map is empty, no file generated";
             }
         }
-        writeHistory(out_dir, histories);
+
+        // 生成历史，写入文件。id 有变化时，资源头文件生成之后才标记为可用
+        History new_history;
+        new_history.available = !*ids_changed;
+        new_history.next_view_id = history.next_view_id;
+        new_history.next_layout_id = history.next_layout_id;
+        new_history.view_ids = view_id_map_;
+        new_history.layout_ids = layout_id_map_;
+        for (auto& task : tasks) {
+            auto& record = new_history.files[task.name];
+            record.ts = task.ts;
+            record.hash = task.hash;
+            record.ids = std::move(task.ids);
+        }
+        writeHistory(out_dir, new_history);
 
         return true;
     }
@@ -217,88 +347,247 @@ namespace necro {
         return layout_id_map_;
     }
 
-    void LayoutProcessor::readHistory(
-        const fs::path& out_dir, std::vector<History>* histories)
+    // static
+    void LayoutProcessor::loadFile(
+        FileTask* task, const FileRecord* record, const fs::path& out_dir)
     {
-        std::ifstream cache_file(out_dir / kLayoutHistoryFileName, std::ios::binary);
-        if (!cache_file) {
+        std::error_code ec;
+        auto out_file = out_dir / task->path.filename();
+        auto bin_file = out_file;
+        bin_file.replace_extension(kLayoutBinaryExt);
+        bool has_output = fs::exists(out_file, ec) && fs::exists(bin_file, ec);
+
+        // 修改时间没变时不读取文件
+        if (record && has_output && task->ts != 0 && record->ts == task->ts) {
+            task->hash = record->hash;
             return;
         }
-        std::istream& s = cache_file;
 
-        uint8_t available;
-        s.read(reinterpret_cast<char*>(&available), 1);
-        if (!s.good()) {
+        std::ifstream reader(task->path, std::ios::binary);
+        if (!reader) {
+            task->err = "Cannot open xml file: " + task->name;
             return;
         }
-        if (available == 0) {
+
+        std::string content(
+            (std::istreambuf_iterator<char>(reader)),
+            std::istreambuf_iterator<char>());
+        if (reader.bad()) {
+            task->err = "Cannot read xml file: " + task->name;
             return;
         }
 
-        uint32_t count;
-        s.read(reinterpret_cast<char*>(&count), 4);
-        if (!s.good()) {
+        task->hash = hashContent(content);
+        if (record && has_output && record->hash == task->hash) {
             return;
         }
-        count = utl::fromToBE(count);
-        for (uint32_t i = 0; i < count; ++i) {
-            History his;
-            std::string path_u8;
-            for (;;) {
-                char buf;
-                s.read(&buf, 1);
-                if (!s.good() || buf == 0) break;
-                path_u8.push_back(buf);
-            }
-            his.xml_path = utl::u8to16(path_u8);
-            s.read(reinterpret_cast<char*>(&his.ts), 8);
-            if (!s.good()) break;
-            his.ts = utl::fromToBE(his.ts);
 
-            histories->push_back(std::move(his));
+        task->changed = true;
+
+        std::istringstream content_reader(content);
+        utl::XMLParser xml_parser;
+        if (!xml_parser.parse(content_reader, &task->root)) {
+            auto& pedometer = xml_parser.getPedometer();
+            task->err = "Failed to parse xml file: " + task->name
+                + " line: " + std::to_string(pedometer.getCurRow())
+                + " col: " + std::to_string(pedometer.getCurCol());
+            return;
+        }
+
+        std::string err;
+        if (!collectIds(task->root, &task->ids, &err)) {
+            task->err = "Failed to traverse xml file: " + task->name + ": " + err;
+            return;
         }
     }
 
-    void LayoutProcessor::writeHistory(
-        const fs::path& out_dir, const std::vector<History>& histories)
+    // static
+    void LayoutProcessor::writeFile(
+        FileTask* task, const IdMap& view_ids, const fs::path& out_dir)
     {
-        if (histories.empty()) {
+        // 文件中只能引用本文件中声明的 id
+        IdMap file_ids;
+        for (const auto& id : task->ids) {
+            file_ids[id] = view_ids.at(id);
+        }
+
+        std::string err;
+        if (!resolveIds(task->root, file_ids, &err)) {
+            task->err = "Failed to traverse xml file: " + task->name + ": " + err;
+            return;
+        }
+
+        std::string xml_str;
+        utl::XMLWriter xml_writer;
+        if (!xml_writer.write(*task->root, &xml_str)) {
+            task->err = "Failed to write xml file: " + task->name;
+            return;
+        }
+
+        fs::path new_file = out_dir / task->path.filename();
+        std::ofstream writer(new_file, std::ios::binary | std::ios::trunc);
+        if (!writer) {
+            task->err = "Cannot open file: " + task->name;
             return;
         }
 
+        writer.write(xml_str.data(), xml_str.length());
+
+        // 同时生成二进制布局，运行时优先使用
+        std::string bin_str;
+        LayoutBinaryWriter bin_writer;
+        if (!bin_writer.write(*task->root, &bin_str)) {
+            task->err = "Failed to write binary layout: " + task->name;
+            return;
+        }
+
+        auto bin_file = new_file;
+        bin_file.replace_extension(kLayoutBinaryExt);
+        std::ofstream bin_file_writer(bin_file, std::ios::binary | std::ios::trunc);
+        if (!bin_file_writer) {
+            task->err = "Cannot open binary layout file for: " + task->name;
+            return;
+        }
+
+        bin_file_writer.write(bin_str.data(), bin_str.length());
+    }
+
+    bool LayoutProcessor::readHistory(const fs::path& out_dir, History* history) {
+        std::ifstream cache_file(out_dir / kLayoutHistoryFileName, std::ios::binary);
+        if (!cache_file) {
+            return false;
+        }
+        std::istream& s = cache_file;
+
+        uint8_t available;
+        uint32_t version;
+        uint16_t bin_version;
+        if (!readBE(s, &available) ||
+            !readBE(s, &version) || version != kLayoutHistoryVersion ||
+            !readBE(s, &bin_version))
+        {
+            return false;
+        }
+
+        History his;
+        int64_t next_view_id, next_layout_id;
+        if (!readBE(s, &next_view_id) || !readBE(s, &next_layout_id) ||
+            !readIdMap(s, &his.view_ids) || !readIdMap(s, &his.layout_ids))
+        {
+            return false;
+        }
+        his.next_view_id = next_view_id;
+        his.next_layout_id = next_layout_id;
+
+        uint32_t file_count;
+        if (!readBE(s, &file_count)) {
+            return false;
+        }
+        for (uint32_t i = 0; i < file_count; ++i) {
+            std::string name;
+            FileRecord record;
+            uint32_t id_count;
+            if (!readString(s, &name) ||
+                !readBE(s, &record.ts) || !readBE(s, &record.hash) ||
+                !readBE(s, &id_count))
+            {
+                return false;
+            }
+
+            for (uint32_t j = 0; j < id_count; ++j) {
+                std::string id;
+                if (!readString(s, &id)) {
+                    return false;
+                }
+                record.ids.push_back(std::move(id));
+            }
+            his.files[name] = std::move(record);
+        }
+
+        // 二进制布局的格式变化时，已有的输出都不可用
+        his.available = (available != 0) && (bin_version == kLayoutBinaryVersion);
+        *history = std::move(his);
+        return true;
+    }
+
+    void LayoutProcessor::writeHistory(const fs::path& out_dir, const History& history) {
         std::ofstream cache_file(out_dir / kLayoutHistoryFileName, std::ios::binary | std::ios::trunc);
         if (!cache_file) {
             return;
         }
         std::ostream& s = cache_file;
 
-        uint8_t available = 0;
-        s.write(reinterpret_cast<const char*>(&available), 1);
-        if (!s.good()) {
-            return;
+        // 第一个字节须为可用标志，资源头文件生成后会被改写
+        writeBE(s, uint8_t(history.available ? 1 : 0));
+        writeBE(s, kLayoutHistoryVersion);
+        writeBE(s, kLayoutBinaryVersion);
+        writeBE(s, int64_t(history.next_view_id));
+        writeBE(s, int64_t(history.next_layout_id));
+        writeIdMap(s, history.view_ids);
+        writeIdMap(s, history.layout_ids);
+
+        writeBE(s, utl::num_cast<uint32_t>(history.files.size()));
+        for (const auto& pair : history.files) {
+            writeString(s, pair.first);
+            writeBE(s, pair.second.ts);
+            writeBE(s, pair.second.hash);
+            writeBE(s, utl::num_cast<uint32_t>(pair.second.ids.size()));
+            for (const auto& id : pair.second.ids) {
+                writeString(s, id);
+            }
         }
 
-        uint32_t count = utl::fromToBE(utl::num_cast<uint32_t>(histories.size()));
-        s.write(reinterpret_cast<const char*>(&count), 4);
         if (!s.good()) {
-            return;
+            LOG(Log::WARNING) << "Failed to write layout histories.";
         }
-        for (const auto& item : histories) {
-            auto path_u8 = item.xml_path.u8string();
-            s.write(reinterpret_cast<const char*>(path_u8.data()), path_u8.size());
-            if (!s.good()) { return; }
+    }
+
+    // static
+    bool LayoutProcessor::collectIds(
+        const ElementPtr& element, std::vector<std::string>* ids, std::string* err)
+    {
+        if (!element) {
+            return false;
+        }
+
+        for (const auto& attr : element->attrs) {
+            if (!utl::startWith(attr.second, "@+id/")) {
+                continue;
+            }
+
+            // 声明 ID
+            auto id_val = attr.second.substr(5);
+            if (id_val.empty()) {
+                *err = "The id attr: " + attr.first
+                    + " of element: " + element->tag_name + " is invalid";
+                return false;
+            }
 
-            uint8_t term = 0;
-            s.write(reinterpret_cast<const char*>(&term), 1);
-            if (!s.good()) { return; }
+            // 当前文件中的 view_id 重复
+            if (std::find(ids->begin(), ids->end(), id_val) != ids->end()) {
+                *err = "The id: " + id_val
+                    + " of element: " + element->tag_name + " is duplicated";
+                return false;
+            }
+            ids->push_back(std::move(id_val));
+        }
 
-            uint64_t ts = utl::fromToBE(item.ts);
-            s.write(reinterpret_cast<const char*>(&ts), 8);
-            if (!s.good()) { return; }
+        for (const auto& content : element->contents) {
+            if (content.type != utl::xml::Content::Type::Element) {
+                continue;
+            }
+            if (!collectIds(content.element, ids, err)) {
+                return false;
+            }
         }
+
+        return true;
     }
 
-    bool LayoutProcessor::traverseTree(const ElementPtr& element, bool is_first, IdMap* cur_map) {
+    // static
+    bool LayoutProcessor::resolveIds(
+        const ElementPtr& element, const IdMap& ids, std::string* err)
+    {
         if (!element) {
             return false;
         }
@@ -307,95 +596,56 @@ namespace necro {
             auto attr_val = attr.second;
             if (utl::startWith(attr_val, "@+id/")) {
                 // 声明 ID
-                auto id_val = attr_val.substr(5);
-                if (id_val.empty()) {
-                    LOG(Log::ERR) << "The id attr: " << attr.first
-                        << " of element: " << element->tag_name
-                        << " is invalid";
-                    return false;
-                }
+                attr.second = std::to_string(ids.at(attr_val.substr(5)));
+                continue;
+            }
 
-                // 当前文件中的 view_id 重复
-                if (cur_map->find(id_val) != cur_map->end()) {
-                    LOG(Log::ERR) << "The id: " << id_val
-                        << " of element: " << element->tag_name
-                        << " is duplicated";
-                    return false;
+            bool modified = false;
+            decltype(attr_val)::size_type cur_idx = 0;
+            for (;;) {
+                auto idx = attr_val.find('@', cur_idx);
+                if (idx == decltype(attr_val)::npos) {
+                    if (modified) {
+                        attr.second = attr_val;
+                    }
+                    break;
                 }
-                // 整个项目的 view_id 重复
-                if (view_id_map_.find(id_val) != view_id_map_.end()) {
-                    jour_e(
-                        "The id: %s of element: %s is duplicated in other files.",
-                        id_val.c_str(), element->tag_name.c_str());
-                    return false;
+
+                auto end_idx = attr_val.find(',', idx);
+                if (end_idx == decltype(attr_val)::npos) {
+                    end_idx = attr_val.length();
                 }
 
-                cur_map->insert({ id_val, cur_view_id_ });
-                attr.second = std::to_string(cur_view_id_);
-                ++cur_view_id_;
-            } else {
-                bool modified = false;
-                decltype(attr_val)::size_type cur_idx = 0;
-                for (;;) {
-                    auto idx = attr_val.find('@', cur_idx);
-                    if (idx == decltype(attr_val)::npos) {
-                        if (modified) {
-                            attr.second = attr_val;
-                        }
-                        break;
+                if (utl::startWith(attr_val, "@id/", idx)) {
+                    // 引用 ID
+                    auto id_val = attr_val.substr(idx + 4, end_idx - idx - 4);
+                    utl::trim_self(&id_val);
+                    if (id_val.empty()) {
+                        *err = "The id in attr: " + attr.first
+                            + " of element: " + element->tag_name + " is invalid.";
+                        return false;
                     }
 
-                    if (utl::startWith(attr_val, "@id/", idx)) {
-                        // 引用 ID
-                        auto end_idx = attr_val.find(',', idx);
-                        if (end_idx == decltype(attr_val)::npos) {
-                            end_idx = attr_val.length();
-                        }
-
-                        auto id_val = attr_val.substr(idx + 4, end_idx - idx - 4);
-                        utl::trim_self(&id_val);
-                        if (id_val.empty()) {
-                            LOG(Log::ERR) << "The id in attr: " << attr.first
-                                << " of element: " << element->tag_name
-                                << " is invalid.";
-                            return false;
-                        }
-
-                        auto it = cur_map->find(id_val);
-                        if (it == cur_map->end()) {
-                            if (is_first) {
-                                need_second_ = true;
-                                cur_idx = end_idx;
-                            } else {
-                                LOG(Log::ERR) << "Cannot find id: " << id_val
-                                    << " in attr: " << attr.first
-                                    << " of element: " << element->tag_name;
-                                return false;
-                            }
-                        } else {
-                            attr_val.replace(idx, end_idx - idx, std::to_string(it->second));
-                            cur_idx = idx;
-                            modified = true;
-                        }
-                    } else if (utl::startWith(attr_val, "@color/", idx)) {
-                        // 颜色由运行时解析
-                        auto end_idx = attr_val.find(',', idx);
-                        if (end_idx == decltype(attr_val)::npos) {
-                            end_idx = attr_val.length();
-                        }
-                        cur_idx = end_idx;
-                    } else if (utl::startWith(attr_val, "@element/", idx)) {
-                        // Element 由运行时解析
-                        auto end_idx = attr_val.find(',', idx);
-                        if (end_idx == decltype(attr_val)::npos) {
-                            end_idx = attr_val.length();
-                        }
-                        cur_idx = end_idx;
-                    } else {
-                        LOG(Log::ERR) << "Unsupported @ operation in: " << attr_val
-                            << " of element: " << element->tag_name;
+                    auto it = ids.find(id_val);
+                    if (it == ids.end()) {
+                        *err = "Cannot find id: " + id_val
+                            + " in attr: " + attr.first
+                            + " of element: " + element->tag_name;
                         return false;
                     }
+
+                    attr_val.replace(idx, end_idx - idx, std::to_string(it->second));
+                    cur_idx = idx;
+                    modified = true;
+                } else if (utl::startWith(attr_val, "@color/", idx) ||
+                    utl::startWith(attr_val, "@element/", idx))
+                {
+                    // 颜色和 Element 由运行时解析
+                    cur_idx = end_idx;
+                } else {
+                    *err = "Unsupported @ operation in: " + attr_val
+                        + " of element: " + element->tag_name;
+                    return false;
                 }
             }
         }
@@ -404,7 +654,7 @@ namespace necro {
             if (content.type != utl::xml::Content::Type::Element) {
                 continue;
             }
-            if (!traverseTree(content.element, is_first, cur_map)) {
+            if (!resolveIds(content.element, ids, err)) {
                 return false;
             }
         }
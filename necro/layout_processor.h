@@ -9,14 +9,22 @@
 
 #include <filesystem>
 #include <map>
+#include <vector>
 
 #include "utils/xml/xml_structs.h"
 
+#include "necro/layout_constants.h"
+
 
 namespace necro {
 
     namespace fs = std::filesystem;
 
+    /**
+     * 处理布局 XML 文件：为 View 和布局分配 id，输出处理后的 XML 和二进制布局。
+     * 按文件内容的哈希判断文件是否有改动，只重新处理有改动的文件，多个文件并行处理。
+     * 已分配的 id 记录在历史文件中，在多次运行之间保持不变。
+     */
     class LayoutProcessor {
     public:
         using IdMap = std::map<std::string, long long>;
@@ -24,24 +32,46 @@ namespace necro {
 
         LayoutProcessor();
 
-        bool process(const fs::path& res_dir, const fs::path& out_dir, bool* changed);
+        /**
+         * @param ids_changed 返回 id 集合是否有变化。
+         *                    只有 id 集合变化时才需要重新生成资源头文件。
+         */
+        bool process(const fs::path& res_dir, const fs::path& out_dir, bool* ids_changed);
 
         const IdMap& getViewIdMap() const;
         const IdMap& getLayoutIdMap() const;
 
     private:
+        struct FileRecord {
+            uint64_t ts = 0;
+            uint64_t hash = 0;
+            // 文件中声明的 View id 名称
+            std::vector<std::string> ids;
+        };
+
         struct History {
-            fs::path xml_path;
-            uint64_t ts;
+            // 上次运行是否完整结束（包括生成资源头文件）
+            bool available = false;
+            long long next_view_id = kXmlLayoutIdStart;
+            long long next_layout_id = kXmlLayoutIdStart;
+            IdMap view_ids;
+            IdMap layout_ids;
+            // 文件名 -> 记录
+            std::map<std::string, FileRecord> files;
         };
 
-        void readHistory(const fs::path& out_dir, std::vector<History>* histories);
-        void writeHistory(const fs::path& out_dir, const std::vector<History>& histories);
-        bool traverseTree(const ElementPtr& element, bool is_first, IdMap* cur_map);
+        struct FileTask;
+
+        bool readHistory(const fs::path& out_dir, History* history);
+        void writeHistory(const fs::path& out_dir, const History& history);
+
+        static void loadFile(FileTask* task, const FileRecord* record, const fs::path& out_dir);
+        static void writeFile(FileTask* task, const IdMap& view_ids, const fs::path& out_dir);
+        static bool collectIds(
+            const ElementPtr& element, std::vector<std::string>* ids, std::string* err);
+        static bool resolveIds(
+            const ElementPtr& element, const IdMap& ids, std::string* err);
 
-        bool need_second_;
-        unsigned long long cur_view_id_;
-        unsigned long long cur_layout_id_;
         IdMap view_id_map_;
         IdMap layout_id_map_;
     };
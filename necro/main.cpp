@@ -36,11 +36,14 @@ int processXMLFiles(
     LOG(Log::INFO) << "Resource path: " << res_path;
     LOG(Log::INFO) << "Build path: " << build_path;
 
-    bool xml_changed;
+    bool ids_changed;
     auto layout_out_dir = build_res_file / u"layout";
     necro::LayoutProcessor layout_processor;
-    if (layout_processor.process(layout_xml_file, layout_out_dir, &xml_changed)) {
-        if (!xml_changed) {
+    if (layout_processor.process(layout_xml_file, layout_out_dir, &ids_changed)) {
+        // 头文件被所有使用资源 id 的源文件包含，只在 id 有变化时才重新生成
+        std::error_code ec;
+        if (!ids_changed && fs::exists(header_file, ec)) {
+            LOG(Log::INFO) << "Resource ids were not changed.";
             return 0;
         }
 
@@ -54,12 +57,10 @@ int processXMLFiles(
             return 1;
         }
 
-        if (xml_changed) {
-            std::ofstream necro_cache(layout_out_dir / necro::kLayoutHistoryFileName, std::ios::binary | std::ios::in);
-            if (necro_cache.good()) {
-                uint8_t available = 1;
-                necro_cache.write(reinterpret_cast<const char*>(&available), 1);
-            }
+        std::ofstream necro_cache(layout_out_dir / necro::kLayoutHistoryFileName, std::ios::binary | std::ios::in);
+        if (necro_cache.good()) {
+            uint8_t available = 1;
+            necro_cache.write(reinterpret_cast<const char*>(&available), 1);
         }
     } else {
         LOG(Log::ERR) << "Failed to process layout";
@@ -7,6 +7,7 @@
 #include "necro/resource_header_processor.h"
 
 #include <fstream>
+#include <iterator>
 
 #include "utils/log.h"
 #include "utils/strings/string_utils.hpp"
@@ -31,12 +32,6 @@ namespace necro {
     bool ResourceHeaderProcessor::write(
         const fs::path& path, const IdMap& view_id_map, const IdMap& layout_id_map)
     {
-        std::ofstream writer(path, std::ios::binary | std::ios::ate);
-        if (writer.fail()) {
-            jour_e("Cannot open file: %s", path);
-            return false;
-        }
-
         std::error_code ec;
         if (!fs::create_directories(path.parent_path(), ec) && ec) {
             jour_e("Failed to make dir: %s", path.parent_path());
@@ -55,9 +50,28 @@ namespace necro {
         std::string out_str;
         generateOutput(utl::u16to8(name_macro), view_id_map, layout_id_map, &out_str);
 
+        // 内容相同时不写入，以免修改时间变化导致包含该头文件的源文件重新编译
+        std::ifstream reader(path, std::ios::binary);
+        if (reader) {
+            std::string old_str(
+                (std::istreambuf_iterator<char>(reader)),
+                std::istreambuf_iterator<char>());
+            if (!reader.bad() && old_str == out_str) {
+                LOG(Log::INFO) << "Resources header is up to date.";
+                return true;
+            }
+        }
+        reader.close();
+
+        std::ofstream writer(path, std::ios::binary | std::ios::trunc);
+        if (writer.fail()) {
+            jour_e("Cannot open file: %s", path);
+            return false;
+        }
+
         writer.write(out_str.data(), out_str.length());
 
-        return true;
+        return bool(writer);
     }
 
     void ResourceHeaderProcessor::generateOutput(
@@ -6,12 +6,14 @@
 
 #include <memory>
 
+#include "utils/command_line.h"
 #include "utils/log.h"
 #include "utils/platform_utils.h"
 
 #include "ukive/app/application.h"
 #include "ukive/window/purpose.h"
 
+#include "shell/benchmarks/benchmarks.h"
 #include "shell/lod/lod_window.h"
 #include "shell/examples/example_window.h"
 #include "shell/text/text_window.h"
@@ -35,6 +37,12 @@ GUI_MAIN() {
     options.app_name = u"shell";
     auto app = std::make_shared<ukive::Application>(options);
 
+    if (utl::CommandLine::hasName("benchmark")) {
+        shell::runBenchmarks();
+        utl::UninitLogging();
+        return 0;
+    }
+
     ukive::Window::InitParams native_params;
     native_params.frame_type = ukive::WINDOW_FRAME_NATIVE;
 
@@ -0,0 +1,36 @@
+// Copyright (c) 2016 ucclkp <ucclkp@gmail.com>.
+// This file is part of ukive project.
+//
+// This program is licensed under GPLv3 license that can be
+// found in the LICENSE file.
+
+#include "shell/benchmarks/benchmarks.h"
+
+#include "utils/log.h"
+
+#include "ukive/graphics/cpu/pixel_kernels_benchmark.h"
+#include "ukive/resources/layout_parser_benchmark.h"
+#include "ukive/text/editable_benchmark.h"
+#include "ukive/text/piece_table_benchmark.h"
+#include "ukive/text/span/span_tree_benchmark.h"
+#include "ukive/text/text_breaker_benchmark.h"
+#include "ukive/views/layout/restraint_layout_benchmark.h"
+
+
+namespace shell {
+
+    void runBenchmarks() {
+        LOG(Log::INFO) << "========== Benchmarks start.";
+
+        ukive::cpu::runPixelKernelsBenchmark();
+        ukive::runLayoutParserBenchmark();
+        ukive::runRestraintLayoutBenchmark();
+        ukive::runPieceTableBenchmark();
+        ukive::runSpanTreeBenchmark();
+        ukive::runEditableBenchmark();
+        ukive::runTextBreakerBenchmark();
+
+        LOG(Log::INFO) << "========== Benchmarks end.";
+    }
+
+}
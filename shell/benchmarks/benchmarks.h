@@ -0,0 +1,21 @@
+// Copyright (c) 2016 ucclkp <ucclkp@gmail.com>.
+// This file is part of ukive project.
+//
+// This program is licensed under GPLv3 license that can be
+// found in the LICENSE file.
+
+#ifndef SHELL_BENCHMARKS_BENCHMARKS_H_
+#define SHELL_BENCHMARKS_BENCHMARKS_H_
+
+
+namespace shell {
+
+    /**
+     * 依次运行 ukive 中的性能测试，结果写入日志。
+     * 以 --benchmark 参数启动 shell 时调用，之后直接退出。
+     */
+    void runBenchmarks();
+
+}
+
+#endif  // SHELL_BENCHMARKS_BENCHMARKS_H_
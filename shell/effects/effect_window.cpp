@@ -28,6 +28,7 @@
 
 #include "ukive/graphics/colors/ucmm.h"
 #include "ukive/graphics/colors/color_manager.h"
+#include "ukive/graphics/colors/icc/icc_profile_cache.h"
 
 #define BACKGROUND_SIZE 100
 
@@ -79,17 +80,17 @@ namespace shell {
             std::u16string icc_path;
             if (ukive::ColorManager::getDefaultProfile(&icc_path))
             {
-                ukive::icc::ICCProfile pf;
-                pf.load(icc_path);
-
-                ukive::Color tc;
-                ukive::UCMM cmm;
-                cmm.sRGBToTarget(
-                    ukive::UCMM::Intent::Perceptual,
-                    ukive::Color(0.25f, 0.89f, 0.47f),
-                    pf, &tc);
-
-                int sdg = 0;
+                auto pf = ukive::icc::ICCProfileCache::getInstance()->obtain(icc_path);
+                if (pf) {
+                    ukive::Color tc;
+                    ukive::UCMM cmm;
+                    cmm.sRGBToTarget(
+                        ukive::UCMM::Intent::Perceptual,
+                        ukive::Color(0.25f, 0.89f, 0.47f),
+                        *pf, &tc);
+
+                    int sdg = 0;
+                }
             }
 
             image_img_ = ukive::ImageFrame::decodeFile(
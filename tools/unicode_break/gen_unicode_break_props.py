@@ -0,0 +1,197 @@
+#!/usr/bin/env python3
+# Copyright (c) 2016 ucclkp <ucclkp@gmail.com>.
+# This file is part of ukive project.
+#
+# This program is licensed under GPLv3 license that can be
+# found in the LICENSE file.
+
+# 由 Unicode 字符数据库生成 ukive/text/unicode_break_props.cpp。
+#
+# 用法：
+#   python3 gen_unicode_break_props.py [--ucd-dir DIR] [-o OUTPUT]
+#
+# DIR 中需要有 UCD_VERSION 版本的 GraphemeBreakProperty.txt、
+# WordBreakProperty.txt 和 emoji-data.txt；不指定时从 unicode.org 下载。
+# 表的结构见 ukive/text/unicode_break_props.h。如果生成后的表长度或
+# kBreakPropShift 发生变化，需要同步修改头文件中的声明。
+
+import argparse
+import os
+import sys
+import urllib.request
+
+UCD_VERSION = "15.0.0"
+UCD_URL = "https://www.unicode.org/Public/%s/ucd/" % UCD_VERSION
+UCD_FILES = {
+    "GraphemeBreakProperty.txt": "auxiliary/GraphemeBreakProperty.txt",
+    "WordBreakProperty.txt": "auxiliary/WordBreakProperty.txt",
+    "emoji-data.txt": "emoji/emoji-data.txt",
+}
+
+# 与 unicode_break_props.h 中 GraphemeBreak 和 WordBreak 的顺序一致
+GRAPHEME_BREAK = [
+    "Other", "CR", "LF", "Control", "Extend", "ZWJ", "Regional_Indicator",
+    "Prepend", "SpacingMark", "L", "V", "T", "LV", "LVT",
+]
+WORD_BREAK = [
+    "Other", "CR", "LF", "Newline", "Extend", "ZWJ", "Regional_Indicator",
+    "Format", "Katakana", "Hebrew_Letter", "ALetter", "Single_Quote",
+    "Double_Quote", "MidNumLet", "MidLetter", "MidNum", "Numeric",
+    "ExtendNumLet", "WSegSpace",
+]
+
+# 表只覆盖 U+0000-U+1FFFF 和 U+E0000-U+E0FFF
+DOMAIN = 0x21000
+
+
+def domain_index(cp):
+    if cp < 0x20000:
+        return cp
+    if 0xE0000 <= cp < 0xE1000:
+        return cp - 0xE0000 + 0x20000
+    return None
+
+
+def read_ucd(ucd_dir, name):
+    if ucd_dir:
+        path = os.path.join(ucd_dir, name)
+        with open(path, encoding="utf-8") as f:
+            text = f.read()
+    else:
+        with urllib.request.urlopen(UCD_URL + UCD_FILES[name]) as f:
+            text = f.read().decode("utf-8")
+
+    # 文件头中带有版本号，例如 "# GraphemeBreakProperty-15.0.0.txt"
+    stem = os.path.splitext(name)[0]
+    if "%s-%s.txt" % (stem, UCD_VERSION) not in text.split("\n", 1)[0]:
+        sys.exit("%s is not from UCD %s" % (name, UCD_VERSION))
+
+    for line in text.splitlines():
+        line = line.split("#", 1)[0].strip()
+        if not line:
+            continue
+        cps, value = [s.strip() for s in line.split(";")[:2]]
+        if ".." in cps:
+            first, last = cps.split("..")
+        else:
+            first = last = cps
+        yield int(first, 16), int(last, 16), value
+
+
+def load_props(ucd_dir):
+    grapheme = [0] * DOMAIN
+    word = [0] * DOMAIN
+    pictographic = [0] * DOMAIN
+
+    def apply(name, table, mapping, other_props=False):
+        for first, last, value in read_ucd(ucd_dir, name):
+            if value not in mapping:
+                # emoji-data.txt 中还有其他属性
+                if other_props:
+                    continue
+                sys.exit("unknown value %s in %s" % (value, name))
+            for cp in range(first, last + 1):
+                i = domain_index(cp)
+                if i is None:
+                    sys.exit("U+%04X (%s) is outside the table" % (cp, value))
+                table[i] = mapping[value]
+
+    apply("GraphemeBreakProperty.txt", grapheme, {v: i for i, v in enumerate(GRAPHEME_BREAK)})
+    apply("WordBreakProperty.txt", word, {v: i for i, v in enumerate(WORD_BREAK)})
+    apply("emoji-data.txt", pictographic, {"Extended_Pictographic": 1}, True)
+
+    return [g | (p << 4) | (w << 5) for g, p, w in zip(grapheme, pictographic, word)]
+
+
+def build_tables(props):
+    # 属性组合按首次出现的顺序编号，0 为默认值
+    classes = [0]
+    class_index = {0: 0}
+    values = []
+    for p in props:
+        if p not in class_index:
+            class_index[p] = len(classes)
+            classes.append(p)
+        values.append(class_index[p])
+
+    # 选择总大小最小的块长度
+    best = None
+    for shift in range(4, 10):
+        size = 1 << shift
+        blocks = {}
+        for b in range(DOMAIN >> shift):
+            blocks.setdefault(tuple(values[b * size:(b + 1) * size]), len(blocks))
+        index_width = 2 if len(blocks) > 256 else 1
+        total = (DOMAIN >> shift) * index_width + len(blocks) * size
+        if best is None or total < best[0]:
+            best = (total, shift)
+
+    shift = best[1]
+    size = 1 << shift
+    blocks = {}
+    block_list = []
+    index = []
+    for b in range(DOMAIN >> shift):
+        block = tuple(values[b * size:(b + 1) * size])
+        if block not in blocks:
+            blocks[block] = len(block_list)
+            block_list.append(block)
+        index.append(blocks[block])
+    return classes, shift, index, [v for block in block_list for v in block]
+
+
+def format_array(decl, items, per_line, fmt):
+    out = ["    %s[%d] = {" % (decl, len(items))]
+    for i in range(0, len(items), per_line):
+        row = ", ".join(fmt % v for v in items[i:i + per_line])
+        out.append("        %s," % row)
+    out.append("    };")
+    return "\n".join(out)
+
+
+def generate(ucd_dir):
+    classes, shift, index, blocks = build_tables(load_props(ucd_dir))
+    index_type = "uint16_t" if max(index) > 255 else "uint8_t"
+    major_minor = ".".join(UCD_VERSION.split(".")[:2])
+
+    parts = [
+        "// Copyright (c) 2016 ucclkp <ucclkp@gmail.com>.\n"
+        "// This file is part of ukive project.\n"
+        "//\n"
+        "// This program is licensed under GPLv3 license that can be\n"
+        "// found in the LICENSE file.\n"
+        "\n"
+        "// 此文件由 Unicode %s 字符数据库中的 Grapheme_Cluster_Break、\n"
+        "// Word_Break 和 Extended_Pictographic 属性生成，请勿手动修改。\n"
+        "// 生成脚本为 tools/unicode_break/gen_unicode_break_props.py。\n"
+        "\n"
+        "#include \"ukive/text/unicode_break_props.h\"\n"
+        "\n"
+        "\n"
+        "namespace ukive {" % major_minor,
+        format_array("const uint16_t kBreakPropClasses", classes, 8, "0x%03X"),
+        format_array("const %s kBreakPropIndex" % index_type, index, 16, "%d"),
+        format_array("const uint8_t kBreakPropBlocks", blocks, 16, "%d"),
+        "}\n",
+    ]
+    summary = "kBreakPropClasses[%d], kBreakPropIndex[%d] (%s), kBreakPropBlocks[%d], kBreakPropShift = %d" % (
+        len(classes), len(index), index_type, len(blocks), shift)
+    return "\n\n".join(parts), summary
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Generate unicode_break_props.cpp from the UCD.")
+    parser.add_argument("--ucd-dir", help="directory containing the UCD %s files" % UCD_VERSION)
+    parser.add_argument(
+        "-o", "--output",
+        default=os.path.join(os.path.dirname(__file__), "..", "..", "ukive", "text", "unicode_break_props.cpp"))
+    args = parser.parse_args()
+
+    source, summary = generate(args.ucd_dir)
+    with open(args.output, "w", encoding="utf-8", newline="\n") as f:
+        f.write(source)
+    print(summary)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,296 @@
+// Copyright (c) 2016 ucclkp <ucclkp@gmail.com>.
+// This file is part of ukive project.
+//
+// This program is licensed under GPLv3 license that can be
+// found in the LICENSE file.
+
+// 检查 CharacterBreaker 和 WordBreaker 是否符合 UAX #29：
+// 1. 指定 UCD 中的 GraphemeBreakTest.txt 和 WordBreakTest.txt 时，逐条检查；
+// 2. 用随机字符串与 ICU 的 BreakIterator 比较；
+// 3. 检查 next()、prev() 和 findSafeBoundary() 与 fill() 一致。
+//
+// ICU 的版本需要与 unicode_break_props.cpp 使用的 Unicode 版本一致（ICU 72 为 Unicode 15.0）。
+// 在仓库根目录下编译：
+//   c++ -std=c++17 -O2 -I. -I<utils 所在的目录> tools/unicode_break/icu_break_compare.cpp
+//       ukive/text/text_breaker.cpp ukive/text/unicode_break_props.cpp -licuuc -o icu_break_compare
+// 运行：
+//   icu_break_compare [GraphemeBreakTest.txt WordBreakTest.txt]
+//
+// 与 ICU 比较时有意避开了以下差异：
+// - ICU 的字素簇规则带有婆罗米系文字的 aksara 裁剪（Unicode 15.1 的 GB9c），这里没有实现；
+// - ICU 的单词边界对泰文、片假名和汉字等使用词典，这里没有词典；
+// - ICU 的单词规则不再把 ':' 视为 MidLetter；
+// 所以随机字符串的字母表中不含这些字符。另外 ICU 的单词规则把韩文音节单独作为一类，
+// 不与其他字母相连，含有韩文音节的字符串只比较字素簇。
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <unicode/brkiter.h>
+#include <unicode/uchar.h>
+#include <unicode/unistr.h>
+
+#include "ukive/text/text_breaker.h"
+
+
+namespace {
+
+    using ukive::BoundaryBitmap;
+    using ukive::CharacterBreaker;
+    using ukive::WordBreaker;
+
+    const int kRandomStrings = 500000;
+    const int kLongStrings = 2000;
+    const int kMaxReports = 5;
+
+    enum Kind {
+        GRAPHEME,
+        WORD,
+    };
+
+    const char* kKindNames[] = { "grapheme", "word" };
+
+    const char32_t kAlphabet[] = {
+        'a', 'b', 'Z', '1', '9', '.', ',', '\'', '"', ' ', '_', '-', '\r', '\n',
+        0x0007, 0x0085, 0x00A0, 0x00AD, 0x0301, 0x0308, 0x0600, 0x0660, 0x0903,
+        0x05D0, 0x1100, 0x1161, 0x11A8, 0xAC00, 0xAC01, 0x200C, 0x200D, 0x202F,
+        0x2028, 0x2060, 0x2764, 0x3000, 0xFE0F, 0xFF0E, 0xFFFD,
+        0x1F1EF, 0x1F1F8, 0x1F1FA, 0x1F3FB, 0x1F3FF, 0x1F44D, 0x1F466, 0x1F600,
+        0xE0061,
+    };
+
+    // 长字符串中重复出现的片段，用来检查向前查找安全边界
+    const char32_t kRuns[] = { 0x1F1FA, 0x0301, 'a', '1', 0x200D, ' ' };
+
+    std::u16string encode(const std::vector<char32_t>& cps) {
+        std::u16string s;
+        for (auto cp : cps) {
+            if (cp >= 0x10000) {
+                cp -= 0x10000;
+                s.push_back(char16_t(0xD800 + (cp >> 10)));
+                s.push_back(char16_t(0xDC00 + (cp & 0x3FF)));
+            } else {
+                s.push_back(char16_t(cp));
+            }
+        }
+        return s;
+    }
+
+    bool hasHangulSyllable(const std::vector<char32_t>& cps) {
+        return std::any_of(cps.begin(), cps.end(), [](char32_t cp) {
+            return cp >= 0xAC00 && cp <= 0xD7A3;
+        });
+    }
+
+    std::vector<size_t> fillBoundaries(Kind kind, const std::u16string& s) {
+        BoundaryBitmap bitmap;
+        if (kind == GRAPHEME) {
+            CharacterBreaker::fill(s, &bitmap);
+        } else {
+            WordBreaker::fill(s, &bitmap);
+        }
+
+        std::vector<size_t> out;
+        for (size_t i = 0; i <= s.length(); ++i) {
+            if (bitmap.test(i)) {
+                out.push_back(i);
+            }
+        }
+        return out;
+    }
+
+    std::vector<size_t> icuBoundaries(icu::BreakIterator* it, const std::u16string& s) {
+        icu::UnicodeString us(
+            reinterpret_cast<const UChar*>(s.data()), int32_t(s.length()));
+        it->setText(us);
+
+        std::vector<size_t> out;
+        for (int32_t pos = it->first(); pos != icu::BreakIterator::DONE; pos = it->next()) {
+            out.push_back(size_t(pos));
+        }
+        return out;
+    }
+
+    /**
+     * 用 next() 和 prev() 分别走一遍，并检查每个安全边界都是边界。
+     */
+    bool checkWalkers(Kind kind, const std::u16string& s, const std::vector<size_t>& expected) {
+        if (s.empty()) {
+            return true;
+        }
+
+        std::unique_ptr<ukive::TextBreaker> breaker;
+        if (kind == GRAPHEME) {
+            breaker = std::make_unique<CharacterBreaker>(&s);
+        } else {
+            breaker = std::make_unique<WordBreaker>(&s);
+        }
+
+        std::vector<size_t> forward{ 0 };
+        breaker->setCur(0);
+        while (breaker->next()) {
+            forward.push_back(breaker->getCur());
+        }
+        if (forward != expected) {
+            return false;
+        }
+
+        std::vector<size_t> backward{ s.length() };
+        breaker->setCur(s.length());
+        while (breaker->prev()) {
+            backward.insert(backward.begin(), breaker->getCur());
+        }
+        if (backward != expected) {
+            return false;
+        }
+
+        size_t pos = s.length();
+        for (;;) {
+            pos = kind == GRAPHEME ?
+                CharacterBreaker::findSafeBoundary(s, pos) : WordBreaker::findSafeBoundary(s, pos);
+            if (pos == BoundaryBitmap::npos) {
+                return true;
+            }
+            if (!std::binary_search(expected.begin(), expected.end(), pos)) {
+                return false;
+            }
+        }
+    }
+
+    void report(Kind kind, const char* what, const std::vector<char32_t>& cps, int* count) {
+        if (++*count > kMaxReports) {
+            return;
+        }
+        std::printf("%s %s mismatch:", kKindNames[kind], what);
+        for (auto cp : cps) {
+            std::printf(" %04X", unsigned(cp));
+        }
+        std::printf("\n");
+    }
+
+    /**
+     * 逐行读取 UCD 的测试文件，每行形如 "÷ 0020 × 0308 ÷ # ..."。
+     * @return 不一致的行数，无法打开文件时返回 -1。
+     */
+    int runConformance(Kind kind, const char* path, int* total) {
+        std::ifstream file(path);
+        if (!file) {
+            std::printf("cannot open %s\n", path);
+            return -1;
+        }
+
+        int failed = 0;
+        std::string line;
+        while (std::getline(file, line)) {
+            line = line.substr(0, line.find('#'));
+            std::istringstream tokens(line);
+
+            std::vector<char32_t> cps;
+            std::vector<size_t> expected;
+            size_t length = 0;
+            std::string token;
+            while (tokens >> token) {
+                if (token == "\xC3\xB7") {
+                    expected.push_back(length);
+                } else if (token != "\xC3\x97") {
+                    char32_t cp = char32_t(std::stoul(token, nullptr, 16));
+                    cps.push_back(cp);
+                    length += cp >= 0x10000 ? 2 : 1;
+                }
+            }
+            if (cps.empty()) {
+                continue;
+            }
+
+            ++*total;
+            auto s = encode(cps);
+            // fill() 总把开头和结尾视为边界，与测试文件一致
+            if (fillBoundaries(kind, s) != expected || !checkWalkers(kind, s, expected)) {
+                report(kind, "conformance", cps, &failed);
+            }
+        }
+        return failed;
+    }
+
+}
+
+int main(int argc, char* argv[]) {
+    int result = 0;
+    std::printf("Unicode %s, ICU %s\n", U_UNICODE_VERSION, U_ICU_VERSION);
+
+    if (argc >= 3) {
+        for (int kind = GRAPHEME; kind <= WORD; ++kind) {
+            int total = 0;
+            int failed = runConformance(Kind(kind), argv[1 + kind], &total);
+            std::printf("%s conformance: %d of %d cases failed\n", kKindNames[kind], failed, total);
+            if (failed != 0) {
+                result = 1;
+            }
+        }
+    }
+
+    UErrorCode status = U_ZERO_ERROR;
+    std::unique_ptr<icu::BreakIterator> icu_breakers[] = {
+        std::unique_ptr<icu::BreakIterator>(
+            icu::BreakIterator::createCharacterInstance(icu::Locale::getRoot(), status)),
+        std::unique_ptr<icu::BreakIterator>(
+            icu::BreakIterator::createWordInstance(icu::Locale::getRoot(), status)),
+    };
+    if (U_FAILURE(status)) {
+        std::printf("cannot create ICU break iterators: %s\n", u_errorName(status));
+        return 1;
+    }
+
+    std::mt19937 rng(20240530);
+    int icu_compared[2] = { 0, 0 };
+    int icu_failed[2] = { 0, 0 };
+    int walk_failed[2] = { 0, 0 };
+    for (int i = 0; i < kRandomStrings + kLongStrings; ++i) {
+        std::vector<char32_t> cps;
+        if (i < kRandomStrings) {
+            int count = 1 + int(rng() % 12);
+            for (int j = 0; j < count; ++j) {
+                cps.push_back(kAlphabet[rng() % std::size(kAlphabet)]);
+            }
+        } else {
+            // 较长的重复片段之间夹杂随机字符
+            int pieces = 1 + int(rng() % 8);
+            for (int j = 0; j < pieces; ++j) {
+                char32_t run = kRuns[rng() % std::size(kRuns)];
+                cps.insert(cps.end(), rng() % 300, run);
+                cps.push_back(kAlphabet[rng() % std::size(kAlphabet)]);
+            }
+        }
+
+        auto s = encode(cps);
+        for (int kind = GRAPHEME; kind <= WORD; ++kind) {
+            auto actual = fillBoundaries(Kind(kind), s);
+            if (kind == GRAPHEME || !hasHangulSyllable(cps)) {
+                ++icu_compared[kind];
+                if (actual != icuBoundaries(icu_breakers[kind].get(), s)) {
+                    report(Kind(kind), "ICU", cps, &icu_failed[kind]);
+                }
+            }
+            if (!checkWalkers(Kind(kind), s, actual)) {
+                report(Kind(kind), "walker", cps, &walk_failed[kind]);
+            }
+        }
+    }
+
+    for (int kind = GRAPHEME; kind <= WORD; ++kind) {
+        std::printf(
+            "%s: %d of %d random strings differ from ICU, %d walker mismatches\n",
+            kKindNames[kind], icu_failed[kind], icu_compared[kind], walk_failed[kind]);
+        if (icu_failed[kind] != 0 || walk_failed[kind] != 0) {
+            result = 1;
+        }
+    }
+    return result;
+}
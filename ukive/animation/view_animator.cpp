@@ -169,7 +169,7 @@ namespace ukive {
         if (!director_.update(start_time, display_freq)) {
             stopVSync();
         }
-        owner_view_->requestDraw();
+        owner_view_->requestDrawProperties();
     }
 
     void ViewAnimator::onDirectorStarted(AnimationDirector* director) {
@@ -0,0 +1,372 @@
+// Copyright (c) 2016 ucclkp <ucclkp@gmail.com>.
+// This file is part of ukive project.
+//
+// This program is licensed under GPLv3 license that can be
+// found in the LICENSE file.
+
+#include "ukive/diagnostic/frame_profiler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <unordered_map>
+
+#include "utils/log.h"
+#include "utils/time_utils.h"
+
+
+namespace {
+
+    // 当前线程中最内层的区间
+    thread_local ukive::FrameProfiler::Scope* current_scope = nullptr;
+
+    uint64_t percentile(const std::vector<uint64_t>& sorted, double p) {
+        if (sorted.empty()) {
+            return 0;
+        }
+        auto rank = size_t(std::ceil(p * sorted.size()));
+        return sorted[rank > 0 ? rank - 1 : 0];
+    }
+
+    ukive::FrameProfiler::Stats makeStats(std::vector<uint64_t>* vals) {
+        ukive::FrameProfiler::Stats stats;
+        std::sort(vals->begin(), vals->end());
+        stats.p50 = percentile(*vals, 0.5);
+        stats.p95 = percentile(*vals, 0.95);
+        stats.p99 = percentile(*vals, 0.99);
+        stats.samples = vals->size();
+        return stats;
+    }
+
+    void writeJSONString(std::ostream& out, const char* str) {
+        out << '"';
+        for (auto p = str; *p; ++p) {
+            char ch = *p;
+            switch (ch) {
+            case '"':  out << "\\\""; break;
+            case '\\': out << "\\\\"; break;
+            case '\n': out << "\\n"; break;
+            case '\r': out << "\\r"; break;
+            case '\t': out << "\\t"; break;
+            default:
+                if (uint8_t(ch) < 0x20) {
+                    out << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+                        << int(ch) << std::dec << std::setfill(' ');
+                } else {
+                    out << ch;
+                }
+                break;
+            }
+        }
+        out << '"';
+    }
+
+}
+
+namespace ukive {
+
+    // FrameProfiler::Scope
+    FrameProfiler::Scope::Scope(Phase phase, const char* name, bool is_view)
+        : phase_(phase),
+          name_(name),
+          is_view_(is_view),
+          enabled_(FrameProfiler::getInstance()->isEnabled())
+    {
+        if (!enabled_) {
+            return;
+        }
+
+        parent_ = current_scope;
+        current_scope = this;
+        start_ = utl::TimeUtils::upTimeNanos();
+    }
+
+    FrameProfiler::Scope::~Scope() {
+        if (!enabled_) {
+            return;
+        }
+
+        uint64_t dur = utl::TimeUtils::upTimeNanos() - start_;
+        uint64_t self = dur > child_ns_ ? dur - child_ns_ : 0;
+        if (parent_) {
+            parent_->child_ns_ += dur;
+        }
+        current_scope = parent_;
+
+        FrameProfiler::getInstance()->record(
+            phase_, name_, is_view_, start_, dur, self);
+    }
+
+
+    // FrameProfiler
+    std::unique_ptr<FrameProfiler> FrameProfiler::instance_;
+
+    FrameProfiler::FrameProfiler() {}
+
+    // static
+    FrameProfiler* FrameProfiler::getInstance() {
+        // 记录点可能位于任意线程
+        static std::once_flag flag;
+        std::call_once(flag, []() { instance_.reset(new FrameProfiler()); });
+        return instance_.get();
+    }
+
+    void FrameProfiler::setEnabled(bool enabled) {
+        enabled_.store(enabled, std::memory_order_relaxed);
+    }
+
+    bool FrameProfiler::isEnabled() const {
+        return enabled_.load(std::memory_order_relaxed);
+    }
+
+    void FrameProfiler::endFrame() {
+        uint64_t frame = frame_index_.fetch_add(1, std::memory_order_relaxed);
+        if (!cur_has_phase_.exchange(false, std::memory_order_relaxed)) {
+            return;
+        }
+
+        FrameTotals totals;
+        totals.frame = frame;
+        for (int p = 0; p < PHASE_COUNT; ++p) {
+            totals.phase_ns[p] = cur_phase_ns_[p].exchange(0, std::memory_order_relaxed);
+        }
+
+        std::lock_guard<std::mutex> lg(history_mutex_);
+        history_[history_count_ % kHistorySize] = totals;
+        ++history_count_;
+    }
+
+    uint64_t FrameProfiler::getFrameIndex() const {
+        return frame_index_.load(std::memory_order_relaxed);
+    }
+
+    void FrameProfiler::record(
+        Phase phase, const char* name, bool is_view,
+        uint64_t start_ns, uint64_t dur_ns, uint64_t self_ns)
+    {
+        if (!is_view) {
+            cur_phase_ns_[phase].fetch_add(dur_ns, std::memory_order_relaxed);
+            cur_has_phase_.store(true, std::memory_order_relaxed);
+        }
+
+        auto buffer = getThreadBuffer();
+        uint64_t index = buffer->write_index.load(std::memory_order_relaxed);
+
+        auto& e = buffer->events[index & (kBufferSize - 1)];
+        e.name = name;
+        e.start_ns = start_ns;
+        e.dur_ns = dur_ns;
+        e.self_ns = self_ns;
+        e.frame = getFrameIndex();
+        e.tid = buffer->tid;
+        e.phase = uint8_t(phase);
+        e.is_view = is_view;
+
+        // 写完事件后才发布新的下标
+        buffer->write_index.store(index + 1, std::memory_order_release);
+    }
+
+    FrameProfiler::ThreadBuffer* FrameProfiler::getThreadBuffer() {
+        thread_local ThreadBuffer* buffer = nullptr;
+        if (!buffer) {
+            auto new_buffer = std::make_shared<ThreadBuffer>();
+
+            std::lock_guard<std::mutex> lg(buffers_mutex_);
+            new_buffer->tid = next_tid_++;
+            buffers_.push_back(new_buffer);
+            buffer = new_buffer.get();
+        }
+        return buffer;
+    }
+
+    void FrameProfiler::snapshot(std::vector<Event>* events) const {
+        std::lock_guard<std::mutex> lg(buffers_mutex_);
+        for (const auto& buffer : buffers_) {
+            uint64_t end = buffer->write_index.load(std::memory_order_acquire);
+            uint64_t start = end > kBufferSize ? end - kBufferSize : 0;
+            start = (std::max)(start, buffer->clear_index.load(std::memory_order_relaxed));
+
+            size_t prev_size = events->size();
+            for (uint64_t i = start; i < end; ++i) {
+                events->push_back(buffer->events[i & (kBufferSize - 1)]);
+            }
+
+            // 复制期间被写线程覆盖的事件不可信，丢弃。
+            // 写线程可能正在填写尚未发布的 new_end，它会覆盖 new_end - kBufferSize，
+            // 因此该下标也要丢弃。
+            uint64_t new_end = buffer->write_index.load(std::memory_order_acquire);
+            if (new_end >= kBufferSize && new_end - kBufferSize >= start) {
+                auto overwritten = size_t((std::min)(new_end - kBufferSize + 1, end) - start);
+                events->erase(
+                    events->begin() + prev_size,
+                    events->begin() + prev_size + overwritten);
+            }
+        }
+    }
+
+    void FrameProfiler::getPhaseStats(size_t frame_count, Stats stats[PHASE_COUNT]) const {
+        for (int i = 0; i < PHASE_COUNT; ++i) {
+            stats[i] = {};
+        }
+
+        uint64_t end_frame = getFrameIndex();
+        uint64_t start_frame = end_frame > frame_count ? end_frame - frame_count : 0;
+        if (end_frame == start_frame) {
+            return;
+        }
+
+        std::vector<FrameTotals> frames;
+        {
+            std::lock_guard<std::mutex> lg(history_mutex_);
+            uint64_t first = history_count_ > kHistorySize ? history_count_ - kHistorySize : 0;
+            for (uint64_t i = first; i < history_count_; ++i) {
+                const auto& totals = history_[i % kHistorySize];
+                if (totals.frame >= start_frame && totals.frame < end_frame) {
+                    frames.push_back(totals);
+                }
+            }
+        }
+
+        std::vector<uint64_t> vals;
+        for (int p = 0; p < PHASE_COUNT; ++p) {
+            vals.clear();
+            for (const auto& totals : frames) {
+                vals.push_back(totals.phase_ns[p]);
+            }
+            stats[p] = makeStats(&vals);
+        }
+    }
+
+    void FrameProfiler::getViewStats(
+        size_t frame_count, size_t max_count, std::vector<ViewStats>* stats) const
+    {
+        stats->clear();
+
+        uint64_t end_frame = getFrameIndex();
+        uint64_t start_frame = end_frame > frame_count ? end_frame - frame_count : 0;
+        if (end_frame == start_frame) {
+            return;
+        }
+
+        std::vector<Event> events;
+        snapshot(&events);
+
+        // typeid 的名称在进程内地址固定，直接用作键
+        size_t count = size_t(end_frame - start_frame);
+        std::unordered_map<const char*, std::vector<uint64_t>> totals;
+        for (const auto& e : events) {
+            if (!e.is_view || e.frame < start_frame || e.frame >= end_frame) {
+                continue;
+            }
+
+            auto& frames = totals[e.name];
+            if (frames.empty()) {
+                frames.resize(count, 0);
+            }
+            frames[size_t(e.frame - start_frame)] += e.self_ns;
+        }
+
+        std::vector<uint64_t> vals;
+        for (auto& pair : totals) {
+            vals.clear();
+            for (auto t : pair.second) {
+                if (t > 0) {
+                    vals.push_back(t);
+                }
+            }
+
+            ViewStats vs;
+            vs.name = pair.first;
+            vs.stats = makeStats(&vals);
+            stats->push_back(std::move(vs));
+        }
+
+        std::sort(stats->begin(), stats->end(),
+            [](const ViewStats& l, const ViewStats& r)
+        {
+            return l.stats.p95 > r.stats.p95;
+        });
+        if (stats->size() > max_count) {
+            stats->resize(max_count);
+        }
+    }
+
+    void FrameProfiler::exportChromeTrace(std::ostream& out) const {
+        std::vector<Event> events;
+        snapshot(&events);
+
+        std::sort(events.begin(), events.end(),
+            [](const Event& l, const Event& r)
+        {
+            return l.start_ns < r.start_ns;
+        });
+
+        // 时间戳和时长的单位为微秒
+        out << "{\"traceEvents\":[";
+        out << std::fixed << std::setprecision(3);
+
+        bool first = true;
+        for (const auto& e : events) {
+            if (!first) {
+                out << ",";
+            }
+            first = false;
+
+            out << "\n{\"name\":";
+            writeJSONString(out, e.name);
+            out << ",\"cat\":\"" << (e.is_view ? "view" : getPhaseName(Phase(e.phase))) << "\""
+                << ",\"ph\":\"X\""
+                << ",\"ts\":" << e.start_ns / 1000.0
+                << ",\"dur\":" << e.dur_ns / 1000.0
+                << ",\"pid\":1"
+                << ",\"tid\":" << e.tid
+                << ",\"args\":{\"frame\":" << e.frame;
+            if (e.is_view) {
+                out << ",\"self_us\":" << e.self_ns / 1000.0;
+            }
+            out << "}}";
+        }
+
+        out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    }
+
+    bool FrameProfiler::exportChromeTrace(const std::filesystem::path& file_name) const {
+        std::ofstream writer(file_name, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!writer) {
+            DLOG(Log::ERR) << "Failed to open trace file: " << file_name.u8string();
+            return false;
+        }
+
+        exportChromeTrace(writer);
+        return bool(writer);
+    }
+
+    void FrameProfiler::clear() {
+        {
+            std::lock_guard<std::mutex> lg(history_mutex_);
+            history_count_ = 0;
+        }
+
+        std::lock_guard<std::mutex> lg(buffers_mutex_);
+        for (auto& buffer : buffers_) {
+            buffer->clear_index.store(
+                buffer->write_index.load(std::memory_order_acquire),
+                std::memory_order_relaxed);
+        }
+    }
+
+    // static
+    const char* FrameProfiler::getPhaseName(Phase phase) {
+        switch (phase) {
+        case INPUT:          return "input";
+        case ANIMATION:      return "animation";
+        case DETERMINE_SIZE: return "determine_size";
+        case LAYOUT:         return "layout";
+        case DRAW:           return "draw";
+        case PRESENT:        return "present";
+        default:             return "unknown";
+        }
+    }
+
+}
@@ -0,0 +1,189 @@
+// Copyright (c) 2016 ucclkp <ucclkp@gmail.com>.
+// This file is part of ukive project.
+//
+// This program is licensed under GPLv3 license that can be
+// found in the LICENSE file.
+
+#ifndef UKIVE_DIAGNOSTIC_FRAME_PROFILER_H_
+#define UKIVE_DIAGNOSTIC_FRAME_PROFILER_H_
+
+#include <atomic>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+#define FRAME_PROFILE_PHASE(phase, name)  \
+    ukive::FrameProfiler::Scope frame_profile_scope_(  \
+        ukive::FrameProfiler::phase, name, false);
+
+#define FRAME_PROFILE_VIEW_DRAW  \
+    ukive::FrameProfiler::Scope frame_profile_scope_(  \
+        ukive::FrameProfiler::DRAW, typeid(*this).name(), true);
+
+
+namespace ukive {
+
+    /**
+     * 按帧记录 UI 各阶段耗时的分析器。
+     * 每个线程将事件写入各自的环形缓冲区，写入时不加锁；缓冲区写满后覆盖最早的事件。
+     * 记录的事件可导出为 Chrome trace-event JSON，在 chrome://tracing 或 Perfetto 中查看，
+     * 也可按阶段统计最近若干帧耗时的分位数，供 StatisticDrawer 显示。
+     * 未启用时各记录点只读取一个原子变量。
+     */
+    class FrameProfiler {
+    public:
+        enum Phase {
+            INPUT,
+            ANIMATION,
+            DETERMINE_SIZE,
+            LAYOUT,
+            DRAW,
+            PRESENT,
+            PHASE_COUNT,
+        };
+
+        /**
+         * 记录一个区间的 RAII 辅助类。
+         * 同一线程中嵌套的 View 绘制区间会从外层区间的自身耗时中扣除。
+         */
+        class Scope {
+        public:
+            Scope(Phase phase, const char* name, bool is_view);
+            ~Scope();
+
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+
+        private:
+            Phase phase_;
+            const char* name_;
+            bool is_view_;
+            bool enabled_;
+            uint64_t start_ = 0;
+            uint64_t child_ns_ = 0;
+            Scope* parent_ = nullptr;
+        };
+
+        /**
+         * 分位数统计结果，单位为纳秒。
+         */
+        struct Stats {
+            uint64_t p50 = 0;
+            uint64_t p95 = 0;
+            uint64_t p99 = 0;
+            size_t samples = 0;
+        };
+
+        struct ViewStats {
+            std::string name;
+            Stats stats;
+        };
+
+        static FrameProfiler* getInstance();
+
+        void setEnabled(bool enabled);
+        bool isEnabled() const;
+
+        /**
+         * 结束当前帧。应在画面提交之后调用。
+         */
+        void endFrame();
+        uint64_t getFrameIndex() const;
+
+        /**
+         * 记录一个事件。name 须指向静态存储期的字符串。
+         * @param self_ns 除去嵌套子区间后的自身耗时。
+         */
+        void record(
+            Phase phase, const char* name, bool is_view,
+            uint64_t start_ns, uint64_t dur_ns, uint64_t self_ns);
+
+        /**
+         * 统计最近 frame_count 个已结束的帧中每个阶段耗时的分位数。
+         * 一帧中同一阶段的多个事件耗时相加。
+         * 各阶段的每帧耗时单独保存，不受事件缓冲区覆盖的影响，但最多只保存 kHistorySize 帧；
+         * 没有阶段事件的帧不参与统计。Stats::samples 为实际参与统计的帧数。
+         */
+        void getPhaseStats(size_t frame_count, Stats stats[PHASE_COUNT]) const;
+
+        /**
+         * 统计最近 frame_count 个已结束的帧中各 View 类型每帧绘制自身耗时的分位数，
+         * 按 p95 从大到小排序，最多返回 max_count 项。
+         */
+        void getViewStats(
+            size_t frame_count, size_t max_count, std::vector<ViewStats>* stats) const;
+
+        /**
+         * 以 Chrome trace-event JSON 格式导出缓冲区中的所有事件。
+         */
+        void exportChromeTrace(std::ostream& out) const;
+        bool exportChromeTrace(const std::filesystem::path& file_name) const;
+
+        /**
+         * 丢弃所有已记录的事件。
+         */
+        void clear();
+
+        static const char* getPhaseName(Phase phase);
+
+    private:
+        // 每个线程的缓冲区可容纳的事件数，须为 2 的幂
+        static constexpr size_t kBufferSize = 1u << 14;
+        // 保存各阶段每帧耗时的帧数
+        static constexpr size_t kHistorySize = 256;
+
+        struct Event {
+            const char* name;
+            uint64_t start_ns;
+            uint64_t dur_ns;
+            uint64_t self_ns;
+            uint64_t frame;
+            uint32_t tid;
+            uint8_t phase;
+            bool is_view;
+        };
+
+        struct FrameTotals {
+            uint64_t frame;
+            uint64_t phase_ns[PHASE_COUNT];
+        };
+
+        struct ThreadBuffer {
+            uint32_t tid;
+            // 只由所属线程写入
+            std::atomic<uint64_t> write_index{ 0 };
+            // clear() 之后从该下标开始读取
+            std::atomic<uint64_t> clear_index{ 0 };
+            Event events[kBufferSize];
+        };
+
+        FrameProfiler();
+
+        ThreadBuffer* getThreadBuffer();
+        void snapshot(std::vector<Event>* events) const;
+
+        std::atomic_bool enabled_{ false };
+        std::atomic<uint64_t> frame_index_{ 0 };
+
+        // 当前帧中各阶段的耗时之和，在 endFrame() 中移入 history_
+        std::atomic<uint64_t> cur_phase_ns_[PHASE_COUNT] = {};
+        std::atomic_bool cur_has_phase_{ false };
+
+        mutable std::mutex history_mutex_;
+        FrameTotals history_[kHistorySize];
+        uint64_t history_count_ = 0;
+
+        mutable std::mutex buffers_mutex_;
+        std::vector<std::shared_ptr<ThreadBuffer>> buffers_;
+        uint32_t next_tid_ = 1;
+
+        static std::unique_ptr<FrameProfiler> instance_;
+    };
+
+}
+
+#endif  // UKIVE_DIAGNOSTIC_FRAME_PROFILER_H_
@@ -6,6 +6,7 @@
 
 #include "grid_view.h"
 
+#include <algorithm>
 #include <cmath>
 
 #include "utils/strings/int_conv.hpp"
@@ -23,6 +24,21 @@ namespace {
     const int kLineWidth = 1;
     const int kInitSqLength = 16;
     const int kMaxScaleLevel = 11;
+
+    // 像素块缓存图片的最大边长，超过时直接绘制各个像素
+    const int kMaxTileImageLength = 1024;
+
+    int floorDiv(int a, int b) {
+        int q = a / b;
+        if ((a % b != 0) && ((a < 0) != (b < 0))) {
+            --q;
+        }
+        return q;
+    }
+
+    uint64_t getTileKey(int tile_col, int tile_row) {
+        return (uint64_t(uint32_t(tile_col)) << 32) | uint32_t(tile_row);
+    }
 }
 
 namespace ukive {
@@ -69,20 +85,22 @@ namespace ukive {
     }
 
     void GridView::addPixel(int col, int row, const Color& color) {
-        PixelInfo info{ col, row, color };
+        int tile_col = floorDiv(col, kTileSize);
+        int tile_row = floorDiv(row, kTileSize);
 
-        bool hit = false;
-        for (auto& p : pixels_) {
-            if (p.col == col && p.row == row) {
-                p = info;
-                hit = true;
-                break;
-            }
+        auto& tile = tiles_[getTileKey(tile_col, tile_row)];
+        if (!tile) {
+            tile = std::make_unique<PixelTile>();
         }
 
-        if (!hit) {
-            pixels_.push_back(info);
-        }
+        size_t index = size_t(row - tile_row * kTileSize) * kTileSize + (col - tile_col * kTileSize);
+        tile->colors[index] = color;
+        tile->present.set(index);
+        tile->is_dirty = true;
+
+        has_last_pixel_ = true;
+        last_pixel_col_ = col;
+        last_pixel_row_ = row;
 
         startVSync();
         animator_.start();
@@ -91,17 +109,12 @@ namespace ukive {
     }
 
     bool GridView::getPixel(int col, int row, Color* color) const {
-        for (auto& p : pixels_) {
-            if (p.col == col && p.row == row) {
-                *color = p.color;
-                return true;
-            }
-        }
-        return false;
+        return getGridColor(col, row, color);
     }
 
     void GridView::clearPixels() {
-        pixels_.clear();
+        tiles_.clear();
+        has_last_pixel_ = false;
         animator_.finish();
         requestDraw();
     }
@@ -212,13 +225,14 @@ namespace ukive {
         canvas->fillCircle(
             pf, float(getContext().dp2pxi(4)), Color(0, 0, 0, 1));
 
-        size_t index = 0;
-        for (const auto& info : pixels_) {
+        drawGridPixels(canvas);
+
+        Color last_color;
+        if (has_last_pixel_ &&
+            getGridColor(last_pixel_col_, last_pixel_row_, &last_color))
+        {
             drawGridPixel(
-                canvas,
-                info.col, info.row, info.color,
-                index + 1 == pixels_.size());
-            ++index;
+                canvas, last_pixel_col_, last_pixel_row_, last_color, true);
         }
 
         for (auto& info : lines_) {
@@ -349,6 +363,16 @@ namespace ukive {
         showOverlay(visibility == SHOW);
     }
 
+    void GridView::onContextChanged(Context::Type type, const Context& context) {
+        super::onContextChanged(type, context);
+
+        if (type == Context::DPI_CHANGED) {
+            // 块缓存会因线宽不同而失效，见 makeTileImage()
+            line_width_ = getAdjustedLineWidth(kLineWidth);
+            requestDraw();
+        }
+    }
+
     void GridView::onVSync(
         uint64_t start_time, uint32_t display_freq, uint32_t real_interval)
     {
@@ -408,6 +432,94 @@ namespace ukive {
         }
     }
 
+    void GridView::drawGridPixels(Canvas* canvas) {
+        if (tiles_.empty()) {
+            return;
+        }
+
+        int col_start, row_start, col_end, row_end;
+        getVisibleCells(&col_start, &row_start, &col_end, &row_end);
+
+        bool use_cache = length_ * kTileSize <= kMaxTileImageLength;
+        int tile_col_end = floorDiv(col_end, kTileSize);
+        int tile_row_end = floorDiv(row_end, kTileSize);
+        for (int tr = floorDiv(row_start, kTileSize); tr <= tile_row_end; ++tr) {
+            for (int tc = floorDiv(col_start, kTileSize); tc <= tile_col_end; ++tc) {
+                auto it = tiles_.find(getTileKey(tc, tr));
+                if (it == tiles_.end()) {
+                    continue;
+                }
+
+                auto tile = it->second.get();
+                int base_col = tc * kTileSize;
+                int base_row = tr * kTileSize;
+
+                if (use_cache && makeTileImage(canvas, tile)) {
+                    // 翻转时块的上边缘是最后一行的上边缘
+                    Point p;
+                    getGridPoint(base_col, flipped_y_ ? base_row + kTileSize : base_row, &p);
+                    canvas->drawImage(float(p.x()), float(p.y()), tile->cache.get());
+                    continue;
+                }
+
+                int cs = (std::max)(col_start, base_col);
+                int ce = (std::min)(col_end, base_col + kTileSize - 1);
+                int rs = (std::max)(row_start, base_row);
+                int re = (std::min)(row_end, base_row + kTileSize - 1);
+                for (int row = rs; row <= re; ++row) {
+                    for (int col = cs; col <= ce; ++col) {
+                        size_t index = size_t(row - base_row) * kTileSize + (col - base_col);
+                        if (tile->present[index]) {
+                            drawGridPixel(canvas, col, row, tile->colors[index], false);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    bool GridView::makeTileImage(Canvas* canvas, PixelTile* tile) {
+        if (!tile->is_dirty && tile->cache &&
+            tile->cache_length == length_ &&
+            tile->cache_line_width == line_width_ &&
+            tile->cache_flipped == flipped_y_)
+        {
+            return true;
+        }
+
+        int size = length_ * kTileSize;
+        int inset = int(line_width_ / 2);
+
+        Canvas offscreen(size, size, canvas->getImageOptions());
+        offscreen.beginDraw();
+        offscreen.clear();
+        for (int r = 0; r < kTileSize; ++r) {
+            for (int c = 0; c < kTileSize; ++c) {
+                size_t index = size_t(r) * kTileSize + c;
+                if (!tile->present[index]) {
+                    continue;
+                }
+
+                int y = flipped_y_ ? (kTileSize - 1 - r) * length_ : r * length_;
+                Rect rect(c * length_, y, length_, length_);
+                rect.insets(inset, inset, inset, inset);
+                offscreen.fillRect(RectF(rect), tile->colors[index]);
+            }
+        }
+        offscreen.endDraw();
+
+        tile->cache = offscreen.extractImage();
+        if (!tile->cache) {
+            return false;
+        }
+
+        tile->is_dirty = false;
+        tile->cache_length = length_;
+        tile->cache_line_width = line_width_;
+        tile->cache_flipped = flipped_y_;
+        return true;
+    }
+
     void GridView::drawGridPixel(
         Canvas* canvas, int col, int row, const Color& color, bool highlight)
     {
@@ -646,14 +758,41 @@ namespace ukive {
         pos->y((y - start_row_offset_) / length_ - start_row_);
     }
 
-    bool GridView::getGridColor(int col, int row, Color* color) {
-        for (const auto& info : pixels_) {
-            if (info.col == col && info.row == row) {
-                *color = info.color;
-                return true;
-            }
+    bool GridView::getGridColor(int col, int row, Color* color) const {
+        auto tile = findTile(col, row);
+        if (!tile) {
+            return false;
+        }
+
+        size_t index = size_t(row - floorDiv(row, kTileSize) * kTileSize) * kTileSize +
+            (col - floorDiv(col, kTileSize) * kTileSize);
+        if (!tile->present[index]) {
+            return false;
+        }
+
+        *color = tile->colors[index];
+        return true;
+    }
+
+    void GridView::getVisibleCells(
+        int* col_start, int* row_start, int* col_end, int* row_end)
+    {
+        auto bounds = getContentBounds();
+
+        // 翻转时行坐标从下往上增长，但可见的范围相同，四周各多留一格
+        *col_start = floorDiv(-start_col_offset_, length_) - start_col_ - 1;
+        *col_end = floorDiv(bounds.width() - start_col_offset_, length_) - start_col_ + 1;
+        *row_start = floorDiv(-start_row_offset_, length_) - start_row_ - 1;
+        *row_end = floorDiv(bounds.height() - start_row_offset_, length_) - start_row_ + 1;
+    }
+
+    GridView::PixelTile* GridView::findTile(int col, int row) const {
+        auto it = tiles_.find(
+            getTileKey(floorDiv(col, kTileSize), floorDiv(row, kTileSize)));
+        if (it == tiles_.end()) {
+            return nullptr;
         }
-        return false;
+        return it->second.get();
     }
 
     float GridView::getAdjustedLineWidth(int dip) const {
@@ -668,13 +807,13 @@ namespace ukive {
         if (getVisibility() != SHOW) {
             return;
         }
-        if (pixels_.empty()) {
+        if (!has_last_pixel_) {
             new_nav_.closeNav();
             return;
         }
 
-        int col = pixels_.back().col;
-        int row = pixels_.back().row;
+        int col = last_pixel_col_;
+        int row = last_pixel_row_;
         int inset = int(line_width_ / 2);
 
         Rect rect;
@@ -7,11 +7,15 @@
 #ifndef UKIVE_DIAGNOSTIC_GRID_VIEW_H_
 #define UKIVE_DIAGNOSTIC_GRID_VIEW_H_
 
+#include <bitset>
+#include <unordered_map>
+
 #include "utils/weak_ref_nest.hpp"
 
 #include "ukive/animation/animator.h"
 #include "ukive/diagnostic/grid_navigator.h"
 #include "ukive/graphics/size.hpp"
+#include "ukive/graphics/images/image_frame.h"
 #include "ukive/graphics/vsyncable.h"
 #include "ukive/views/view.h"
 
@@ -52,6 +56,7 @@ namespace ukive {
         void onDraw(Canvas* canvas) override;
         bool onInputEvent(InputEvent* e) override;
         void onVisibilityChanged(int visibility) override;
+        void onContextChanged(Context::Type type, const Context& context) override;
 
         // VSyncable
         void onVSync(
@@ -60,10 +65,22 @@ namespace ukive {
     private:
         using super = View;
 
-        struct PixelInfo {
-            int col;
-            int row;
-            Color color;
+        // 像素按 kTileSize x kTileSize 分块存储
+        static constexpr int kTileSize = 32;
+
+        /**
+         * 像素块。
+         * 块内的像素为稠密存储，绘制时整块缓存为一张图片。
+         */
+        struct PixelTile {
+            Color colors[kTileSize * kTileSize];
+            std::bitset<kTileSize * kTileSize> present;
+
+            bool is_dirty = true;
+            int cache_length = 0;
+            float cache_line_width = 0;
+            bool cache_flipped = false;
+            GPtr<ImageFrame> cache;
         };
 
         struct PointInfo {
@@ -86,6 +103,8 @@ namespace ukive {
         };
 
         void drawGridLines(Canvas* canvas);
+        void drawGridPixels(Canvas* canvas);
+        bool makeTileImage(Canvas* canvas, PixelTile* tile);
         void drawGridPixel(
             Canvas* canvas, int col, int row, const Color& color, bool highlight);
         void drawGridPoint(Canvas* canvas, const PointInfo& info);
@@ -102,7 +121,9 @@ namespace ukive {
         void getGridPoint(int col, int row, int off_col, int off_row, Point* p);
         void getGridPoint(double col, double row, Point* p);
         void getGridPosition(int x, int y, Point* pos, Size* off);
-        bool getGridColor(int col, int row, Color* color);
+        bool getGridColor(int col, int row, Color* color) const;
+        void getVisibleCells(int* col_start, int* row_start, int* col_end, int* row_end);
+        PixelTile* findTile(int col, int row) const;
         float getAdjustedLineWidth(int dip) const;
 
         void showNewNav();
@@ -130,7 +151,10 @@ namespace ukive {
         int text_row_ = 0;
 
         Animator animator_;
-        std::vector<PixelInfo> pixels_;
+        std::unordered_map<uint64_t, std::unique_ptr<PixelTile>> tiles_;
+        bool has_last_pixel_ = false;
+        int last_pixel_col_ = 0;
+        int last_pixel_row_ = 0;
         std::vector<PointInfo> points_;
         std::vector<LineInfo> lines_;
         GridNavigator new_nav_;
@@ -7,18 +7,87 @@
 #include "statistic_drawer.h"
 
 #include <cmath>
+#include <cstdlib>
+#include <cstring>
 
+#ifndef _MSC_VER
+#include <cxxabi.h>
+#endif
+
+#include "utils/strings/int_conv.hpp"
+
+#include "ukive/diagnostic/frame_profiler.h"
 #include "ukive/graphics/canvas.h"
 #include "ukive/graphics/display.h"
 #include "ukive/window/window.h"
 
 
+namespace {
+
+    // 参与分位数统计的帧数
+    const size_t kStatsFrameCount = 240;
+
+    // 显示的 View 类型的数量
+    const size_t kTopViewCount = 5;
+
+    std::u16string formatMs(uint64_t ns) {
+        uint64_t us = ns / 1000;
+        auto frac = utl::itos16(us % 1000 / 10);
+        if (frac.size() < 2) {
+            frac.insert(0, 1, u'0');
+        }
+        return utl::itos16(us / 1000).append(u".").append(frac);
+    }
+
+    std::u16string padRight(std::u16string str, size_t width) {
+        if (str.size() < width) {
+            str.append(width - str.size(), u' ');
+        }
+        return str;
+    }
+
+    /**
+     * 将 typeid().name() 的结果转换为可读的类名。
+     * MSVC 返回的已经是可读名称，其他编译器返回的是修饰名，需要还原。
+     */
+    std::string demangle(const std::string& name) {
+#ifdef _MSC_VER
+        return name;
+#else
+        int status = 0;
+        char* readable = abi::__cxa_demangle(name.c_str(), nullptr, nullptr, &status);
+        if (status != 0 || !readable) {
+            return name;
+        }
+        std::string result(readable);
+        std::free(readable);
+        return result;
+#endif
+    }
+
+    std::u16string padLeft(const std::u16string& str, size_t width) {
+        if (str.size() < width) {
+            return std::u16string(width - str.size(), u' ').append(str);
+        }
+        return str;
+    }
+
+}
+
 namespace ukive {
 
     StatisticDrawer::StatisticDrawer(Context c)
         : mode_(RENDER),
           strip_width_(c.dp2pxi(4)),
-          context_(c) {}
+          context_(c)
+    {
+        FrameProfiler::getInstance()->clear();
+        FrameProfiler::getInstance()->setEnabled(true);
+    }
+
+    StatisticDrawer::~StatisticDrawer() {
+        FrameProfiler::getInstance()->setEnabled(false);
+    }
 
     void StatisticDrawer::draw(int x, int y, int width, int height, Canvas* canvas) {
         int cur_x = x + width;
@@ -45,6 +114,96 @@ namespace ukive {
 
         Rect base_line(x, y + height - base_height, width, int(std::round(context_.dp2px(2))));
         canvas->fillRect(RectF(base_line), Color::Red400);
+
+        // 阴影缓存命中情况
+        uint64_t hits, misses;
+        View::getShadowCacheStats(&hits, &misses);
+
+        std::u16string cache_text;
+        cache_text.append(u"Shadow cache: ")
+            .append(utl::itos16(hits))
+            .append(u" hits, ")
+            .append(utl::itos16(misses))
+            .append(u" misses");
+
+        float padding = context_.dp2px(4);
+        canvas->drawText(
+            cache_text, u"Consolas", context_.dp2px(12),
+            RectF(x + padding, y + padding, width - padding * 2, context_.dp2px(16)),
+            Color::Red400);
+
+        // 测量缓存命中情况
+        View::getMeasureCacheStats(&hits, &misses);
+
+        std::u16string measure_text;
+        measure_text.append(u"Measure cache: ")
+            .append(utl::itos16(hits))
+            .append(u" hits, ")
+            .append(utl::itos16(misses))
+            .append(u" misses");
+
+        canvas->drawText(
+            measure_text, u"Consolas", context_.dp2px(12),
+            RectF(x + padding, y + padding + context_.dp2px(16),
+                width - padding * 2, context_.dp2px(16)),
+            Color::Red400);
+
+        drawPhaseStats(
+            int(x + padding), int(y + padding + context_.dp2px(32)),
+            int(width - padding * 2), canvas);
+    }
+
+    void StatisticDrawer::drawPhaseStats(int x, int y, int width, Canvas* canvas) {
+        auto profiler = FrameProfiler::getInstance();
+
+        FrameProfiler::Stats stats[FrameProfiler::PHASE_COUNT];
+        profiler->getPhaseStats(kStatsFrameCount, stats);
+
+        std::vector<FrameProfiler::ViewStats> view_stats;
+        profiler->getViewStats(kStatsFrameCount, kTopViewCount, &view_stats);
+
+        auto make_line = [](const std::u16string& name, const FrameProfiler::Stats& s) {
+            return padRight(name, 16)
+                .append(padLeft(formatMs(s.p50), 8))
+                .append(padLeft(formatMs(s.p95), 8))
+                .append(padLeft(formatMs(s.p99), 8))
+                .append(padLeft(utl::itos16(s.samples), 6));
+        };
+
+        // 各阶段每帧的耗时，单位为毫秒；n 为实际参与统计的帧数
+        std::vector<std::u16string> lines;
+        lines.push_back(padRight(u"Phase (ms)", 16)
+            .append(padLeft(u"p50", 8))
+            .append(padLeft(u"p95", 8))
+            .append(padLeft(u"p99", 8))
+            .append(padLeft(u"n", 6)));
+        for (int i = 0; i < FrameProfiler::PHASE_COUNT; ++i) {
+            auto name = FrameProfiler::getPhaseName(FrameProfiler::Phase(i));
+            lines.push_back(make_line(std::u16string(name, name + std::strlen(name)), stats[i]));
+        }
+
+        // 每帧绘制自身耗时最多的 View 类型
+        for (const auto& vs : view_stats) {
+            auto name = demangle(vs.name);
+            auto pos = name.find_last_of(": ");
+            if (pos != std::string::npos) {
+                name = name.substr(pos + 1);
+            }
+            if (name.size() > 15) {
+                name.resize(15);
+            }
+            lines.push_back(make_line(std::u16string(name.begin(), name.end()), vs.stats));
+        }
+
+        float line_height = context_.dp2px(16);
+        float cur_y = float(y);
+        for (const auto& line : lines) {
+            canvas->drawText(
+                line, u"Consolas", context_.dp2px(12),
+                RectF(float(x), cur_y, float(width), line_height),
+                Color::Red400);
+            cur_y += line_height;
+        }
     }
 
     void StatisticDrawer::toggleMode() {
@@ -24,6 +24,7 @@ namespace ukive {
         };
 
         explicit StatisticDrawer(Context c);
+        ~StatisticDrawer();
 
         void toggleMode();
         void addDuration(uint64_t duration);
@@ -33,6 +34,8 @@ namespace ukive {
         void draw(int x, int y, int width, int height, Canvas* canvas);
 
     private:
+        void drawPhaseStats(int x, int y, int width, Canvas* canvas);
+
         struct FrameDuration {
             float duration;
 
@@ -6,6 +6,17 @@
 
 #include "byte_data.h"
 
+#include "utils/platform_utils.h"
+
+#ifdef OS_WINDOWS
+#include <Windows.h>
+#elif defined OS_MAC
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #include "ukive/graphics/gref_count_impl.h"
 
 
@@ -227,6 +238,39 @@ namespace ukive {
         size_t len_;
     };
 
+    class ByteData_Mapped :
+        public ByteData,
+        public GRefCountImpl
+    {
+    public:
+        ByteData_Mapped(const void* raw, size_t len)
+            : raw_(raw),
+              len_(len) {}
+        ~ByteData_Mapped() {
+#ifdef OS_WINDOWS
+            ::UnmapViewOfFile(raw_);
+#elif defined OS_MAC
+            ::munmap(const_cast<void*>(raw_), len_);
+#endif
+        }
+
+        GPtr<ByteData> substantiate() override {
+            GPtr<ByteData> out(this);
+            out->add_ref();
+            return out;
+        }
+
+        bool isRef() const override { return false; }
+        Type getType() const override { return Type::Mapped; }
+        void* getData() override { return nullptr; }
+        const void* getConstData() const override { return raw_; }
+        size_t getSize() const override { return len_; }
+
+    private:
+        const void* raw_;
+        size_t len_;
+    };
+
 
     // static
     GPtr<ByteData> ByteData::ownStr(std::string&& raw) {
@@ -341,4 +385,58 @@ namespace ukive {
         return GPtr<ByteData>(new ByteData_Pointer<unsigned char>(nullptr, 0));
     }
 
+    // static
+    GPtr<ByteData> ByteData::mapFile(const std::filesystem::path& path) {
+#ifdef OS_WINDOWS
+        HANDLE file = ::CreateFileW(
+            path.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ,
+            nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            return {};
+        }
+
+        LARGE_INTEGER size;
+        if (!::GetFileSizeEx(file, &size) || size.QuadPart <= 0) {
+            ::CloseHandle(file);
+            return {};
+        }
+
+        // 映射对象和视图会保持文件的引用，句柄可以立即关闭
+        HANDLE mapping = ::CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        ::CloseHandle(file);
+        if (!mapping) {
+            return {};
+        }
+
+        auto raw = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        ::CloseHandle(mapping);
+        if (!raw) {
+            return {};
+        }
+
+        return GPtr<ByteData>(new ByteData_Mapped(raw, size_t(size.QuadPart)));
+#elif defined OS_MAC
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd == -1) {
+            return {};
+        }
+
+        struct stat st;
+        if (::fstat(fd, &st) != 0 || st.st_size <= 0) {
+            ::close(fd);
+            return {};
+        }
+
+        auto raw = ::mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (raw == MAP_FAILED) {
+            return {};
+        }
+
+        return GPtr<ByteData>(new ByteData_Mapped(raw, size_t(st.st_size)));
+#else
+        return {};
+#endif
+    }
+
 }
@@ -7,6 +7,7 @@
 #ifndef UKIVE_GRAPHICS_BYTE_DATA_H_
 #define UKIVE_GRAPHICS_BYTE_DATA_H_
 
+#include <filesystem>
 #include <memory>
 #include <string>
 #include <vector>
@@ -24,6 +25,7 @@ namespace ukive {
             Vector,
             Unique,
             Pointer,
+            Mapped,
         };
 
         static GPtr<ByteData> ownStr(std::string&& raw);
@@ -47,6 +49,13 @@ namespace ukive {
         static GPtr<ByteData> copyUni(const std::unique_ptr<unsigned char[]>& raw, size_t len);
         static GPtr<ByteData> copyPtr(const void* raw, size_t len);
 
+        /**
+         * 以只读方式将文件映射到内存。
+         * 返回的对象持有映射，getData() 返回 nullptr。
+         * @return 文件无法打开、为空或当前平台不支持映射时返回空指针。
+         */
+        static GPtr<ByteData> mapFile(const std::filesystem::path& path);
+
         virtual ~ByteData() = default;
 
         virtual GPtr<ByteData> substantiate() = 0;
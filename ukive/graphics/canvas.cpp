@@ -10,6 +10,7 @@
 #include "ukive/graphics/cyro_buffer.h"
 #include "ukive/graphics/cyro_render_target.h"
 #include "ukive/graphics/paint.h"
+#include "ukive/graphics/render_node/display_list_recorder.h"
 #include "ukive/text/text_layout.h"
 #include "ukive/window/window.h"
 
@@ -109,7 +110,7 @@ namespace ukive {
 
     void Canvas::setOpacity(float opacity) {
         if (rt_) {
-            rt_->setOpacity(opacity);
+            target()->setOpacity(opacity);
         }
     }
 
@@ -122,13 +123,13 @@ namespace ukive {
 
     void Canvas::clear() {
         if (rt_) {
-            rt_->clear();
+            target()->clear();
         }
     }
 
     void Canvas::clear(const Color& color) {
         if (rt_) {
-            rt_->clear(color);
+            target()->clear(color);
         }
     }
 
@@ -151,25 +152,25 @@ namespace ukive {
 
     void Canvas::pushClip(const RectF& rect) {
         if (rt_) {
-            rt_->pushClip(rect);
+            target()->pushClip(rect);
         }
     }
 
     void Canvas::popClip() {
         if (rt_) {
-            rt_->popClip();
+            target()->popClip();
         }
     }
 
     void Canvas::save() {
         if (rt_) {
-            rt_->save();
+            target()->save();
         }
     }
 
     void Canvas::restore() {
         if (rt_) {
-            rt_->restore();
+            target()->restore();
         }
     }
 
@@ -237,7 +238,7 @@ namespace ukive {
 
     void Canvas::scale(float sx, float sy, float cx, float cy) {
         if (rt_) {
-            rt_->scale(sx, sy, { cx, cy });
+            target()->scale(sx, sy, { cx, cy });
         }
     }
 
@@ -247,19 +248,19 @@ namespace ukive {
 
     void Canvas::rotate(float angle, float cx, float cy) {
         if (rt_) {
-            rt_->rotate(angle, { cx, cy });
+            target()->rotate(angle, { cx, cy });
         }
     }
 
     void Canvas::translate(float dx, float dy) {
         if (rt_) {
-            rt_->translate(dx, dy);
+            target()->translate(dx, dy);
         }
     }
 
     void Canvas::concat(const Matrix2x3F& matrix) {
         if (rt_) {
-            rt_->concat(matrix);
+            target()->concat(matrix);
         }
     }
 
@@ -276,7 +277,7 @@ namespace ukive {
         ImageFrame* mask, ImageFrame* content)
     {
         if (rt_ && mask && content) {
-            rt_->fillOpacityMask(width, height, mask, content);
+            target()->fillOpacityMask(width, height, mask, content);
         }
     }
 
@@ -288,7 +289,7 @@ namespace ukive {
         Paint paint;
         paint.setStyle(Paint::Style::IMAGE);
         paint.setImage(content, Paint::ImageExtendMode::WRAP, Paint::ImageExtendMode::WRAP);
-        rt_->drawRect(rect, paint);
+        target()->drawRect(rect, paint);
     }
 
     void Canvas::drawLine(
@@ -308,7 +309,7 @@ namespace ukive {
         paint.setStyle(Paint::Style::STROKE);
         paint.setStrokeWidth(stroke_width);
         paint.setColor(color);
-        rt_->drawLine(start, end, paint);
+        target()->drawLine(start, end, paint);
     }
 
     void Canvas::drawRect(const RectF& rect, const Color& color) {
@@ -319,7 +320,7 @@ namespace ukive {
         Paint paint;
         paint.setStyle(Paint::Style::STROKE);
         paint.setColor(color);
-        rt_->drawRect(rect, paint);
+        target()->drawRect(rect, paint);
     }
 
     void Canvas::drawRect(const RectF& rect, float stroke_width, const Color& color) {
@@ -331,7 +332,7 @@ namespace ukive {
         paint.setStyle(Paint::Style::STROKE);
         paint.setStrokeWidth(stroke_width);
         paint.setColor(color);
-        rt_->drawRect(rect, paint);
+        target()->drawRect(rect, paint);
     }
 
     void Canvas::fillRect(const RectF& rect, const Color& color) {
@@ -342,7 +343,7 @@ namespace ukive {
         Paint paint;
         paint.setStyle(Paint::Style::FILL);
         paint.setColor(color);
-        rt_->drawRect(rect, paint);
+        target()->drawRect(rect, paint);
     }
 
     void Canvas::fillRect(const RectF& rect, ImageFrame* img) {
@@ -353,7 +354,7 @@ namespace ukive {
         Paint paint;
         paint.setStyle(Paint::Style::IMAGE);
         paint.setImage(img);
-        rt_->drawRect(rect, paint);
+        target()->drawRect(rect, paint);
     }
 
     void Canvas::drawRoundRect(
@@ -366,7 +367,7 @@ namespace ukive {
         Paint paint;
         paint.setStyle(Paint::Style::STROKE);
         paint.setColor(color);
-        rt_->drawRoundRect(rect, radius, paint);
+        target()->drawRoundRect(rect, radius, paint);
     }
 
     void Canvas::drawRoundRect(
@@ -381,7 +382,7 @@ namespace ukive {
         paint.setStyle(Paint::Style::STROKE);
         paint.setStrokeWidth(stroke_width);
         paint.setColor(color);
-        rt_->drawRoundRect(rect, radius, paint);
+        target()->drawRoundRect(rect, radius, paint);
     }
 
     void Canvas::fillRoundRect(
@@ -394,7 +395,7 @@ namespace ukive {
         Paint paint;
         paint.setStyle(Paint::Style::FILL);
         paint.setColor(color);
-        rt_->drawRoundRect(rect, radius, paint);
+        target()->drawRoundRect(rect, radius, paint);
     }
 
     void Canvas::drawCircle(const PointF& cp, float radius, const Color& color) {
@@ -417,7 +418,7 @@ namespace ukive {
         Paint paint;
         paint.setStyle(Paint::Style::IMAGE);
         paint.setImage(img);
-        rt_->drawCircle(cp, radius, paint);
+        target()->drawCircle(cp, radius, paint);
     }
 
     void Canvas::drawOval(const PointF& cp, float rx, float ry, const Color& color) {
@@ -428,7 +429,7 @@ namespace ukive {
         Paint paint;
         paint.setStyle(Paint::Style::STROKE);
         paint.setColor(color);
-        rt_->drawEllipse(cp, rx, ry, paint);
+        target()->drawEllipse(cp, rx, ry, paint);
     }
 
     void Canvas::drawOval(const PointF& cp, float rx, float ry, float stroke_width, const Color& color) {
@@ -440,7 +441,7 @@ namespace ukive {
         paint.setStyle(Paint::Style::STROKE);
         paint.setStrokeWidth(stroke_width);
         paint.setColor(color);
-        rt_->drawEllipse(cp, rx, ry, paint);
+        target()->drawEllipse(cp, rx, ry, paint);
     }
 
     void Canvas::fillOval(const PointF& cp, float rx, float ry, const Color& color) {
@@ -451,7 +452,7 @@ namespace ukive {
         Paint paint;
         paint.setStyle(Paint::Style::FILL);
         paint.setColor(color);
-        rt_->drawEllipse(cp, rx, ry, paint);
+        target()->drawEllipse(cp, rx, ry, paint);
     }
 
     void Canvas::drawPath(const Path* path, float stroke_width, const Color& color) {
@@ -463,7 +464,7 @@ namespace ukive {
         paint.setStyle(Paint::Style::STROKE);
         paint.setStrokeWidth(stroke_width);
         paint.setColor(color);
-        rt_->drawPath(path, paint);
+        target()->drawPath(path, paint);
     }
 
     void Canvas::fillPath(const Path* path, const Color& color) {
@@ -474,7 +475,7 @@ namespace ukive {
         Paint paint;
         paint.setStyle(Paint::Style::FILL);
         paint.setColor(color);
-        rt_->drawPath(path, paint);
+        target()->drawPath(path, paint);
     }
 
     void Canvas::fillPath(const Path* path, ImageFrame* img) {
@@ -485,7 +486,7 @@ namespace ukive {
         Paint paint;
         paint.setStyle(Paint::Style::IMAGE);
         paint.setImage(img);
-        rt_->drawPath(path, paint);
+        target()->drawPath(path, paint);
     }
 
     void Canvas::drawImage(ImageFrame* img) {
@@ -535,7 +536,7 @@ namespace ukive {
 
     void Canvas::drawImage(const RectF& src, const RectF& dst, float opacity, ImageFrame* img) {
         if (rt_ && img) {
-            rt_->drawImage(src, dst, opacity, img);
+            target()->drawImage(src, dst, opacity, img);
         }
     }
 
@@ -551,7 +552,7 @@ namespace ukive {
         Paint paint;
         paint.setStyle(Paint::Style::FILL);
         paint.setColor(color);
-        rt_->drawText(text, font_name, font_size, rect, paint);
+        target()->drawText(text, font_name, font_size, rect, paint);
     }
 
     void Canvas::drawTextLayout(
@@ -564,7 +565,42 @@ namespace ukive {
         Paint paint;
         paint.setStyle(Paint::Style::FILL);
         paint.setColor(color);
-        rt_->drawTextLayout(x, y, layout, paint);
+        target()->drawTextLayout(x, y, layout, paint);
+    }
+
+    void Canvas::drawTextLayout(float x, float y, TextLayout* layout) {
+        if (!rt_ || !layout) {
+            return;
+        }
+
+        if (!recorder_) {
+            layout->draw(this, x, y);
+            return;
+        }
+
+        // 文本布局直接使用底层渲染目标绘制，整体录制为一条命令
+        auto recorder = recorder_;
+        recorder->recordTextLayout(x, y, layout);
+        recorder_ = nullptr;
+        layout->draw(this, x, y);
+        recorder_ = recorder;
+    }
+
+    DisplayListRecorder* Canvas::setRecorder(DisplayListRecorder* recorder) {
+        auto prev = recorder_;
+        recorder_ = recorder;
+        return prev;
+    }
+
+    DisplayListRecorder* Canvas::getRecorder() const {
+        return recorder_;
+    }
+
+    CyroRenderTarget* Canvas::target() const {
+        if (recorder_) {
+            return recorder_;
+        }
+        return rt_;
     }
 
 }
@@ -27,6 +27,7 @@ namespace ukive {
     class OffscreenBuffer;
     class ImageOptions;
     class GPUTexture;
+    class DisplayListRecorder;
 
     class Canvas {
     public:
@@ -133,8 +134,23 @@ namespace ukive {
         void drawTextLayout(
             float x, float y, TextLayout* layout, const Color& color);
 
+        /**
+         * 使用文本布局自身的颜色和效果绘制。
+         */
+        void drawTextLayout(float x, float y, TextLayout* layout);
+
+        /**
+         * 设置录制器。设置后，绘制命令在执行的同时会被录制下来。
+         * 传入 nullptr 以停止录制。返回之前设置的录制器。
+         */
+        DisplayListRecorder* setRecorder(DisplayListRecorder* recorder);
+        DisplayListRecorder* getRecorder() const;
+
     private:
+        CyroRenderTarget* target() const;
+
         CyroRenderTarget* rt_ = nullptr;
+        DisplayListRecorder* recorder_ = nullptr;
     };
 
 }
@@ -0,0 +1,303 @@
+// Copyright (c) 2016 ucclkp <ucclkp@gmail.com>.
+// This file is part of ukive project.
+//
+// This program is licensed under GPLv3 license that can be
+// found in the LICENSE file.
+
+#include "ukive/graphics/colors/color_transform.h"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+#include "utils/log.h"
+
+#include "ukive/graphics/images/lc_image_frame.h"
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define UKIVE_COLOR_TRANSFORM_SSE2
+#include <emmintrin.h>
+#endif
+
+
+namespace {
+
+    float evalCurve(const std::vector<float>& table, float val) {
+        if (table.empty()) {
+            return val;
+        }
+
+        float x = std::clamp(val, 0.f, 1.f) * (table.size() - 1);
+        size_t i = size_t(x);
+        if (i + 1 >= table.size()) {
+            return table.back();
+        }
+
+        float t = x - i;
+        return table[i] + (table[i + 1] - table[i]) * t;
+    }
+
+}
+
+namespace ukive {
+
+    ColorTransform::ColorTransform(const Pipeline& pipeline)
+        : pipeline_(pipeline)
+    {
+        buildTables();
+    }
+
+    void ColorTransform::transform(const Color& src, Color* dst) const {
+        float in[3] = { src.r, src.g, src.b };
+        for (int i = 0; i < 3; ++i) {
+            if (pipeline_.is_srgb) {
+                in[i] = Color::sRGBToLinear(in[i]);
+            } else {
+                in[i] = std::pow(in[i], pipeline_.gamma[i]);
+            }
+        }
+
+        auto m = pipeline_.matrix;
+        float out[3];
+        for (int i = 0; i < 3; ++i) {
+            float v = m[i * 3] * in[0] + m[i * 3 + 1] * in[1] + m[i * 3 + 2] * in[2];
+            out[i] = evalCurve(pipeline_.inv_trc[i], std::clamp(v, 0.f, 1.f));
+        }
+
+        dst->r = out[0];
+        dst->g = out[1];
+        dst->b = out[2];
+        dst->a = src.a;
+    }
+
+    bool ColorTransform::transformPixels(
+        uint8_t* pixels, size_t count,
+        ImagePixelFormat pf, ImageAlphaMode am) const
+    {
+        bool premul = (am == ImageAlphaMode::PREMULTIPLIED);
+        switch (pf) {
+        case ImagePixelFormat::B8G8R8A8_UNORM:
+            if (premul) {
+                transformRow<2, 1, 0, true>(pixels, count);
+            } else {
+                transformRow<2, 1, 0, false>(pixels, count);
+            }
+            return true;
+
+        case ImagePixelFormat::R8G8B8A8_UNORM:
+            if (premul) {
+                transformRow<0, 1, 2, true>(pixels, count);
+            } else {
+                transformRow<0, 1, 2, false>(pixels, count);
+            }
+            return true;
+
+        default:
+            return false;
+        }
+    }
+
+    bool ColorTransform::transformFrame(LcImageFrame* frame, size_t thread_count) const {
+        if (!frame) {
+            return false;
+        }
+
+        auto& options = frame->getOptions();
+        if (options.pixel_format != ImagePixelFormat::B8G8R8A8_UNORM &&
+            options.pixel_format != ImagePixelFormat::R8G8B8A8_UNORM)
+        {
+            DLOG(Log::WARNING) << "Unsupported pixel format for color transform";
+            return false;
+        }
+
+        size_t stride;
+        auto data = static_cast<uint8_t*>(frame->lockPixels(IAF_READ | IAF_WRITE, &stride));
+        if (!data) {
+            return false;
+        }
+
+        auto size = frame->getPixelSize();
+        size_t width = size.width();
+        size_t height = size.height();
+
+        auto func = [&, this](size_t row_start, size_t row_end) {
+            for (size_t y = row_start; y < row_end; ++y) {
+                transformPixels(
+                    data + y * stride, width, options.pixel_format, options.alpha_mode);
+            }
+        };
+
+        thread_count = std::clamp(thread_count, size_t(1), (std::max)(height, size_t(1)));
+        if (thread_count == 1) {
+            func(0, height);
+        } else {
+            // 当前线程处理第一块，其余的块交给新线程
+            std::vector<std::thread> threads;
+            size_t rows = (height + thread_count - 1) / thread_count;
+            for (size_t i = 1; i < thread_count; ++i) {
+                size_t start = i * rows;
+                if (start >= height) {
+                    break;
+                }
+                threads.emplace_back(func, start, (std::min)(start + rows, height));
+            }
+
+            func(0, (std::min)(rows, height));
+            for (auto& t : threads) {
+                t.join();
+            }
+        }
+
+        frame->unlockPixels();
+        return true;
+    }
+
+    void ColorTransform::buildTables() {
+        const int G = kGridSize;
+
+        step_[0] = G * G;
+        step_[1] = G;
+        step_[2] = 1;
+
+        // 输入整形表。最后一个分量值落在最后一个格子的末端，以免越界。
+        for (int v = 0; v < 256; ++v) {
+            int pos = (v * (G - 1) * kFracOne + 127) / 255;
+            int index = pos / kFracOne;
+            int frac = pos % kFracOne;
+            if (index >= G - 1) {
+                index = G - 2;
+                frac = kFracOne;
+            }
+
+            for (int c = 0; c < 3; ++c) {
+                in_offset_[c][v] = uint32_t(index) * step_[c];
+                in_frac_[c][v] = uint16_t(frac);
+            }
+        }
+
+        lut_.resize(size_t(G) * G * G * 4);
+        auto ptr = lut_.data();
+        for (int r = 0; r < G; ++r) {
+            for (int g = 0; g < G; ++g) {
+                for (int b = 0; b < G; ++b) {
+                    Color src(float(r) / (G - 1), float(g) / (G - 1), float(b) / (G - 1));
+                    Color dst;
+                    transform(src, &dst);
+
+                    ptr[0] = int16_t(std::lround(std::clamp(dst.r, 0.f, 1.f) * kLUTMax));
+                    ptr[1] = int16_t(std::lround(std::clamp(dst.g, 0.f, 1.f) * kLUTMax));
+                    ptr[2] = int16_t(std::lround(std::clamp(dst.b, 0.f, 1.f) * kLUTMax));
+                    ptr[3] = 0;
+                    ptr += 4;
+                }
+            }
+        }
+
+        for (size_t i = 0; i < kOutTableSize; ++i) {
+            float v = (i + 0.5f) / kOutTableSize;
+            out_table_[i] = uint8_t((std::min)(255L, std::lround(v * 255)));
+        }
+    }
+
+    template<int R, int G, int B, bool Premul>
+    void ColorTransform::transformRow(uint8_t* pixels, size_t count) const {
+        uint8_t out[3];
+        for (size_t i = 0; i < count; ++i, pixels += 4) {
+            int a = pixels[3];
+            if (!Premul || a == 255) {
+                lookup(pixels[R], pixels[G], pixels[B], out);
+                pixels[R] = out[0];
+                pixels[G] = out[1];
+                pixels[B] = out[2];
+                continue;
+            }
+
+            if (a == 0) {
+                continue;
+            }
+
+            int half = a / 2;
+            lookup(
+                (std::min)(255, (pixels[R] * 255 + half) / a),
+                (std::min)(255, (pixels[G] * 255 + half) / a),
+                (std::min)(255, (pixels[B] * 255 + half) / a), out);
+            pixels[R] = uint8_t((out[0] * a + 127) / 255);
+            pixels[G] = uint8_t((out[1] * a + 127) / 255);
+            pixels[B] = uint8_t((out[2] * a + 127) / 255);
+        }
+    }
+
+    void ColorTransform::lookup(int r, int g, int b, uint8_t* out) const {
+        int fr = in_frac_[0][r];
+        int fg = in_frac_[1][g];
+        int fb = in_frac_[2][b];
+        uint32_t base = in_offset_[0][r] + in_offset_[1][g] + in_offset_[2][b];
+        uint32_t sr = step_[0];
+        uint32_t sg = step_[1];
+        uint32_t sb = step_[2];
+
+        // 按三个插值系数的大小关系选出所在的四面体，
+        // c0 和 c3 总是立方体的对角顶点。
+        uint32_t c1, c2;
+        int w0, w1, w2, w3;
+        if (fr >= fg) {
+            if (fg >= fb) {
+                c1 = sr; c2 = sr + sg;
+                w0 = kFracOne - fr; w1 = fr - fg; w2 = fg - fb; w3 = fb;
+            } else if (fr >= fb) {
+                c1 = sr; c2 = sr + sb;
+                w0 = kFracOne - fr; w1 = fr - fb; w2 = fb - fg; w3 = fg;
+            } else {
+                c1 = sb; c2 = sr + sb;
+                w0 = kFracOne - fb; w1 = fb - fr; w2 = fr - fg; w3 = fg;
+            }
+        } else {
+            if (fr >= fb) {
+                c1 = sg; c2 = sr + sg;
+                w0 = kFracOne - fg; w1 = fg - fr; w2 = fr - fb; w3 = fb;
+            } else if (fg >= fb) {
+                c1 = sg; c2 = sg + sb;
+                w0 = kFracOne - fg; w1 = fg - fb; w2 = fb - fr; w3 = fr;
+            } else {
+                c1 = sb; c2 = sg + sb;
+                w0 = kFracOne - fb; w1 = fb - fg; w2 = fg - fr; w3 = fr;
+            }
+        }
+
+        const int16_t* p0 = lut_.data() + size_t(base) * 4;
+        const int16_t* p1 = p0 + size_t(c1) * 4;
+        const int16_t* p2 = p0 + size_t(c2) * 4;
+        const int16_t* p3 = p0 + size_t(sr + sg + sb) * 4;
+
+        int vr, vg, vb;
+#ifdef UKIVE_COLOR_TRANSFORM_SSE2
+        // 两两交错后用 pmaddwd 同时计算 r、g、b 三个分量的加权和
+        __m128i v0 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p0));
+        __m128i v1 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p1));
+        __m128i v2 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p2));
+        __m128i v3 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p3));
+
+        __m128i w01 = _mm_set1_epi32((w1 << 16) | w0);
+        __m128i w23 = _mm_set1_epi32((w3 << 16) | w2);
+
+        __m128i sum = _mm_add_epi32(
+            _mm_madd_epi16(_mm_unpacklo_epi16(v0, v1), w01),
+            _mm_madd_epi16(_mm_unpacklo_epi16(v2, v3), w23));
+        sum = _mm_srli_epi32(_mm_add_epi32(sum, _mm_set1_epi32(kFracOne / 2)), 8);
+
+        vr = _mm_cvtsi128_si32(sum);
+        vg = _mm_cvtsi128_si32(_mm_srli_si128(sum, 4));
+        vb = _mm_cvtsi128_si32(_mm_srli_si128(sum, 8));
+#else
+        vr = (p0[0] * w0 + p1[0] * w1 + p2[0] * w2 + p3[0] * w3 + kFracOne / 2) >> 8;
+        vg = (p0[1] * w0 + p1[1] * w1 + p2[1] * w2 + p3[1] * w3 + kFracOne / 2) >> 8;
+        vb = (p0[2] * w0 + p1[2] * w1 + p2[2] * w2 + p3[2] * w3 + kFracOne / 2) >> 8;
+#endif
+
+        out[0] = out_table_[vr >> 3];
+        out[1] = out_table_[vg >> 3];
+        out[2] = out_table_[vb >> 3];
+    }
+
+}
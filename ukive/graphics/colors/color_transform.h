@@ -0,0 +1,108 @@
+// Copyright (c) 2016 ucclkp <ucclkp@gmail.com>.
+// This file is part of ukive project.
+//
+// This program is licensed under GPLv3 license that can be
+// found in the LICENSE file.
+
+#ifndef UKIVE_GRAPHICS_COLORS_COLOR_TRANSFORM_H_
+#define UKIVE_GRAPHICS_COLORS_COLOR_TRANSFORM_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "ukive/graphics/colors/color.h"
+#include "ukive/graphics/images/image_options.h"
+
+
+namespace ukive {
+
+    class LcImageFrame;
+
+    /**
+     * 预编译的颜色变换，由 UCMM::compileTransform() 创建。
+     * 源 RGB -> PCS -> 目标设备 RGB 的整个流程被烘焙为：
+     * 1. 一维输入整形表，将 8 位分量映射为 LUT 的网格坐标；
+     * 2. 在源编码空间中均匀采样的 3D LUT，使用四面体插值；
+     * 3. 一维输出整形表，将 LUT 的输出量化为 8 位分量。
+     * 创建后只读，可在多个线程中同时使用。
+     */
+    class ColorTransform {
+    public:
+        // 3D LUT 每一维的网格点数
+        static constexpr int kGridSize = 33;
+
+        // 反向 TRC 采样表的长度
+        static constexpr size_t kCurveSize = 4096;
+
+        /**
+         * 由配置文件得到的变换流程。
+         * 线性源 RGB 经 matrix 变换并截断到 [0, 1] 后，再经过 inv_trc 得到设备值。
+         */
+        struct Pipeline {
+            // 为 true 时使用 sRGB 曲线线性化源 RGB，否则使用 gamma
+            bool is_srgb = true;
+            float gamma[3] = { 1.f, 1.f, 1.f };
+
+            // 线性源 RGB 到线性目标 RGB 的矩阵，行优先
+            float matrix[9];
+
+            // 目标设备的反向 TRC，在 [0, 1] 上均匀采样 kCurveSize 个点
+            std::vector<float> inv_trc[3];
+        };
+
+        explicit ColorTransform(const Pipeline& pipeline);
+
+        /**
+         * 精确地转换单个颜色，不经过 LUT。
+         */
+        void transform(const Color& src, Color* dst) const;
+
+        /**
+         * 就地转换 count 个 8 位像素。
+         * 支持 B8G8R8A8_UNORM 和 R8G8B8A8_UNORM 格式。预乘的像素会先反预乘，转换后再预乘。
+         * @return 不支持该像素格式时返回 false。
+         */
+        bool transformPixels(
+            uint8_t* pixels, size_t count,
+            ImagePixelFormat pf, ImageAlphaMode am) const;
+
+        /**
+         * 就地转换整个图像帧。
+         * @param thread_count 按行分割时使用的线程数，为 1 时只在当前线程中转换。
+         */
+        bool transformFrame(LcImageFrame* frame, size_t thread_count = 1) const;
+
+    private:
+        // LUT 中的值为 15 位定点数，以便使用有符号 16 位乘加指令插值
+        static constexpr int kLUTMax = 0x7FFF;
+
+        // 四面体插值的权重之和
+        static constexpr int kFracOne = 256;
+
+        static constexpr size_t kOutTableSize = 4096;
+
+        void buildTables();
+
+        template<int R, int G, int B, bool Premul>
+        void transformRow(uint8_t* pixels, size_t count) const;
+
+        void lookup(int r, int g, int b, uint8_t* out) const;
+
+        Pipeline pipeline_;
+
+        // 输入整形表：分量值 -> 网格中的偏移（以项为单位）和插值系数
+        uint32_t in_offset_[3][256];
+        uint16_t in_frac_[3][256];
+        uint32_t step_[3];
+
+        // 每项 4 个 int16，依次为 r、g、b 和填充
+        std::vector<int16_t> lut_;
+
+        // 输出整形表：15 位定点数的高 12 位 -> 8 位分量
+        uint8_t out_table_[kOutTableSize];
+    };
+
+}
+
+#endif  // UKIVE_GRAPHICS_COLORS_COLOR_TRANSFORM_H_
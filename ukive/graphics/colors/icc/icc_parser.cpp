@@ -7,6 +7,8 @@
 #include "icc_parser.h"
 
 #include <cassert>
+#include <streambuf>
+#include <utility>
 
 #include "utils/stream_utils.h"
 
@@ -36,34 +38,90 @@
     }
 
 
+namespace {
+
+    // 文件头 128 字节，加上标签数量 4 字节
+    constexpr uint32_t kHeaderSize = 128;
+    constexpr uint32_t kTagTableEntrySize = 12;
+
+    /**
+     * 只读的内存流缓冲，直接在配置文件的内存上读取，不复制数据。
+     */
+    class MemoryStreamBuf : public std::streambuf {
+    public:
+        MemoryStreamBuf(const void* data, size_t size) {
+            auto ptr = static_cast<char*>(const_cast<void*>(data));
+            setg(ptr, ptr, ptr + size);
+        }
+
+    protected:
+        pos_type seekoff(
+            off_type off, std::ios_base::seekdir dir,
+            std::ios_base::openmode which) override
+        {
+            off_type base;
+            switch (dir) {
+            case std::ios_base::beg: base = 0; break;
+            case std::ios_base::cur: base = gptr() - eback(); break;
+            case std::ios_base::end: base = egptr() - eback(); break;
+            default: return pos_type(off_type(-1));
+            }
+            return seekpos(pos_type(base + off), which);
+        }
+
+        pos_type seekpos(pos_type pos, std::ios_base::openmode which) override {
+            off_type off = pos;
+            if (!(which & std::ios_base::in) ||
+                off < 0 || off > egptr() - eback())
+            {
+                return pos_type(off_type(-1));
+            }
+            setg(eback(), eback() + off, egptr());
+            return pos;
+        }
+    };
+
+}
+
 namespace ukive {
 namespace icc {
 
     ICCParser::ICCParser() {}
 
     ICCParser::~ICCParser() {
-        for (auto& t : tags_) {
-            delete t.type;
-        }
+        clear();
     }
 
-    bool ICCParser::parseHeader(std::istream& s) {
-        for (auto& t : tags_) {
-            delete t.type;
+    bool ICCParser::parse(const GPtr<ByteData>& data) {
+        clear();
+        if (!data || data->getSize() < kHeaderSize + 4) {
+            return false;
         }
-        tags_.clear();
+
+        MemoryStreamBuf buf(data->getConstData(), data->getSize());
+        std::istream s(&buf);
 
         if (!parserHeader(s)) {
             return false;
         }
+
+        // 文件可能比配置文件长，只使用配置文件声明的部分
+        if (header_.profile_size < kHeaderSize + 4 ||
+            header_.profile_size > data->getSize())
+        {
+            return false;
+        }
+
+        data_ = data;
         if (!parseTagTable(s)) {
+            clear();
             return false;
         }
 
         return true;
     }
 
-    int ICCParser::obtainTagData(std::istream& s, uint32_t tag_sign, const ICCType** type) {
+    int ICCParser::obtainTagData(uint32_t tag_sign, const ICCType** type) {
         auto tag = getTagElement(tag_sign);
         if (!tag) {
             return ICCRC_NOT_FOUND;
@@ -74,7 +132,7 @@ namespace icc {
             return ICCRC_OK;
         }
 
-        if (!parseTagData(s, tag)) {
+        if (!parseTagData(tag)) {
             return ICCRC_PARSING_FAILED;
         }
 
@@ -82,6 +140,27 @@ namespace icc {
         return ICCRC_OK;
     }
 
+    int ICCParser::obtainTagRawData(
+        uint32_t tag_sign, const uint8_t** data, uint32_t* size) const
+    {
+        auto tag = getTagElement(tag_sign);
+        if (!tag) {
+            return ICCRC_NOT_FOUND;
+        }
+
+        *data = static_cast<const uint8_t*>(data_->getConstData()) + tag->data_offset;
+        *size = tag->data_size;
+        return ICCRC_OK;
+    }
+
+    void ICCParser::clear() {
+        for (auto& t : tags_) {
+            delete t.type;
+        }
+        tags_.clear();
+        data_.reset();
+    }
+
     bool ICCParser::parserHeader(std::istream& s) {
         auto header = &header_;
 
@@ -122,31 +201,46 @@ namespace icc {
         uint32_t count;
         READ_STREAM_BE(count, 4);
 
-        tags_.resize(63);
+        uint32_t profile_size = header_.profile_size;
+        if (count > (profile_size - kHeaderSize - 4) / kTagTableEntrySize) {
+            return false;
+        }
+
+        tags_.resize(kKnownTagCount);
         for (uint32_t i = 0; i < count; ++i) {
-            uint32_t sign;
-            READ_STREAM_BE(sign, 4);
+            TagElement tag;
+            tag.valid = true;
+            READ_STREAM_BE(tag.tag_signature, 4);
+            READ_STREAM_BE(tag.data_offset, 4);
+            READ_STREAM_BE(tag.data_size, 4);
+
+            // 标签数据必须完整地位于配置文件之内
+            if (tag.data_offset < kHeaderSize ||
+                tag.data_offset > profile_size ||
+                tag.data_size > profile_size - tag.data_offset)
+            {
+                return false;
+            }
 
-            size_t index = getTagIndex(sign);
+            size_t index = getTagIndex(tag.tag_signature);
             if (index == size_t(-1)) {
-                TagElement tag;
-                tag.valid = true;
-                tag.tag_signature = sign;
-                READ_STREAM_BE(tag.data_offset, 4);
-                READ_STREAM_BE(tag.data_size, 4);
                 tags_.push_back(tag);
             } else {
-                tags_[index].valid = true;
-                tags_[index].tag_signature = sign;
-                READ_STREAM_BE(tags_[index].data_offset, 4);
-                READ_STREAM_BE(tags_[index].data_size, 4);
+                tags_[index] = tag;
             }
         }
 
         return true;
     }
 
-    bool ICCParser::parseTagData(std::istream& s, TagElement* tag) {
+    bool ICCParser::parseTagData(TagElement* tag) {
+        // 至少要有类型签名和保留的 4 字节
+        if (tag->data_size < 8) {
+            return false;
+        }
+
+        MemoryStreamBuf buf(data_->getConstData(), header_.profile_size);
+        std::istream s(&buf);
         SEEKG_STREAM(tag->data_offset);
 
         uint32_t type_sign;
@@ -168,7 +262,7 @@ namespace icc {
             TYPE_PARSER(kTypeS15F16Array, S15F16ArrayType);
 
         default:
-            assert(false);
+            // 私有类型，只能通过 obtainTagRawData() 获取
             break;
         }
 
@@ -176,8 +270,20 @@ namespace icc {
     }
 
     ICCParser::TagElement* ICCParser::getTagElement(uint32_t tag_sign) {
+        return const_cast<TagElement*>(std::as_const(*this).getTagElement(tag_sign));
+    }
+
+    const ICCParser::TagElement* ICCParser::getTagElement(uint32_t tag_sign) const {
         size_t index = getTagIndex(tag_sign);
         if (index == size_t(-1)) {
+            for (size_t i = kKnownTagCount; i < tags_.size(); ++i) {
+                if (tags_[i].tag_signature == tag_sign) {
+                    return &tags_[i];
+                }
+            }
+            return nullptr;
+        }
+        if (index >= tags_.size()) {
             return nullptr;
         }
 
@@ -10,13 +10,19 @@
 #include <istream>
 #include <vector>
 
+#include "ukive/graphics/byte_data.h"
 #include "ukive/graphics/colors/icc/types/icc_type_lut16.h"
 
 
 namespace ukive {
 namespace icc {
 
-    // ICC 4.3 Parser
+    /**
+     * ICC 4.3 Parser
+     * 配置文件的全部数据由 ByteData 提供（通常是文件映射）。
+     * parse() 一次性读取并校验文件头和标签表，之后各标签的数据在首次使用时
+     * 直接从这块内存中解析，不再访问文件。
+     */
     class ICCParser {
     public:
         struct ProfileHeader {
@@ -53,22 +59,38 @@ namespace icc {
         ICCParser();
         ~ICCParser();
 
-        bool parseHeader(std::istream& s);
-        int obtainTagData(
-            std::istream& s, uint32_t tag_sign, const ICCType** type);
+        /**
+         * 解析并校验文件头和标签表。
+         * 所有标签的数据范围都必须位于配置文件之内，否则解析失败。
+         */
+        bool parse(const GPtr<ByteData>& data);
+        int obtainTagData(uint32_t tag_sign, const ICCType** type);
+
+        /**
+         * 获取标签的原始数据，包括类型签名。
+         * 数据直接指向 ByteData 的内存，不经过解析，私有标签也可以通过它获取。
+         */
+        int obtainTagRawData(
+            uint32_t tag_sign, const uint8_t** data, uint32_t* size) const;
 
         const ProfileHeader& getHeader() const { return header_; }
 
     private:
+        // 已知标签在 tags_ 中占据固定的位置，其余的标签依次排列在后面
+        static constexpr size_t kKnownTagCount = 63;
+
+        void clear();
         bool parserHeader(std::istream& s);
         bool parseTagTable(std::istream& s);
-        bool parseTagData(std::istream& s, TagElement* tag);
+        bool parseTagData(TagElement* tag);
         TagElement* getTagElement(uint32_t tag_sign);
+        const TagElement* getTagElement(uint32_t tag_sign) const;
 
         static size_t getTagIndex(uint32_t tag_sign);
 
         ProfileHeader header_;
         std::vector<TagElement> tags_;
+        GPtr<ByteData> data_;
     };
 
 }
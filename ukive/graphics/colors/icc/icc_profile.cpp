@@ -6,9 +6,6 @@
 
 #include "icc_profile.h"
 
-#include <cassert>
-#include <fstream>
-
 #include "ukive/graphics/colors/icc/icc_types.h"
 
 
@@ -18,40 +15,27 @@ namespace icc {
     ICCProfile::ICCProfile() {}
 
     bool ICCProfile::load(const std::filesystem::path& icc_file_path) {
-        icc_file_path_ = icc_file_path;
         header_parsed_ = false;
 
-        icc_fs_.open(icc_file_path, std::ios::binary);
-        if (!icc_fs_) {
-            return false;
-        }
-
-        if (!parser_.parseHeader(icc_fs_)) {
+        auto data = ByteData::mapFile(icc_file_path);
+        if (!data) {
             return false;
         }
 
-        header_parsed_ = true;
-        return true;
+        return load(data);
     }
 
-    bool ICCProfile::open() {
-        if (icc_fs_.is_open()) {
-            return true;
-        }
+    bool ICCProfile::load(const GPtr<ByteData>& data) {
+        header_parsed_ = false;
 
-        icc_fs_.open(icc_file_path_, std::ios::binary);
-        if (!icc_fs_) {
+        if (!parser_.parse(data)) {
             return false;
         }
 
+        header_parsed_ = true;
         return true;
     }
 
-    void ICCProfile::close() {
-        icc_fs_.close();
-        assert(!!icc_fs_);
-    }
-
     int ICCProfile::getHeader(ICCParser::ProfileHeader* header) const {
         if (!header_parsed_) {
             return ICCRC_NOT_FOUND;
@@ -64,10 +48,18 @@ namespace icc {
         if (!header_parsed_) {
             return ICCRC_NO_HEADER;
         }
-        if (!open()) {
-            return ICCRC_NO_FILE;
+
+        std::lock_guard<std::mutex> lg(tag_mutex_);
+        return parser_.obtainTagData(tag_sign, type);
+    }
+
+    int ICCProfile::obtainTagRawData(
+        uint32_t tag_sign, const uint8_t** data, uint32_t* size) const
+    {
+        if (!header_parsed_) {
+            return ICCRC_NO_HEADER;
         }
-        return parser_.obtainTagData(icc_fs_, tag_sign, type);
+        return parser_.obtainTagRawData(tag_sign, data, size);
     }
 
 }
@@ -8,33 +8,41 @@
 #define UKIVE_GRAPHICS_COLORS_ICC_ICC_PROFILE_H_
 
 #include <filesystem>
-#include <fstream>
+#include <mutex>
 
+#include "ukive/graphics/byte_data.h"
 #include "ukive/graphics/colors/icc/icc_parser.h"
 
 
 namespace ukive {
 namespace icc {
 
+    /**
+     * ICC 配置文件。
+     * 文件被映射到内存中，文件头和标签表在加载时校验，标签数据在首次使用时解析。
+     * 可以在多个线程间共享，参见 ICCProfileCache。
+     */
     class ICCProfile {
     public:
         ICCProfile();
 
         bool load(const std::filesystem::path& icc_file_path);
-        bool open();
-        void close();
+        bool load(const GPtr<ByteData>& data);
 
         int getHeader(ICCParser::ProfileHeader* header) const;
         int obtainTagData(uint32_t tag_sign, const ICCType** type);
+        int obtainTagRawData(
+            uint32_t tag_sign, const uint8_t** data, uint32_t* size) const;
 
     private:
         ICCParser parser_;
-        std::ifstream icc_fs_;
-        std::filesystem::path icc_file_path_;
         bool header_parsed_ = false;
+
+        // 保护标签数据的延迟解析
+        std::mutex tag_mutex_;
     };
 
 }
 }
 
-#endif  // UKIVE_GRAPHICS_COLORS_ICC_ICC_PROFILE_H_
\ No newline at end of file
+#endif  // UKIVE_GRAPHICS_COLORS_ICC_ICC_PROFILE_H_
@@ -0,0 +1,143 @@
+// Copyright (c) 2016 ucclkp <ucclkp@gmail.com>.
+// This file is part of ukive project.
+//
+// This program is licensed under GPLv3 license that can be
+// found in the LICENSE file.
+
+#include "icc_profile_cache.h"
+
+#include <algorithm>
+
+#include "utils/log.h"
+
+#include "ukive/graphics/colors/icc/icc_types.h"
+
+
+namespace ukive {
+namespace icc {
+
+    std::unique_ptr<ICCProfileCache> ICCProfileCache::instance_;
+
+    // static
+    ICCProfileCache* ICCProfileCache::getInstance() {
+        if (!instance_) {
+            instance_.reset(new ICCProfileCache());
+        }
+        return instance_.get();
+    }
+
+    std::shared_ptr<ICCProfile> ICCProfileCache::obtain(
+        const std::filesystem::path& icc_file_path)
+    {
+        std::error_code ec;
+        auto key = std::filesystem::absolute(icc_file_path, ec).lexically_normal();
+        if (ec) {
+            key = icc_file_path.lexically_normal();
+        }
+
+        auto write_time = std::filesystem::last_write_time(key, ec);
+        if (ec) {
+            return {};
+        }
+        auto size = std::filesystem::file_size(key, ec);
+        if (ec) {
+            return {};
+        }
+
+        std::lock_guard<std::mutex> lg(mutex_);
+
+        auto it = files_.find(key);
+        if (it != files_.end()) {
+            if (it->second.write_time == write_time && it->second.size == size) {
+                return it->second.profile;
+            }
+            files_.erase(it);
+        }
+
+        auto profile = std::make_shared<ICCProfile>();
+        if (!profile->load(key)) {
+            DLOG(Log::WARNING) << "Failed to load ICC profile.";
+            return {};
+        }
+
+        profile = shareById(profile);
+
+        FileEntry entry;
+        entry.write_time = write_time;
+        entry.size = size;
+        entry.profile = profile;
+        files_[key] = entry;
+        return profile;
+    }
+
+    std::shared_ptr<ICCProfile> ICCProfileCache::obtain(const GPtr<ByteData>& data) {
+        auto profile = std::make_shared<ICCProfile>();
+        if (!profile->load(data)) {
+            return {};
+        }
+
+        std::lock_guard<std::mutex> lg(mutex_);
+        return shareById(profile);
+    }
+
+    void ICCProfileCache::purge() {
+        std::lock_guard<std::mutex> lg(mutex_);
+
+        // 同一个配置文件可能同时被两张表引用
+        for (auto it = files_.begin(); it != files_.end();) {
+            auto& p = it->second.profile;
+            long refs = p.use_count();
+            for (const auto& pair : ids_) {
+                if (pair.second == p) {
+                    --refs;
+                    break;
+                }
+            }
+            if (refs <= 1) {
+                it = files_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        for (auto it = ids_.begin(); it != ids_.end();) {
+            if (it->second.use_count() <= 1) {
+                it = ids_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    void ICCProfileCache::clear() {
+        std::lock_guard<std::mutex> lg(mutex_);
+        files_.clear();
+        ids_.clear();
+    }
+
+    std::shared_ptr<ICCProfile> ICCProfileCache::shareById(
+        const std::shared_ptr<ICCProfile>& profile)
+    {
+        ICCParser::ProfileHeader header;
+        if (profile->getHeader(&header) != ICCRC_OK) {
+            return profile;
+        }
+
+        // 未计算 ID 的配置文件（全为 0）无法按 ID 识别
+        ProfileId id;
+        std::copy(std::begin(header.profile_id), std::end(header.profile_id), id.begin());
+        if (std::all_of(id.begin(), id.end(), [](uint8_t b) { return b == 0; })) {
+            return profile;
+        }
+
+        auto it = ids_.find(id);
+        if (it != ids_.end()) {
+            return it->second;
+        }
+
+        ids_[id] = profile;
+        return profile;
+    }
+
+}
+}
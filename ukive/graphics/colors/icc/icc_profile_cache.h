@@ -0,0 +1,68 @@
+// Copyright (c) 2016 ucclkp <ucclkp@gmail.com>.
+// This file is part of ukive project.
+//
+// This program is licensed under GPLv3 license that can be
+// found in the LICENSE file.
+
+#ifndef UKIVE_GRAPHICS_COLORS_ICC_ICC_PROFILE_CACHE_H_
+#define UKIVE_GRAPHICS_COLORS_ICC_ICC_PROFILE_CACHE_H_
+
+#include <array>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include "ukive/graphics/colors/icc/icc_profile.h"
+
+
+namespace ukive {
+namespace icc {
+
+    /**
+     * 进程内共享的 ICC 配置文件缓存。
+     * 以文件路径和配置文件 ID 为键，使用同一个显示器配置文件的各个窗口
+     * 共享同一个已解析的 ICCProfile。文件的修改时间或大小变化时会重新加载。
+     */
+    class ICCProfileCache {
+    public:
+        static ICCProfileCache* getInstance();
+
+        std::shared_ptr<ICCProfile> obtain(const std::filesystem::path& icc_file_path);
+
+        /**
+         * 从内存中加载配置文件。
+         * 只有带有配置文件 ID 的配置文件才会被缓存。
+         */
+        std::shared_ptr<ICCProfile> obtain(const GPtr<ByteData>& data);
+
+        /**
+         * 释放当前没有被外部引用的配置文件。
+         */
+        void purge();
+        void clear();
+
+    private:
+        using ProfileId = std::array<uint8_t, 16>;
+
+        struct FileEntry {
+            std::filesystem::file_time_type write_time;
+            uintmax_t size;
+            std::shared_ptr<ICCProfile> profile;
+        };
+
+        ICCProfileCache() = default;
+
+        std::shared_ptr<ICCProfile> shareById(const std::shared_ptr<ICCProfile>& profile);
+
+        static std::unique_ptr<ICCProfileCache> instance_;
+
+        std::mutex mutex_;
+        std::map<std::filesystem::path, FileEntry> files_;
+        std::map<ProfileId, std::shared_ptr<ICCProfile>> ids_;
+    };
+
+}
+}
+
+#endif  // UKIVE_GRAPHICS_COLORS_ICC_ICC_PROFILE_CACHE_H_
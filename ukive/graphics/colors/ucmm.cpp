@@ -150,17 +150,8 @@ namespace ukive {
          * 5. 转换到目标 RGB 值
          */
 
-        // ITU 709
         RGBSystem system;
-        system.red.x = 0.6400f;
-        system.red.y = 0.3300f;
-        system.green.x = 0.3000f;
-        system.green.y = 0.6000f;
-        system.blue.x = 0.1500f;
-        system.blue.y = 0.0600f;
-        // D65
-        system.ref_white.x = 0.3127f;
-        system.ref_white.y = 0.3290f;
+        getsRGBSystem(&system);
 
         Color l_rgb = srgb;
         sRGBToLinear(&l_rgb);
@@ -249,6 +240,63 @@ namespace ukive {
         return ret;
     }
 
+    // static
+    int UCMM::compileTransform(
+        Intent intent, const RGBSystem& system,
+        icc::ICCProfile& target, std::unique_ptr<ColorTransform>* out)
+    {
+        ColorTransform::Pipeline pipeline;
+        pipeline.is_srgb = false;
+        pipeline.gamma[0] = system.red_gamma;
+        pipeline.gamma[1] = system.green_gamma;
+        pipeline.gamma[2] = system.blue_gamma;
+
+        int ret = compilePipeline(intent, system, target, &pipeline);
+        if (ret != icc::ICCRC_OK) {
+            return ret;
+        }
+
+        *out = std::make_unique<ColorTransform>(pipeline);
+        return icc::ICCRC_OK;
+    }
+
+    // static
+    int UCMM::compilesRGBTransform(
+        Intent intent,
+        icc::ICCProfile& target, std::unique_ptr<ColorTransform>* out)
+    {
+        RGBSystem system;
+        getsRGBSystem(&system);
+
+        ColorTransform::Pipeline pipeline;
+        pipeline.is_srgb = true;
+
+        int ret = compilePipeline(intent, system, target, &pipeline);
+        if (ret != icc::ICCRC_OK) {
+            return ret;
+        }
+
+        *out = std::make_unique<ColorTransform>(pipeline);
+        return icc::ICCRC_OK;
+    }
+
+    // static
+    void UCMM::getsRGBSystem(RGBSystem* system) {
+        // ITU 709
+        system->red.x = 0.6400f;
+        system->red.y = 0.3300f;
+        system->green.x = 0.3000f;
+        system->green.y = 0.6000f;
+        system->blue.x = 0.1500f;
+        system->blue.y = 0.0600f;
+        // D65
+        system->ref_white.x = 0.3127f;
+        system->ref_white.y = 0.3290f;
+        system->red_gamma = 1.f;
+        system->green_gamma = 1.f;
+        system->blue_gamma = 1.f;
+    }
+
     // static
     void UCMM::RGBToLinear(const RGBSystem& system, Color* rgb) {
         rgb->r = std::pow(rgb->r, system.red_gamma);
@@ -264,6 +312,27 @@ namespace ukive {
     // static
     bool UCMM::RGBToCIEXYZ(
         const Color& src, const RGBSystem& system, CIEXYZ* xyz)
+    {
+        utl::math::MatrixT<float, 3, 3> M;
+        if (!getRGBToXYZMatrix(system, &M)) {
+            return false;
+        }
+
+        utl::math::MatrixT<float, 3, 1> SRC{
+            src.r, src.g, src.b
+        };
+
+        auto DST = M * SRC;
+        xyz->x = DST(0);
+        xyz->y = DST(1);
+        xyz->z = DST(2);
+
+        return true;
+    }
+
+    // static
+    bool UCMM::getRGBToXYZMatrix(
+        const RGBSystem& system, utl::math::MatrixT<float, 3, 3>* out)
     {
         auto Xr = system.red.x / system.red.y;
         auto Yr = 1.f;
@@ -297,21 +366,11 @@ namespace ukive {
 
         auto S = m_inv * W;
 
-        utl::math::MatrixT<float, 3, 3> M{
+        *out = utl::math::MatrixT<float, 3, 3>{
             S(0) * Xr, S(1) * Xg, S(2) * Xb,
             S(0) * Yr, S(1) * Yg, S(2) * Yb,
             S(0) * Zr, S(1) * Zg, S(2) * Zb,
         };
-
-        utl::math::MatrixT<float, 3, 1> SRC{
-            src.r, src.g, src.b
-        };
-
-        auto DST = M * SRC;
-        xyz->x = DST(0);
-        xyz->y = DST(1);
-        xyz->z = DST(2);
-
         return true;
     }
 
@@ -520,6 +579,191 @@ namespace ukive {
         return icc::ICCRC_NOT_IMPL;
     }
 
+    // static
+    int UCMM::compilePipeline(
+        Intent intent, const RGBSystem& system,
+        icc::ICCProfile& target, ColorTransform::Pipeline* pipeline)
+    {
+        /**
+         * 与 RGBToTarget() 的步骤相同，只是将线性 RGB 到 PCS 的各个线性步骤
+         * 合并为一个矩阵，交给 compileIDOCs() 继续合并。
+         */
+        utl::math::MatrixT<float, 3, 3> to_pcs;
+        if (!getRGBToXYZMatrix(system, &to_pcs)) {
+            return icc::ICCRC_NOT_INVERTIBLE;
+        }
+
+        icc::ICCParser::ProfileHeader header;
+        int ret = target.getHeader(&header);
+        if (ret != icc::ICCRC_OK) {
+            return ret;
+        }
+
+        CIEXYZ pcs_wp;
+        pcs_wp.x = fromS15F16(header.pcs_illuminant_nCIEXYZ.x);
+        pcs_wp.y = fromS15F16(header.pcs_illuminant_nCIEXYZ.y);
+        pcs_wp.z = fromS15F16(header.pcs_illuminant_nCIEXYZ.z);
+
+        CIEXYZ act_wp;
+        act_wp.x = system.ref_white.x / system.ref_white.y;
+        act_wp.y = 1.f;
+        act_wp.z = (1 - system.ref_white.x - system.ref_white.y) / system.ref_white.y;
+
+        icc::XYZNumber media_wp_num;
+        ret = obtainXYZType(target, icc::kTagMediaWhitePoint, &media_wp_num);
+        if (ret != icc::ICCRC_OK) {
+            return ret;
+        }
+
+        CIEXYZ media_wp;
+        media_wp.x = fromS15F16(media_wp_num.x);
+        media_wp.y = fromS15F16(media_wp_num.y);
+        media_wp.z = fromS15F16(media_wp_num.z);
+
+        if (!utl::is_num_equal(media_wp.x, act_wp.x) ||
+            !utl::is_num_equal(media_wp.z, act_wp.z))
+        {
+            utl::math::MatrixT<float, 3, 3> m_adapt;
+            if (!chromaticAdapt(media_wp, act_wp, &m_adapt)) {
+                return icc::ICCRC_NOT_INVERTIBLE;
+            }
+            to_pcs = m_adapt * to_pcs;
+        }
+
+        utl::math::MatrixT<float, 3, 3> m_pcs{
+            pcs_wp.x / media_wp.x, 0, 0,
+            0, pcs_wp.y / media_wp.y, 0,
+            0, 0, pcs_wp.z / media_wp.z,
+        };
+        to_pcs = m_pcs * to_pcs;
+
+        switch (header.profile_dev_class) {
+        case icc::kClassDisplayDevice:
+        case icc::kClassInputDevice:
+        case icc::kClassOutputDevice:
+        case icc::kClassColorSpace:
+            return compileIDOCs(target, header, intent, to_pcs, pipeline);
+
+        case icc::kClassDeviceLink:
+        case icc::kClassAbstract:
+            return icc::ICCRC_NOT_IMPL;
+
+        case icc::kClassNamedColor:
+        default:
+            return icc::ICCRC_NO_DATA;
+        }
+    }
+
+    // static
+    int UCMM::compileIDOCs(
+        icc::ICCProfile& profile,
+        const icc::ICCParser::ProfileHeader& header, Intent intent,
+        const utl::math::MatrixT<float, 3, 3>& to_pcs, ColorTransform::Pipeline* pipeline)
+    {
+        // 与 transformIDOCs() 一致，目前只有 Perceptual 意图下的矩阵/TRC 流程
+        if (intent != Intent::Perceptual) {
+            return icc::ICCRC_NOT_IMPL;
+        }
+
+        const icc::ICCType* type;
+        if (profile.obtainTagData(icc::kTagBToD0, &type) == icc::ICCRC_OK ||
+            profile.obtainTagData(icc::kTagBToA0, &type) == icc::ICCRC_OK)
+        {
+            return icc::ICCRC_NOT_IMPL;
+        }
+
+        icc::XYZNumber red_mat_num, green_mat_num, blue_mat_num;
+        int ret = obtainXYZType(profile, icc::kTagRedMatCol, &red_mat_num);
+        if (ret != icc::ICCRC_OK) {
+            return ret;
+        }
+        ret = obtainXYZType(profile, icc::kTagGreenMatCol, &green_mat_num);
+        if (ret != icc::ICCRC_OK) {
+            return ret;
+        }
+        ret = obtainXYZType(profile, icc::kTagBlueMatCol, &blue_mat_num);
+        if (ret != icc::ICCRC_OK) {
+            return ret;
+        }
+
+        utl::math::MatrixT<float, 3, 3> mat{
+            fromS15F16(red_mat_num.x), fromS15F16(green_mat_num.x), fromS15F16(blue_mat_num.x),
+            fromS15F16(red_mat_num.y), fromS15F16(green_mat_num.y), fromS15F16(blue_mat_num.y),
+            fromS15F16(red_mat_num.z), fromS15F16(green_mat_num.z), fromS15F16(blue_mat_num.z),
+        };
+
+        bool has_inv;
+        auto mat_inv = mat.inverse(&has_inv);
+        if (!has_inv) {
+            return icc::ICCRC_NOT_INVERTIBLE;
+        }
+
+        CIEXYZ pcs_wp;
+        pcs_wp.x = fromS15F16(header.pcs_illuminant_nCIEXYZ.x);
+        pcs_wp.y = fromS15F16(header.pcs_illuminant_nCIEXYZ.y);
+        pcs_wp.z = fromS15F16(header.pcs_illuminant_nCIEXYZ.z);
+
+        CIEXYZ act_wp;
+        act_wp.x = 0.95047f;
+        act_wp.y = 1.f;
+        act_wp.z = 1.08883f;
+
+        utl::math::MatrixT<float, 3, 3> m_adapt;
+        chromaticAdapt(act_wp, pcs_wp, &m_adapt);
+
+        auto m = mat_inv * m_adapt * to_pcs;
+        for (int j = 0; j < 3; ++j) {
+            utl::math::MatrixT<float, 3, 1> e{
+                j == 0 ? 1.f : 0.f, j == 1 ? 1.f : 0.f, j == 2 ? 1.f : 0.f
+            };
+            auto col = m * e;
+            for (int i = 0; i < 3; ++i) {
+                pipeline->matrix[i * 3 + j] = col(i);
+            }
+        }
+
+        ret = compileInvTRC(profile, icc::kTagRedTRC, &pipeline->inv_trc[0]);
+        if (ret != icc::ICCRC_OK) {
+            return ret;
+        }
+        ret = compileInvTRC(profile, icc::kTagGreenTRC, &pipeline->inv_trc[1]);
+        if (ret != icc::ICCRC_OK) {
+            return ret;
+        }
+        return compileInvTRC(profile, icc::kTagBlueTRC, &pipeline->inv_trc[2]);
+    }
+
+    // static
+    int UCMM::compileInvTRC(
+        icc::ICCProfile& profile, uint32_t tag_sign, std::vector<float>* table)
+    {
+        const icc::ICCType* type;
+        int ret = profile.obtainTagData(tag_sign, &type);
+        if (ret != icc::ICCRC_OK) {
+            return ret;
+        }
+
+        auto size = ColorTransform::kCurveSize;
+        table->resize(size);
+
+        if (type->getType() == icc::kTypeCurve) {
+            auto curve = static_cast<const icc::CurveType*>(type);
+            for (size_t i = 0; i < size; ++i) {
+                (*table)[i] = calInvCurve(curve, float(i) / (size - 1));
+            }
+        } else if (type->getType() == icc::kTypeParamCurve) {
+            auto curve = static_cast<const icc::ParamCurveType*>(type);
+            for (size_t i = 0; i < size; ++i) {
+                if (!calInvParamCurve(curve, float(i) / (size - 1), &(*table)[i])) {
+                    return icc::ICCRC_NO_DATA;
+                }
+            }
+        } else {
+            return icc::ICCRC_WRONG_TYPE;
+        }
+        return icc::ICCRC_OK;
+    }
+
     // static
     int UCMM::obtainXYZType(
         icc::ICCProfile& profile, uint32_t tag_sign, icc::XYZNumber* num)
@@ -7,9 +7,12 @@
 #ifndef UKIVE_GRAPHICS_COLORS_UCMM_H_
 #define UKIVE_GRAPHICS_COLORS_UCMM_H_
 
+#include <memory>
+
 #include "utils/math/algebra/matrix.hpp"
 
 #include "ukive/graphics/colors/color.h"
+#include "ukive/graphics/colors/color_transform.h"
 #include "ukive/graphics/colors/icc/icc_profile.h"
 
 
@@ -52,6 +55,18 @@ namespace icc {
             const Color& srgb,
             icc::ICCProfile& target, Color* dst);
 
+        /**
+         * 将 RGB -> 目标配置文件的整个变换编译为 ColorTransform，
+         * 之后可以用它批量转换像素，不必再逐个颜色地查询配置文件。
+         * 目前与 RGBToTarget() 相同，只支持使用矩阵/TRC 的配置文件和 Perceptual 意图。
+         */
+        static int compileTransform(
+            Intent intent, const RGBSystem& system,
+            icc::ICCProfile& target, std::unique_ptr<ColorTransform>* out);
+        static int compilesRGBTransform(
+            Intent intent,
+            icc::ICCProfile& target, std::unique_ptr<ColorTransform>* out);
+
     private:
         struct CIEXYZ {
             float x, y, z;
@@ -61,10 +76,13 @@ namespace icc {
             float x, y, z;
         };
 
+        static void getsRGBSystem(RGBSystem* system);
         static void RGBToLinear(const RGBSystem& system, Color* rgb);
         static void sRGBToLinear(Color* srgb);
         static bool RGBToCIEXYZ(
             const Color& src, const RGBSystem& system, CIEXYZ* xyz);
+        static bool getRGBToXYZMatrix(
+            const RGBSystem& system, utl::math::MatrixT<float, 3, 3>* out);
         static bool chromaticAdapt(
             const CIEXYZ& dst_wp, const CIEXYZ& src_wp, utl::math::MatrixT<float, 3, 3>* out);
         static void CIEXYZToPCSXYZ(
@@ -80,6 +98,16 @@ namespace icc {
             const icc::ICCParser::ProfileHeader& header, Intent intent,
             const PCSXYZ& src, Color* dev);
 
+        static int compilePipeline(
+            Intent intent, const RGBSystem& system,
+            icc::ICCProfile& target, ColorTransform::Pipeline* pipeline);
+        static int compileIDOCs(
+            icc::ICCProfile& profile,
+            const icc::ICCParser::ProfileHeader& header, Intent intent,
+            const utl::math::MatrixT<float, 3, 3>& to_pcs, ColorTransform::Pipeline* pipeline);
+        static int compileInvTRC(
+            icc::ICCProfile& profile, uint32_t tag_sign, std::vector<float>* table);
+
         static int obtainXYZType(
             icc::ICCProfile& profile, uint32_t tag_sign, icc::XYZNumber* num);
         static int cpcTransform(
@@ -0,0 +1,947 @@
+// Copyright (c) 2016 ucclkp <ucclkp@gmail.com>.
+// This file is part of ukive project.
+//
+// This program is licensed under GPLv3 license that can be
+// found in the LICENSE file.
+
+#include "ukive/graphics/cpu/cyro_render_target_cpu.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "utils/log.h"
+
+#include "ukive/graphics/cyro_buffer.h"
+#include "ukive/graphics/images/image_options.h"
+#include "ukive/graphics/images/lc_image_frame.h"
+#include "ukive/graphics/cpu/native_rt_cpu.h"
+#include "ukive/graphics/cpu/path_cpu.h"
+
+
+namespace {
+
+    // 曲线展开时允许的最大误差（设备像素）
+    const float kFlattenTolerance = 0.25f;
+
+    inline uint32_t mul255(uint32_t a, uint32_t b) {
+        uint32_t v = a * b + 128;
+        return (v + (v >> 8)) >> 8;
+    }
+
+    inline float clamp01(float v) {
+        return std::clamp(v, 0.f, 1.f);
+    }
+
+    bool invert(const ukive::Matrix2x3F& m, ukive::Matrix2x3F* out) {
+        float det = m.m11 * m.m22 - m.m12 * m.m21;
+        if (det == 0) {
+            return false;
+        }
+
+        float inv = 1 / det;
+        out->m11 = m.m22 * inv;
+        out->m12 = -m.m12 * inv;
+        out->m21 = -m.m21 * inv;
+        out->m22 = m.m11 * inv;
+        out->m13 = -(out->m11 * m.m13 + out->m12 * m.m23);
+        out->m23 = -(out->m21 * m.m13 + out->m22 * m.m23);
+        return true;
+    }
+
+    int resolveCoord(int v, int size, ukive::Paint::ImageExtendMode em) {
+        using EM = ukive::Paint::ImageExtendMode;
+        switch (em) {
+        case EM::WRAP:
+            v %= size;
+            return v < 0 ? v + size : v;
+        case EM::MIRROR:
+        {
+            int period = size * 2;
+            v %= period;
+            if (v < 0) v += period;
+            return v < size ? v : period - 1 - v;
+        }
+        case EM::CLAMP:
+        default:
+            return std::clamp(v, 0, size - 1);
+        }
+    }
+
+    void sampleBilinear(
+        const ukive::cpu::ImageFrameCpu* img, float fx, float fy,
+        ukive::Paint::ImageExtendMode x_em,
+        ukive::Paint::ImageExtendMode y_em,
+        float out[4])
+    {
+        int w = img->getPixelWidth();
+        int h = img->getPixelHeight();
+
+        fx -= 0.5f;
+        fy -= 0.5f;
+        float fx0 = std::floor(fx);
+        float fy0 = std::floor(fy);
+        float tx = fx - fx0;
+        float ty = fy - fy0;
+
+        int x0 = resolveCoord(int(fx0), w, x_em);
+        int x1 = resolveCoord(int(fx0) + 1, w, x_em);
+        int y0 = resolveCoord(int(fy0), h, y_em);
+        int y1 = resolveCoord(int(fy0) + 1, h, y_em);
+
+        uint8_t p00[4], p10[4], p01[4], p11[4];
+        img->getPixel(x0, y0, p00);
+        img->getPixel(x1, y0, p10);
+        img->getPixel(x0, y1, p01);
+        img->getPixel(x1, y1, p11);
+
+        for (int i = 0; i < 4; ++i) {
+            float top = p00[i] + (p10[i] - p00[i]) * tx;
+            float btm = p01[i] + (p11[i] - p01[i]) * tx;
+            out[i] = top + (btm - top) * ty;
+        }
+    }
+
+    void toPremultiplied(const ukive::Color& c, uint8_t out[4]) {
+        float a = clamp01(c.a);
+        out[0] = uint8_t(clamp01(c.b) * a * 255 + 0.5f);
+        out[1] = uint8_t(clamp01(c.g) * a * 255 + 0.5f);
+        out[2] = uint8_t(clamp01(c.r) * a * 255 + 0.5f);
+        out[3] = uint8_t(a * 255 + 0.5f);
+    }
+
+    inline uint32_t packPixel(const uint8_t bgra[4]) {
+        return uint32_t(bgra[0]) |
+            (uint32_t(bgra[1]) << 8) |
+            (uint32_t(bgra[2]) << 16) |
+            (uint32_t(bgra[3]) << 24);
+    }
+
+    void normalizeWinding(std::vector<ukive::PointF>* polygon) {
+        float area = 0;
+        auto& pts = *polygon;
+        for (size_t i = 0; i < pts.size(); ++i) {
+            auto& p0 = pts[i];
+            auto& p1 = pts[(i + 1) % pts.size()];
+            area += p0.x() * p1.y() - p1.x() * p0.y();
+        }
+        if (area < 0) {
+            std::reverse(pts.begin(), pts.end());
+        }
+    }
+
+}
+
+namespace ukive {
+namespace cpu {
+
+    CyroRenderTargetCpu::CyroRenderTargetCpu()
+        : kernels_(PixelKernels::get()) {}
+
+    CyroRenderTargetCpu::~CyroRenderTargetCpu() {}
+
+    bool CyroRenderTargetCpu::onCreate(CyroBuffer* buffer) {
+        if (!buffer) {
+            return false;
+        }
+
+        buffer_ = buffer;
+        refreshSurface();
+        return true;
+    }
+
+    void CyroRenderTargetCpu::onDestroy() {
+        save_stack_.clear();
+        clip_stack_.clear();
+        surface_.reset();
+
+        if (buffer_) {
+            buffer_->onDestroy();
+            delete buffer_;
+            buffer_ = nullptr;
+        }
+    }
+
+    CyroBuffer* CyroRenderTargetCpu::getBuffer() const {
+        return buffer_;
+    }
+
+    GPtr<ImageFrame> CyroRenderTargetCpu::createImage(const GPtr<LcImageFrame>& frame) {
+        if (!frame) {
+            return {};
+        }
+
+        GPtr<LcImageFrame> src = frame;
+        auto& options = frame->getOptions();
+        if (options.pixel_format != ImagePixelFormat::B8G8R8A8_UNORM ||
+            options.alpha_mode != ImageAlphaMode::PREMULTIPLIED)
+        {
+            src = frame->convertTo(ImageOptions());
+            if (!src) {
+                return {};
+            }
+        }
+
+        auto size = src->getPixelSize();
+        size_t stride = size.width() * 4;
+        std::vector<uint8_t> buf(stride * size.height());
+        if (!src->copyPixels(stride, buf.data(), buf.size())) {
+            return {};
+        }
+
+        auto img = ImageFrameCpu::create(
+            int(size.width()), int(size.height()), buf.data(), stride, src->getOptions());
+        if (!img) {
+            return {};
+        }
+
+        float dpi_x, dpi_y;
+        frame->getDpi(&dpi_x, &dpi_y);
+        img->setDpi(dpi_x, dpi_y);
+
+        return GPtr<ImageFrame>(img.detach());
+    }
+
+    GPtr<ImageFrame> CyroRenderTargetCpu::createImage(
+        int width, int height, const ImageOptions& options)
+    {
+        auto img = ImageFrameCpu::create(width, height, options);
+        if (!img) {
+            return {};
+        }
+        return GPtr<ImageFrame>(img.detach());
+    }
+
+    GPtr<ImageFrame> CyroRenderTargetCpu::createImage(
+        int width, int height,
+        const GPtr<ByteData>& pixel_data, size_t stride,
+        const ImageOptions& options)
+    {
+        if (!pixel_data) {
+            return {};
+        }
+
+        auto img = ImageFrameCpu::create(
+            width, height, pixel_data->getConstData(), stride, options);
+        if (!img) {
+            return {};
+        }
+        return GPtr<ImageFrame>(img.detach());
+    }
+
+    GPtr<ImageFrame> CyroRenderTargetCpu::createImage(
+        const GPtr<GPUTexture>& tex2d, const ImageOptions& options)
+    {
+        // CPU 后端无法访问 GPU 纹理
+        return {};
+    }
+
+    void CyroRenderTargetCpu::setOpacity(float opacity) {
+        opacity_ = opacity;
+    }
+
+    float CyroRenderTargetCpu::getOpacity() const {
+        return opacity_;
+    }
+
+    Size CyroRenderTargetCpu::getSize() const {
+        if (!buffer_) {
+            return {};
+        }
+        return buffer_->getSize();
+    }
+
+    Size CyroRenderTargetCpu::getPixelSize() const {
+        if (!buffer_) {
+            return {};
+        }
+        return buffer_->getPixelSize();
+    }
+
+    Matrix2x3F CyroRenderTargetCpu::getMatrix() const {
+        return matrix_;
+    }
+
+    void CyroRenderTargetCpu::onBeginDraw() {
+        if (!buffer_) {
+            return;
+        }
+        buffer_->onBeginDraw();
+        refreshSurface();
+    }
+
+    GRet CyroRenderTargetCpu::onEndDraw() {
+        if (!buffer_) {
+            return GRet::Failed;
+        }
+        return buffer_->onEndDraw();
+    }
+
+    GRet CyroRenderTargetCpu::onResize(int width, int height) {
+        if (!buffer_) {
+            return GRet::Failed;
+        }
+
+        auto ret = buffer_->onResize(width, height);
+        if (ret != GRet::Succeeded) {
+            return ret;
+        }
+
+        refreshSurface();
+        return GRet::Succeeded;
+    }
+
+    void CyroRenderTargetCpu::clear() {
+        clear(Color(0, 0, 0, 0));
+    }
+
+    void CyroRenderTargetCpu::clear(const Color& c) {
+        if (!surface_) {
+            return;
+        }
+
+        uint8_t color[4];
+        toPremultiplied(c, color);
+
+        auto clip = getClipRect();
+        if (clip.empty()) {
+            return;
+        }
+
+        auto bpp = surface_->getBytesPerPixel();
+        uint32_t color32 = packPixel(color);
+        for (int y = clip.y(); y < clip.bottom(); ++y) {
+            auto row = surface_->getPixels() + y * surface_->getStride();
+            if (bpp == 1) {
+                std::memset(row + clip.x(), color[3], clip.width());
+            } else {
+                kernels_.fill(
+                    reinterpret_cast<uint32_t*>(row) + clip.x(), clip.width(), color32);
+            }
+        }
+    }
+
+    void CyroRenderTargetCpu::pushClip(const RectF& rect) {
+        PointF lt, tr, rb, bl;
+        getDeviceMatrix().transformRect(rect, &lt, &tr, &rb, &bl);
+
+        float l = (std::min)({ lt.x(), tr.x(), rb.x(), bl.x() });
+        float t = (std::min)({ lt.y(), tr.y(), rb.y(), bl.y() });
+        float r = (std::max)({ lt.x(), tr.x(), rb.x(), bl.x() });
+        float b = (std::max)({ lt.y(), tr.y(), rb.y(), bl.y() });
+
+        Rect clip;
+        clip.xyrb(
+            int(std::round(l)), int(std::round(t)),
+            int(std::round(r)), int(std::round(b)));
+        clip.same(getClipRect());
+        clip_stack_.push_back(clip);
+    }
+
+    void CyroRenderTargetCpu::popClip() {
+        if (clip_stack_.empty()) {
+            ubassert(false);
+            return;
+        }
+        clip_stack_.pop_back();
+    }
+
+    void CyroRenderTargetCpu::save() {
+        save_stack_.push({ opacity_, matrix_ });
+    }
+
+    void CyroRenderTargetCpu::restore() {
+        if (save_stack_.empty()) {
+            ubassert(false);
+            return;
+        }
+
+        auto& sb = save_stack_.top();
+        matrix_ = sb.matrix;
+        opacity_ = sb.opacity;
+        save_stack_.pop();
+    }
+
+    void CyroRenderTargetCpu::scale(float sx, float sy, const PointF& c) {
+        matrix_.preScale(sx, sy, c.x(), c.y());
+    }
+
+    void CyroRenderTargetCpu::rotate(float angle, const PointF& c) {
+        matrix_.preRotate(angle, c.x(), c.y());
+    }
+
+    void CyroRenderTargetCpu::translate(float dx, float dy) {
+        matrix_.preTranslate(dx, dy);
+    }
+
+    void CyroRenderTargetCpu::concat(const Matrix2x3F& matrix) {
+        matrix_ = matrix_ * matrix;
+    }
+
+    void CyroRenderTargetCpu::drawPoint(const PointF& p, const Paint& paint) {
+        auto polygon = makeRect(RectF(p.x(), p.y(), 1, 1));
+        toDevice(&polygon);
+
+        Shader shader;
+        toPremultiplied(paint.getColor(), shader.color);
+        shader.opacity = opacity_;
+        fillPolygons({ polygon }, shader);
+    }
+
+    void CyroRenderTargetCpu::drawLine(
+        const PointF& start, const PointF& end, const Paint& paint)
+    {
+        std::vector<Polygon> polygons;
+        strokePolyline({ start, end }, false, paint.getStrokeWidth(), &polygons);
+
+        Shader shader;
+        toPremultiplied(paint.getColor(), shader.color);
+        shader.opacity = opacity_;
+        fillPolygons(polygons, shader);
+    }
+
+    void CyroRenderTargetCpu::drawRect(const RectF& rect, const Paint& paint) {
+        float half = paint.getStrokeWidth() / 2;
+
+        Polygon outer, inner;
+        if (paint.getStyle() == Paint::Style::STROKE) {
+            RectF out_rect(rect.x() - half, rect.y() - half, rect.width() + half * 2, rect.height() + half * 2);
+            outer = makeRect(out_rect);
+            if (rect.width() > half * 2 && rect.height() > half * 2) {
+                RectF in_rect(rect.x() + half, rect.y() + half, rect.width() - half * 2, rect.height() - half * 2);
+                inner = makeRect(in_rect);
+            }
+        }
+        fillOrStroke(makeRect(rect), outer, inner, paint);
+    }
+
+    void CyroRenderTargetCpu::drawRoundRect(
+        const RectF& rect, float radius, const Paint& paint)
+    {
+        float half = paint.getStrokeWidth() / 2;
+
+        Polygon outer, inner;
+        if (paint.getStyle() == Paint::Style::STROKE) {
+            RectF out_rect(rect.x() - half, rect.y() - half, rect.width() + half * 2, rect.height() + half * 2);
+            outer = makeRoundRect(out_rect, radius + half);
+            if (rect.width() > half * 2 && rect.height() > half * 2) {
+                RectF in_rect(rect.x() + half, rect.y() + half, rect.width() - half * 2, rect.height() - half * 2);
+                inner = makeRoundRect(in_rect, (std::max)(radius - half, 0.f));
+            }
+        }
+        fillOrStroke(makeRoundRect(rect, radius), outer, inner, paint);
+    }
+
+    void CyroRenderTargetCpu::drawCircle(const PointF& c, float radius, const Paint& paint) {
+        drawEllipse(c, radius, radius, paint);
+    }
+
+    void CyroRenderTargetCpu::drawEllipse(
+        const PointF& c, float rx, float ry, const Paint& paint)
+    {
+        float half = paint.getStrokeWidth() / 2;
+
+        Polygon outer, inner;
+        if (paint.getStyle() == Paint::Style::STROKE) {
+            outer = makeEllipse(c.x(), c.y(), rx + half, ry + half);
+            if (rx > half && ry > half) {
+                inner = makeEllipse(c.x(), c.y(), rx - half, ry - half);
+            }
+        }
+        fillOrStroke(makeEllipse(c.x(), c.y(), rx, ry), outer, inner, paint);
+    }
+
+    void CyroRenderTargetCpu::drawPath(const Path* path, const Paint& paint) {
+        if (!path) {
+            return;
+        }
+
+        std::vector<PathCpu::Polyline> lines;
+        static_cast<const PathCpu*>(path)->flatten(
+            Matrix2x3F(), kFlattenTolerance / getDeviceScale(), &lines);
+
+        std::vector<Polygon> polygons;
+        if (paint.getStyle() == Paint::Style::STROKE) {
+            for (const auto& line : lines) {
+                strokePolyline(line.points, line.closed, paint.getStrokeWidth(), &polygons);
+            }
+        } else {
+            for (auto& line : lines) {
+                toDevice(&line.points);
+                polygons.push_back(std::move(line.points));
+            }
+        }
+        fillPolygons(polygons, makeShader(paint));
+    }
+
+    void CyroRenderTargetCpu::drawImage(
+        const RectF& src, const RectF& dst, float opacity, ImageFrame* img)
+    {
+        if (!img || src.empty() || dst.empty()) {
+            return;
+        }
+
+        auto cpu_img = static_cast<const ImageFrameCpu*>(img);
+
+        Shader shader;
+        shader.opacity = opacity * opacity_;
+        shader.image = cpu_img;
+        shader.to_image = makeImageMatrix(cpu_img, src, dst);
+
+        auto polygon = makeRect(dst);
+        toDevice(&polygon);
+        fillPolygons({ polygon }, shader);
+    }
+
+    void CyroRenderTargetCpu::fillOpacityMask(
+        float width, float height, ImageFrame* mask, ImageFrame* content)
+    {
+        if (!mask || !content) {
+            return;
+        }
+
+        auto mask_img = static_cast<const ImageFrameCpu*>(mask);
+        auto content_img = static_cast<const ImageFrameCpu*>(content);
+
+        RectF dst(0, 0, width, height);
+
+        Shader shader;
+        shader.opacity = opacity_;
+        shader.image = content_img;
+        shader.to_image = makeImageMatrix(
+            content_img, RectF(PointF(0, 0), content_img->getSize()), dst);
+        shader.mask = mask_img;
+        shader.to_mask = makeImageMatrix(
+            mask_img, RectF(PointF(0, 0), mask_img->getSize()), dst);
+
+        auto polygon = makeRect(dst);
+        toDevice(&polygon);
+        fillPolygons({ polygon }, shader);
+    }
+
+    void CyroRenderTargetCpu::drawText(
+        const std::u16string_view& text,
+        const std::u16string_view& font_name, float font_size,
+        const RectF& rect, const Paint& paint)
+    {
+        // CPU 后端没有字体光栅化器，文本不绘制。
+        warnTextUnsupported();
+    }
+
+    void CyroRenderTargetCpu::drawTextLayout(
+        float x, float y,
+        TextLayout* layout, const Paint& paint)
+    {
+        warnTextUnsupported();
+    }
+
+    void CyroRenderTargetCpu::warnTextUnsupported() {
+        if (!is_text_warned_) {
+            is_text_warned_ = true;
+            LOG(Log::WARNING) << "Text is not supported by the CPU render target and is skipped.";
+        }
+    }
+
+    void CyroRenderTargetCpu::refreshSurface() {
+        if (!buffer_) {
+            surface_.reset();
+            return;
+        }
+
+        auto nrt = static_cast<const NativeRTCpu*>(buffer_->getNativeRT());
+        surface_ = nrt ? nrt->getNative() : GPtr<ImageFrameCpu>();
+    }
+
+    Matrix2x3F CyroRenderTargetCpu::getDeviceMatrix() const {
+        auto size = getSize();
+        auto px_size = getPixelSize();
+        if (size.empty() || px_size.empty()) {
+            return matrix_;
+        }
+
+        float sx = float(px_size.width()) / size.width();
+        float sy = float(px_size.height()) / size.height();
+        return Matrix2x3F::scale(sx, sy) * matrix_;
+    }
+
+    float CyroRenderTargetCpu::getDeviceScale() const {
+        auto m = getDeviceMatrix();
+        float s = (std::max)(
+            std::sqrt(m.m11 * m.m11 + m.m21 * m.m21),
+            std::sqrt(m.m12 * m.m12 + m.m22 * m.m22));
+        return s > 0 ? s : 1.f;
+    }
+
+    Rect CyroRenderTargetCpu::getClipRect() const {
+        if (!surface_) {
+            return {};
+        }
+
+        Rect bounds(0, 0, surface_->getPixelWidth(), surface_->getPixelHeight());
+        if (!clip_stack_.empty()) {
+            bounds.same(clip_stack_.back());
+        }
+        return bounds;
+    }
+
+    CyroRenderTargetCpu::Shader CyroRenderTargetCpu::makeShader(const Paint& paint) const {
+        Shader shader;
+        shader.opacity = opacity_;
+
+        if (paint.getStyle() == Paint::Style::IMAGE && paint.getImage()) {
+            auto img = static_cast<const ImageFrameCpu*>(paint.getImage());
+            RectF bounds(PointF(0, 0), img->getSize());
+
+            shader.image = img;
+            shader.to_image = makeImageMatrix(img, bounds, bounds);
+            shader.x_em = paint.getImageExtendModeX();
+            shader.y_em = paint.getImageExtendModeY();
+        } else {
+            toPremultiplied(paint.getColor(), shader.color);
+        }
+        return shader;
+    }
+
+    Matrix2x3F CyroRenderTargetCpu::makeImageMatrix(
+        const ImageFrameCpu* img, const RectF& src, const RectF& dst) const
+    {
+        // 设备坐标 -> 用户坐标 -> 图像 DIP 坐标 -> 图像像素坐标
+        Matrix2x3F inv;
+        if (!invert(getDeviceMatrix(), &inv)) {
+            return Matrix2x3F::scale(0, 0);
+        }
+
+        auto size = img->getSize();
+        float px_sx = size.width() > 0 ? img->getPixelWidth() / size.width() : 1.f;
+        float px_sy = size.height() > 0 ? img->getPixelHeight() / size.height() : 1.f;
+
+        return Matrix2x3F::scale(px_sx, px_sy) *
+            Matrix2x3F::translate(src.x(), src.y()) *
+            Matrix2x3F::scale(src.width() / dst.width(), src.height() / dst.height()) *
+            Matrix2x3F::translate(-dst.x(), -dst.y()) *
+            inv;
+    }
+
+    void CyroRenderTargetCpu::fillPolygons(
+        const std::vector<Polygon>& polygons, const Shader& shader)
+    {
+        if (!surface_ || polygons.empty()) {
+            return;
+        }
+
+        rasterizer_.reset(getClipRect());
+        for (const auto& polygon : polygons) {
+            rasterizer_.addPolygon(polygon);
+        }
+
+        Rect bounds;
+        if (!rasterizer_.rasterize(&bounds)) {
+            return;
+        }
+
+        auto bpp = surface_->getBytesPerPixel();
+        for (int y = bounds.y(); y < bounds.bottom(); ++y) {
+            auto row = surface_->getPixels() + y * surface_->getStride() + bounds.x() * bpp;
+            shadeRow(
+                bounds.x(), y, bounds.width(),
+                rasterizer_.getCoverageRow(y), shader, row);
+        }
+    }
+
+    void CyroRenderTargetCpu::fillOrStroke(
+        const Polygon& fill, const Polygon& outer, const Polygon& inner,
+        const Paint& paint)
+    {
+        std::vector<Polygon> polygons;
+        if (paint.getStyle() == Paint::Style::STROKE) {
+            polygons.push_back(outer);
+            if (!inner.empty()) {
+                // 内轮廓反向，与外轮廓围成环形
+                polygons.push_back(inner);
+                std::reverse(polygons.back().begin(), polygons.back().end());
+            }
+        } else {
+            polygons.push_back(fill);
+        }
+
+        for (auto& polygon : polygons) {
+            toDevice(&polygon);
+        }
+        fillPolygons(polygons, makeShader(paint));
+    }
+
+    void CyroRenderTargetCpu::strokePolyline(
+        const Polygon& points, bool closed, float width,
+        std::vector<Polygon>* out) const
+    {
+        size_t count = points.size();
+        if (count < 2 || width <= 0) {
+            return;
+        }
+
+        float half = width / 2;
+        size_t seg_count = closed ? count : count - 1;
+        for (size_t i = 0; i < seg_count; ++i) {
+            auto& p0 = points[i];
+            auto& p1 = points[(i + 1) % count];
+
+            float dx = p1.x() - p0.x();
+            float dy = p1.y() - p0.y();
+            float len = std::sqrt(dx * dx + dy * dy);
+            if (len == 0) {
+                continue;
+            }
+
+            float nx = -dy / len * half;
+            float ny = dx / len * half;
+
+            Polygon quad{
+                { p0.x() + nx, p0.y() + ny },
+                { p1.x() + nx, p1.y() + ny },
+                { p1.x() - nx, p1.y() - ny },
+                { p0.x() - nx, p0.y() - ny },
+            };
+            toDevice(&quad);
+            normalizeWinding(&quad);
+            out->push_back(std::move(quad));
+        }
+
+        // 在折点处补上圆形连接
+        size_t join_start = closed ? 0 : 1;
+        size_t join_end = closed ? count : count - 1;
+        for (size_t i = join_start; i < join_end; ++i) {
+            auto join = makeEllipse(points[i].x(), points[i].y(), half, half);
+            toDevice(&join);
+            normalizeWinding(&join);
+            out->push_back(std::move(join));
+        }
+    }
+
+    void CyroRenderTargetCpu::toDevice(Polygon* polygon) const {
+        auto m = getDeviceMatrix();
+        for (auto& p : *polygon) {
+            m.transformPoint(&p);
+        }
+    }
+
+    void CyroRenderTargetCpu::shadeRow(
+        int x, int y, int width,
+        const uint8_t* coverage, const Shader& shader, uint8_t* dst)
+    {
+        uint32_t opacity = uint32_t(clamp01(shader.opacity) * 255 + 0.5f);
+        if (opacity == 0) {
+            return;
+        }
+
+        if (surface_->getBytesPerPixel() == 1) {
+            shadeRowA8(x, y, width, opacity, coverage, shader, dst);
+            return;
+        }
+
+        auto dst32 = reinterpret_cast<uint32_t*>(dst);
+        bool full_cov = std::all_of(
+            coverage, coverage + width, [](uint8_t c) { return c == 255; });
+
+        if (!shader.image) {
+            uint8_t color[4];
+            for (int c = 0; c < 4; ++c) {
+                color[c] = uint8_t(mul255(shader.color[c], opacity));
+            }
+            uint32_t color32 = packPixel(color);
+
+            if (!full_cov) {
+                kernels_.blendSolidMask(dst32, coverage, width, color32);
+            } else if (color[3] == 255) {
+                kernels_.fill(dst32, width, color32);
+            } else {
+                kernels_.blendSolid(dst32, width, color32);
+            }
+            return;
+        }
+
+        auto src = sampleRow(x, y, width, shader);
+        if (full_cov && !shader.mask) {
+            if (opacity == 255) {
+                kernels_.blend(dst32, src, width);
+            } else {
+                kernels_.blendOpacity(dst32, src, width, uint8_t(opacity));
+            }
+            return;
+        }
+
+        cov_row_.resize(width);
+        for (int i = 0; i < width; ++i) {
+            cov_row_[i] = uint8_t(mul255(coverage[i], opacity));
+        }
+
+        if (shader.mask) {
+            for (int i = 0; i < width; ++i) {
+                if (cov_row_[i] == 0) {
+                    continue;
+                }
+
+                PointF mp(x + i + 0.5f, y + 0.5f);
+                auto mm = shader.to_mask;
+                mm.transformPoint(&mp);
+
+                float mask[4];
+                sampleBilinear(
+                    shader.mask, mp.x(), mp.y(),
+                    Paint::ImageExtendMode::CLAMP, Paint::ImageExtendMode::CLAMP, mask);
+                cov_row_[i] = uint8_t(mul255(cov_row_[i], uint32_t(mask[3] + 0.5f)));
+            }
+        }
+
+        kernels_.blendMask(dst32, src, cov_row_.data(), width);
+    }
+
+    void CyroRenderTargetCpu::shadeRowA8(
+        int x, int y, int width, uint32_t opacity,
+        const uint8_t* coverage, const Shader& shader, uint8_t* dst)
+    {
+        for (int i = 0; i < width; ++i) {
+            uint32_t cov = mul255(coverage[i], opacity);
+            if (cov == 0) {
+                continue;
+            }
+
+            uint32_t src_a;
+            if (shader.image) {
+                float px = x + i + 0.5f;
+                float py = y + 0.5f;
+
+                PointF ip(px, py);
+                auto m = shader.to_image;
+                m.transformPoint(&ip);
+
+                float sample[4];
+                sampleBilinear(shader.image, ip.x(), ip.y(), shader.x_em, shader.y_em, sample);
+
+                if (shader.mask) {
+                    PointF mp(px, py);
+                    auto mm = shader.to_mask;
+                    mm.transformPoint(&mp);
+
+                    float mask[4];
+                    sampleBilinear(
+                        shader.mask, mp.x(), mp.y(),
+                        Paint::ImageExtendMode::CLAMP, Paint::ImageExtendMode::CLAMP, mask);
+                    cov = mul255(cov, uint32_t(mask[3] + 0.5f));
+                }
+                src_a = mul255(uint32_t(sample[3] + 0.5f), cov);
+            } else {
+                src_a = mul255(shader.color[3], cov);
+            }
+
+            dst[i] = uint8_t(src_a + mul255(dst[i], 255 - src_a));
+        }
+    }
+
+    const uint32_t* CyroRenderTargetCpu::sampleRow(
+        int x, int y, int width, const Shader& shader)
+    {
+        auto img = shader.image;
+        auto m = shader.to_image;
+
+        // 图像与设备像素一一对应时，直接使用图像的像素行
+        if (img->getBytesPerPixel() == 4 &&
+            m.m11 == 1 && m.m12 == 0 && m.m21 == 0 && m.m22 == 1 &&
+            m.m13 == std::floor(m.m13) && m.m23 == std::floor(m.m23))
+        {
+            int sx = x + int(m.m13);
+            int sy = y + int(m.m23);
+            if (sx >= 0 && sx + width <= img->getPixelWidth() &&
+                sy >= 0 && sy < img->getPixelHeight())
+            {
+                auto row = img->getPixels() + sy * img->getStride();
+                return reinterpret_cast<const uint32_t*>(row) + sx;
+            }
+        }
+
+        src_row_.resize(width);
+        for (int i = 0; i < width; ++i) {
+            PointF ip(x + i + 0.5f, y + 0.5f);
+            m.transformPoint(&ip);
+
+            float sample[4];
+            sampleBilinear(img, ip.x(), ip.y(), shader.x_em, shader.y_em, sample);
+
+            uint8_t px[4];
+            for (int c = 0; c < 4; ++c) {
+                px[c] = uint8_t(sample[c] + 0.5f);
+            }
+            src_row_[i] = packPixel(px);
+        }
+        return src_row_.data();
+    }
+
+    int CyroRenderTargetCpu::arcSegments(float radius) const {
+        // 使每段弦与圆弧间的距离不超过 kFlattenTolerance
+        float r = radius * getDeviceScale();
+        if (r <= kFlattenTolerance) {
+            return 8;
+        }
+
+        float theta = std::sqrt(8 * kFlattenTolerance / r);
+        int n = int(std::ceil(2 * 3.1415926535898f / theta));
+        return std::clamp(n, 8, 1024);
+    }
+
+    void CyroRenderTargetCpu::addArc(
+        float cx, float cy, float rx, float ry,
+        float start, float sweep, Polygon* out) const
+    {
+        int total = arcSegments((std::max)(rx, ry));
+        int n = (std::max)(1, int(std::ceil(total * std::abs(sweep) / (2 * 3.1415926535898f))));
+        for (int i = 0; i <= n; ++i) {
+            float a = start + sweep * i / n;
+            out->push_back({ cx + rx * std::cos(a), cy + ry * std::sin(a) });
+        }
+    }
+
+    CyroRenderTargetCpu::Polygon CyroRenderTargetCpu::makeRect(const RectF& rect) const {
+        return {
+            { rect.x(), rect.y() },
+            { rect.right(), rect.y() },
+            { rect.right(), rect.bottom() },
+            { rect.x(), rect.bottom() },
+        };
+    }
+
+    CyroRenderTargetCpu::Polygon CyroRenderTargetCpu::makeRoundRect(
+        const RectF& rect, float radius) const
+    {
+        radius = (std::min)({ radius, rect.width() / 2, rect.height() / 2 });
+        if (radius <= 0) {
+            return makeRect(rect);
+        }
+
+        const float pi = 3.1415926535898f;
+        float l = rect.x() + radius;
+        float t = rect.y() + radius;
+        float r = rect.right() - radius;
+        float b = rect.bottom() - radius;
+
+        Polygon polygon;
+        addArc(r, t, radius, radius, -pi / 2, pi / 2, &polygon);
+        addArc(r, b, radius, radius, 0, pi / 2, &polygon);
+        addArc(l, b, radius, radius, pi / 2, pi / 2, &polygon);
+        addArc(l, t, radius, radius, pi, pi / 2, &polygon);
+        return polygon;
+    }
+
+    CyroRenderTargetCpu::Polygon CyroRenderTargetCpu::makeEllipse(
+        float cx, float cy, float rx, float ry) const
+    {
+        Polygon polygon;
+        if (rx <= 0 || ry <= 0) {
+            return polygon;
+        }
+
+        addArc(cx, cy, rx, ry, 0, 2 * 3.1415926535898f, &polygon);
+        polygon.pop_back();
+        return polygon;
+    }
+
+}
+}
@@ -0,0 +1,179 @@
+// Copyright (c) 2016 ucclkp <ucclkp@gmail.com>.
+// This file is part of ukive project.
+//
+// This program is licensed under GPLv3 license that can be
+// found in the LICENSE file.
+
+#ifndef UKIVE_GRAPHICS_CPU_CYRO_RENDER_TARGET_CPU_H_
+#define UKIVE_GRAPHICS_CPU_CYRO_RENDER_TARGET_CPU_H_
+
+#include <vector>
+
+#include "ukive/graphics/canvas_stack.hpp"
+#include "ukive/graphics/cyro_render_target.h"
+#include "ukive/graphics/matrix_2x3.hpp"
+#include "ukive/graphics/paint.h"
+#include "ukive/graphics/cpu/image_frame_cpu.h"
+#include "ukive/graphics/cpu/pixel_kernels.h"
+#include "ukive/graphics/cpu/rasterizer_cpu.h"
+
+
+namespace ukive {
+namespace cpu {
+
+    /**
+     * 将图元光栅化到内存中 BGRA 位图的渲染目标，用于 Windows 和 macOS 上的离屏渲染。
+     * 不依赖 GPU，但文本布局、窗口等其他部分仍由平台实现提供，
+     * 因此不能单独用于没有平台实现的环境；工厂函数也不会选择该后端，需要直接构造。
+     * 没有字体光栅化器，不绘制文本。
+     * 只能配合 OffscreenBufferCpu 使用。
+     */
+    class CyroRenderTargetCpu : public CyroRenderTarget {
+    public:
+        CyroRenderTargetCpu();
+        ~CyroRenderTargetCpu();
+
+        bool onCreate(CyroBuffer* buffer) override;
+        void onDestroy() override;
+
+        CyroBuffer* getBuffer() const override;
+
+        GPtr<ImageFrame> createImage(const GPtr<LcImageFrame>& frame) override;
+        GPtr<ImageFrame> createImage(
+            int width, int height, const ImageOptions& options) override;
+        GPtr<ImageFrame> createImage(
+            int width, int height,
+            const GPtr<ByteData>& pixel_data, size_t stride,
+            const ImageOptions& options) override;
+        GPtr<ImageFrame> createImage(
+            const GPtr<GPUTexture>& tex2d, const ImageOptions& options) override;
+
+        void setOpacity(float opacity) override;
+        float getOpacity() const override;
+
+        Size getSize() const override;
+        Size getPixelSize() const override;
+        Matrix2x3F getMatrix() const override;
+
+        void onBeginDraw() override;
+        GRet onEndDraw() override;
+        GRet onResize(int width, int height) override;
+
+        void clear() override;
+        void clear(const Color& c) override;
+
+        void pushClip(const RectF& rect) override;
+        void popClip() override;
+
+        void save() override;
+        void restore() override;
+
+        void scale(float sx, float sy, const PointF& c) override;
+        void rotate(float angle, const PointF& c) override;
+        void translate(float dx, float dy) override;
+        void concat(const Matrix2x3F& matrix) override;
+
+        void drawPoint(const PointF& p, const Paint& paint) override;
+        void drawLine(
+            const PointF& start, const PointF& end, const Paint& paint) override;
+        void drawRect(const RectF& rect, const Paint& paint) override;
+        void drawRoundRect(
+            const RectF& rect, float radius, const Paint& paint) override;
+        void drawCircle(const PointF& c, float radius, const Paint& paint) override;
+        void drawEllipse(
+            const PointF& c, float rx, float ry, const Paint& paint) override;
+        void drawPath(const Path* path, const Paint& paint) override;
+        void drawImage(
+            const RectF& src, const RectF& dst, float opacity, ImageFrame* img) override;
+
+        void fillOpacityMask(
+            float width, float height, ImageFrame* mask, ImageFrame* content) override;
+
+        void drawText(
+            const std::u16string_view& text,
+            const std::u16string_view& font_name, float font_size,
+            const RectF& rect, const Paint& paint) override;
+        void drawTextLayout(
+            float x, float y,
+            TextLayout* layout, const Paint& paint) override;
+
+    private:
+        using Polygon = std::vector<PointF>;
+
+        struct StackData {
+            float opacity;
+            Matrix2x3F matrix;
+        };
+
+        /**
+         * 图元的着色方式。
+         * 若 image 为空，使用 color 填充。
+         */
+        struct Shader {
+            uint8_t color[4] = { 0, 0, 0, 0 };
+            float opacity = 1;
+
+            // 从设备像素坐标到图像像素坐标的变换
+            const ImageFrameCpu* image = nullptr;
+            Matrix2x3F to_image;
+            Paint::ImageExtendMode x_em = Paint::ImageExtendMode::CLAMP;
+            Paint::ImageExtendMode y_em = Paint::ImageExtendMode::CLAMP;
+
+            // 从设备像素坐标到遮罩像素坐标的变换
+            const ImageFrameCpu* mask = nullptr;
+            Matrix2x3F to_mask;
+        };
+
+        void refreshSurface();
+        void warnTextUnsupported();
+        Matrix2x3F getDeviceMatrix() const;
+        float getDeviceScale() const;
+        Rect getClipRect() const;
+
+        Shader makeShader(const Paint& paint) const;
+        Matrix2x3F makeImageMatrix(
+            const ImageFrameCpu* img, const RectF& src, const RectF& dst) const;
+        void fillPolygons(const std::vector<Polygon>& polygons, const Shader& shader);
+        void fillOrStroke(
+            const Polygon& fill, const Polygon& outer, const Polygon& inner,
+            const Paint& paint);
+        void strokePolyline(
+            const Polygon& points, bool closed, float width,
+            std::vector<Polygon>* out) const;
+        void toDevice(Polygon* polygon) const;
+
+        void shadeRow(
+            int x, int y, int width,
+            const uint8_t* coverage, const Shader& shader, uint8_t* dst);
+        void shadeRowA8(
+            int x, int y, int width, uint32_t opacity,
+            const uint8_t* coverage, const Shader& shader, uint8_t* dst);
+        const uint32_t* sampleRow(int x, int y, int width, const Shader& shader);
+
+        int arcSegments(float radius) const;
+        void addArc(
+            float cx, float cy, float rx, float ry,
+            float start, float sweep, Polygon* out) const;
+        Polygon makeRect(const RectF& rect) const;
+        Polygon makeRoundRect(const RectF& rect, float radius) const;
+        Polygon makeEllipse(float cx, float cy, float rx, float ry) const;
+
+        float opacity_ = 1;
+        Matrix2x3F matrix_;
+        CanvasStack<StackData> save_stack_;
+        std::vector<Rect> clip_stack_;
+
+        CyroBuffer* buffer_ = nullptr;
+        GPtr<ImageFrameCpu> surface_;
+        RasterizerCpu rasterizer_;
+
+        const PixelKernels& kernels_;
+        std::vector<uint32_t> src_row_;
+        std::vector<uint8_t> cov_row_;
+        bool is_text_warned_ = false;
+    };
+
+}
+}
+
+#endif  // UKIVE_GRAPHICS_CPU_CYRO_RENDER_TARGET_CPU_H_
@@ -0,0 +1,147 @@
+// Copyright (c) 2016 ucclkp <ucclkp@gmail.com>.
+// This file is part of ukive project.
+//
+// This program is licensed under GPLv3 license that can be
+// found in the LICENSE file.
+
+#include "ukive/graphics/cpu/image_frame_cpu.h"
+
+#include <cstring>
+#include <memory>
+
+#include "ukive/window/window_dpi_utils.h"
+
+
+namespace ukive {
+namespace cpu {
+
+    // static
+    GPtr<ImageFrameCpu> ImageFrameCpu::create(
+        int px_width, int px_height, const ImageOptions& options)
+    {
+        if (px_width <= 0 || px_height <= 0) {
+            return {};
+        }
+
+        size_t bpp = (options.pixel_format == ImagePixelFormat::R8_UNORM) ? 1 : 4;
+        size_t stride = px_width * bpp;
+        size_t size = stride * px_height;
+
+        std::unique_ptr<unsigned char[]> buf(new unsigned char[size]);
+        std::memset(buf.get(), 0, size);
+
+        auto img = new ImageFrameCpu(
+            options, px_width, px_height, stride, ByteData::ownUni(std::move(buf), size));
+        return GPtr<ImageFrameCpu>(img);
+    }
+
+    // static
+    GPtr<ImageFrameCpu> ImageFrameCpu::create(
+        int px_width, int px_height,
+        const void* pixel_data, size_t stride,
+        const ImageOptions& options)
+    {
+        auto img = create(px_width, px_height, options);
+        if (!img || !pixel_data) {
+            return img;
+        }
+
+        auto src = static_cast<const uint8_t*>(pixel_data);
+        auto dst = img->getPixels();
+        size_t row_size = px_width * img->getBytesPerPixel();
+        bool premultiply =
+            img->getBytesPerPixel() == 4 &&
+            options.alpha_mode == ImageAlphaMode::STRAIGHT;
+
+        for (int y = 0; y < px_height; ++y) {
+            auto s = src + y * stride;
+            auto d = dst + y * img->getStride();
+            if (!premultiply) {
+                std::memcpy(d, s, row_size);
+                continue;
+            }
+
+            for (int x = 0; x < px_width; ++x) {
+                uint32_t a = s[3];
+                d[0] = uint8_t((s[0] * a + 127) / 255);
+                d[1] = uint8_t((s[1] * a + 127) / 255);
+                d[2] = uint8_t((s[2] * a + 127) / 255);
+                d[3] = uint8_t(a);
+                s += 4;
+                d += 4;
+            }
+        }
+        return img;
+    }
+
+    ImageFrameCpu::ImageFrameCpu(
+        const ImageOptions& options,
+        int px_width, int px_height, size_t stride,
+        const GPtr<ByteData>& pixels)
+        : ImageFrame(options),
+          px_width_(px_width),
+          px_height_(px_height),
+          stride_(stride),
+          dpi_x_(float(kDefaultDpi)),
+          dpi_y_(float(kDefaultDpi)),
+          pixels_(pixels)
+    {
+        if (options.dpi_type == ImageDPIType::SPECIFIED) {
+            setDpi(options.dpi_x, options.dpi_y);
+        }
+    }
+
+    void ImageFrameCpu::setDpi(float dpi_x, float dpi_y) {
+        if (dpi_x > 0 && dpi_y > 0) {
+            dpi_x_ = dpi_x;
+            dpi_y_ = dpi_y;
+        }
+    }
+
+    void ImageFrameCpu::getDpi(float* dpi_x, float* dpi_y) const {
+        *dpi_x = dpi_x_;
+        *dpi_y = dpi_y_;
+    }
+
+    SizeF ImageFrameCpu::getSize() const {
+        return SizeF(
+            px_width_ * float(kDefaultDpi) / dpi_x_,
+            px_height_ * float(kDefaultDpi) / dpi_y_);
+    }
+
+    SizeU ImageFrameCpu::getPixelSize() const {
+        return SizeU(px_width_, px_height_);
+    }
+
+    size_t ImageFrameCpu::getBytesPerPixel() const {
+        return (getOptions().pixel_format == ImagePixelFormat::R8_UNORM) ? 1 : 4;
+    }
+
+    uint8_t* ImageFrameCpu::getPixels() {
+        return static_cast<uint8_t*>(pixels_->getData());
+    }
+
+    const uint8_t* ImageFrameCpu::getPixels() const {
+        return static_cast<const uint8_t*>(pixels_->getConstData());
+    }
+
+    void ImageFrameCpu::getPixel(int x, int y, uint8_t bgra[4]) const {
+        auto p = getPixels() + y * stride_;
+        if (getBytesPerPixel() == 1) {
+            auto v = p[x];
+            bgra[0] = v;
+            bgra[1] = v;
+            bgra[2] = v;
+            bgra[3] = v;
+            return;
+        }
+
+        p += x * 4;
+        bgra[0] = p[0];
+        bgra[1] = p[1];
+        bgra[2] = p[2];
+        bgra[3] = p[3];
+    }
+
+}
+}
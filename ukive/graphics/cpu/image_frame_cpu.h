@@ -0,0 +1,83 @@
+// Copyright (c) 2016 ucclkp <ucclkp@gmail.com>.
+// This file is part of ukive project.
+//
+// This program is licensed under GPLv3 license that can be
+// found in the LICENSE file.
+
+#ifndef UKIVE_GRAPHICS_CPU_IMAGE_FRAME_CPU_H_
+#define UKIVE_GRAPHICS_CPU_IMAGE_FRAME_CPU_H_
+
+#include <cstdint>
+
+#include "ukive/graphics/byte_data.h"
+#include "ukive/graphics/gptr.hpp"
+#include "ukive/graphics/gref_count_impl.h"
+#include "ukive/graphics/images/image_frame.h"
+
+
+namespace ukive {
+namespace cpu {
+
+    /**
+     * 内存中的位图。
+     * 像素格式为预乘的 B8G8R8A8_UNORM 或 R8_UNORM，
+     * 由 CPU 光栅化器直接读写。
+     */
+    class ImageFrameCpu :
+        public ImageFrame,
+        public GRefCountImpl
+    {
+    public:
+        /**
+         * 创建指定像素大小的位图，内容初始化为全透明。
+         */
+        static GPtr<ImageFrameCpu> create(
+            int px_width, int px_height, const ImageOptions& options);
+
+        /**
+         * 创建位图并从 pixel_data 复制像素。
+         * STRAIGHT 的 BGRA 数据会被转换为预乘格式。
+         */
+        static GPtr<ImageFrameCpu> create(
+            int px_width, int px_height,
+            const void* pixel_data, size_t stride,
+            const ImageOptions& options);
+
+        ImageFrameCpu(
+            const ImageOptions& options,
+            int px_width, int px_height, size_t stride,
+            const GPtr<ByteData>& pixels);
+
+        void setDpi(float dpi_x, float dpi_y) override;
+        void getDpi(float* dpi_x, float* dpi_y) const override;
+
+        SizeF getSize() const override;
+        SizeU getPixelSize() const override;
+
+        int getPixelWidth() const { return px_width_; }
+        int getPixelHeight() const { return px_height_; }
+        size_t getStride() const { return stride_; }
+        size_t getBytesPerPixel() const;
+
+        uint8_t* getPixels();
+        const uint8_t* getPixels() const;
+
+        /**
+         * 取得指定像素的预乘 BGRA 值。
+         * 对于 R8_UNORM 位图，返回的四个分量均为该像素的值。
+         */
+        void getPixel(int x, int y, uint8_t bgra[4]) const;
+
+    private:
+        int px_width_;
+        int px_height_;
+        size_t stride_;
+        float dpi_x_;
+        float dpi_y_;
+        GPtr<ByteData> pixels_;
+    };
+
+}
+}
+
+#endif  // UKIVE_GRAPHICS_CPU_IMAGE_FRAME_CPU_H_
@@ -0,0 +1,26 @@
+// Copyright (c) 2016 ucclkp <ucclkp@gmail.com>.
+// This file is part of ukive project.
+//
+// This program is licensed under GPLv3 license that can be
+// found in the LICENSE file.
+
+#include "ukive/graphics/cpu/native_rt_cpu.h"
+
+
+namespace ukive {
+namespace cpu {
+
+    void NativeRTCpu::destroy() {
+        surface_.reset();
+    }
+
+    void NativeRTCpu::setNative(const GPtr<ImageFrameCpu>& surface) {
+        surface_ = surface;
+    }
+
+    GPtr<ImageFrameCpu> NativeRTCpu::getNative() const {
+        return surface_;
+    }
+
+}
+}
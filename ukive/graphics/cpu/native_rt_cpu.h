@@ -0,0 +1,33 @@
+// Copyright (c) 2016 ucclkp <ucclkp@gmail.com>.
+// This file is part of ukive project.
+//
+// This program is licensed under GPLv3 license that can be
+// found in the LICENSE file.
+
+#ifndef UKIVE_GRAPHICS_CPU_NATIVE_RT_CPU_H_
+#define UKIVE_GRAPHICS_CPU_NATIVE_RT_CPU_H_
+
+#include "ukive/graphics/native_rt.h"
+#include "ukive/graphics/cpu/image_frame_cpu.h"
+
+
+namespace ukive {
+namespace cpu {
+
+    class NativeRTCpu : public NativeRT {
+    public:
+        NativeRTCpu() = default;
+
+        void destroy() override;
+
+        void setNative(const GPtr<ImageFrameCpu>& surface);
+        GPtr<ImageFrameCpu> getNative() const;
+
+    private:
+        GPtr<ImageFrameCpu> surface_;
+    };
+
+}
+}
+
+#endif  // UKIVE_GRAPHICS_CPU_NATIVE_RT_CPU_H_
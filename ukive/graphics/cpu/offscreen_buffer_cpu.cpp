@@ -0,0 +1,152 @@
+// Copyright (c) 2016 ucclkp <ucclkp@gmail.com>.
+// This file is part of ukive project.
+//
+// This program is licensed under GPLv3 license that can be
+// found in the LICENSE file.
+
+#include "ukive/graphics/cpu/offscreen_buffer_cpu.h"
+
+#include <cmath>
+#include <cstring>
+
+#include "utils/log.h"
+
+#include "ukive/window/window_dpi_utils.h"
+
+
+namespace ukive {
+namespace cpu {
+
+    OffscreenBufferCpu::OffscreenBufferCpu()
+        : width_(0), height_(0) {}
+
+    bool OffscreenBufferCpu::createBuffer() {
+        float sx, sy;
+        switch (img_options_.dpi_type) {
+        case ImageDPIType::SPECIFIED:
+            sx = img_options_.dpi_x / float(kDefaultDpi);
+            sy = img_options_.dpi_y / float(kDefaultDpi);
+            break;
+        default:
+            sx = sy = 1;
+            break;
+        }
+
+        int px = int(std::ceil(width_ * sx));
+        int py = int(std::ceil(height_ * sy));
+
+        auto surface = ImageFrameCpu::create(px, py, img_options_);
+        if (!surface) {
+            return false;
+        }
+
+        nrt_.setNative(surface);
+        return true;
+    }
+
+    bool OffscreenBufferCpu::onCreate(
+        int width, int height, const ImageOptions& options)
+    {
+        if (width <= 0 || height <= 0) {
+            DLOG(Log::ERR) << "Invalid size value.";
+            return false;
+        }
+
+        width_ = width;
+        height_ = height;
+        img_options_ = options;
+        return createBuffer();
+    }
+
+    GRet OffscreenBufferCpu::onResize(int width, int height) {
+        if (width <= 0 || height <= 0) {
+            DLOG(Log::WARNING) << "Invalid size value.";
+            return GRet::Succeeded;
+        }
+
+        if (width == width_ && height == height_ && nrt_.getNative()) {
+            return GRet::Succeeded;
+        }
+
+        width_ = width;
+        height_ = height;
+        nrt_.destroy();
+        return createBuffer() ? GRet::Succeeded : GRet::Failed;
+    }
+
+    void OffscreenBufferCpu::onDPIChange(float dpi_x, float dpi_y) {
+        if (dpi_x <= 0 || dpi_y <= 0) {
+            DLOG(Log::ERR) << "Invalid dpi values.";
+            return;
+        }
+
+        img_options_.dpi_x = dpi_x;
+        img_options_.dpi_y = dpi_y;
+        img_options_.dpi_type = ImageDPIType::SPECIFIED;
+
+        nrt_.destroy();
+        createBuffer();
+    }
+
+    void OffscreenBufferCpu::onDestroy() {
+        nrt_.destroy();
+    }
+
+    void OffscreenBufferCpu::onBeginDraw() {}
+
+    GRet OffscreenBufferCpu::onEndDraw() {
+        return nrt_.getNative() ? GRet::Succeeded : GRet::Failed;
+    }
+
+    GPtr<ImageFrame> OffscreenBufferCpu::onExtractImage(const ImageOptions& options) {
+        auto surface = nrt_.getNative();
+        if (!surface) {
+            return {};
+        }
+
+        // 表面的像素已是预乘格式，直接复制
+        auto img = ImageFrameCpu::create(
+            surface->getPixelWidth(), surface->getPixelHeight(), surface->getOptions());
+        if (!img) {
+            return {};
+        }
+
+        size_t row_size = surface->getPixelWidth() * surface->getBytesPerPixel();
+        for (int y = 0; y < surface->getPixelHeight(); ++y) {
+            std::memcpy(
+                img->getPixels() + y * img->getStride(),
+                surface->getPixels() + y * surface->getStride(), row_size);
+        }
+
+        if (options.dpi_type == ImageDPIType::SPECIFIED) {
+            img->setDpi(options.dpi_x, options.dpi_y);
+        }
+        return GPtr<ImageFrame>(img.detach());
+    }
+
+    Size OffscreenBufferCpu::getSize() const {
+        return Size(width_, height_);
+    }
+
+    Size OffscreenBufferCpu::getPixelSize() const {
+        auto surface = nrt_.getNative();
+        if (!surface) {
+            return {};
+        }
+        return Size(surface->getPixelWidth(), surface->getPixelHeight());
+    }
+
+    const NativeRT* OffscreenBufferCpu::getNativeRT() const {
+        return &nrt_;
+    }
+
+    const ImageOptions& OffscreenBufferCpu::getImageOptions() const {
+        return img_options_;
+    }
+
+    GPtr<ImageFrameCpu> OffscreenBufferCpu::getSurface() const {
+        return nrt_.getNative();
+    }
+
+}
+}
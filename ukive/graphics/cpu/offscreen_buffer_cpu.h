@@ -0,0 +1,57 @@
+// Copyright (c) 2016 ucclkp <ucclkp@gmail.com>.
+// This file is part of ukive project.
+//
+// This program is licensed under GPLv3 license that can be
+// found in the LICENSE file.
+
+#ifndef UKIVE_GRAPHICS_CPU_OFFSCREEN_BUFFER_CPU_H_
+#define UKIVE_GRAPHICS_CPU_OFFSCREEN_BUFFER_CPU_H_
+
+#include "ukive/graphics/cyro_buffer.h"
+#include "ukive/graphics/images/image_options.h"
+#include "ukive/graphics/cpu/native_rt_cpu.h"
+
+
+namespace ukive {
+namespace cpu {
+
+    /**
+     * 位于内存中的离屏缓冲。
+     * 不依赖任何图形设备，配合 CyroRenderTargetCpu 进行离屏渲染。
+     */
+    class OffscreenBufferCpu : public OffscreenBuffer {
+    public:
+        OffscreenBufferCpu();
+
+        bool onCreate(
+            int width, int height,
+            const ImageOptions& options) override;
+        GRet onResize(int width, int height) override;
+        void onDPIChange(float dpi_x, float dpi_y) override;
+        void onDestroy() override;
+
+        void onBeginDraw() override;
+        GRet onEndDraw() override;
+
+        GPtr<ImageFrame> onExtractImage(const ImageOptions& options) override;
+
+        Size getSize() const override;
+        Size getPixelSize() const override;
+
+        const NativeRT* getNativeRT() const override;
+        const ImageOptions& getImageOptions() const override;
+
+        GPtr<ImageFrameCpu> getSurface() const;
+
+    private:
+        bool createBuffer();
+
+        int width_, height_;
+        ImageOptions img_options_;
+        NativeRTCpu nrt_;
+    };
+
+}
+}
+
+#endif  // UKIVE_GRAPHICS_CPU_OFFSCREEN_BUFFER_CPU_H_
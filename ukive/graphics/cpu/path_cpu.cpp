@@ -0,0 +1,105 @@
+// Copyright (c) 2016 ucclkp <ucclkp@gmail.com>.
+// This file is part of ukive project.
+//
+// This program is licensed under GPLv3 license that can be
+// found in the LICENSE file.
+
+#include "ukive/graphics/cpu/path_cpu.h"
+
+#include <algorithm>
+#include <cmath>
+
+
+namespace ukive {
+namespace cpu {
+
+    bool PathCpu::open() {
+        figures_.clear();
+        is_opened_ = true;
+        return true;
+    }
+
+    void PathCpu::begin(const PointF& start, bool fill) {
+        if (!is_opened_) {
+            return;
+        }
+
+        Figure figure;
+        figure.start = start;
+        figures_.push_back(std::move(figure));
+    }
+
+    void PathCpu::end(bool close) {
+        if (!is_opened_ || figures_.empty()) {
+            return;
+        }
+        figures_.back().closed = close;
+    }
+
+    bool PathCpu::close() {
+        is_opened_ = false;
+        return true;
+    }
+
+    void PathCpu::addLine(const PointF& p) {
+        if (!is_opened_ || figures_.empty()) {
+            return;
+        }
+        figures_.back().segments.push_back({ false, p, p });
+    }
+
+    void PathCpu::addQBezier(const PointF& p1, const PointF& p2) {
+        if (!is_opened_ || figures_.empty()) {
+            return;
+        }
+        figures_.back().segments.push_back({ true, p1, p2 });
+    }
+
+    void PathCpu::flatten(
+        const Matrix2x3F& matrix, float tolerance,
+        std::vector<Polyline>* out) const
+    {
+        auto m = matrix;
+        for (const auto& figure : figures_) {
+            Polyline line;
+            line.closed = figure.closed;
+
+            auto cur = figure.start;
+            m.transformPoint(&cur);
+            line.points.push_back(cur);
+
+            for (const auto& seg : figure.segments) {
+                auto p2 = seg.p2;
+                m.transformPoint(&p2);
+
+                if (seg.is_bezier) {
+                    auto p1 = seg.p1;
+                    m.transformPoint(&p1);
+
+                    // 二次贝塞尔曲线与其弦的最大距离为 |p0 - 2p1 + p2| / 4，
+                    // 细分为 n 段后距离缩小为原来的 1 / n²。
+                    float dx = cur.x() - 2 * p1.x() + p2.x();
+                    float dy = cur.y() - 2 * p1.y() + p2.y();
+                    float dev = std::sqrt(dx * dx + dy * dy) / 4;
+                    int n = int(std::ceil(std::sqrt(dev / tolerance)));
+                    n = std::clamp(n, 1, 256);
+
+                    for (int i = 1; i <= n; ++i) {
+                        float t = float(i) / n;
+                        float mt = 1 - t;
+                        float x = mt * mt * cur.x() + 2 * mt * t * p1.x() + t * t * p2.x();
+                        float y = mt * mt * cur.y() + 2 * mt * t * p1.y() + t * t * p2.y();
+                        line.points.push_back({ x, y });
+                    }
+                } else {
+                    line.points.push_back(p2);
+                }
+                cur = p2;
+            }
+
+            out->push_back(std::move(line));
+        }
+    }
+
+}
+}
@@ -0,0 +1,64 @@
+// Copyright (c) 2016 ucclkp <ucclkp@gmail.com>.
+// This file is part of ukive project.
+//
+// This program is licensed under GPLv3 license that can be
+// found in the LICENSE file.
+
+#ifndef UKIVE_GRAPHICS_CPU_PATH_CPU_H_
+#define UKIVE_GRAPHICS_CPU_PATH_CPU_H_
+
+#include <vector>
+
+#include "ukive/graphics/matrix_2x3.hpp"
+#include "ukive/graphics/path.h"
+
+
+namespace ukive {
+namespace cpu {
+
+    class PathCpu : public Path {
+    public:
+        struct Polyline {
+            std::vector<PointF> points;
+            bool closed;
+        };
+
+        PathCpu() = default;
+
+        bool open() override;
+        void begin(const PointF& start, bool fill) override;
+        void end(bool close) override;
+        bool close() override;
+
+        void addLine(const PointF& p) override;
+        void addQBezier(const PointF& p1, const PointF& p2) override;
+
+        /**
+         * 使用 matrix 变换路径，并将曲线展开为折线。
+         * @param tolerance 展开后的折线与曲线间允许的最大距离（设备像素）。
+         */
+        void flatten(
+            const Matrix2x3F& matrix, float tolerance,
+            std::vector<Polyline>* out) const;
+
+    private:
+        struct Segment {
+            bool is_bezier;
+            PointF p1;
+            PointF p2;
+        };
+
+        struct Figure {
+            PointF start;
+            std::vector<Segment> segments;
+            bool closed = false;
+        };
+
+        bool is_opened_ = false;
+        std::vector<Figure> figures_;
+    };
+
+}
+}
+
+#endif  // UKIVE_GRAPHICS_CPU_PATH_CPU_H_
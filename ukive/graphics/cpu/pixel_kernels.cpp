@@ -0,0 +1,432 @@
+// Copyright (c) 2016 ucclkp <ucclkp@gmail.com>.
+// This file is part of ukive project.
+//
+// This program is licensed under GPLv3 license that can be
+// found in the LICENSE file.
+
+#include "ukive/graphics/cpu/pixel_kernels.h"
+
+#include <cstring>
+
+#include "ukive/system/cpu_features.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define UKIVE_PIXEL_KERNELS_X86
+#endif
+
+#ifdef UKIVE_PIXEL_KERNELS_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define TARGET_SSE2
+#define TARGET_AVX2
+#else
+#define TARGET_SSE2  __attribute__((target("sse2")))
+#define TARGET_AVX2  __attribute__((target("avx2")))
+#endif
+#endif
+
+
+namespace {
+
+    using ukive::cpu::PixelKernels;
+
+    /**
+     * 标量实现。
+     * 一次处理一个像素中的两个通道（B/R 与 G/A）。
+     */
+    inline uint32_t scalePixel(uint32_t px, uint32_t k) {
+        uint32_t rb = (px & 0x00FF00FF) * k + 0x00800080;
+        rb = ((rb + ((rb >> 8) & 0x00FF00FF)) >> 8) & 0x00FF00FF;
+        uint32_t ag = ((px >> 8) & 0x00FF00FF) * k + 0x00800080;
+        ag = (ag + ((ag >> 8) & 0x00FF00FF)) & 0xFF00FF00;
+        return rb | ag;
+    }
+
+    inline uint32_t blendPixel(uint32_t dst, uint32_t src) {
+        return src + scalePixel(dst, 255 - (src >> 24));
+    }
+
+    void fillScalar(uint32_t* dst, size_t count, uint32_t color) {
+        for (size_t i = 0; i < count; ++i) {
+            dst[i] = color;
+        }
+    }
+
+    void blendSolidScalar(uint32_t* dst, size_t count, uint32_t color) {
+        uint32_t inv_a = 255 - (color >> 24);
+        for (size_t i = 0; i < count; ++i) {
+            dst[i] = color + scalePixel(dst[i], inv_a);
+        }
+    }
+
+    void blendSolidMaskScalar(
+        uint32_t* dst, const uint8_t* mask, size_t count, uint32_t color)
+    {
+        for (size_t i = 0; i < count; ++i) {
+            uint32_t m = mask[i];
+            if (m == 0) {
+                continue;
+            }
+            dst[i] = blendPixel(dst[i], m == 255 ? color : scalePixel(color, m));
+        }
+    }
+
+    void blendScalar(uint32_t* dst, const uint32_t* src, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            dst[i] = blendPixel(dst[i], src[i]);
+        }
+    }
+
+    void blendOpacityScalar(
+        uint32_t* dst, const uint32_t* src, size_t count, uint8_t opacity)
+    {
+        for (size_t i = 0; i < count; ++i) {
+            dst[i] = blendPixel(dst[i], scalePixel(src[i], opacity));
+        }
+    }
+
+    void blendMaskScalar(
+        uint32_t* dst, const uint32_t* src, const uint8_t* mask, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i) {
+            uint32_t m = mask[i];
+            if (m == 0) {
+                continue;
+            }
+            dst[i] = blendPixel(dst[i], m == 255 ? src[i] : scalePixel(src[i], m));
+        }
+    }
+
+    const PixelKernels kScalarKernels = {
+        PixelKernels::Level::SCALAR,
+        fillScalar,
+        blendSolidScalar,
+        blendSolidMaskScalar,
+        blendScalar,
+        blendOpacityScalar,
+        blendMaskScalar,
+    };
+
+
+#ifdef UKIVE_PIXEL_KERNELS_X86
+
+    /**
+     * SSE2 实现。
+     * 每次处理 4 个像素，像素展开为 16 位通道后计算。
+     */
+    TARGET_SSE2 inline __m128i div255x16(__m128i v) {
+        v = _mm_add_epi16(v, _mm_set1_epi16(128));
+        return _mm_srli_epi16(_mm_add_epi16(v, _mm_srli_epi16(v, 8)), 8);
+    }
+
+    TARGET_SSE2 inline __m128i alphaOf16(__m128i px16) {
+        px16 = _mm_shufflelo_epi16(px16, _MM_SHUFFLE(3, 3, 3, 3));
+        return _mm_shufflehi_epi16(px16, _MM_SHUFFLE(3, 3, 3, 3));
+    }
+
+    // 将 4 个遮罩值展开为与两个 16 位像素对应的通道
+    TARGET_SSE2 inline void expandMask4(const uint8_t* mask, __m128i* lo, __m128i* hi) {
+        int m;
+        std::memcpy(&m, mask, 4);
+        __m128i v = _mm_unpacklo_epi8(_mm_cvtsi32_si128(m), _mm_setzero_si128());
+        v = _mm_unpacklo_epi16(v, v);
+        *lo = _mm_unpacklo_epi32(v, v);
+        *hi = _mm_unpackhi_epi32(v, v);
+    }
+
+    TARGET_SSE2 inline __m128i blend16(__m128i dst16, __m128i src16) {
+        __m128i inv_a = _mm_sub_epi16(_mm_set1_epi16(255), alphaOf16(src16));
+        return _mm_add_epi16(src16, div255x16(_mm_mullo_epi16(dst16, inv_a)));
+    }
+
+    TARGET_SSE2 inline __m128i blend4(__m128i dst, __m128i src) {
+        __m128i zero = _mm_setzero_si128();
+        __m128i lo = blend16(_mm_unpacklo_epi8(dst, zero), _mm_unpacklo_epi8(src, zero));
+        __m128i hi = blend16(_mm_unpackhi_epi8(dst, zero), _mm_unpackhi_epi8(src, zero));
+        return _mm_packus_epi16(lo, hi);
+    }
+
+    TARGET_SSE2 inline __m128i blendMask4(__m128i dst, __m128i src, const uint8_t* mask) {
+        __m128i zero = _mm_setzero_si128();
+        __m128i m_lo, m_hi;
+        expandMask4(mask, &m_lo, &m_hi);
+
+        __m128i s_lo = div255x16(_mm_mullo_epi16(_mm_unpacklo_epi8(src, zero), m_lo));
+        __m128i s_hi = div255x16(_mm_mullo_epi16(_mm_unpackhi_epi8(src, zero), m_hi));
+        __m128i lo = blend16(_mm_unpacklo_epi8(dst, zero), s_lo);
+        __m128i hi = blend16(_mm_unpackhi_epi8(dst, zero), s_hi);
+        return _mm_packus_epi16(lo, hi);
+    }
+
+    TARGET_SSE2 void fillSSE2(uint32_t* dst, size_t count, uint32_t color) {
+        __m128i c = _mm_set1_epi32(int(color));
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), c);
+        }
+        fillScalar(dst + i, count - i, color);
+    }
+
+    TARGET_SSE2 void blendSolidSSE2(uint32_t* dst, size_t count, uint32_t color) {
+        __m128i zero = _mm_setzero_si128();
+        __m128i c16 = _mm_unpacklo_epi8(_mm_set1_epi32(int(color)), zero);
+        __m128i inv_a = _mm_set1_epi16(short(255 - (color >> 24)));
+
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            auto p = reinterpret_cast<__m128i*>(dst + i);
+            __m128i d = _mm_loadu_si128(p);
+            __m128i lo = _mm_add_epi16(c16, div255x16(_mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), inv_a)));
+            __m128i hi = _mm_add_epi16(c16, div255x16(_mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), inv_a)));
+            _mm_storeu_si128(p, _mm_packus_epi16(lo, hi));
+        }
+        blendSolidScalar(dst + i, count - i, color);
+    }
+
+    TARGET_SSE2 void blendSolidMaskSSE2(
+        uint32_t* dst, const uint8_t* mask, size_t count, uint32_t color)
+    {
+        __m128i c = _mm_set1_epi32(int(color));
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            auto p = reinterpret_cast<__m128i*>(dst + i);
+            _mm_storeu_si128(p, blendMask4(_mm_loadu_si128(p), c, mask + i));
+        }
+        blendSolidMaskScalar(dst + i, mask + i, count - i, color);
+    }
+
+    TARGET_SSE2 void blendSSE2(uint32_t* dst, const uint32_t* src, size_t count) {
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            auto p = reinterpret_cast<__m128i*>(dst + i);
+            __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            _mm_storeu_si128(p, blend4(_mm_loadu_si128(p), s));
+        }
+        blendScalar(dst + i, src + i, count - i);
+    }
+
+    TARGET_SSE2 void blendOpacitySSE2(
+        uint32_t* dst, const uint32_t* src, size_t count, uint8_t opacity)
+    {
+        __m128i zero = _mm_setzero_si128();
+        __m128i k = _mm_set1_epi16(opacity);
+
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            auto p = reinterpret_cast<__m128i*>(dst + i);
+            __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            __m128i d = _mm_loadu_si128(p);
+
+            __m128i s_lo = div255x16(_mm_mullo_epi16(_mm_unpacklo_epi8(s, zero), k));
+            __m128i s_hi = div255x16(_mm_mullo_epi16(_mm_unpackhi_epi8(s, zero), k));
+            __m128i lo = blend16(_mm_unpacklo_epi8(d, zero), s_lo);
+            __m128i hi = blend16(_mm_unpackhi_epi8(d, zero), s_hi);
+            _mm_storeu_si128(p, _mm_packus_epi16(lo, hi));
+        }
+        blendOpacityScalar(dst + i, src + i, count - i, opacity);
+    }
+
+    TARGET_SSE2 void blendMaskSSE2(
+        uint32_t* dst, const uint32_t* src, const uint8_t* mask, size_t count)
+    {
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            auto p = reinterpret_cast<__m128i*>(dst + i);
+            __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            _mm_storeu_si128(p, blendMask4(_mm_loadu_si128(p), s, mask + i));
+        }
+        blendMaskScalar(dst + i, src + i, mask + i, count - i);
+    }
+
+    const PixelKernels kSSE2Kernels = {
+        PixelKernels::Level::SSE2,
+        fillSSE2,
+        blendSolidSSE2,
+        blendSolidMaskSSE2,
+        blendSSE2,
+        blendOpacitySSE2,
+        blendMaskSSE2,
+    };
+
+
+    /**
+     * AVX2 实现。
+     * 每次处理 8 个像素。unpack 与 pack 均在 128 位通道内进行，
+     * 因此像素顺序在往返后保持不变。
+     * 剩余的像素交给 SSE2 实现，它使用非 VEX 编码的指令，因此在调用前需要清零
+     * ymm 寄存器的高 128 位，否则会有 SSE/AVX 切换的开销。编译器对尾调用不会自动插入。
+     */
+    TARGET_AVX2 inline __m256i div255x16(__m256i v) {
+        v = _mm256_add_epi16(v, _mm256_set1_epi16(128));
+        return _mm256_srli_epi16(_mm256_add_epi16(v, _mm256_srli_epi16(v, 8)), 8);
+    }
+
+    TARGET_AVX2 inline __m256i alphaOf16(__m256i px16) {
+        px16 = _mm256_shufflelo_epi16(px16, _MM_SHUFFLE(3, 3, 3, 3));
+        return _mm256_shufflehi_epi16(px16, _MM_SHUFFLE(3, 3, 3, 3));
+    }
+
+    TARGET_AVX2 inline void expandMask8(const uint8_t* mask, __m256i* lo, __m256i* hi) {
+        // 每个 128 位通道各取 4 个遮罩值
+        int m0, m1;
+        std::memcpy(&m0, mask, 4);
+        std::memcpy(&m1, mask + 4, 4);
+        __m256i v = _mm256_set_epi32(0, 0, 0, m1, 0, 0, 0, m0);
+        v = _mm256_unpacklo_epi8(v, _mm256_setzero_si256());
+        v = _mm256_unpacklo_epi16(v, v);
+        *lo = _mm256_unpacklo_epi32(v, v);
+        *hi = _mm256_unpackhi_epi32(v, v);
+    }
+
+    TARGET_AVX2 inline __m256i blend16(__m256i dst16, __m256i src16) {
+        __m256i inv_a = _mm256_sub_epi16(_mm256_set1_epi16(255), alphaOf16(src16));
+        return _mm256_add_epi16(src16, div255x16(_mm256_mullo_epi16(dst16, inv_a)));
+    }
+
+    TARGET_AVX2 inline __m256i blendScaled8(__m256i dst, __m256i src, __m256i k_lo, __m256i k_hi) {
+        __m256i zero = _mm256_setzero_si256();
+        __m256i s_lo = div255x16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(src, zero), k_lo));
+        __m256i s_hi = div255x16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(src, zero), k_hi));
+        __m256i lo = blend16(_mm256_unpacklo_epi8(dst, zero), s_lo);
+        __m256i hi = blend16(_mm256_unpackhi_epi8(dst, zero), s_hi);
+        return _mm256_packus_epi16(lo, hi);
+    }
+
+    TARGET_AVX2 void fillAVX2(uint32_t* dst, size_t count, uint32_t color) {
+        __m256i c = _mm256_set1_epi32(int(color));
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), c);
+        }
+        _mm256_zeroupper();
+        fillSSE2(dst + i, count - i, color);
+    }
+
+    TARGET_AVX2 void blendSolidAVX2(uint32_t* dst, size_t count, uint32_t color) {
+        __m256i zero = _mm256_setzero_si256();
+        __m256i c16 = _mm256_unpacklo_epi8(_mm256_set1_epi32(int(color)), zero);
+        __m256i inv_a = _mm256_set1_epi16(short(255 - (color >> 24)));
+
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            auto p = reinterpret_cast<__m256i*>(dst + i);
+            __m256i d = _mm256_loadu_si256(p);
+            __m256i lo = _mm256_add_epi16(c16, div255x16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(d, zero), inv_a)));
+            __m256i hi = _mm256_add_epi16(c16, div255x16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(d, zero), inv_a)));
+            _mm256_storeu_si256(p, _mm256_packus_epi16(lo, hi));
+        }
+        _mm256_zeroupper();
+        blendSolidSSE2(dst + i, count - i, color);
+    }
+
+    TARGET_AVX2 void blendSolidMaskAVX2(
+        uint32_t* dst, const uint8_t* mask, size_t count, uint32_t color)
+    {
+        __m256i c = _mm256_set1_epi32(int(color));
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            __m256i m_lo, m_hi;
+            expandMask8(mask + i, &m_lo, &m_hi);
+
+            auto p = reinterpret_cast<__m256i*>(dst + i);
+            _mm256_storeu_si256(p, blendScaled8(_mm256_loadu_si256(p), c, m_lo, m_hi));
+        }
+        _mm256_zeroupper();
+        blendSolidMaskSSE2(dst + i, mask + i, count - i, color);
+    }
+
+    TARGET_AVX2 void blendAVX2(uint32_t* dst, const uint32_t* src, size_t count) {
+        __m256i zero = _mm256_setzero_si256();
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            auto p = reinterpret_cast<__m256i*>(dst + i);
+            __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+            __m256i d = _mm256_loadu_si256(p);
+            __m256i lo = blend16(_mm256_unpacklo_epi8(d, zero), _mm256_unpacklo_epi8(s, zero));
+            __m256i hi = blend16(_mm256_unpackhi_epi8(d, zero), _mm256_unpackhi_epi8(s, zero));
+            _mm256_storeu_si256(p, _mm256_packus_epi16(lo, hi));
+        }
+        _mm256_zeroupper();
+        blendSSE2(dst + i, src + i, count - i);
+    }
+
+    TARGET_AVX2 void blendOpacityAVX2(
+        uint32_t* dst, const uint32_t* src, size_t count, uint8_t opacity)
+    {
+        __m256i k = _mm256_set1_epi16(opacity);
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            auto p = reinterpret_cast<__m256i*>(dst + i);
+            __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+            _mm256_storeu_si256(p, blendScaled8(_mm256_loadu_si256(p), s, k, k));
+        }
+        _mm256_zeroupper();
+        blendOpacitySSE2(dst + i, src + i, count - i, opacity);
+    }
+
+    TARGET_AVX2 void blendMaskAVX2(
+        uint32_t* dst, const uint32_t* src, const uint8_t* mask, size_t count)
+    {
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            __m256i m_lo, m_hi;
+            expandMask8(mask + i, &m_lo, &m_hi);
+
+            auto p = reinterpret_cast<__m256i*>(dst + i);
+            __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+            _mm256_storeu_si256(p, blendScaled8(_mm256_loadu_si256(p), s, m_lo, m_hi));
+        }
+        _mm256_zeroupper();
+        blendMaskSSE2(dst + i, src + i, mask + i, count - i);
+    }
+
+    const PixelKernels kAVX2Kernels = {
+        PixelKernels::Level::AVX2,
+        fillAVX2,
+        blendSolidAVX2,
+        blendSolidMaskAVX2,
+        blendAVX2,
+        blendOpacityAVX2,
+        blendMaskAVX2,
+    };
+
+#endif  // UKIVE_PIXEL_KERNELS_X86
+
+}
+
+namespace ukive {
+namespace cpu {
+
+    // static
+    const PixelKernels& PixelKernels::get() {
+        static const PixelKernels* kernels = []() {
+            if (auto k = get(Level::AVX2)) {
+                return k;
+            }
+            if (auto k = get(Level::SSE2)) {
+                return k;
+            }
+            return &kScalarKernels;
+        }();
+        return *kernels;
+    }
+
+    // static
+    const PixelKernels* PixelKernels::get(Level level) {
+        switch (level) {
+#ifdef UKIVE_PIXEL_KERNELS_X86
+        case Level::AVX2:
+            return hasAVX2() ? &kAVX2Kernels : nullptr;
+        case Level::SSE2:
+            return hasSSE2() ? &kSSE2Kernels : nullptr;
+#endif
+        case Level::SCALAR:
+            return &kScalarKernels;
+        default:
+            return nullptr;
+        }
+    }
+
+}
+}
@@ -0,0 +1,68 @@
+// Copyright (c) 2016 ucclkp <ucclkp@gmail.com>.
+// This file is part of ukive project.
+//
+// This program is licensed under GPLv3 license that can be
+// found in the LICENSE file.
+
+#ifndef UKIVE_GRAPHICS_CPU_PIXEL_KERNELS_H_
+#define UKIVE_GRAPHICS_CPU_PIXEL_KERNELS_H_
+
+#include <cstddef>
+#include <cstdint>
+
+
+namespace ukive {
+namespace cpu {
+
+    /**
+     * CPU 渲染路径使用的像素处理函数。
+     * 像素格式为预乘的 B8G8R8A8_UNORM，以 uint32_t 存储（小端序，A 位于最高字节）；
+     * 遮罩格式为 R8_UNORM。
+     * 根据运行时检测到的 CPU 特性选择 AVX2、SSE2 或标量实现。
+     */
+    struct PixelKernels {
+        enum class Level {
+            SCALAR,
+            SSE2,
+            AVX2,
+        };
+
+        /**
+         * 获取当前 CPU 支持的最快实现。
+         */
+        static const PixelKernels& get();
+
+        /**
+         * 获取指定级别的实现。
+         * 若 CPU 不支持该级别，返回 nullptr。
+         */
+        static const PixelKernels* get(Level level);
+
+        Level level;
+
+        // dst = color
+        void (*fill)(uint32_t* dst, size_t count, uint32_t color);
+
+        // dst = color + dst * (1 - color.a)
+        void (*blendSolid)(uint32_t* dst, size_t count, uint32_t color);
+
+        // dst = color * mask + dst * (1 - color.a * mask)
+        void (*blendSolidMask)(
+            uint32_t* dst, const uint8_t* mask, size_t count, uint32_t color);
+
+        // dst = src + dst * (1 - src.a)
+        void (*blend)(uint32_t* dst, const uint32_t* src, size_t count);
+
+        // dst = src * opacity + dst * (1 - src.a * opacity)
+        void (*blendOpacity)(
+            uint32_t* dst, const uint32_t* src, size_t count, uint8_t opacity);
+
+        // dst = src * mask + dst * (1 - src.a * mask)
+        void (*blendMask)(
+            uint32_t* dst, const uint32_t* src, const uint8_t* mask, size_t count);
+    };
+
+}
+}
+
+#endif  // UKIVE_GRAPHICS_CPU_PIXEL_KERNELS_H_
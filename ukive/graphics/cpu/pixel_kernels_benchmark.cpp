@@ -0,0 +1,161 @@
+// Copyright (c) 2016 ucclkp <ucclkp@gmail.com>.
+// This file is part of ukive project.
+//
+// This program is licensed under GPLv3 license that can be
+// found in the LICENSE file.
+
+#include "ukive/graphics/cpu/pixel_kernels_benchmark.h"
+
+#include <algorithm>
+#include <functional>
+#include <sstream>
+#include <vector>
+
+#include "utils/log.h"
+#include "utils/time_utils.h"
+
+#include "ukive/graphics/cpu/pixel_kernels.h"
+
+
+namespace {
+
+    using ukive::cpu::PixelKernels;
+
+    struct SurfaceSize {
+        size_t width;
+        size_t height;
+    };
+
+    // 从小图标到 4K 整帧。小尺寸下每行只有十几个像素，主要测量尾部处理和调用开销。
+    const SurfaceSize kSizes[] = {
+        { 16, 16 },
+        { 64, 64 },
+        { 256, 256 },
+        { 1280, 720 },
+        { 1920, 1080 },
+        { 3840, 2160 },
+    };
+
+    // 每项测量至少处理的像素数
+    const size_t kMinPixels = 64 * 1024 * 1024;
+
+    const char* getLevelName(PixelKernels::Level level) {
+        switch (level) {
+        case PixelKernels::Level::SCALAR: return "scalar";
+        case PixelKernels::Level::SSE2:   return "SSE2";
+        case PixelKernels::Level::AVX2:   return "AVX2";
+        default: return "unknown";
+        }
+    }
+
+    /**
+     * 对整个表面逐行执行 op，重复到至少处理 kMinPixels 个像素，返回每秒处理的像素数（百万）。
+     * op 的参数为行号。
+     */
+    double measure(const SurfaceSize& size, const std::function<void(size_t)>& op) {
+        size_t pixels = size.width * size.height;
+        size_t repeats = (std::max)(size_t(1), kMinPixels / pixels);
+
+        // 预热
+        for (size_t y = 0; y < size.height; ++y) {
+            op(y);
+        }
+
+        auto start = utl::TimeUtils::upTimeNanos();
+        for (size_t i = 0; i < repeats; ++i) {
+            for (size_t y = 0; y < size.height; ++y) {
+                op(y);
+            }
+        }
+        auto elapsed = utl::TimeUtils::upTimeNanos() - start;
+        if (elapsed == 0) {
+            return 0;
+        }
+        return double(pixels * repeats) * 1000.0 / double(elapsed);
+    }
+
+}
+
+namespace ukive {
+namespace cpu {
+
+    void runPixelKernelsBenchmark() {
+        LOG(Log::INFO) << "PixelKernels benchmark, Mpixel/s (speedup over scalar):";
+
+        const uint32_t kColor = 0x80402010;
+        const PixelKernels::Level levels[] = {
+            PixelKernels::Level::SCALAR,
+            PixelKernels::Level::SSE2,
+            PixelKernels::Level::AVX2,
+        };
+
+        for (const auto& size : kSizes) {
+            // 半透明的源像素和渐变的遮罩，避免走全透明或全不透明的捷径
+            size_t pixels = size.width * size.height;
+            std::vector<uint32_t> dst(pixels);
+            std::vector<uint32_t> src(pixels);
+            std::vector<uint8_t> mask(pixels);
+            for (size_t i = 0; i < pixels; ++i) {
+                uint32_t a = uint32_t(i % 256);
+                uint32_t c = a * 3 / 4;
+                src[i] = (a << 24) | (c << 16) | (c / 2 << 8) | (c / 3);
+                mask[i] = uint8_t(255 - i % 256);
+            }
+
+            struct Result {
+                const char* name;
+                double mpix[3] = { 0, 0, 0 };
+            };
+            Result results[] = {
+                { "fill" },
+                { "blendSolid" },
+                { "blendSolidMask" },
+                { "blend" },
+                { "blendOpacity" },
+                { "blendMask" },
+            };
+
+            size_t w = size.width;
+            for (size_t l = 0; l < 3; ++l) {
+                auto k = PixelKernels::get(levels[l]);
+                if (!k) {
+                    continue;
+                }
+
+                auto d = dst.data();
+                auto s = src.data();
+                auto m = mask.data();
+                results[0].mpix[l] = measure(size, [&](size_t y) {
+                    k->fill(d + y * w, w, kColor); });
+                results[1].mpix[l] = measure(size, [&](size_t y) {
+                    k->blendSolid(d + y * w, w, kColor); });
+                results[2].mpix[l] = measure(size, [&](size_t y) {
+                    k->blendSolidMask(d + y * w, m + y * w, w, kColor); });
+                results[3].mpix[l] = measure(size, [&](size_t y) {
+                    k->blend(d + y * w, s + y * w, w); });
+                results[4].mpix[l] = measure(size, [&](size_t y) {
+                    k->blendOpacity(d + y * w, s + y * w, w, 200); });
+                results[5].mpix[l] = measure(size, [&](size_t y) {
+                    k->blendMask(d + y * w, s + y * w, m + y * w, w); });
+            }
+
+            LOG(Log::INFO) << "  " << size.width << "x" << size.height << ":";
+            for (const auto& r : results) {
+                std::ostringstream line;
+                line << "    " << r.name << ":";
+                for (size_t l = 0; l < 3; ++l) {
+                    if (r.mpix[l] == 0) {
+                        continue;
+                    }
+                    line << " " << getLevelName(levels[l]) << " " << int(r.mpix[l]);
+                    if (l > 0 && r.mpix[0] > 0) {
+                        line.precision(2);
+                        line << std::fixed << " (" << (r.mpix[l] / r.mpix[0]) << "x)";
+                    }
+                }
+                LOG(Log::INFO) << line.str();
+            }
+        }
+    }
+}
+}
@@ -0,0 +1,23 @@
+// Copyright (c) 2016 ucclkp <ucclkp@gmail.com>.
+// This file is part of ukive project.
+//
+// This program is licensed under GPLv3 license that can be
+// found in the LICENSE file.
+
+#ifndef UKIVE_GRAPHICS_CPU_PIXEL_KERNELS_BENCHMARK_H_
+#define UKIVE_GRAPHICS_CPU_PIXEL_KERNELS_BENCHMARK_H_
+
+
+namespace ukive {
+namespace cpu {
+
+    /**
+     * 在 16x16 到 3840x2160 的多种表面尺寸下，测量当前 CPU 支持的各级别 PixelKernels
+     * 逐行处理整个表面的吞吐量，并与标量实现比较，结果按尺寸写入日志。
+     */
+    void runPixelKernelsBenchmark();
+
+}
+}
+
+#endif  // UKIVE_GRAPHICS_CPU_PIXEL_KERNELS_BENCHMARK_H_
@@ -0,0 +1,212 @@
+// Copyright (c) 2016 ucclkp <ucclkp@gmail.com>.
+// This file is part of ukive project.
+//
+// This program is licensed under GPLv3 license that can be
+// found in the LICENSE file.
+
+#include "ukive/graphics/cpu/rasterizer_cpu.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+
+namespace ukive {
+namespace cpu {
+
+    void RasterizerCpu::reset(const Rect& clip) {
+        clip_ = clip;
+        bounds_ = {};
+        edges_.clear();
+    }
+
+    void RasterizerCpu::addPolygon(const PointF* points, size_t count) {
+        if (count < 3) {
+            return;
+        }
+
+        for (size_t i = 0; i < count; ++i) {
+            auto& p0 = points[i];
+            auto& p1 = points[(i + 1) % count];
+            if (p0.y() == p1.y()) {
+                continue;
+            }
+            edges_.push_back({ p0, p1 });
+        }
+    }
+
+    void RasterizerCpu::addPolygon(const std::vector<PointF>& points) {
+        addPolygon(points.data(), points.size());
+    }
+
+    bool RasterizerCpu::rasterize(Rect* bounds) {
+        if (edges_.empty() || clip_.empty()) {
+            return false;
+        }
+
+        float min_x = (std::numeric_limits<float>::max)();
+        float min_y = min_x;
+        float max_x = std::numeric_limits<float>::lowest();
+        float max_y = max_x;
+        for (const auto& e : edges_) {
+            min_x = (std::min)({ min_x, e.p0.x(), e.p1.x() });
+            min_y = (std::min)({ min_y, e.p0.y(), e.p1.y() });
+            max_x = (std::max)({ max_x, e.p0.x(), e.p1.x() });
+            max_y = (std::max)({ max_y, e.p0.y(), e.p1.y() });
+        }
+
+        // 避免超大坐标导致整数溢出
+        min_x = std::clamp(min_x, float(clip_.x()), float(clip_.right()));
+        min_y = std::clamp(min_y, float(clip_.y()), float(clip_.bottom()));
+        max_x = std::clamp(max_x, float(clip_.x()), float(clip_.right()));
+        max_y = std::clamp(max_y, float(clip_.y()), float(clip_.bottom()));
+
+        int l = int(std::floor(min_x));
+        int t = int(std::floor(min_y));
+        int r = int(std::ceil(max_x));
+        int b = int(std::ceil(max_y));
+        bounds_.xyrb(l, t, r, b);
+        bounds_.same(clip_);
+        if (bounds_.empty()) {
+            return false;
+        }
+
+        int w = bounds_.width();
+        int h = bounds_.height();
+        acc_stride_ = w + 2;
+        acc_.assign(size_t(acc_stride_) * h, 0.f);
+
+        float ox = float(bounds_.x());
+        float oy = float(bounds_.y());
+        for (const auto& e : edges_) {
+            accumulateLine(
+                { e.p0.x() - ox, e.p0.y() - oy },
+                { e.p1.x() - ox, e.p1.y() - oy });
+        }
+
+        coverage_.resize(size_t(w) * h);
+        for (int y = 0; y < h; ++y) {
+            auto acc = acc_.data() + size_t(y) * acc_stride_;
+            auto cov = coverage_.data() + size_t(y) * w;
+
+            float sum = 0;
+            for (int x = 0; x < w; ++x) {
+                sum += acc[x];
+                float v = (std::min)(std::abs(sum), 1.f);
+                cov[x] = uint8_t(v * 255 + 0.5f);
+            }
+        }
+
+        *bounds = bounds_;
+        return true;
+    }
+
+    const uint8_t* RasterizerCpu::getCoverageRow(int y) const {
+        return coverage_.data() + size_t(y - bounds_.y()) * bounds_.width();
+    }
+
+    void RasterizerCpu::accumulateLine(PointF p0, PointF p1) {
+        // 在左右边界处将线段切开，边界外的部分贴到边界上，
+        // 这样边界外的线段仍然能为边界内的像素贡献覆盖率。
+        float w = float(bounds_.width());
+        float ts[4] = { 0, 1, 1, 1 };
+        int count = 1;
+
+        float dx = p1.x() - p0.x();
+        if (dx != 0) {
+            float t0 = (0 - p0.x()) / dx;
+            float t1 = (w - p0.x()) / dx;
+            if (t0 > 0 && t0 < 1) ts[count++] = t0;
+            if (t1 > 0 && t1 < 1) ts[count++] = t1;
+            std::sort(ts, ts + count);
+        }
+        ts[count] = 1;
+
+        auto lerp = [&](float t) -> PointF {
+            float x = p0.x() + dx * t;
+            float y = p0.y() + (p1.y() - p0.y()) * t;
+            return { std::clamp(x, 0.f, w), y };
+        };
+
+        for (int i = 0; i < count; ++i) {
+            accumulateClampedLine(lerp(ts[i]), lerp(ts[i + 1]));
+        }
+    }
+
+    void RasterizerCpu::accumulateClampedLine(const PointF& p0, const PointF& p1) {
+        if (p0.y() == p1.y()) {
+            return;
+        }
+
+        float dir;
+        PointF top, btm;
+        if (p0.y() < p1.y()) {
+            dir = 1;
+            top = p0;
+            btm = p1;
+        } else {
+            dir = -1;
+            top = p1;
+            btm = p0;
+        }
+
+        int h = bounds_.height();
+        float w = float(bounds_.width());
+        if (btm.y() <= 0 || top.y() >= h) {
+            return;
+        }
+
+        float dxdy = (btm.x() - top.x()) / (btm.y() - top.y());
+        float x = top.x();
+        if (top.y() < 0) {
+            x -= top.y() * dxdy;
+        }
+
+        int y0 = (std::max)(0, int(std::floor(top.y())));
+        int y1 = (std::min)(h, int(std::ceil(btm.y())));
+
+        for (int y = y0; y < y1; ++y) {
+            auto line = acc_.data() + size_t(y) * acc_stride_;
+            float dy = (std::min)(float(y + 1), btm.y()) - (std::max)(float(y), top.y());
+            float x_next = x + dxdy * dy;
+            float d = dy * dir;
+
+            float x0 = std::clamp((std::min)(x, x_next), 0.f, w);
+            float x1 = std::clamp((std::max)(x, x_next), 0.f, w);
+            float x0_floor = std::floor(x0);
+            int x0i = int(x0_floor);
+            float x1_ceil = std::ceil(x1);
+            int x1i = int(x1_ceil);
+
+            if (x1i <= x0i + 1) {
+                // 线段在该行内只经过一个像素
+                float xm = 0.5f * (x0 + x1) - x0_floor;
+                line[x0i] += d - d * xm;
+                line[x0i + 1] += d * xm;
+            } else {
+                float s = 1 / (x1 - x0);
+                float x0f = x0 - x0_floor;
+                float a0 = 0.5f * s * (1 - x0f) * (1 - x0f);
+                float x1f = x1 - x1_ceil + 1;
+                float am = 0.5f * s * x1f * x1f;
+
+                line[x0i] += d * a0;
+                if (x1i == x0i + 2) {
+                    line[x0i + 1] += d * (1 - a0 - am);
+                } else {
+                    float a1 = s * (1.5f - x0f);
+                    line[x0i + 1] += d * (a1 - a0);
+                    for (int xi = x0i + 2; xi < x1i - 1; ++xi) {
+                        line[xi] += d * s;
+                    }
+                    float a2 = a1 + (x1i - x0i - 3) * s;
+                    line[x1i - 1] += d * (1 - a2 - am);
+                }
+                line[x1i] += d * am;
+            }
+            x = x_next;
+        }
+    }
+
+}
+}
@@ -0,0 +1,73 @@
+// Copyright (c) 2016 ucclkp <ucclkp@gmail.com>.
+// This file is part of ukive project.
+//
+// This program is licensed under GPLv3 license that can be
+// found in the LICENSE file.
+
+#ifndef UKIVE_GRAPHICS_CPU_RASTERIZER_CPU_H_
+#define UKIVE_GRAPHICS_CPU_RASTERIZER_CPU_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "ukive/graphics/point.hpp"
+#include "ukive/graphics/rect.hpp"
+
+
+namespace ukive {
+namespace cpu {
+
+    /**
+     * 带抗锯齿的多边形扫描转换器。
+     * 使用面积累加的方式计算每个像素的覆盖率，填充规则近似为非零环绕。
+     * 所有坐标均为设备像素坐标。
+     */
+    class RasterizerCpu {
+    public:
+        RasterizerCpu() = default;
+
+        /**
+         * 开始新的一次光栅化，clip 之外的部分会被丢弃。
+         */
+        void reset(const Rect& clip);
+
+        /**
+         * 添加一个闭合多边形。
+         */
+        void addPolygon(const PointF* points, size_t count);
+        void addPolygon(const std::vector<PointF>& points);
+
+        /**
+         * 计算覆盖率。
+         * @param bounds 覆盖区域的设备坐标。
+         * @return 若覆盖区域为空，返回 false。
+         */
+        bool rasterize(Rect* bounds);
+
+        /**
+         * 获取第 y 行（设备坐标）的覆盖率，范围为 0 到 255。
+         * 返回的数组从 bounds.x() 开始，长度为 bounds.width()。
+         */
+        const uint8_t* getCoverageRow(int y) const;
+
+    private:
+        struct Edge {
+            PointF p0;
+            PointF p1;
+        };
+
+        void accumulateLine(PointF p0, PointF p1);
+        void accumulateClampedLine(const PointF& p0, const PointF& p1);
+
+        Rect clip_;
+        Rect bounds_;
+        int acc_stride_ = 0;
+        std::vector<Edge> edges_;
+        std::vector<float> acc_;
+        std::vector<uint8_t> coverage_;
+    };
+
+}
+}
+
+#endif  // UKIVE_GRAPHICS_CPU_RASTERIZER_CPU_H_
@@ -6,6 +6,8 @@
 
 #include "dirty_region.h"
 
+#include <limits>
+
 
 namespace ukive {
 
@@ -16,55 +18,92 @@ namespace ukive {
             return;
         }
 
-        if (rect0.empty()) {
-            rect0 = rect;
-            return;
+        for (size_t i = 0; i < count_; ++i) {
+            if (rects_[i].contains(rect)) {
+                return;
+            }
         }
 
-        if (rect0.intersect(rect)) {
-            rect0.join(rect);
+        rects_[count_] = rect;
+        ++count_;
 
-            if (!rect1.empty() && rect0.intersect(rect1)) {
-                rect0.join(rect1);
-                rect1.xywh(0, 0, 0, 0);
-            }
-            return;
+        while (coalesce()) {}
+        while (count_ > kMaxRectCount) {
+            mergeCheapest();
+            while (coalesce()) {}
         }
+    }
 
-        if (rect1.empty()) {
-            rect1 = rect;
+    void DirtyRegion::setOne(const Rect& rect) {
+        if (rect.empty()) {
+            count_ = 0;
             return;
         }
+        rects_[0] = rect;
+        count_ = 1;
+    }
 
-        if (rect1.intersect(rect)) {
-            rect1.join(rect);
+    void DirtyRegion::clear() {
+        count_ = 0;
+    }
 
-            if (rect0.intersect(rect1)) {
-                rect0.join(rect1);
-                rect1.xywh(0, 0, 0, 0);
-            }
-            return;
-        }
+    bool DirtyRegion::empty() const {
+        return count_ == 0;
+    }
+
+    size_t DirtyRegion::size() const {
+        return count_;
+    }
+
+    // static
+    int64_t DirtyRegion::area(const Rect& r) {
+        return int64_t(r.width()) * r.height();
+    }
+
+    // static
+    int64_t DirtyRegion::mergeCost(const Rect& r0, const Rect& r1) {
+        // 分开绘制时，相交部分会被绘制两次
+        return area(r0 | r1) - area(r0) - area(r1);
+    }
 
-        rect0.join(rect);
-        if (rect0.intersect(rect1)) {
-            rect0.join(rect1);
-            rect1.xywh(0, 0, 0, 0);
+    void DirtyRegion::removeAt(size_t index) {
+        for (size_t i = index + 1; i < count_; ++i) {
+            rects_[i - 1] = rects_[i];
         }
+        --count_;
     }
 
-    void DirtyRegion::setOne(const Rect& rect) {
-        rect0 = rect;
-        rect1.xywh(0, 0, 0, 0);
+    void DirtyRegion::merge(size_t i, size_t j) {
+        rects_[i].join(rects_[j]);
+        removeAt(j);
     }
 
-    void DirtyRegion::clear() {
-        rect0.xywh(0, 0, 0, 0);
-        rect1.xywh(0, 0, 0, 0);
+    bool DirtyRegion::coalesce() {
+        for (size_t i = 0; i < count_; ++i) {
+            for (size_t j = i + 1; j < count_; ++j) {
+                if (mergeCost(rects_[i], rects_[j]) <= kDrawPassCost) {
+                    merge(i, j);
+                    return true;
+                }
+            }
+        }
+        return false;
     }
 
-    bool DirtyRegion::empty() const {
-        return rect0.empty() && rect1.empty();
+    void DirtyRegion::mergeCheapest() {
+        size_t bi = 0, bj = 1;
+        auto min_cost = (std::numeric_limits<int64_t>::max)();
+        for (size_t i = 0; i < count_; ++i) {
+            for (size_t j = i + 1; j < count_; ++j) {
+                auto cost = mergeCost(rects_[i], rects_[j]);
+                if (cost < min_cost) {
+                    min_cost = cost;
+                    bi = i;
+                    bj = j;
+                }
+            }
+        }
+        merge(bi, bj);
     }
 
 }
@@ -7,13 +7,30 @@
 #ifndef UKIVE_GRAPHICS_DIRTY_REGION_H_
 #define UKIVE_GRAPHICS_DIRTY_REGION_H_
 
+#include <cstddef>
+#include <cstdint>
+
 #include "ukive/graphics/rect.hpp"
 
 
 namespace ukive {
 
+    /**
+     * 由多个矩形组成的脏区域。
+     * 最多保存 kMaxRectCount 个矩形。当两个矩形合并后多出的面积
+     * 小于一次绘制的开销（kDrawPassCost）时，将其合并；
+     * 矩形数量超出上限时，合并代价最小的一对。
+     */
     class DirtyRegion {
     public:
+        static constexpr size_t kMaxRectCount = 8;
+
+        /**
+         * 以面积表示的单次绘制开销。
+         * 合并两个矩形多出的面积若不超过此值，认为合并更划算。
+         */
+        static constexpr int64_t kDrawPassCost = 64 * 64;
+
         DirtyRegion();
 
         void add(const Rect& rect);
@@ -21,11 +38,29 @@ namespace ukive {
         void clear();
 
         bool empty() const;
+        size_t size() const;
+
+        Rect* begin() { return rects_; }
+        Rect* end() { return rects_ + count_; }
+        const Rect* begin() const { return rects_; }
+        const Rect* end() const { return rects_ + count_; }
+
+        const Rect& operator[](size_t index) const { return rects_[index]; }
+
+    private:
+        static int64_t area(const Rect& r);
+        static int64_t mergeCost(const Rect& r0, const Rect& r1);
+
+        void removeAt(size_t index);
+        void merge(size_t i, size_t j);
+        bool coalesce();
+        void mergeCheapest();
 
-        Rect rect0;
-        Rect rect1;
+        // 多留一个位置，用于在合并前暂存新加入的矩形
+        Rect rects_[kMaxRectCount + 1];
+        size_t count_ = 0;
     };
 
 }
 
-#endif  // UKIVE_GRAPHICS_DIRTY_REGION_H_
\ No newline at end of file
+#endif  // UKIVE_GRAPHICS_DIRTY_REGION_H_
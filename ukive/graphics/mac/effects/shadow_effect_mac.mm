@@ -48,7 +48,7 @@ namespace mac {
         [ns_img drawInRect:rect
                   fromRect:rect
                  operation:NSCompositingOperationSourceOver
-                  fraction:1.0f
+                  fraction:c->getOpacity()
             respectFlipped:!img->alreadyFilpped()
                      hints:nil];
 
@@ -67,11 +67,11 @@ namespace mac {
     }
 
     void ShadowEffectMac::resetCache() {
-
+        content_.reset();
     }
 
     bool ShadowEffectMac::hasCache() const {
-        return false;
+        return content_ != nullptr;
     }
 
     bool ShadowEffectMac::setRadius(int radius) {
@@ -0,0 +1,45 @@
+// Copyright (c) 2016 ucclkp <ucclkp@gmail.com>.
+// This file is part of ukive project.
+//
+// This program is licensed under GPLv3 license that can be
+// found in the LICENSE file.
+
+#include "ukive/graphics/render_node/display_list.h"
+
+#include "ukive/graphics/canvas.h"
+
+
+namespace ukive {
+
+    void DisplayList::addOp(Op&& op) {
+        ops_.push_back(std::move(op));
+    }
+
+    void DisplayList::addChildren() {
+        ops_.push_back(nullptr);
+    }
+
+    void DisplayList::clear() {
+        ops_.clear();
+    }
+
+    bool DisplayList::empty() const {
+        return ops_.empty();
+    }
+
+    size_t DisplayList::getOpCount() const {
+        return ops_.size();
+    }
+
+    void DisplayList::replay(Canvas* c, const ChildrenDrawer& drawer) const {
+        float base_opacity = c->getOpacity();
+        for (const auto& op : ops_) {
+            if (op) {
+                op(c, base_opacity);
+            } else if (drawer) {
+                drawer();
+            }
+        }
+    }
+
+}
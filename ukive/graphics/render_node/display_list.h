@@ -0,0 +1,55 @@
+// Copyright (c) 2016 ucclkp <ucclkp@gmail.com>.
+// This file is part of ukive project.
+//
+// This program is licensed under GPLv3 license that can be
+// found in the LICENSE file.
+
+#ifndef UKIVE_GRAPHICS_RENDER_NODE_DISPLAY_LIST_H_
+#define UKIVE_GRAPHICS_RENDER_NODE_DISPLAY_LIST_H_
+
+#include <functional>
+#include <vector>
+
+
+namespace ukive {
+
+    class Canvas;
+
+    /**
+     * 录制下来的一组绘制命令。
+     * 命令中的变换均相对于录制开始时画布的状态，因此可以在
+     * 不同的平移、缩放和透明度下回放。
+     */
+    class DisplayList {
+    public:
+        /**
+         * 绘制命令。
+         * base_opacity 为回放开始时画布的透明度。
+         */
+        using Op = std::function<void(Canvas* c, float base_opacity)>;
+        using ChildrenDrawer = std::function<void()>;
+
+        DisplayList() = default;
+
+        void addOp(Op&& op);
+
+        /**
+         * 标记子视图的绘制位置。
+         * 子视图不录制到此列表中，回放到此处时会调用 ChildrenDrawer。
+         */
+        void addChildren();
+
+        void clear();
+        bool empty() const;
+        size_t getOpCount() const;
+
+        void replay(Canvas* c, const ChildrenDrawer& drawer) const;
+
+    private:
+        // 空的 Op 表示子视图的绘制位置
+        std::vector<Op> ops_;
+    };
+
+}
+
+#endif  // UKIVE_GRAPHICS_RENDER_NODE_DISPLAY_LIST_H_
@@ -0,0 +1,313 @@
+// Copyright (c) 2016 ucclkp <ucclkp@gmail.com>.
+// This file is part of ukive project.
+//
+// This program is licensed under GPLv3 license that can be
+// found in the LICENSE file.
+
+#include "ukive/graphics/render_node/display_list_recorder.h"
+
+#include <string>
+
+#include "utils/log.h"
+
+#include "ukive/graphics/canvas.h"
+#include "ukive/graphics/colors/color.h"
+#include "ukive/graphics/images/image_frame.h"
+#include "ukive/graphics/paint.h"
+#include "ukive/graphics/render_node/display_list.h"
+#include "ukive/text/text_layout.h"
+
+
+namespace {
+
+    ukive::GPtr<ukive::ImageFrame> retain(ukive::ImageFrame* img) {
+        if (img) {
+            img->add_ref();
+        }
+        return ukive::GPtr<ukive::ImageFrame>(img);
+    }
+
+}
+
+namespace ukive {
+
+    DisplayListRecorder::DisplayListRecorder() {}
+
+    void DisplayListRecorder::begin(CyroRenderTarget* target, DisplayList* list) {
+        ubassert(target && list);
+        target_ = target;
+        list_ = list;
+        list_->clear();
+        base_opacity_ = target_->getOpacity();
+        is_complete_ = true;
+    }
+
+    void DisplayListRecorder::end() {
+        target_ = nullptr;
+        list_ = nullptr;
+    }
+
+    void DisplayListRecorder::recordTextLayout(float x, float y, TextLayout* layout) {
+        list_->addOp([x, y, layout](Canvas* c, float) {
+            layout->draw(c, x, y);
+        });
+    }
+
+    bool DisplayListRecorder::isComplete() const {
+        return is_complete_;
+    }
+
+    CyroRenderTarget* DisplayListRecorder::getTarget() const {
+        return target_;
+    }
+
+    bool DisplayListRecorder::onCreate(CyroBuffer* buffer) {
+        return false;
+    }
+
+    void DisplayListRecorder::onDestroy() {}
+
+    CyroBuffer* DisplayListRecorder::getBuffer() const {
+        return target_->getBuffer();
+    }
+
+    GPtr<ImageFrame> DisplayListRecorder::createImage(const GPtr<LcImageFrame>& frame) {
+        return target_->createImage(frame);
+    }
+
+    GPtr<ImageFrame> DisplayListRecorder::createImage(
+        int width, int height, const ImageOptions& options)
+    {
+        return target_->createImage(width, height, options);
+    }
+
+    GPtr<ImageFrame> DisplayListRecorder::createImage(
+        int width, int height,
+        const GPtr<ByteData>& pixel_data, size_t stride,
+        const ImageOptions& options)
+    {
+        return target_->createImage(width, height, pixel_data, stride, options);
+    }
+
+    GPtr<ImageFrame> DisplayListRecorder::createImage(
+        const GPtr<GPUTexture>& tex2d, const ImageOptions& options)
+    {
+        return target_->createImage(tex2d, options);
+    }
+
+    void DisplayListRecorder::setOpacity(float opacity) {
+        target_->setOpacity(opacity);
+
+        // 以比例的形式录制，使回放时的透明度动画仍然生效
+        if (base_opacity_ <= 0) {
+            is_complete_ = false;
+            return;
+        }
+
+        float factor = opacity / base_opacity_;
+        list_->addOp([factor](Canvas* c, float base_opacity) {
+            c->getRT()->setOpacity(base_opacity * factor);
+        });
+    }
+
+    float DisplayListRecorder::getOpacity() const {
+        return target_->getOpacity();
+    }
+
+    Size DisplayListRecorder::getSize() const {
+        return target_->getSize();
+    }
+
+    Size DisplayListRecorder::getPixelSize() const {
+        return target_->getPixelSize();
+    }
+
+    Matrix2x3F DisplayListRecorder::getMatrix() const {
+        return target_->getMatrix();
+    }
+
+    void DisplayListRecorder::onBeginDraw() {
+        // 录制只发生在绘制过程中
+        ubassert(false);
+    }
+
+    GRet DisplayListRecorder::onEndDraw() {
+        ubassert(false);
+        return GRet::Failed;
+    }
+
+    GRet DisplayListRecorder::onResize(int width, int height) {
+        ubassert(false);
+        return GRet::Failed;
+    }
+
+    void DisplayListRecorder::clear() {
+        target_->clear();
+        list_->addOp([](Canvas* c, float) {
+            c->getRT()->clear();
+        });
+    }
+
+    void DisplayListRecorder::clear(const Color& color) {
+        target_->clear(color);
+        list_->addOp([color](Canvas* c, float) {
+            c->getRT()->clear(color);
+        });
+    }
+
+    void DisplayListRecorder::pushClip(const RectF& rect) {
+        target_->pushClip(rect);
+        list_->addOp([rect](Canvas* c, float) {
+            c->getRT()->pushClip(rect);
+        });
+    }
+
+    void DisplayListRecorder::popClip() {
+        target_->popClip();
+        list_->addOp([](Canvas* c, float) {
+            c->getRT()->popClip();
+        });
+    }
+
+    void DisplayListRecorder::save() {
+        target_->save();
+        list_->addOp([](Canvas* c, float) {
+            c->getRT()->save();
+        });
+    }
+
+    void DisplayListRecorder::restore() {
+        target_->restore();
+        list_->addOp([](Canvas* c, float) {
+            c->getRT()->restore();
+        });
+    }
+
+    void DisplayListRecorder::scale(float sx, float sy, const PointF& cp) {
+        target_->scale(sx, sy, cp);
+        list_->addOp([sx, sy, cp](Canvas* c, float) {
+            c->getRT()->scale(sx, sy, cp);
+        });
+    }
+
+    void DisplayListRecorder::rotate(float angle, const PointF& cp) {
+        target_->rotate(angle, cp);
+        list_->addOp([angle, cp](Canvas* c, float) {
+            c->getRT()->rotate(angle, cp);
+        });
+    }
+
+    void DisplayListRecorder::translate(float dx, float dy) {
+        target_->translate(dx, dy);
+        list_->addOp([dx, dy](Canvas* c, float) {
+            c->getRT()->translate(dx, dy);
+        });
+    }
+
+    void DisplayListRecorder::concat(const Matrix2x3F& matrix) {
+        target_->concat(matrix);
+        list_->addOp([matrix](Canvas* c, float) {
+            c->getRT()->concat(matrix);
+        });
+    }
+
+    void DisplayListRecorder::drawPoint(const PointF& p, const Paint& paint) {
+        target_->drawPoint(p, paint);
+        list_->addOp([p, paint, img = retain(paint.getImage())](Canvas* c, float) {
+            c->getRT()->drawPoint(p, paint);
+        });
+    }
+
+    void DisplayListRecorder::drawLine(
+        const PointF& start, const PointF& end, const Paint& paint)
+    {
+        target_->drawLine(start, end, paint);
+        list_->addOp([start, end, paint, img = retain(paint.getImage())](Canvas* c, float) {
+            c->getRT()->drawLine(start, end, paint);
+        });
+    }
+
+    void DisplayListRecorder::drawRect(const RectF& rect, const Paint& paint) {
+        target_->drawRect(rect, paint);
+        list_->addOp([rect, paint, img = retain(paint.getImage())](Canvas* c, float) {
+            c->getRT()->drawRect(rect, paint);
+        });
+    }
+
+    void DisplayListRecorder::drawRoundRect(
+        const RectF& rect, float radius, const Paint& paint)
+    {
+        target_->drawRoundRect(rect, radius, paint);
+        list_->addOp([rect, radius, paint, img = retain(paint.getImage())](Canvas* c, float) {
+            c->getRT()->drawRoundRect(rect, radius, paint);
+        });
+    }
+
+    void DisplayListRecorder::drawCircle(const PointF& cp, float radius, const Paint& paint) {
+        target_->drawCircle(cp, radius, paint);
+        list_->addOp([cp, radius, paint, img = retain(paint.getImage())](Canvas* c, float) {
+            c->getRT()->drawCircle(cp, radius, paint);
+        });
+    }
+
+    void DisplayListRecorder::drawEllipse(
+        const PointF& cp, float rx, float ry, const Paint& paint)
+    {
+        target_->drawEllipse(cp, rx, ry, paint);
+        list_->addOp([cp, rx, ry, paint, img = retain(paint.getImage())](Canvas* c, float) {
+            c->getRT()->drawEllipse(cp, rx, ry, paint);
+        });
+    }
+
+    void DisplayListRecorder::drawPath(const Path* path, const Paint& paint) {
+        target_->drawPath(path, paint);
+        list_->addOp([path, paint, img = retain(paint.getImage())](Canvas* c, float) {
+            c->getRT()->drawPath(path, paint);
+        });
+    }
+
+    void DisplayListRecorder::drawImage(
+        const RectF& src, const RectF& dst, float opacity, ImageFrame* img)
+    {
+        target_->drawImage(src, dst, opacity, img);
+        list_->addOp([src, dst, opacity, img = retain(img)](Canvas* c, float) {
+            c->getRT()->drawImage(src, dst, opacity, img.get());
+        });
+    }
+
+    void DisplayListRecorder::fillOpacityMask(
+        float width, float height, ImageFrame* mask, ImageFrame* content)
+    {
+        target_->fillOpacityMask(width, height, mask, content);
+        list_->addOp(
+            [width, height, mask = retain(mask), content = retain(content)](Canvas* c, float)
+        {
+            c->getRT()->fillOpacityMask(width, height, mask.get(), content.get());
+        });
+    }
+
+    void DisplayListRecorder::drawText(
+        const std::u16string_view& text,
+        const std::u16string_view& font_name, float font_size,
+        const RectF& rect, const Paint& paint)
+    {
+        target_->drawText(text, font_name, font_size, rect, paint);
+        list_->addOp(
+            [text = std::u16string(text), font_name = std::u16string(font_name),
+            font_size, rect, paint, img = retain(paint.getImage())](Canvas* c, float)
+        {
+            c->getRT()->drawText(text, font_name, font_size, rect, paint);
+        });
+    }
+
+    void DisplayListRecorder::drawTextLayout(
+        float x, float y,
+        TextLayout* layout, const Paint& paint)
+    {
+        target_->drawTextLayout(x, y, layout, paint);
+        list_->addOp([x, y, layout, paint, img = retain(paint.getImage())](Canvas* c, float) {
+            c->getRT()->drawTextLayout(x, y, layout, paint);
+        });
+    }
+
+}
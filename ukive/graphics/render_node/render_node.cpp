@@ -6,6 +6,12 @@
 
 #include "render_node.h"
 
+#include <algorithm>
+
+#include "utils/log.h"
+
+#include "ukive/graphics/canvas.h"
+
 
 namespace ukive {
 
@@ -23,11 +29,77 @@ namespace ukive {
     }
 
     void RenderNode::removeChild(RenderNode* node) {
-
+        auto it = std::find(children_.begin(), children_.end(), node);
+        if (it != children_.end()) {
+            children_.erase(it);
+        }
     }
 
     void RenderNode::removeAllChild() {
         children_.clear();
     }
 
-}
\ No newline at end of file
+    void RenderNode::beginRecording(Canvas* c) {
+        ubassert(!is_recording_);
+
+        is_valid_ = false;
+        is_recording_ = true;
+        is_invalidated_ = false;
+
+        // 外层若正在录制，录制器会以外层录制器为目标，
+        // 本节点的命令同时也会进入外层的显示列表。
+        auto rt = c->getRecorder();
+        recorder_.begin(rt ? rt : c->getRT(), &display_list_);
+        prev_recorder_ = c->setRecorder(&recorder_);
+    }
+
+    void RenderNode::endRecording(Canvas* c) {
+        ubassert(is_recording_);
+
+        c->setRecorder(prev_recorder_);
+        prev_recorder_ = nullptr;
+
+        is_recording_ = false;
+        is_valid_ = recorder_.isComplete() && !is_invalidated_;
+        recorder_.end();
+        if (!is_valid_) {
+            display_list_.clear();
+        }
+    }
+
+    void RenderNode::drawChildren(Canvas* c, const ChildrenDrawer& drawer) {
+        if (!is_recording_) {
+            drawer();
+            return;
+        }
+
+        display_list_.addChildren();
+
+        // 子 View 有自己的显示列表，绘制时暂停录制
+        auto recorder = c->setRecorder(prev_recorder_);
+        drawer();
+        c->setRecorder(recorder);
+    }
+
+    void RenderNode::replay(Canvas* c, const ChildrenDrawer& drawer) const {
+        display_list_.replay(c, drawer);
+    }
+
+    void RenderNode::invalidate() {
+        is_valid_ = false;
+
+        // 录制过程中内容发生了变化，录制的结果不能再用
+        if (is_recording_) {
+            is_invalidated_ = true;
+        }
+    }
+
+    bool RenderNode::isValid() const {
+        return is_valid_;
+    }
+
+    bool RenderNode::isRecording() const {
+        return is_recording_;
+    }
+
+}
@@ -9,11 +9,25 @@
 
 #include <vector>
 
+#include "ukive/graphics/render_node/display_list.h"
+#include "ukive/graphics/render_node/display_list_recorder.h"
+
 
 namespace ukive {
 
+    class Canvas;
+
+    /**
+     * 保存 View 的显示列表。
+     * 显示列表中只包含 View 自身的内容，子 View 的绘制以标记的形式
+     * 保留在列表中，回放时由调用方实时绘制。
+     * 只要 View 自身的内容不变，平移、透明度和动画矩阵的变化都可以
+     * 直接回放显示列表，无需再次调用 onDraw()。
+     */
     class RenderNode {
     public:
+        using ChildrenDrawer = DisplayList::ChildrenDrawer;
+
         RenderNode();
         ~RenderNode() = default;
 
@@ -22,10 +36,36 @@ namespace ukive {
         void removeChild(RenderNode* node);
         void removeAllChild();
 
+        /**
+         * 开始录制。在 endRecording() 之前，画布上的绘制命令
+         * 在执行的同时会被录制到显示列表中。
+         */
+        void beginRecording(Canvas* c);
+        void endRecording(Canvas* c);
+
+        /**
+         * 绘制子 View。
+         * 若正在录制，在显示列表中记录子 View 的位置，并在暂停录制的情况下调用 drawer。
+         */
+        void drawChildren(Canvas* c, const ChildrenDrawer& drawer);
+
+        void replay(Canvas* c, const ChildrenDrawer& drawer) const;
+        void invalidate();
+
+        bool isValid() const;
+        bool isRecording() const;
+
     private:
         RenderNode* parent_;
         std::vector<RenderNode*> children_;
+
+        bool is_valid_ = false;
+        bool is_recording_ = false;
+        bool is_invalidated_ = false;
+        DisplayList display_list_;
+        DisplayListRecorder recorder_;
+        DisplayListRecorder* prev_recorder_ = nullptr;
     };
 }
 
-#endif  // UKIVE_GRAPHICS_RENDER_NODE_RENDER_NODE_H_
\ No newline at end of file
+#endif  // UKIVE_GRAPHICS_RENDER_NODE_RENDER_NODE_H_
@@ -10,6 +10,8 @@
 #include "utils/multi_callbacks.hpp"
 #include "utils/platform_utils.h"
 
+#include "ukive/diagnostic/frame_profiler.h"
+
 #ifdef OS_WINDOWS
 #include "ukive/graphics/win/vsync_provider_win.h"
 #elif defined OS_MAC
@@ -105,6 +107,7 @@ namespace ukive {
     void VSyncProvider::notifyCallbacks(
         uint64_t start_time, uint32_t display_freq, uint32_t real_interval)
     {
+        FRAME_PROFILE_PHASE(ANIMATION, "VSyncProvider::notifyCallbacks");
         for (auto cb : callbacks_) {
             cb->onVSync(start_time, display_freq, real_interval);
         }
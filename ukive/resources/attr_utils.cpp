@@ -6,6 +6,8 @@
 
 #include "attr_utils.h"
 
+#include <cstring>
+
 #include "utils/log.h"
 #include "utils/strings/float_conv.h"
 #include "utils/strings/int_conv.hpp"
@@ -17,11 +19,147 @@
 #include "necro/layout_constants.h"
 
 
+namespace {
+
+    float floatOf(const necro::AttrValue& val) {
+        float f;
+        std::memcpy(&f, &val.value, 4);
+        return f;
+    }
+
+    // 无单位的数字按 dp 处理
+    bool getDimension(
+        const ukive::Context& c, const necro::AttrValue& val, float* out)
+    {
+        switch (val.type) {
+        case necro::AttrValueType::INT:
+            *out = c.dp2px(int(int32_t(val.value)));
+            return true;
+        case necro::AttrValueType::FLOAT:
+            *out = c.dp2px(floatOf(val));
+            return true;
+        case necro::AttrValueType::DIMENSION:
+            *out = (val.unit == necro::DimUnit::PX) ? floatOf(val) : c.dp2px(floatOf(val));
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    bool getDimension(
+        const ukive::Context& c, const necro::AttrValue& val, int* out)
+    {
+        switch (val.type) {
+        case necro::AttrValueType::INT:
+            *out = c.dp2pxi(int(int32_t(val.value)));
+            return true;
+        case necro::AttrValueType::FLOAT:
+            *out = c.dp2pxi(floatOf(val));
+            return true;
+        case necro::AttrValueType::DIMENSION:
+            *out = (val.unit == necro::DimUnit::PX) ? int(floatOf(val)) : c.dp2pxi(floatOf(val));
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    std::string_view trim(std::string_view str) {
+        while (!str.empty() && (str.front() == ' ' || str.front() == '\t')) {
+            str.remove_prefix(1);
+        }
+        while (!str.empty() && (str.back() == ' ' || str.back() == '\t')) {
+            str.remove_suffix(1);
+        }
+        return str;
+    }
+
+    /**
+     * 解析以逗号分隔的 start, top, end, bottom。
+     * 只有一个值时四边都使用该值。
+     */
+    template <typename Edges>
+    bool resolveAttrEdges(
+        const ukive::Context& c, ukive::AttrsRef attrs, const std::string& key, Edges* edges)
+    {
+        auto item = attrs.find(key);
+        if (!item) {
+            return false;
+        }
+
+        auto str = attrs.getRaw(*item);
+        if (str.empty()) {
+            return false;
+        }
+
+        // 大多数情况下只有一个值，此时已预先解析
+        int val;
+        if (str.find(',') == std::string_view::npos) {
+            if (getDimension(c, item->value, &val)) {
+                edges->start(val);
+                edges->top(val);
+                edges->end(val);
+                edges->bottom(val);
+            }
+            return true;
+        }
+
+        size_t index = 0;
+        for (;;) {
+            auto pos = str.find(',');
+            auto part = trim(str.substr(0, pos));
+            if (getDimension(c, necro::classifyAttrValue(part), &val)) {
+                switch (index) {
+                case 0: edges->start(val); break;
+                case 1: edges->top(val); break;
+                case 2: edges->end(val); break;
+                case 3: edges->bottom(val); break;
+                default: break;
+                }
+            }
+
+            if (pos == std::string_view::npos || ++index > 3) {
+                break;
+            }
+            str.remove_prefix(pos + 1);
+        }
+        return true;
+    }
+
+    int resolveLayoutLength(
+        const ukive::Context& c, ukive::AttrsRef attrs, const std::string& key)
+    {
+        auto item = attrs.find(key);
+        if (!item) {
+            return ukive::View::LS_AUTO;
+        }
+
+        int length;
+        if (getDimension(c, item->value, &length)) {
+            return length;
+        }
+
+        auto str = attrs.getRaw(*item);
+        if (str == necro::kAttrValLayoutAuto) {
+            return ukive::View::LS_AUTO;
+        }
+        if (str == necro::kAttrValLayoutFill) {
+            return ukive::View::LS_FILL;
+        }
+        if (str == necro::kAttrValLayoutFree) {
+            return ukive::View::LS_FREE;
+        }
+
+        DLOG(Log::ERR) << "Unknown attr: " << str;
+        return ukive::View::LS_AUTO;
+    }
+
+}
+
 namespace ukive {
 
     bool hasAttr(AttrsRef attrs, const std::string& key) {
-        auto it = attrs.find(key);
-        return it != attrs.end();
+        return attrs.find(key) != nullptr;
     }
 
     bool resolveDimension(
@@ -102,14 +240,13 @@ namespace ukive {
     int resolveAttrInt(
         AttrsRef attrs, const std::string& key, int def_val)
     {
-        auto it = attrs.find(key);
-        if (it != attrs.end()) {
-            int val = 0;
-            if (utl::stoi(it->second, &val)) {
-                return val;
+        auto item = attrs.find(key);
+        if (item) {
+            if (item->value.type == necro::AttrValueType::INT) {
+                return int32_t(item->value.value);
             }
             LOG(Log::WARNING) << "Cannot resolve int attr " << key
-                << ", val: " << it->second;
+                << ", val: " << attrs.getRaw(*item);
         }
         return def_val;
     }
@@ -117,14 +254,18 @@ namespace ukive {
     float resolveAttrFloat(
         AttrsRef attrs, const std::string& key, float def_val)
     {
-        auto it = attrs.find(key);
-        if (it != attrs.end()) {
-            float val = 0;
-            if (utl::stof(it->second, &val) == utl::SCR_OK) {
+        auto item = attrs.find(key);
+        if (item) {
+            if (item->value.type == necro::AttrValueType::INT) {
+                return float(int32_t(item->value.value));
+            }
+            if (item->value.type == necro::AttrValueType::FLOAT) {
+                float val;
+                std::memcpy(&val, &item->value.value, 4);
                 return val;
             }
             LOG(Log::WARNING) << "Cannot resolve float attr " << key
-                << ", val: " << it->second;
+                << ", val: " << attrs.getRaw(*item);
         }
         return def_val;
     }
@@ -132,14 +273,14 @@ namespace ukive {
     float resolveAttrDimension(
         const Context& c, AttrsRef attrs, const std::string& key, float def_val)
     {
-        auto it = attrs.find(key);
-        if (it != attrs.end()) {
-            float val = 0;
-            if (resolveDimension(c, it->second, &val)) {
+        auto item = attrs.find(key);
+        if (item) {
+            float val;
+            if (getDimension(c, item->value, &val)) {
                 return val;
             }
             LOG(Log::WARNING) << "Cannot resolve dimension attr " << key
-                << ", val: " << it->second;
+                << ", val: " << attrs.getRaw(*item);
         }
         return def_val;
     }
@@ -147,14 +288,24 @@ namespace ukive {
     dim resolveAttrDimensionRaw(
         AttrsRef attrs, const std::string& key, dimcref def_val)
     {
-        auto it = attrs.find(key);
-        if (it != attrs.end()) {
-            dim val;
-            if (resolveDimensionRaw(it->second, &val)) {
-                return val;
+        auto item = attrs.find(key);
+        if (item) {
+            float f;
+            std::memcpy(&f, &item->value.value, 4);
+
+            switch (item->value.type) {
+            case necro::AttrValueType::INT:
+                return dim::of_dp(float(int32_t(item->value.value)));
+            case necro::AttrValueType::FLOAT:
+                return dim::of_dp(f);
+            case necro::AttrValueType::DIMENSION:
+                return (item->value.unit == necro::DimUnit::PX) ?
+                    dim::of_px(int(f)) : dim::of_dp(f);
+            default:
+                break;
             }
             LOG(Log::WARNING) << "Cannot resolve dimension attr " << key
-                << ", val: " << it->second;
+                << ", val: " << attrs.getRaw(*item);
         }
         return def_val;
     }
@@ -162,16 +313,13 @@ namespace ukive {
     bool resolveAttrBool(
         AttrsRef attrs, const std::string& key, bool def_val)
     {
-        auto it = attrs.find(key);
-        if (it != attrs.end()) {
-            if (utl::isLitEqual(it->second, "true")) {
-                return true;
-            }
-            if (utl::isLitEqual(it->second, "false")) {
-                return false;
+        auto item = attrs.find(key);
+        if (item) {
+            if (item->value.type == necro::AttrValueType::BOOL) {
+                return item->value.value != 0;
             }
             LOG(Log::WARNING) << "Cannot resolve bool attr " << key
-                << ", val: " << it->second;
+                << ", val: " << attrs.getRaw(*item);
         }
         return def_val;
     }
@@ -179,9 +327,9 @@ namespace ukive {
     std::string resolveAttrString(
         AttrsRef attrs, const std::string& key, const std::string& def_val)
     {
-        auto it = attrs.find(key);
-        if (it != attrs.end()) {
-            return it->second;
+        auto item = attrs.find(key);
+        if (item) {
+            return std::string(attrs.getRaw(*item));
         }
         return def_val;
     }
@@ -189,11 +337,12 @@ namespace ukive {
     bool resolveAttrVisibility(
         AttrsRef attrs, const std::string& key, int* visibility)
     {
-        auto v_str = resolveAttrString(attrs, key, {});
-        if (v_str.empty()) {
+        auto item = attrs.find(key);
+        if (!item) {
             return false;
         }
 
+        auto v_str = attrs.getRaw(*item);
         if (v_str == necro::kAttrValViewShow) {
             *visibility = View::SHOW;
         } else if (v_str == necro::kAttrValViewHide) {
@@ -210,159 +359,39 @@ namespace ukive {
     bool resolveAttrPadding(
         const Context& c, AttrsRef attrs, const std::string& key, Padding* padding)
     {
-        auto padding_str = resolveAttrString(attrs, key, {});
-        if (!padding_str.empty()) {
-            auto paddings = utl::split(padding_str, ",");
-            if (paddings.size() > 0) {
-                int val;
-                auto padding_start = paddings[0];
-                utl::trim_self(&padding_start);
-                if (resolveDimension(c, padding_start, &val)) {
-                    padding->start(val);
-                    if (paddings.size() == 1) {
-                        padding->top(padding->start());
-                        padding->end(padding->start());
-                        padding->bottom(padding->start());
-                    }
-                }
-            }
-            if (paddings.size() > 1) {
-                int val;
-                auto padding_top = paddings[1];
-                utl::trim_self(&padding_top);
-                if (resolveDimension(c, padding_top, &val)) {
-                    padding->top(val);
-                }
-            }
-            if (paddings.size() > 2) {
-                int val;
-                auto padding_end = paddings[2];
-                utl::trim_self(&padding_end);
-                if (resolveDimension(c, padding_end, &val)) {
-                    padding->end(val);
-                }
-            }
-            if (paddings.size() > 3) {
-                int val;
-                auto padding_bottom = paddings[3];
-                utl::trim_self(&padding_bottom);
-                if (resolveDimension(c, padding_bottom, &val)) {
-                    padding->bottom(val);
-                }
-            }
-            return true;
-        }
-        return false;
+        return resolveAttrEdges(c, attrs, key, padding);
     }
 
     bool resolveAttrMargin(
         const Context& c, AttrsRef attrs, const std::string& key, Margin* margin)
     {
-        auto margin_str = resolveAttrString(attrs, key, {});
-        if (!margin_str.empty()) {
-            auto margins = utl::split(margin_str, ",");
-            if (margins.size() > 0) {
-                int val;
-                auto margin_start = margins[0];
-                utl::trim_self(&margin_start);
-                if (resolveDimension(c, margin_start, &val)) {
-                    margin->start(val);
-                    if (margins.size() == 1) {
-                        margin->top(val);
-                        margin->end(val);
-                        margin->bottom(val);
-                    }
-                }
-            }
-            if (margins.size() > 1) {
-                int val;
-                auto margin_top = margins[1];
-                utl::trim_self(&margin_top);
-                if (resolveDimension(c, margin_top, &val)) {
-                    margin->top(val);
-                }
-            }
-            if (margins.size() > 2) {
-                int val;
-                auto margin_end = margins[2];
-                utl::trim_self(&margin_end);
-                if (resolveDimension(c, margin_end, &val)) {
-                    margin->end(val);
-                }
-            }
-            if (margins.size() > 3) {
-                int val;
-                auto margin_bottom = margins[3];
-                utl::trim_self(&margin_bottom);
-                if (resolveDimension(c, margin_bottom, &val)) {
-                    margin->bottom(val);
-                }
-            }
-            return true;
-        }
-        return false;
+        return resolveAttrEdges(c, attrs, key, margin);
     }
 
     void resolveAttrLayoutSize(
         const Context& c, AttrsRef attrs, Size* size)
     {
-        auto width_attr = resolveAttrString(
-            attrs, necro::kAttrLayoutWidth, necro::kAttrValLayoutAuto);
-
-        int width;
-        if (!resolveDimension(c, width_attr, &width)) {
-            if (width_attr == necro::kAttrValLayoutAuto) {
-                size->width(View::LS_AUTO);
-            }
-            else if (width_attr == necro::kAttrValLayoutFill) {
-                size->width(View::LS_FILL);
-            }
-            else if (width_attr == necro::kAttrValLayoutFree) {
-                size->width(View::LS_FREE);
-            }
-            else {
-                DLOG(Log::ERR) << "Unknown attr: " << width_attr;
-                size->width(View::LS_AUTO);
-            }
-        } else {
-            size->width(width);
-        }
-
-        auto height_attr = resolveAttrString(
-            attrs, necro::kAttrLayoutHeight, necro::kAttrValLayoutAuto);
-
-        int height;
-        if (!resolveDimension(c, height_attr, &height)) {
-            if (height_attr == necro::kAttrValLayoutAuto) {
-                size->height(View::LS_AUTO);
-            }
-            else if (height_attr == necro::kAttrValLayoutFill) {
-                size->height(View::LS_FILL);
-            }
-            else if (height_attr == necro::kAttrValLayoutFree) {
-                size->height(View::LS_FREE);
-            }
-            else {
-                DLOG(Log::ERR) << "Unknown attr: " << height_attr;
-                size->height(View::LS_AUTO);
-            }
-        } else {
-            size->height(height);
-        }
+        size->width(resolveLayoutLength(c, attrs, necro::kAttrLayoutWidth));
+        size->height(resolveLayoutLength(c, attrs, necro::kAttrLayoutHeight));
     }
 
     bool resolveAttrColor(
         AttrsRef attrs, const std::string& key, Color* c)
     {
-        auto str = resolveAttrString(attrs, key, {});
-        if (str.empty()) {
+        auto item = attrs.find(key);
+        if (!item) {
             return false;
         }
 
-        if (key[0] == '#') {
-            return Color::parseARGB(str, c);
+        if (item->value.type == necro::AttrValueType::COLOR) {
+            *c = Color::ofARGB(item->value.value);
+            return true;
         }
 
+        auto str = attrs.getRaw(*item);
+        if (str.empty()) {
+            return false;
+        }
         return Color::parseName(str, c);
     }
 
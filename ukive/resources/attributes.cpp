@@ -0,0 +1,186 @@
+// Copyright (c) 2016 ucclkp <ucclkp@gmail.com>.
+// This file is part of ukive project.
+//
+// This program is licensed under GPLv3 license that can be
+// found in the LICENSE file.
+
+#include "ukive/resources/attributes.h"
+
+#include <algorithm>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+#include "utils/log.h"
+
+
+namespace {
+
+    /**
+     * 进程范围内的属性名表。
+     * 属性名保存在 deque 中，地址不会改变，因此可以用 string_view 作为键。
+     */
+    class KeyPool {
+    public:
+        ukive::Attributes::KeyId intern(const std::string_view& key, std::string_view* name) {
+            std::lock_guard<std::mutex> lg(mutex_);
+            auto it = ids_.find(key);
+            if (it != ids_.end()) {
+                *name = it->first;
+                return it->second;
+            }
+
+            auto id = ukive::Attributes::KeyId(names_.size());
+            names_.emplace_back(key);
+            ids_.insert({ names_.back(), id });
+            *name = names_.back();
+            return id;
+        }
+
+        bool find(const std::string_view& key, ukive::Attributes::KeyId* id) {
+            std::lock_guard<std::mutex> lg(mutex_);
+            auto it = ids_.find(key);
+            if (it == ids_.end()) {
+                return false;
+            }
+            *id = it->second;
+            return true;
+        }
+
+        std::string_view getName(ukive::Attributes::KeyId id) {
+            std::lock_guard<std::mutex> lg(mutex_);
+            if (id >= names_.size()) {
+                return {};
+            }
+            return names_[id];
+        }
+
+    private:
+        std::mutex mutex_;
+        std::deque<std::string> names_;
+        std::unordered_map<std::string_view, ukive::Attributes::KeyId> ids_;
+    };
+
+    // 属性数量不超过该值时，按名称查找属性直接逐项比较，无需计算哈希和加锁
+    const size_t kLinearFindLimit = 16;
+
+    KeyPool& getKeyPool() {
+        static KeyPool pool;
+        return pool;
+    }
+
+    bool itemLess(const ukive::Attributes::Item& item, ukive::Attributes::KeyId key) {
+        return item.key < key;
+    }
+
+}
+
+namespace ukive {
+
+    Attributes::Attributes() {}
+
+    Attributes::Attributes(
+        std::initializer_list<std::pair<std::string_view, std::string_view>> list)
+    {
+        size_t raw_size = 0;
+        for (const auto& pair : list) {
+            raw_size += pair.second.size();
+        }
+        reserve(list.size(), raw_size);
+
+        for (const auto& pair : list) {
+            set(pair.first, pair.second);
+        }
+    }
+
+    // static
+    Attributes::KeyId Attributes::internKey(const std::string_view& key) {
+        std::string_view name;
+        return getKeyPool().intern(key, &name);
+    }
+
+    // static
+    bool Attributes::findKey(const std::string_view& key, KeyId* id) {
+        return getKeyPool().find(key, id);
+    }
+
+    void Attributes::set(const std::string_view& key, const std::string_view& raw) {
+        std::string_view name;
+        auto id = getKeyPool().intern(key, &name);
+        set(id, name, raw, necro::classifyAttrValue(raw));
+    }
+
+    void Attributes::set(KeyId key, const std::string_view& raw, const necro::AttrValue& value) {
+        auto name = getKeyPool().getName(key);
+        if (name.empty()) {
+            LOG(Log::ERR) << "Invalid attribute key: " << key;
+            return;
+        }
+        set(key, name, raw, value);
+    }
+
+    void Attributes::set(
+        KeyId key, const std::string_view& name,
+        const std::string_view& raw, const necro::AttrValue& value)
+    {
+        if (raw_text_.size() + raw.size() > UINT32_MAX) {
+            LOG(Log::ERR) << "Attribute text is too large.";
+            return;
+        }
+
+        Item item;
+        item.key = key;
+        item.name = name;
+        item.raw_offset = uint32_t(raw_text_.size());
+        item.raw_length = uint32_t(raw.size());
+        item.value = value;
+        raw_text_.append(raw);
+
+        // 重复设置时，旧的原文仍留在缓冲区中
+        auto it = std::lower_bound(items_.begin(), items_.end(), key, itemLess);
+        if (it != items_.end() && it->key == key) {
+            *it = item;
+        } else {
+            items_.insert(it, item);
+        }
+    }
+
+    void Attributes::reserve(size_t count, size_t raw_size) {
+        items_.reserve(count);
+        raw_text_.reserve(raw_size);
+    }
+
+    const Attributes::Item* Attributes::find(const std::string_view& key) const {
+        if (items_.empty()) {
+            return nullptr;
+        }
+
+        if (items_.size() <= kLinearFindLimit) {
+            for (const auto& item : items_) {
+                if (item.name == key) {
+                    return &item;
+                }
+            }
+            return nullptr;
+        }
+
+        KeyId id;
+        if (!findKey(key, &id)) {
+            return nullptr;
+        }
+        return find(id);
+    }
+
+    const Attributes::Item* Attributes::find(KeyId key) const {
+        auto it = std::lower_bound(items_.begin(), items_.end(), key, itemLess);
+        if (it != items_.end() && it->key == key) {
+            return &*it;
+        }
+        return nullptr;
+    }
+
+    std::string_view Attributes::getRaw(const Item& item) const {
+        return std::string_view(raw_text_).substr(item.raw_offset, item.raw_length);
+    }
+
+}
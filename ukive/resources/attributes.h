@@ -7,15 +7,91 @@
 #ifndef UKIVE_RESOURCES_ATTRIBUTES_H_
 #define UKIVE_RESOURCES_ATTRIBUTES_H_
 
-#include <map>
+#include <initializer_list>
 #include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "necro/layout_binary.h"
 
 
 namespace ukive {
 
-    using Attributes = std::map<std::string, std::string>;
+    /**
+     * View 的属性集合。
+     * 属性名在进程范围内驻留为整数 id，属性按 id 排序保存在连续的数组中；
+     * 属性原文保存在同一个字符串缓冲区中，加入时即预先解析为带类型的值，
+     * 读取数值时无需再解析文本。
+     * 通常使用 attr_utils 中的函数读取属性。
+     */
+    class Attributes {
+    public:
+        using KeyId = uint32_t;
+
+        struct Item {
+            KeyId key;
+            // 驻留的属性名，在进程内一直有效
+            std::string_view name;
+            uint32_t raw_offset;
+            uint32_t raw_length;
+            necro::AttrValue value;
+        };
+
+        Attributes();
+        Attributes(std::initializer_list<std::pair<std::string_view, std::string_view>> list);
+
+        /**
+         * 驻留属性名，返回其 id。同一属性名在进程内总是得到相同的 id。
+         */
+        static KeyId internKey(const std::string_view& key);
+
+        /**
+         * 查找已驻留的属性名。
+         * @return 属性名未驻留过时返回 false，此时任何属性集合中都不会有该属性。
+         */
+        static bool findKey(const std::string_view& key, KeyId* id);
+
+        /**
+         * 设置属性。值由原文解析得到。
+         */
+        void set(const std::string_view& key, const std::string_view& raw);
+
+        /**
+         * 设置属性，使用已解析的值。
+         */
+        void set(KeyId key, const std::string_view& raw, const necro::AttrValue& value);
+
+        /**
+         * 预留属性数量和原文的总长度。
+         */
+        void reserve(size_t count, size_t raw_size);
+
+        const Item* find(const std::string_view& key) const;
+        const Item* find(KeyId key) const;
+
+        /**
+         * 获取属性原文，在本对象被修改或销毁前有效。
+         */
+        std::string_view getRaw(const Item& item) const;
+
+        bool empty() const { return items_.empty(); }
+        size_t size() const { return items_.size(); }
+
+        std::vector<Item>::const_iterator begin() const { return items_.begin(); }
+        std::vector<Item>::const_iterator end() const { return items_.end(); }
+
+    private:
+        void set(
+            KeyId key, const std::string_view& name,
+            const std::string_view& raw, const necro::AttrValue& value);
+
+        std::vector<Item> items_;
+        std::string raw_text_;
+    };
+
     using AttrsRef = const Attributes&;
 
 }
 
-#endif  // UKIVE_RESOURCES_ATTRIBUTES_H_
\ No newline at end of file
+#endif  // UKIVE_RESOURCES_ATTRIBUTES_H_
@@ -0,0 +1,175 @@
+// Copyright (c) 2016 ucclkp <ucclkp@gmail.com>.
+// This file is part of ukive project.
+//
+// This program is licensed under GPLv3 license that can be
+// found in the LICENSE file.
+
+#include "ukive/resources/layout_binary.h"
+
+#include <cstring>
+
+#include "utils/log.h"
+
+
+namespace {
+
+    uint16_t readU16(const uint8_t* p) {
+        return uint16_t((p[0] << 8) | p[1]);
+    }
+
+    uint32_t readU32(const uint8_t* p) {
+        return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) |
+            (uint32_t(p[2]) << 8) | uint32_t(p[3]);
+    }
+
+    bool isRangeValid(size_t offset, size_t count, size_t item_size, size_t total) {
+        if (offset > total) {
+            return false;
+        }
+        return count <= (total - offset) / item_size;
+    }
+
+}
+
+namespace ukive {
+
+    LayoutBinary::LayoutBinary() {}
+
+    bool LayoutBinary::load(const std::filesystem::path& path) {
+        auto data = ByteData::mapFile(path);
+        if (!data) {
+            return false;
+        }
+        return load(data);
+    }
+
+    bool LayoutBinary::load(const GPtr<ByteData>& data) {
+        if (!data) {
+            return false;
+        }
+
+        data_ = data;
+        ptr_ = static_cast<const uint8_t*>(data->getConstData());
+        size_ = data->getSize();
+
+        if (!validate()) {
+            data_.reset();
+            ptr_ = nullptr;
+            size_ = 0;
+            return false;
+        }
+        return true;
+    }
+
+    bool LayoutBinary::validate() {
+        if (!ptr_ || size_ < necro::kLayoutBinaryHeaderSize) {
+            return false;
+        }
+
+        if (std::memcmp(ptr_, necro::kLayoutBinaryMagic, 4) != 0) {
+            DLOG(Log::ERR) << "Invalid layout binary magic";
+            return false;
+        }
+        if (readU16(ptr_ + 4) != necro::kLayoutBinaryVersion) {
+            DLOG(Log::WARNING) << "Unsupported layout binary version: " << readU16(ptr_ + 4);
+            return false;
+        }
+
+        string_count_ = readU32(ptr_ + 8);
+        string_offset_ = readU32(ptr_ + 12);
+        node_count_ = readU32(ptr_ + 16);
+        node_offset_ = readU32(ptr_ + 20);
+        attr_count_ = readU32(ptr_ + 24);
+        attr_offset_ = readU32(ptr_ + 28);
+
+        if (!isRangeValid(string_offset_, string_count_, necro::kLayoutBinaryStringSize, size_) ||
+            !isRangeValid(node_offset_, node_count_, necro::kLayoutBinaryNodeSize, size_) ||
+            !isRangeValid(attr_offset_, attr_count_, necro::kLayoutBinaryAttrSize, size_))
+        {
+            DLOG(Log::ERR) << "Invalid layout binary tables";
+            return false;
+        }
+
+        // 字符串须位于文件内且以 0 结尾
+        for (uint32_t i = 0; i < string_count_; ++i) {
+            auto p = ptr_ + string_offset_ + size_t(i) * necro::kLayoutBinaryStringSize;
+            uint32_t offset = readU32(p);
+            uint32_t length = readU32(p + 4);
+            if (offset > size_ || length >= size_ - offset || ptr_[offset + length] != 0) {
+                DLOG(Log::ERR) << "Invalid layout binary string: " << i;
+                return false;
+            }
+        }
+
+        for (uint32_t i = 0; i < attr_count_; ++i) {
+            auto attr = getAttr(i);
+            if (attr.key >= string_count_ ||
+                attr.raw >= string_count_ ||
+                attr.val.type > necro::AttrValueType::COLOR)
+            {
+                DLOG(Log::ERR) << "Invalid layout binary attr: " << i;
+                return false;
+            }
+        }
+
+        // 先序排列的节点：每个节点的子树须恰好位于节点表内
+        size_t pending = node_count_ > 0 ? 1 : 0;
+        for (uint32_t i = 0; i < node_count_; ++i) {
+            auto node = getNode(i);
+            if (node.type >= string_count_ ||
+                node.attr_start > attr_count_ ||
+                node.attr_count > attr_count_ - node.attr_start)
+            {
+                DLOG(Log::ERR) << "Invalid layout binary node: " << i;
+                return false;
+            }
+
+            if (pending == 0) {
+                DLOG(Log::ERR) << "Layout binary has more than one root";
+                return false;
+            }
+            pending = pending - 1 + node.child_count;
+            if (pending > node_count_ - i - 1) {
+                DLOG(Log::ERR) << "Invalid layout binary child count: " << i;
+                return false;
+            }
+        }
+
+        if (node_count_ == 0 || pending != 0) {
+            DLOG(Log::ERR) << "Invalid layout binary tree";
+            return false;
+        }
+        return true;
+    }
+
+    std::string_view LayoutBinary::getString(uint32_t index) const {
+        auto p = ptr_ + string_offset_ + size_t(index) * necro::kLayoutBinaryStringSize;
+        uint32_t offset = readU32(p);
+        uint32_t length = readU32(p + 4);
+        return std::string_view(reinterpret_cast<const char*>(ptr_ + offset), length);
+    }
+
+    LayoutBinary::Node LayoutBinary::getNode(size_t index) const {
+        auto p = ptr_ + node_offset_ + index * necro::kLayoutBinaryNodeSize;
+
+        Node node;
+        node.type = readU32(p);
+        node.attr_start = readU32(p + 4);
+        node.attr_count = readU32(p + 8);
+        node.child_count = readU32(p + 12);
+        return node;
+    }
+
+    LayoutBinary::Attr LayoutBinary::getAttr(size_t index) const {
+        auto p = ptr_ + attr_offset_ + index * necro::kLayoutBinaryAttrSize;
+
+        Attr attr;
+        attr.key = readU32(p);
+        attr.val.type = necro::AttrValueType(p[4]);
+        attr.val.unit = necro::DimUnit(p[5]);
+        attr.raw = readU32(p + 8);
+        attr.val.value = readU32(p + 12);
+        return attr;
+    }
+
+}
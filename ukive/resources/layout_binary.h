@@ -0,0 +1,73 @@
+// Copyright (c) 2016 ucclkp <ucclkp@gmail.com>.
+// This file is part of ukive project.
+//
+// This program is licensed under GPLv3 license that can be
+// found in the LICENSE file.
+
+#ifndef UKIVE_RESOURCES_LAYOUT_BINARY_H_
+#define UKIVE_RESOURCES_LAYOUT_BINARY_H_
+
+#include <filesystem>
+#include <string_view>
+
+#include "ukive/graphics/byte_data.h"
+
+#include "necro/layout_binary.h"
+
+
+namespace ukive {
+
+    /**
+     * necro 生成的二进制布局。
+     * 文件被映射到内存中，load() 时校验所有的位置和下标，之后的访问不再检查。
+     */
+    class LayoutBinary {
+    public:
+        struct Node {
+            uint32_t type;
+            uint32_t attr_start;
+            uint32_t attr_count;
+            uint32_t child_count;
+        };
+
+        struct Attr {
+            uint32_t key;
+            uint32_t raw;
+            necro::AttrValue val;
+        };
+
+        LayoutBinary();
+
+        bool load(const std::filesystem::path& path);
+        bool load(const GPtr<ByteData>& data);
+
+        size_t getStringCount() const { return string_count_; }
+        size_t getNodeCount() const { return node_count_; }
+        size_t getAttrCount() const { return attr_count_; }
+
+        /**
+         * 获取字符串表中的第 index 个字符串。
+         * 返回的字符串以 0 结尾，在本对象销毁前有效。
+         */
+        std::string_view getString(uint32_t index) const;
+        Node getNode(size_t index) const;
+        Attr getAttr(size_t index) const;
+
+    private:
+        bool validate();
+
+        GPtr<ByteData> data_;
+        const uint8_t* ptr_ = nullptr;
+        size_t size_ = 0;
+
+        uint32_t string_count_ = 0;
+        uint32_t string_offset_ = 0;
+        uint32_t node_count_ = 0;
+        uint32_t node_offset_ = 0;
+        uint32_t attr_count_ = 0;
+        uint32_t attr_offset_ = 0;
+    };
+
+}
+
+#endif  // UKIVE_RESOURCES_LAYOUT_BINARY_H_
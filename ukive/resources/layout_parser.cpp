@@ -7,6 +7,7 @@
 #include "ukive/resources/layout_parser.h"
 
 #include <fstream>
+#include <iterator>
 
 #include "utils/log.h"
 #include "utils/strings/int_conv.hpp"
@@ -15,6 +16,7 @@
 
 #include "ukive/app/application.h"
 #include "ukive/diagnostic/grid_view.h"
+#include "ukive/resources/layout_binary.h"
 #include "ukive/resources/resource_manager.h"
 #include "ukive/views/button.h"
 #include "ukive/views/chart_view.h"
@@ -39,6 +41,7 @@
 #include "ukive/views/tab/tab_view.h"
 #include "ukive/views/tree/tree_node_button.h"
 
+#include "necro/layout_binary.h"
 #include "necro/layout_constants.h"
 
 
@@ -51,14 +54,20 @@
 }
 
 
+namespace {
+
+    const ukive::Attributes::KeyId kInvalidKey = ~ukive::Attributes::KeyId(0);
+
+}
+
 namespace ukive {
 
     LayoutParser::ViewMap LayoutParser::view_map_;
     LayoutParser::ViewMap LayoutParser::view_map2_;
+    std::map<int, LayoutParser::TemplatePtr> LayoutParser::template_cache_;
 
     LayoutParser::LayoutParser()
-        : has_read_lim_(false),
-          root_parent_(nullptr) {}
+        : has_read_lim_(false) {}
 
     // static
     void LayoutParser::initialize() {
@@ -105,6 +114,9 @@ namespace ukive {
         auto& info = view_map2_[std::string(name)];
         info.is_layout = is_layout;
         info.creator = std::move(ctor);
+
+        // 缓存的布局中保存有 ViewInfo 的指针
+        clearCache();
     }
 
     // static
@@ -112,6 +124,7 @@ namespace ukive {
         auto it = view_map2_.find(name);
         if (it != view_map2_.end()) {
             view_map2_.erase(it);
+            clearCache();
         }
     }
 
@@ -119,58 +132,119 @@ namespace ukive {
     View* LayoutParser::createView(
         const std::string_view& name, Context c, AttrsRef attrs)
     {
-        Creator* handler;
+        auto info = findViewInfo(name);
+        if (!info) {
+            LOG(Log::ERR) << "Cannot find View: " << name;
+            return nullptr;
+        }
+
+        return info->creator(c, attrs);
+    }
+
+    // static
+    const LayoutParser::ViewInfo* LayoutParser::findViewInfo(const std::string_view& name) {
         auto it = view_map_.find(name);
         if (it != view_map_.end()) {
-            handler = &it->second.creator;
+            return &it->second;
+        }
+
+        auto it2 = view_map2_.find(name);
+        if (it2 != view_map2_.end()) {
+            return &it2->second;
+        }
+        return nullptr;
+    }
+
+    // static
+    View* LayoutParser::from(Context c, LayoutView* parent, int layout_id) {
+        TemplatePtr tmpl;
+        auto it = template_cache_.find(layout_id);
+        if (it != template_cache_.end()) {
+            tmpl = it->second;
         } else {
-            auto it2 = view_map2_.find(name);
-            if (it2 != view_map2_.end()) {
-                handler = &it2->second.creator;
-            } else {
-                LOG(Log::ERR) << "Cannot find View: " << name;
+            tmpl = LayoutParser().load(layout_id);
+            if (!tmpl) {
                 return nullptr;
             }
+            template_cache_[layout_id] = tmpl;
         }
 
-        auto& view_constructor = *handler;
-        return view_constructor(c, attrs);
+        View* root_view = nullptr;
+        if (!inflate(*tmpl, c, parent, &root_view)) {
+            ubassert(false);
+            return nullptr;
+        }
+        return root_view;
     }
 
     // static
-    View* LayoutParser::from(Context c, LayoutView* parent, int layout_id) {
-        return LayoutParser().parse(c, parent, layout_id);
+    View* LayoutParser::fromXML(Context c, LayoutView* parent, std::istream& reader) {
+        auto tmpl = LayoutParser().loadXML(reader);
+        if (!tmpl) {
+            return nullptr;
+        }
+
+        View* root_view = nullptr;
+        if (!inflate(*tmpl, c, parent, &root_view)) {
+            return nullptr;
+        }
+        return root_view;
     }
 
-    View* LayoutParser::parse(Context c, LayoutView* parent, int layout_id) {
-        context_ = c;
-        root_parent_ = parent;
+    // static
+    void LayoutParser::clearCache() {
+        template_cache_.clear();
+    }
 
+    LayoutParser::TemplatePtr LayoutParser::load(int layout_id) {
         std::filesystem::path xml_file_path;
         if (!fetchLayoutFileName(layout_id, &xml_file_path)) {
-            return nullptr;
+            return {};
+        }
+
+        auto tmpl = std::make_shared<TemplateNode>();
+
+        // 优先使用 necro 生成的二进制布局
+        auto bin_file_path = xml_file_path;
+        bin_file_path.replace_extension(necro::kLayoutBinaryExt);
+
+        LayoutBinary bin;
+        if (bin.load(bin_file_path)) {
+            bin_types_.assign(bin.getStringCount(), nullptr);
+            bin_keys_.assign(bin.getStringCount(), kInvalidKey);
+
+            size_t index = 0;
+            if (!buildFromBinary(bin, &index, true, false, tmpl.get())) {
+                ubassert(false);
+                return {};
+            }
+            return tmpl;
         }
 
         std::ifstream reader(xml_file_path, std::ios::binary);
         if (!reader) {
             ubassert(false);
-            return nullptr;
+            return {};
         }
 
+        auto xml_tmpl = loadXML(reader);
+        ubassert(xml_tmpl);
+        return xml_tmpl;
+    }
+
+    LayoutParser::TemplatePtr LayoutParser::loadXML(std::istream& reader) {
         utl::XMLParser parser;
         std::shared_ptr<utl::XMLParser::Element> root;
         if (!parser.parse(reader, &root)) {
-            ubassert(false);
-            return nullptr;
+            LOG(Log::ERR) << "Failed to parse the layout XML.";
+            return {};
         }
 
-        View* root_view = nullptr;
-        if (!traverseTree(root, &root_view)) {
-            ubassert(false);
-            return nullptr;
+        auto tmpl = std::make_shared<TemplateNode>();
+        if (!buildFromTree(root, true, false, tmpl.get())) {
+            return {};
         }
-
-        return root_view;
+        return tmpl;
     }
 
     bool LayoutParser::fetchLayoutFileName(int layout_id, std::filesystem::path* file_name) {
@@ -189,33 +263,23 @@ namespace ukive {
                 return false;
             }
 
-            char buf;
-            std::string str;
-            bool prev_r = false;
-            std::vector<std::string> lines;
-            for (;;) {
-                id_file_reader.read(&buf, 1);
-                if (id_file_reader.bad()) {
-                    ubassert(false);
-                    return false;
-                }
-                if (id_file_reader.eof()) {
-                    break;
-                }
+            // 一次读入整个文件后再分行
+            std::string content(
+                (std::istreambuf_iterator<char>(id_file_reader)),
+                std::istreambuf_iterator<char>());
+            if (id_file_reader.bad()) {
+                ubassert(false);
+                return false;
+            }
 
-                if (buf == '\r') {
-                    lines.push_back(str);
-                    str.clear();
-                    prev_r = true;
-                } else if (buf == '\n') {
-                    if (!prev_r) {
-                        lines.push_back(str);
-                        str.clear();
+            std::vector<std::string> lines;
+            size_t line_start = 0;
+            for (size_t i = 0; i <= content.size(); ++i) {
+                if (i == content.size() || content[i] == '\r' || content[i] == '\n') {
+                    if (i > line_start) {
+                        lines.push_back(content.substr(line_start, i - line_start));
                     }
-                    prev_r = false;
-                } else {
-                    str.push_back(buf);
-                    prev_r = false;
+                    line_start = i + 1;
                 }
             }
 
@@ -248,51 +312,148 @@ namespace ukive {
         return true;
     }
 
-    bool LayoutParser::traverseTree(const ElementPtr& element, View** parent) {
-        ubassert(parent != nullptr);
-        if (!element || !parent) {
+    bool LayoutParser::buildFromTree(
+        const ElementPtr& element, bool is_root, bool parent_is_layout, TemplateNode* node)
+    {
+        if (!element) {
             return false;
         }
 
-        if (*parent && !(*parent)->isLayoutView()) {
+        if (!is_root && !parent_is_layout) {
             LOG(Log::ERR) << "The parent of the View: " << element->tag_name << " is not a LayoutView.";
             return false;
         }
 
-        View* cur_view;
+        bool is_layout;
         if (element->tag_name == "RadioGroup") {
-            if (!*parent) {
+            if (is_root) {
                 LOG(Log::ERR) << element->tag_name << " cannot be root!";
                 return false;
             }
+            is_layout = parent_is_layout;
+        } else {
+            node->info = findViewInfo(element->tag_name);
+            if (!node->info) {
+                LOG(Log::ERR) << "Cannot find View: " << element->tag_name;
+                return false;
+            }
+            is_layout = node->info->is_layout;
+
+            size_t raw_size = 0;
+            for (const auto& pair : element->attrs) {
+                raw_size += pair.second.size();
+            }
+
+            node->attrs.reserve(element->attrs.size(), raw_size);
+            for (const auto& pair : element->attrs) {
+                node->attrs.set(pair.first, pair.second);
+            }
+        }
+
+        for (const auto& content : element->contents) {
+            if (content.type != utl::xml::Content::Type::Element) {
+                continue;
+            }
+
+            node->children.emplace_back();
+            if (!buildFromTree(content.element, false, is_layout, &node->children.back())) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool LayoutParser::buildFromBinary(
+        const LayoutBinary& bin, size_t* index,
+        bool is_root, bool parent_is_layout, TemplateNode* node)
+    {
+        auto bin_node = bin.getNode(*index);
+        ++*index;
+
+        auto type_name = bin.getString(bin_node.type);
+        if (!is_root && !parent_is_layout) {
+            LOG(Log::ERR) << "The parent of the View: " << type_name << " is not a LayoutView.";
+            return false;
+        }
+
+        bool is_layout;
+        if (type_name == "RadioGroup") {
+            if (is_root) {
+                LOG(Log::ERR) << type_name << " cannot be root!";
+                return false;
+            }
+            is_layout = parent_is_layout;
+        } else {
+            auto& info = bin_types_[bin_node.type];
+            if (!info) {
+                info = findViewInfo(type_name);
+                if (!info) {
+                    LOG(Log::ERR) << "Cannot find View: " << type_name;
+                    return false;
+                }
+            }
+            node->info = info;
+            is_layout = info->is_layout;
+
+            node->attrs.reserve(bin_node.attr_count, 0);
+            for (uint32_t i = 0; i < bin_node.attr_count; ++i) {
+                auto attr = bin.getAttr(bin_node.attr_start + i);
+                auto& key = bin_keys_[attr.key];
+                if (key == kInvalidKey) {
+                    key = Attributes::internKey(bin.getString(attr.key));
+                }
+                node->attrs.set(key, bin.getString(attr.raw), attr.val);
+            }
+        }
+
+        node->children.resize(bin_node.child_count);
+        for (auto& child : node->children) {
+            if (!buildFromBinary(bin, index, false, is_layout, &child)) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    // static
+    bool LayoutParser::inflate(
+        const TemplateNode& node, Context c, LayoutView* root_parent, View** parent)
+    {
+        ubassert(parent != nullptr);
+
+        View* cur_view;
+        if (!node.info) {
             RadioButton::StartGroup();
             cur_view = *parent;
         } else {
-            cur_view = createView(element->tag_name, context_, element->attrs);
+            cur_view = node.info->creator(c, node.attrs);
+            if (!cur_view) {
+                return false;
+            }
+
             if (!*parent) {
                 *parent = cur_view;
-                if (root_parent_) {
-                    auto lp = root_parent_->makeExtraLayoutInfo(element->attrs);
+                if (root_parent) {
+                    auto lp = root_parent->makeExtraLayoutInfo(node.attrs);
                     cur_view->setExtraLayoutInfo(lp);
                 }
             } else {
                 auto lv = static_cast<LayoutView*>(*parent);
-                auto lp = lv->makeExtraLayoutInfo(element->attrs);
+                auto lp = lv->makeExtraLayoutInfo(node.attrs);
                 cur_view->setExtraLayoutInfo(lp);
                 lv->addView(cur_view);
             }
         }
 
-        for (const auto& content : element->contents) {
-            if (content.type != utl::xml::Content::Type::Element) {
-                continue;
-            }
-            if (!traverseTree(content.element, &cur_view)) {
+        for (const auto& child : node.children) {
+            if (!inflate(child, c, root_parent, &cur_view)) {
                 return false;
             }
         }
 
-        if (element->tag_name == "RadioGroup") {
+        if (!node.info) {
             RadioButton::EndGroup();
         }
 
@@ -9,7 +9,10 @@
 
 #include <filesystem>
 #include <functional>
+#include <istream>
 #include <map>
+#include <memory>
+#include <vector>
 
 #include "utils/xml/xml_structs.h"
 
@@ -28,6 +31,7 @@ namespace ukive {
 
     class View;
     class LayoutView;
+    class LayoutBinary;
 
     class LayoutParser {
     public:
@@ -56,22 +60,72 @@ namespace ukive {
         static View* createView(
             const std::string_view& name, Context c, AttrsRef attrs);
 
+        /**
+         * 根据布局 id 创建 View 树。
+         * 首次使用某个布局时读取并解析布局文件，结果缓存在进程内；
+         * 之后再创建同一布局时只需构造 View，不再读取文件。
+         */
         static View* from(Context c, LayoutView* parent, int layout_id);
 
+        /**
+         * 从 XML 文本创建 View 树。
+         * 每次调用都会重新解析，结果不进入缓存。
+         */
+        static View* fromXML(Context c, LayoutView* parent, std::istream& reader);
+
+        /**
+         * 丢弃缓存的布局。
+         * 增删 View 类型时会自动调用。
+         */
+        static void clearCache();
+
     private:
         using ElementPtr = std::shared_ptr<utl::xml::Element>;
 
-        View* parse(Context c, LayoutView* parent, int layout_id);
+        /**
+         * 解析后的布局节点，保存创建 View 所需的类型和属性。
+         */
+        struct TemplateNode {
+            // 为 nullptr 时表示 RadioGroup
+            const ViewInfo* info = nullptr;
+            Attributes attrs;
+            std::vector<TemplateNode> children;
+        };
+
+        using TemplatePtr = std::shared_ptr<const TemplateNode>;
+
+        static const ViewInfo* findViewInfo(const std::string_view& name);
+
+        TemplatePtr load(int layout_id);
+        TemplatePtr loadXML(std::istream& reader);
         bool fetchLayoutFileName(int layout_id, std::filesystem::path* file_name);
-        bool traverseTree(const ElementPtr& element, View** parent);
+        bool buildFromTree(
+            const ElementPtr& element, bool is_root, bool parent_is_layout, TemplateNode* node);
+
+        /**
+         * 从 necro 生成的二进制布局构建布局节点。
+         * @param index 当前节点在节点表中的下标，返回时指向下一个兄弟节点。
+         */
+        bool buildFromBinary(
+            const LayoutBinary& bin, size_t* index,
+            bool is_root, bool parent_is_layout, TemplateNode* node);
+
+        static bool inflate(
+            const TemplateNode& node, Context c, LayoutView* root_parent, View** parent);
 
         bool has_read_lim_;
-        Context context_;
-        LayoutView* root_parent_;
         std::map<int, std::filesystem::path> layout_id_map_;
 
+        // 二进制布局中类型名的下标 -> ViewInfo，首次使用时查找
+        std::vector<const ViewInfo*> bin_types_;
+        // 二进制布局中属性名的下标 -> 驻留的属性名 id，首次使用时驻留
+        std::vector<Attributes::KeyId> bin_keys_;
+
         static ViewMap view_map_;
         static ViewMap view_map2_;
+
+        // 布局 id -> 解析后的布局，只在 UI 线程中使用
+        static std::map<int, TemplatePtr> template_cache_;
     };
 
 }
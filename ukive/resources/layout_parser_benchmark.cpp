@@ -0,0 +1,84 @@
+// Copyright (c) 2016 ucclkp <ucclkp@gmail.com>.
+// This file is part of ukive project.
+//
+// This program is licensed under GPLv3 license that can be
+// found in the LICENSE file.
+
+#include "ukive/resources/layout_parser_benchmark.h"
+
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include "utils/log.h"
+#include "utils/time_utils.h"
+
+#include "ukive/resources/layout_parser.h"
+#include "ukive/views/view.h"
+#include "ukive/window/context.h"
+
+
+namespace {
+
+    // 根布局下有 kRows 行，每行 kColumns 个 TextView，共 1 + kRows * (1 + kColumns) 个 View
+    const int kRows = 40;
+    const int kColumns = 49;
+    const int kRounds = 10;
+
+    /**
+     * 生成布局 XML。每个 TextView 带有 8 个属性，
+     * 包括单值和多值的边距，以及需要解析的尺寸和颜色。
+     */
+    std::string makeLayoutXML() {
+        std::ostringstream xml;
+        xml << "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+            << "<SequenceLayout width=\"fill\" height=\"free\">\n";
+        for (int r = 0; r < kRows; ++r) {
+            xml << "  <SequenceLayout width=\"fill\" height=\"auto\" orientation=\"horizontal\">\n";
+            for (int c = 0; c < kColumns; ++c) {
+                xml << "    <TextView"
+                    << " width=\"auto\" height=\"auto\""
+                    << " margin=\"4\" padding=\"2, 4, 2, 4\""
+                    << " text=\"Item " << (r * kColumns + c) << "\""
+                    << " text_size=\"13dp\" text_color=\"#FF333333\""
+                    << " auto_wrap=\"false\" />\n";
+            }
+            xml << "  </SequenceLayout>\n";
+        }
+        xml << "</SequenceLayout>\n";
+        return xml.str();
+    }
+
+}
+
+namespace ukive {
+
+    void runLayoutParserBenchmark() {
+        auto xml = makeLayoutXML();
+        int view_count = 1 + kRows * (1 + kColumns);
+
+        Context c;
+        uint64_t elapsed = 0;
+        int succeeded = 0;
+        for (int i = 0; i < kRounds; ++i) {
+            std::istringstream reader(xml);
+
+            auto start = utl::TimeUtils::upTimeNanos();
+            std::unique_ptr<View> root(LayoutParser::fromXML(c, nullptr, reader));
+            elapsed += utl::TimeUtils::upTimeNanos() - start;
+
+            if (!root) {
+                LOG(Log::ERR) << "LayoutParser benchmark: failed to inflate the layout.";
+                return;
+            }
+            ++succeeded;
+        }
+
+        auto pass_ms = double(elapsed) / succeeded / 1000000.0;
+        LOG(Log::INFO) << "LayoutParser benchmark, parse + inflate "
+            << view_count << " views: "
+            << pass_ms << " ms/pass, "
+            << (pass_ms * 1000.0 / view_count) << " us/view";
+    }
+
+}
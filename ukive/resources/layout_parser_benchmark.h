@@ -0,0 +1,21 @@
+// Copyright (c) 2016 ucclkp <ucclkp@gmail.com>.
+// This file is part of ukive project.
+//
+// This program is licensed under GPLv3 license that can be
+// found in the LICENSE file.
+
+#ifndef UKIVE_RESOURCES_LAYOUT_PARSER_BENCHMARK_H_
+#define UKIVE_RESOURCES_LAYOUT_PARSER_BENCHMARK_H_
+
+
+namespace ukive {
+
+    /**
+     * 测量通过 LayoutParser 从 XML 创建约 2000 个 View 的耗时，结果写入日志。
+     * 需要在 Application 初始化之后调用。
+     */
+    void runLayoutParserBenchmark();
+
+}
+
+#endif  // UKIVE_RESOURCES_LAYOUT_PARSER_BENCHMARK_H_
@@ -0,0 +1,27 @@
+// Copyright (c) 2016 ucclkp <ucclkp@gmail.com>.
+// This file is part of ukive project.
+//
+// This program is licensed under GPLv3 license that can be
+// found in the LICENSE file.
+
+#ifndef UKIVE_SYSTEM_CPU_FEATURES_H_
+#define UKIVE_SYSTEM_CPU_FEATURES_H_
+
+
+namespace ukive {
+
+    /**
+     * 运行时检测 CPU 是否支持 SSE2。
+     * 在非 x86 平台上返回 false。
+     */
+    bool hasSSE2();
+
+    /**
+     * 运行时检测 CPU 和操作系统是否支持 AVX2。
+     * 在非 x86 平台上返回 false。
+     */
+    bool hasAVX2();
+
+}
+
+#endif  // UKIVE_SYSTEM_CPU_FEATURES_H_
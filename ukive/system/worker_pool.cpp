@@ -0,0 +1,89 @@
+// Copyright (c) 2016 ucclkp <ucclkp@gmail.com>.
+// This file is part of ukive project.
+//
+// This program is licensed under GPLv3 license that can be
+// found in the LICENSE file.
+
+#include "ukive/system/worker_pool.h"
+
+#include <algorithm>
+
+#include "utils/log.h"
+
+
+namespace ukive {
+
+    // static
+    std::unique_ptr<WorkerPool> WorkerPool::instance_;
+
+    // static
+    WorkerPool* WorkerPool::getInstance() {
+        if (!instance_) {
+            // 留出一个核心给 UI 线程
+            size_t count = std::thread::hardware_concurrency();
+            count = (std::max)(size_t(1), (std::min)(size_t(4), count > 1 ? count - 1 : 1));
+            instance_ = std::make_unique<WorkerPool>(count);
+        }
+        return instance_.get();
+    }
+
+    WorkerPool::WorkerPool(size_t thread_count) {
+        ubassert(thread_count > 0);
+        for (size_t i = 0; i < thread_count; ++i) {
+            workers_.emplace_back(&WorkerPool::onWork, this);
+        }
+    }
+
+    WorkerPool::~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lg(mutex_);
+            is_finished_ = true;
+            tasks_.clear();
+        }
+        cv_.notify_all();
+
+        for (auto& worker : workers_) {
+            worker.join();
+        }
+    }
+
+    void WorkerPool::post(Task&& task) {
+        if (!task) {
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lg(mutex_);
+            tasks_.push_back(std::move(task));
+        }
+        cv_.notify_one();
+    }
+
+    void WorkerPool::cancelPending() {
+        std::lock_guard<std::mutex> lg(mutex_);
+        tasks_.clear();
+    }
+
+    size_t WorkerPool::getThreadCount() const {
+        return workers_.size();
+    }
+
+    void WorkerPool::onWork() {
+        for (;;) {
+            Task task;
+            {
+                std::unique_lock<std::mutex> ul(mutex_);
+                cv_.wait(ul, [this] { return is_finished_ || !tasks_.empty(); });
+                if (is_finished_) {
+                    return;
+                }
+
+                task = std::move(tasks_.front());
+                tasks_.pop_front();
+            }
+
+            task();
+        }
+    }
+
+}
@@ -0,0 +1,61 @@
+// Copyright (c) 2016 ucclkp <ucclkp@gmail.com>.
+// This file is part of ukive project.
+//
+// This program is licensed under GPLv3 license that can be
+// found in the LICENSE file.
+
+#ifndef UKIVE_SYSTEM_WORKER_POOL_H_
+#define UKIVE_SYSTEM_WORKER_POOL_H_
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace ukive {
+
+    /**
+     * 用于在 UI 线程之外执行耗时任务（如图像解码）的线程池。
+     * 任务按提交顺序执行；任务结束后若需要更新 UI，
+     * 应通过 utl::Cycler 将结果投递回 UI 线程。
+     */
+    class WorkerPool {
+    public:
+        using Task = std::function<void()>;
+
+        static WorkerPool* getInstance();
+
+        explicit WorkerPool(size_t thread_count);
+        ~WorkerPool();
+
+        WorkerPool(const WorkerPool&) = delete;
+        WorkerPool& operator=(const WorkerPool&) = delete;
+
+        void post(Task&& task);
+
+        /**
+         * 移除所有尚未开始执行的任务。
+         */
+        void cancelPending();
+
+        size_t getThreadCount() const;
+
+    private:
+        void onWork();
+
+        static std::unique_ptr<WorkerPool> instance_;
+
+        std::vector<std::thread> workers_;
+        std::deque<Task> tasks_;
+        std::mutex mutex_;
+        std::condition_variable cv_;
+        bool is_finished_ = false;
+    };
+
+}
+
+#endif  // UKIVE_SYSTEM_WORKER_POOL_H_
@@ -0,0 +1,254 @@
+// Copyright (c) 2016 ucclkp <ucclkp@gmail.com>.
+// This file is part of ukive project.
+//
+// This program is licensed under GPLv3 license that can be
+// found in the LICENSE file.
+
+#include "ukive/text/edit_journal.h"
+
+#include "utils/log.h"
+#include "utils/time_utils.h"
+
+
+namespace {
+
+    // 默认的内存上限，单位为字节
+    const size_t kDefaultMemoryLimit = 32 * 1024 * 1024;
+
+    // 两次输入的间隔超过该值（毫秒）时，不再合并
+    const uint64_t kCoalesceInterval = 1000;
+
+}
+
+namespace ukive {
+
+    EditJournal::EditJournal()
+        : limit_(kDefaultMemoryLimit) {}
+
+    void EditJournal::setMemoryLimit(size_t limit) {
+        limit_ = limit;
+        trim();
+    }
+
+    size_t EditJournal::getMemoryLimit() const {
+        return limit_;
+    }
+
+    size_t EditJournal::getMemoryUsage() const {
+        return usage_;
+    }
+
+    void EditJournal::beginGroup() {
+        if (group_depth_++ == 0) {
+            is_group_started_ = false;
+        }
+    }
+
+    void EditJournal::endGroup() {
+        if (group_depth_ <= 0) {
+            ubassert(false);
+            return;
+        }
+        if (--group_depth_ == 0) {
+            is_group_started_ = false;
+            is_sealed_ = true;
+        }
+    }
+
+    void EditJournal::seal() {
+        is_sealed_ = true;
+    }
+
+    void EditJournal::record(Change&& change, Kind kind, const Selection& sel, bool coalesce) {
+        for (const auto& item : redo_) {
+            usage_ -= item.cost;
+        }
+        redo_.clear();
+
+        if (limit_ == 0) {
+            return;
+        }
+
+        auto time = utl::TimeUtils::upTimeMillis();
+
+        // 组内的改动追加到组的记录中
+        if (group_depth_ > 0 && is_group_started_) {
+            auto& item = undo_.back();
+            auto cost = getCost(change);
+            item.entry.changes.push_back(std::move(change));
+            item.kind = OTHER;
+            item.cost += cost;
+            usage_ += cost;
+            trim();
+            return;
+        }
+
+        if (coalesce && group_depth_ == 0 && !is_sealed_ && !undo_.empty()) {
+            if (merge(&undo_.back(), &change, kind, time)) {
+                trim();
+                return;
+            }
+        }
+
+        Item item;
+        item.entry.changes.push_back(std::move(change));
+        item.entry.sel = sel;
+        item.kind = kind;
+        item.cost = getCost(item.entry);
+        item.time = time;
+
+        usage_ += item.cost;
+        undo_.push_back(std::move(item));
+
+        is_sealed_ = !coalesce;
+        if (group_depth_ > 0) {
+            is_group_started_ = true;
+        }
+        trim();
+    }
+
+    bool EditJournal::canUndo() const {
+        return !undo_.empty();
+    }
+
+    bool EditJournal::canRedo() const {
+        return !redo_.empty();
+    }
+
+    bool EditJournal::popUndo(Entry* out) {
+        if (undo_.empty() || group_depth_ > 0) {
+            return false;
+        }
+
+        usage_ -= undo_.back().cost;
+        *out = std::move(undo_.back().entry);
+        undo_.pop_back();
+        is_sealed_ = true;
+        return true;
+    }
+
+    bool EditJournal::popRedo(Entry* out) {
+        if (redo_.empty() || group_depth_ > 0) {
+            return false;
+        }
+
+        usage_ -= redo_.back().cost;
+        *out = std::move(redo_.back().entry);
+        redo_.pop_back();
+        return true;
+    }
+
+    void EditJournal::pushUndo(Entry&& entry) {
+        if (limit_ == 0) {
+            return;
+        }
+
+        Item item;
+        item.cost = getCost(entry);
+        item.entry = std::move(entry);
+        item.kind = OTHER;
+        item.time = 0;
+
+        usage_ += item.cost;
+        undo_.push_back(std::move(item));
+        is_sealed_ = true;
+        trim();
+    }
+
+    void EditJournal::pushRedo(Entry&& entry) {
+        if (limit_ == 0) {
+            return;
+        }
+
+        Item item;
+        item.cost = getCost(entry);
+        item.entry = std::move(entry);
+        item.kind = OTHER;
+        item.time = 0;
+
+        usage_ += item.cost;
+        redo_.push_back(std::move(item));
+        trim();
+    }
+
+    void EditJournal::clear() {
+        undo_.clear();
+        redo_.clear();
+        usage_ = 0;
+        is_group_started_ = false;
+        is_sealed_ = true;
+    }
+
+    // static
+    size_t EditJournal::getCost(const Change& change) {
+        return sizeof(Change) +
+            change.text.capacity() * sizeof(char16_t) +
+            change.spans.capacity() * sizeof(SpanPos);
+    }
+
+    // static
+    size_t EditJournal::getCost(const Entry& entry) {
+        size_t cost = sizeof(Item);
+        for (const auto& change : entry.changes) {
+            cost += getCost(change);
+        }
+        return cost;
+    }
+
+    bool EditJournal::merge(Item* item, Change* change, Kind kind, uint64_t time) {
+        if (kind == OTHER || item->kind != kind || time - item->time > kCoalesceInterval) {
+            return false;
+        }
+
+        // 被挤压的 Span 的位置是按合并前的文本记录的，无法合并
+        if (item->entry.changes.size() != 1 || !change->spans.empty()) {
+            return false;
+        }
+
+        auto& last = item->entry.changes.back();
+        auto old_cost = getCost(last);
+        if (kind == INSERT) {
+            // 插入的撤销记录为 { pos, 插入的长度, "" }，只合并接在后面的插入
+            if (change->pos != last.pos + last.length) {
+                return false;
+            }
+            last.length += change->length;
+        } else {
+            // 删除的撤销记录为 { pos, 0, 删除的文本 }，合并向前（Backspace）或向后（Delete）的删除
+            if (change->pos + change->text.length() == last.pos) {
+                last.text.insert(0, change->text);
+                last.pos = change->pos;
+            } else if (change->pos == last.pos) {
+                last.text.append(change->text);
+            } else {
+                return false;
+            }
+        }
+
+        auto new_cost = getCost(last);
+        item->cost = item->cost - old_cost + new_cost;
+        usage_ = usage_ - old_cost + new_cost;
+        item->time = time;
+        return true;
+    }
+
+    void EditJournal::trim() {
+        // 先丢弃最早的撤销记录，再丢弃最远的重做记录
+        while (usage_ > limit_) {
+            if (!undo_.empty()) {
+                usage_ -= undo_.front().cost;
+                undo_.pop_front();
+                if (undo_.empty()) {
+                    is_group_started_ = false;
+                    is_sealed_ = true;
+                }
+            } else if (!redo_.empty()) {
+                usage_ -= redo_.front().cost;
+                redo_.pop_front();
+            } else {
+                break;
+            }
+        }
+    }
+
+}
@@ -0,0 +1,124 @@
+// Copyright (c) 2016 ucclkp <ucclkp@gmail.com>.
+// This file is part of ukive project.
+//
+// This program is licensed under GPLv3 license that can be
+// found in the LICENSE file.
+
+#ifndef UKIVE_TEXT_EDIT_JOURNAL_H_
+#define UKIVE_TEXT_EDIT_JOURNAL_H_
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ukive/text/selection.hpp"
+
+
+namespace ukive {
+
+    class Span;
+
+    /**
+     * Editable 的编辑记录，用于撤销和重做。
+     * 每项改动只保存被替换掉的文本，以及因此被挤压的 Span 原来的位置；
+     * 新文本不保存，撤销时再从当前文本中取出，作为重做的记录。
+     * 在短时间内连续输入或连续删除的改动合并为一条记录。
+     * 记录占用的内存超出上限时，从最早的记录开始丢弃。
+     */
+    class EditJournal {
+    public:
+        enum Kind {
+            INSERT,
+            REMOVE,
+            OTHER,
+        };
+
+        struct SpanPos {
+            std::weak_ptr<Span> span;
+            size_t start;
+            size_t end;
+        };
+
+        /**
+         * 将 [pos, pos + length) 替换为 text，然后将 spans 中的 Span 恢复到记录的位置。
+         */
+        struct Change {
+            size_t pos;
+            size_t length;
+            std::u16string text;
+            std::vector<SpanPos> spans;
+        };
+
+        /**
+         * 一条记录。changes 按发生的顺序排列，应用时从后往前进行；
+         * sel 为应用之后的选择区。
+         */
+        struct Entry {
+            std::vector<Change> changes;
+            Selection sel;
+        };
+
+        EditJournal();
+
+        /**
+         * 设置记录可占用的内存上限，单位为字节。为 0 时不记录。
+         */
+        void setMemoryLimit(size_t limit);
+        size_t getMemoryLimit() const;
+        size_t getMemoryUsage() const;
+
+        /**
+         * beginGroup() 和 endGroup() 之间的改动合并为一条记录，可以嵌套。
+         */
+        void beginGroup();
+        void endGroup();
+
+        /**
+         * 之后的改动不再与已有的记录合并。
+         */
+        void seal();
+
+        /**
+         * 记录一项改动，并清空重做记录。
+         * sel 为改动之前的选择区。coalesce 为 true 时，尝试与上一条记录合并。
+         */
+        void record(Change&& change, Kind kind, const Selection& sel, bool coalesce);
+
+        bool canUndo() const;
+        bool canRedo() const;
+
+        bool popUndo(Entry* out);
+        bool popRedo(Entry* out);
+        void pushUndo(Entry&& entry);
+        void pushRedo(Entry&& entry);
+
+        void clear();
+
+    private:
+        struct Item {
+            Entry entry;
+            Kind kind;
+            size_t cost;
+            uint64_t time;
+        };
+
+        static size_t getCost(const Change& change);
+        static size_t getCost(const Entry& entry);
+
+        bool merge(Item* item, Change* change, Kind kind, uint64_t time);
+        void trim();
+
+        std::deque<Item> undo_;
+        std::deque<Item> redo_;
+        size_t usage_ = 0;
+        size_t limit_;
+        int group_depth_ = 0;
+        bool is_group_started_ = false;
+        bool is_sealed_ = true;
+    };
+
+}
+
+#endif  // UKIVE_TEXT_EDIT_JOURNAL_H_
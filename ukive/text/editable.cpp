@@ -6,6 +6,8 @@
 
 #include "editable.h"
 
+#include <algorithm>
+
 #include "utils/log.h"
 #include "utils/multi_callbacks.hpp"
 
@@ -13,6 +15,48 @@
 #include "ukive/text/text_breaker.h"
 
 
+namespace {
+
+    // 计算字符边界时，光标前后最初取出的文本长度
+    const size_t kBreakContext = 64;
+    // 计算单词边界时，前后最初取出的文本长度
+    const size_t kWordContext = 256;
+
+    /**
+     * 计算 pos 在全部替换后的位置。
+     * matches 为按顺序排列的匹配位置，位于匹配内部的位置移至替换文本的末尾。
+     */
+    size_t mapThroughMatches(
+        size_t pos, const std::vector<size_t>& matches, size_t find_length, size_t rep_length)
+    {
+        // 在 pos 之前开始的匹配数
+        size_t n = std::lower_bound(matches.begin(), matches.end(), pos) - matches.begin();
+        if (n > 0 && pos < matches[n - 1] + find_length) {
+            --n;
+            return matches[n] - n * find_length + n * rep_length + rep_length;
+        }
+        return pos - n * find_length + n * rep_length;
+    }
+
+    /**
+     * 将先后发生的两项改动合并为一项。next 的位置以 prev 之后的文本为准。
+     */
+    ukive::RangeChg mergeChanges(const ukive::RangeChg& prev, const ukive::RangeChg& next) {
+        size_t prev_new_end = prev.new_end();
+        size_t pos = (std::min)(prev.pos, next.pos);
+        size_t old_end, new_end;
+        if (next.old_end() > prev_new_end) {
+            old_end = prev.old_end() + (next.old_end() - prev_new_end);
+            new_end = next.new_end();
+        } else {
+            old_end = prev.old_end();
+            new_end = prev_new_end - next.old_length + next.new_length;
+        }
+        return { pos, old_end - pos, new_end - pos };
+    }
+
+}
+
 namespace ukive {
 
     Editable::Editable(const std::u16string_view& text, void* ctx)
@@ -22,6 +66,7 @@ namespace ukive {
     }
 
     Editable::~Editable() {
+        span_tree_.clear();
     }
 
     // 对文本的操作包括插入、删除和替换。
@@ -31,13 +76,7 @@ namespace ukive {
     void Editable::notifyTextChanged(
         const RangeChg& rc, Reason r)
     {
-        for (auto span : spans_) {
-            auto span_start = span->getStart();
-            auto span_end = span->getEnd();
-
-            if (span_start >= rc.pos && span_start < rc.old_end()) {
-            }
-        }
+        span_tree_.shift(rc);
 
         for (auto watcher : watchers_) {
             watcher->onTextChanged(this, rc, r);
@@ -57,6 +96,8 @@ namespace ukive {
         const Selection& nsl, const Selection& osl,
         Reason r)
     {
+        span_tree_.shift(text_rc);
+
         for (auto watcher : watchers_) {
             watcher->onTextChanged(this, text_rc, r);
             watcher->onSelectionChanged(this, nsl, osl, r);
@@ -83,6 +124,7 @@ namespace ukive {
         const std::u16string_view& text, size_t position, Reason r)
     {
         if (!text.empty()) {
+            recordChange({ position, 0, text.length() }, text, r);
             text_.insert(position, text);
             notifyTextChanged({ position, 0, text.length() }, r);
         }
@@ -97,6 +139,7 @@ namespace ukive {
     void Editable::replace(
         const std::u16string_view& text, size_t start, size_t length, Reason r)
     {
+        recordChange({ start, length, text.length() }, text, r);
         text_.replace(start, length, text);
         notifyTextChanged({ start, length, text.length() }, r);
     }
@@ -106,6 +149,7 @@ namespace ukive {
             auto old_sel = sel_;
             auto old_length = length();
 
+            recordChange({ 0, old_length, 0 }, {}, r);
             text_.clear();
             sel_.zero();
 
@@ -121,19 +165,79 @@ namespace ukive {
         const std::u16string_view& find, const std::u16string_view& rep, Reason r)
     {
         auto first = text_.find(find);
-        if (first != std::u16string::npos) {
+        if (first != PieceTable::npos) {
+            recordChange({ first, find.length(), rep.length() }, rep, r);
             text_.replace(first, find.length(), rep);
             notifyTextChanged({ first, find.length(), rep.length() }, r);
         }
     }
 
+    size_t Editable::replaceAll(
+        const std::u16string_view& find, const std::u16string_view& rep, Reason r)
+    {
+        if (find.empty()) {
+            return 0;
+        }
+
+        std::vector<size_t> matches;
+        text_.findAll(find, 0, &matches);
+        if (matches.empty()) {
+            return 0;
+        }
+
+        // 从第一个匹配的开头到最后一个匹配的结尾，一次构造出替换后的文本
+        size_t first = matches.front();
+        size_t old_length = matches.back() + find.length() - first;
+        size_t new_length = old_length - matches.size() * find.length() + matches.size() * rep.length();
+
+        std::u16string result(new_length, u'\0');
+        size_t prev = first;
+        size_t out = 0;
+        for (auto pos : matches) {
+            text_.copy(prev, pos - prev, result.data() + out);
+            out += pos - prev;
+            std::copy(rep.begin(), rep.end(), result.begin() + out);
+            out += rep.length();
+            prev = pos + find.length();
+        }
+
+        // Span 按每个匹配调整，从后往前进行，使前面的匹配位置保持不变。
+        // 编辑记录同样按匹配记录，撤销时 Span 才能按匹配恢复
+        journal_.beginGroup();
+        for (auto it = matches.rbegin(); it != matches.rend(); ++it) {
+            RangeChg match_rc(*it, find.length(), rep.length());
+            recordChange(match_rc, rep, r);
+            span_tree_.shift(match_rc);
+        }
+        journal_.endGroup();
+
+        text_.replace(first, old_length, result);
+
+        auto old_sel = sel_;
+        sel_.set(
+            mapThroughMatches(old_sel.start, matches, find.length(), rep.length()),
+            mapThroughMatches(old_sel.end, matches, find.length(), rep.length()));
+        bool sel_changed = !sel_.equal(old_sel.start, old_sel.end);
+
+        RangeChg rc(first, old_length, new_length);
+        for (auto watcher : watchers_) {
+            watcher->onTextChanged(this, rc, r);
+            if (sel_changed) {
+                watcher->onSelectionChanged(this, sel_, old_sel, r);
+            }
+        }
+        return matches.size();
+    }
+
     void Editable::insert(const std::u16string_view& text, Reason r) {
         auto old_sel = sel_;
         if (old_sel.empty()) {
             if (length() < old_sel.end) {
                 ubassert(false);
+                recordChange({ text_.length(), 0, text.length() }, text, r);
                 text_.insert(text_.length(), text);
             } else {
+                recordChange({ old_sel.end, 0, text.length() }, text, r);
                 text_.insert(old_sel.end, text);
             }
 
@@ -150,6 +254,7 @@ namespace ukive {
     void Editable::replace(const std::u16string_view& text, Reason r) {
         auto old_sel = sel_;
         if (!old_sel.empty()) {
+            recordChange({ old_sel.start, old_sel.length(), text.length() }, text, r);
             text_.replace(old_sel.start, old_sel.length(), text);
             sel_.set(old_sel.start + text.length());
 
@@ -184,6 +289,10 @@ namespace ukive {
 
     void Editable::addSpan(Span* span, Reason r) {
         spans_.push_back(std::shared_ptr<Span>(span));
+        span_tree_.insert(span);
+        if (span->getType() == Span::INTERACTABLE) {
+            ++interactable_count_;
+        }
 
         notifySpanChanged(
             span, EditWatcher::SpanChange::ADD, r);
@@ -195,23 +304,160 @@ namespace ukive {
             notifySpanChanged(
                 span, EditWatcher::SpanChange::REMOVE, r);
 
+            if (span->getType() == Span::INTERACTABLE) {
+                --interactable_count_;
+            }
+            span_tree_.remove(span);
             spans_.erase(spans_.begin() + index);
         }
     }
 
     void Editable::removeAllSpans(Reason r) {
+        // 从末尾开始移除，避免每次移动其余的 Span
         while (!spans_.empty()) {
-            removeSpan(0, r);
+            removeSpan(spans_.size() - 1, r);
         }
     }
 
-    bool Editable::isInteractable() const {
-        for (const auto& span : spans_) {
-            if (span->getType() == Span::INTERACTABLE) {
-                return true;
+    bool Editable::undo(Reason r) {
+        EditJournal::Entry entry;
+        if (!journal_.popUndo(&entry)) {
+            return false;
+        }
+
+        EditJournal::Entry inverse;
+        replay(&entry, &inverse, r);
+        journal_.pushRedo(std::move(inverse));
+        return true;
+    }
+
+    bool Editable::redo(Reason r) {
+        EditJournal::Entry entry;
+        if (!journal_.popRedo(&entry)) {
+            return false;
+        }
+
+        EditJournal::Entry inverse;
+        replay(&entry, &inverse, r);
+        journal_.pushUndo(std::move(inverse));
+        return true;
+    }
+
+    bool Editable::canUndo() const {
+        return journal_.canUndo();
+    }
+
+    bool Editable::canRedo() const {
+        return journal_.canRedo();
+    }
+
+    void Editable::beginEditGroup() {
+        journal_.beginGroup();
+    }
+
+    void Editable::endEditGroup() {
+        journal_.endGroup();
+    }
+
+    void Editable::setHistoryLimit(size_t limit) {
+        journal_.setMemoryLimit(limit);
+    }
+
+    void Editable::clearHistory() {
+        journal_.clear();
+    }
+
+    void Editable::recordChange(
+        const RangeChg& rc, const std::u16string_view& text, Reason r)
+    {
+        if (rc.old_length == 0 && rc.new_length == 0) {
+            return;
+        }
+
+        // 被替换的文本超出上限时，不再复制，之前的记录也随之失效
+        auto limit = journal_.getMemoryLimit();
+        if (limit == 0 || rc.old_length > limit / sizeof(char16_t)) {
+            journal_.clear();
+            return;
+        }
+
+        EditJournal::Kind kind;
+        if (rc.old_length == 0) {
+            kind = EditJournal::INSERT;
+        } else if (rc.new_length == 0) {
+            kind = EditJournal::REMOVE;
+        } else {
+            kind = EditJournal::OTHER;
+        }
+
+        // 换行结束连续的输入
+        bool coalesce = r == USER_INPUT && text.find(u'\n') == std::u16string_view::npos;
+        journal_.record(captureChange(rc), kind, sel_, coalesce);
+    }
+
+    EditJournal::Change Editable::captureChange(const RangeChg& rc) const {
+        EditJournal::Change change;
+        change.pos = rc.pos;
+        change.length = rc.new_length;
+        change.text = text_.substr(rc.pos, rc.old_length);
+
+        // 起始或结束位置在被替换的范围内的 Span 会被挤压，需要记录原来的位置。
+        // 撤销删除时插入的文本会推后起始于 rc.pos 的 Span，但不会推后结束于 rc.pos 的 Span，
+        // 因此边界上的 Span 也要记录，包括 rc.pos 处的空 Span
+        if (rc.old_length > 0 && span_tree_.size() > 0) {
+            std::vector<Span*> spans;
+            span_tree_.query(Range(rc.pos, rc.old_length), &spans);
+            span_tree_.queryEmpty(rc.pos, &spans);
+            for (auto span : spans) {
+                auto start = span->getStart();
+                auto end = span->getEnd();
+                if ((start >= rc.pos && start < rc.old_end()) ||
+                    (end > rc.pos && end <= rc.old_end()))
+                {
+                    change.spans.push_back({ span->weak_from_this(), start, end });
+                }
             }
         }
-        return false;
+        return change;
+    }
+
+    void Editable::replay(
+        EditJournal::Entry* entry, EditJournal::Entry* inverse, Reason r)
+    {
+        inverse->sel = sel_;
+
+        RangeChg total;
+        for (auto it = entry->changes.rbegin(); it != entry->changes.rend(); ++it) {
+            RangeChg rc(it->pos, it->length, it->text.length());
+            inverse->changes.push_back(captureChange(rc));
+
+            text_.replace(rc.pos, rc.old_length, it->text);
+            span_tree_.shift(rc);
+            for (const auto& sp : it->spans) {
+                if (auto span = sp.span.lock()) {
+                    span->resize(sp.start, sp.end);
+                }
+            }
+
+            total = (it == entry->changes.rbegin()) ? rc : mergeChanges(total, rc);
+        }
+
+        auto old_sel = sel_;
+        sel_.set(
+            (std::min)(entry->sel.start, length()),
+            (std::min)(entry->sel.end, length()));
+        bool sel_changed = !sel_.equal(old_sel.start, old_sel.end);
+
+        for (auto watcher : watchers_) {
+            watcher->onTextChanged(this, total, r);
+            if (sel_changed) {
+                watcher->onSelectionChanged(this, sel_, old_sel, r);
+            }
+        }
+    }
+
+    bool Editable::isInteractable() const {
+        return interactable_count_ > 0;
     }
 
     bool Editable::hasSelection() const {
@@ -222,13 +468,11 @@ namespace ukive {
         return sel_;
     }
 
-    std::u16string_view Editable::getSelectionString() const {
+    std::u16string Editable::getSelectionString() const {
         if (sel_.empty()) {
             return {};
         }
-
-        std::u16string_view r(text_);
-        return r.substr(sel_.start, sel_.length());
+        return text_.substr(sel_.start, sel_.length());
     }
 
     char16_t Editable::at(size_t pos) const {
@@ -236,21 +480,121 @@ namespace ukive {
     }
 
     const std::u16string& Editable::getString() const {
+        return text_.str();
+    }
+
+    const PieceTable& Editable::getStorage() const {
         return text_;
     }
 
     size_t Editable::getPrevOffset(size_t cur) const {
-        CharacterBreaker breaker(&text_);
-        breaker.setCur(cur);
-        breaker.prev();
-        return breaker.getPrev() - breaker.getCur();
+        // 只取出光标附近的文本，光标之前没有安全边界时逐步扩大范围
+        for (size_t context = kBreakContext;; context *= 2) {
+            size_t start = cur > context ? cur - context : 0;
+            auto text = text_.substr(start, cur - start + kBreakContext);
+            size_t rel = cur - start;
+            if (start > 0 &&
+                CharacterBreaker::findSafeBoundary(text, rel) == BoundaryBitmap::npos)
+            {
+                continue;
+            }
+
+            BoundaryBitmap boundaries;
+            CharacterBreaker::fill(text, &boundaries);
+            size_t prev = boundaries.prev(rel);
+            if (prev == BoundaryBitmap::npos) {
+                return 0;
+            }
+            return rel - prev;
+        }
     }
 
     size_t Editable::getNextOffset(size_t cur) const {
-        CharacterBreaker breaker(&text_);
-        breaker.setCur(cur);
-        breaker.next();
-        return breaker.getCur() - breaker.getPrev();
+        for (size_t context = kBreakContext;; context *= 2) {
+            size_t start = cur > context ? cur - context : 0;
+            auto text = text_.substr(start, cur - start + context);
+            size_t rel = cur - start;
+            if (start > 0 &&
+                CharacterBreaker::findSafeBoundary(text, rel + 1) == BoundaryBitmap::npos)
+            {
+                continue;
+            }
+
+            BoundaryBitmap boundaries;
+            CharacterBreaker::fill(text, &boundaries);
+            size_t next = boundaries.next(rel);
+            if (next == BoundaryBitmap::npos) {
+                return 0;
+            }
+            // 取出的文本的末尾总被视为边界
+            if (next == text.length() && start + next < length()) {
+                continue;
+            }
+            return next - rel;
+        }
+    }
+
+    void Editable::getWordRange(size_t pos, size_t* start, size_t* end) const {
+        pos = (std::min)(pos, length());
+
+        // 只取出所在行中 pos 附近的文本。行首和行尾总是安全边界，
+        // 取出的文本在单词之前和之后都找不到安全边界时逐步扩大范围。
+        size_t line = text_.getLineAt(pos);
+        size_t line_start = text_.getLineStart(line);
+        size_t line_end = text_.getLineStart(line + 1);
+        for (size_t context = kWordContext;; context *= 2) {
+            size_t win_start = line_start;
+            if (pos > context) {
+                win_start = (std::max)(win_start, pos - context);
+            }
+            size_t win_end = (std::min)(line_end, pos + context);
+
+            auto text = text_.substr(win_start, win_end - win_start);
+            BoundaryBitmap boundaries;
+            WordBreaker::fill(text, &boundaries);
+
+            size_t rel = pos - win_start;
+            size_t word_end = boundaries.next(rel);
+            if (word_end == BoundaryBitmap::npos) {
+                // 位于末尾时，取前面的单词
+                word_end = rel;
+                rel = rel > 0 ? rel - 1 : 0;
+            }
+            size_t word_start = boundaries.test(rel) ? rel : boundaries.prev(rel);
+            if (word_start == BoundaryBitmap::npos) {
+                word_start = 0;
+            }
+
+            if (win_start != line_start &&
+                WordBreaker::findSafeBoundary(text, rel + 1) == BoundaryBitmap::npos)
+            {
+                continue;
+            }
+            // WB6、WB7b 和 WB12 需要向后查看，单词之后的安全边界保证了这些字符都已取出
+            if (win_end != line_end) {
+                size_t safe = WordBreaker::findSafeBoundary(text, text.length());
+                if (safe == BoundaryBitmap::npos || safe <= word_end) {
+                    continue;
+                }
+            }
+
+            *start = win_start + word_start;
+            *end = win_start + word_end;
+            return;
+        }
+    }
+
+    void Editable::findAll(const std::u16string_view& s, std::vector<Range>* out) const {
+        if (s.empty()) {
+            return;
+        }
+
+        std::vector<size_t> matches;
+        text_.findAll(s, 0, &matches);
+        out->reserve(out->size() + matches.size());
+        for (auto pos : matches) {
+            out->push_back({ pos, s.length() });
+        }
     }
 
     Span* Editable::getSpan(size_t index) const {
@@ -261,6 +605,10 @@ namespace ukive {
         return spans_.size();
     }
 
+    void Editable::getSpans(const Range& range, std::vector<Span*>* out) const {
+        span_tree_.query(range, out);
+    }
+
     void* Editable::getContext() const {
         return ctx_;
     }
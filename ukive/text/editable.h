@@ -12,8 +12,11 @@
 #include <string>
 #include <vector>
 
+#include "ukive/text/edit_journal.h"
+#include "ukive/text/piece_table.h"
 #include "ukive/text/range.hpp"
 #include "ukive/text/selection.hpp"
+#include "ukive/text/span/span_tree.h"
 
 
 namespace ukive {
@@ -23,6 +26,9 @@ namespace ukive {
     /**
      * 文本编辑类。
      * 使用字间定位。
+     * 文本保存在 PieceTable 中，编辑的耗时与文本长度无关。
+     * Span 同时保存在 SpanTree 中，文本改动时自动调整位置。
+     * 文本改动记录在 EditJournal 中，可以撤销和重做。
      */
     class Editable {
     public:
@@ -64,6 +70,14 @@ namespace ukive {
         void replace(const std::u16string_view& text, size_t start, size_t length, Reason r = API);
         void clear(Reason r = API);
         void replace(const std::u16string_view& find, const std::u16string_view& rep, Reason r = API);
+
+        /**
+         * 将所有不重叠的 find 替换为 rep，返回替换的数量。
+         * 替换后的文本一次构造完成，只发出一次文本改动通知，
+         * 其范围为第一个匹配的开头到最后一个匹配的结尾。
+         * Span 和选择区按每个匹配分别调整位置，位于匹配内部的位置移至替换文本的末尾。
+         */
+        size_t replaceAll(const std::u16string_view& find, const std::u16string_view& rep, Reason r = API);
         void insert(const std::u16string_view& text, Reason r = API);
         void remove(Reason r = API);
         void replace(const std::u16string_view& text, Reason r = API);
@@ -73,16 +87,66 @@ namespace ukive {
         void removeSpan(size_t index, Reason r = API);
         void removeAllSpans(Reason r = API);
 
+        /**
+         * 撤销或重做一条记录。记录中的所有改动只发出一次文本改动通知。
+         * 没有可用的记录时返回 false。
+         */
+        bool undo(Reason r = API);
+        bool redo(Reason r = API);
+        bool canUndo() const;
+        bool canRedo() const;
+
+        /**
+         * beginEditGroup() 和 endEditGroup() 之间的改动作为一条记录撤销，可以嵌套。
+         */
+        void beginEditGroup();
+        void endEditGroup();
+
+        /**
+         * 设置编辑记录可占用的内存上限，单位为字节。为 0 时不记录。
+         */
+        void setHistoryLimit(size_t limit);
+        void clearHistory();
+
         bool isInteractable() const;
         bool hasSelection() const;
         const Selection& getSelection() const;
-        std::u16string_view getSelectionString() const;
+        std::u16string getSelectionString() const;
         char16_t at(size_t pos) const;
+
+        /**
+         * 获取连续的文本。
+         * 首次调用时需要复制全部文本，结果在下次编辑前有效。
+         * 只需要部分文本时，应使用 getStorage()。
+         */
         const std::u16string& getString() const;
+
+        /**
+         * 获取文本存储，可按片段遍历文本或按行定位。
+         */
+        const PieceTable& getStorage() const;
         size_t getPrevOffset(size_t cur) const;
         size_t getNextOffset(size_t cur) const;
+
+        /**
+         * 获取 pos 处的单词的范围。pos 位于文本末尾时，获取前一个单词。
+         */
+        void getWordRange(size_t pos, size_t* start, size_t* end) const;
+
+        /**
+         * 查找 s 所有不重叠的出现位置，按顺序追加到 out 中。
+         */
+        void findAll(const std::u16string_view& s, std::vector<Range>* out) const;
+
         Span* getSpan(size_t index) const;
         size_t getSpanCount() const;
+
+        /**
+         * 获取与 range 重叠的 Span，按加入的顺序排列。
+         * range 为空时，获取包含 range.pos 的 Span。
+         */
+        void getSpans(const Range& range, std::vector<Span*>* out) const;
+
         void* getContext() const;
 
         void addEditWatcher(EditWatcher* watcher);
@@ -99,11 +163,21 @@ namespace ukive {
         void notifySpanChanged(
             Span* span, EditWatcher::SpanChange action, Reason r);
 
+        /**
+         * 在文本改动之前调用，将改动记录到 journal_ 中。
+         */
+        void recordChange(const RangeChg& rc, const std::u16string_view& text, Reason r);
+        EditJournal::Change captureChange(const RangeChg& rc) const;
+        void replay(EditJournal::Entry* entry, EditJournal::Entry* inverse, Reason r);
+
         void* ctx_;
-        std::u16string text_;
+        PieceTable text_;
         std::vector<EditWatcher*> watchers_;
         std::vector<std::shared_ptr<Span>> spans_;
+        SpanTree span_tree_;
+        size_t interactable_count_ = 0;
         Selection sel_;
+        EditJournal journal_;
     };
 
 }
@@ -0,0 +1,256 @@
+// Copyright (c) 2016 ucclkp <ucclkp@gmail.com>.
+// This file is part of ukive project.
+//
+// This program is licensed under GPLv3 license that can be
+// found in the LICENSE file.
+
+#include "ukive/text/editable_benchmark.h"
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "utils/log.h"
+#include "utils/time_utils.h"
+
+#include "ukive/text/editable.h"
+#include "ukive/text/span/span.h"
+
+
+namespace {
+
+    const int kFuzzRounds = 3000;
+    const int kMaxEdits = 12;
+    // 约 16 MB 的 UTF-16 文本
+    const size_t kLargeUnits = 8 * 1024 * 1024;
+    const int kTimedEdits = 100000;
+    const int kBursts = 2000;
+    const int kBurstLength = 5;
+
+    class BenchSpan : public ukive::Span {
+    public:
+        BenchSpan(size_t start, size_t end)
+            : Span(start, end) {}
+
+        Type getType() const override { return NONE; }
+    };
+
+    /**
+     * 按照通知的改动范围维护一份文本副本，检查每次通知是否与实际文本一致。
+     */
+    class ShadowWatcher : public ukive::Editable::EditWatcher {
+    public:
+        explicit ShadowWatcher(const std::u16string& text)
+            : shadow_(text) {}
+
+        void onTextChanged(
+            ukive::Editable* editable, const ukive::RangeChg& rc, ukive::Editable::Reason r) override
+        {
+            if (rc.old_end() > shadow_.size()) {
+                matched_ = false;
+                return;
+            }
+            shadow_.replace(
+                rc.pos, rc.old_length,
+                editable->getString().substr(rc.pos, rc.new_length));
+            if (shadow_ != editable->getString()) {
+                matched_ = false;
+            }
+        }
+
+        bool matched() const { return matched_; }
+
+    private:
+        std::u16string shadow_;
+        bool matched_ = true;
+    };
+
+    struct Snapshot {
+        std::u16string text;
+        std::vector<std::pair<size_t, size_t>> spans;
+        size_t sel_start;
+        size_t sel_end;
+
+        bool sameContent(const Snapshot& rhs) const {
+            return text == rhs.text && spans == rhs.spans;
+        }
+        bool operator==(const Snapshot& rhs) const {
+            return sameContent(rhs) && sel_start == rhs.sel_start && sel_end == rhs.sel_end;
+        }
+    };
+
+    Snapshot takeSnapshot(const ukive::Editable& e) {
+        Snapshot s;
+        s.text = e.getString();
+        for (size_t i = 0; i < e.getSpanCount(); ++i) {
+            auto span = e.getSpan(i);
+            s.spans.push_back({ span->getStart(), span->getEnd() });
+        }
+        s.sel_start = e.getSelection().start;
+        s.sel_end = e.getSelection().end;
+        return s;
+    }
+
+    /**
+     * 执行一次随机编辑：插入、删除、替换、全部替换，或者一段带退格的连续输入。
+     */
+    void randomEdit(std::mt19937& rng, ukive::Editable* e) {
+        auto rand = [&rng](size_t max) {
+            return std::uniform_int_distribution<size_t>(0, max)(rng);
+        };
+        auto rand_text = [&]() {
+            const char16_t kChars[] = u"abc \n";
+            std::u16string text(1 + rand(2), u' ');
+            for (auto& ch : text) {
+                ch = kChars[rand(4)];
+            }
+            return text;
+        };
+
+        size_t length = e->length();
+        switch (rng() % 5) {
+        case 0:
+            e->insert(rand_text(), rand(length));
+            break;
+        case 1:
+            if (length > 0) {
+                size_t pos = rand(length - 1);
+                e->remove(pos, (std::min)(1 + rand(3), length - pos));
+            }
+            break;
+        case 2:
+            if (length > 0) {
+                size_t pos = rand(length - 1);
+                e->replace(rand_text(), pos, (std::min)(1 + rand(2), length - pos));
+            }
+            break;
+        case 3:
+            e->replaceAll(u"abc", (rng() % 2) ? u"X" : u"YYYY");
+            break;
+        default:
+        {
+            e->setSelection(rand(length));
+            int count = 1 + int(rand(3));
+            for (int i = 0; i < count; ++i) {
+                size_t cur = e->getSelection().start;
+                if (rng() % 3 == 0 && cur > 0) {
+                    e->setSelection(cur - 1, cur);
+                    e->remove(ukive::Editable::USER_INPUT);
+                } else {
+                    e->insert(u"q", ukive::Editable::USER_INPUT);
+                }
+            }
+            break;
+        }
+        }
+    }
+
+    /**
+     * 随机编辑后全部撤销、全部重做、再全部撤销。
+     * @return 第一次不一致时的轮次，全部一致时返回 -1。
+     */
+    int fuzz(std::mt19937& rng) {
+        for (int round = 0; round < kFuzzRounds; ++round) {
+            ukive::Editable e(u"hello world\nfoo bar baz abc abc");
+            ShadowWatcher watcher(e.getString());
+            e.addEditWatcher(&watcher);
+
+            for (int i = 0; i < 4; ++i) {
+                size_t start = rng() % e.length();
+                size_t end = (std::min)(start + rng() % 5, e.length());
+                e.addSpan(new BenchSpan(start, end));
+            }
+
+            auto initial = takeSnapshot(e);
+            int edits = 1 + int(rng() % kMaxEdits);
+            for (int i = 0; i < edits; ++i) {
+                randomEdit(rng, &e);
+            }
+            auto edited = takeSnapshot(e);
+
+            while (e.undo()) {}
+            auto undone = takeSnapshot(e);
+            if (!undone.sameContent(initial)) {
+                return round;
+            }
+
+            while (e.redo()) {}
+            if (!takeSnapshot(e).sameContent(edited)) {
+                return round;
+            }
+
+            // 第二次撤销还要恢复第一次撤销后的选区
+            while (e.undo()) {}
+            if (!(takeSnapshot(e) == undone) || !watcher.matched()) {
+                return round;
+            }
+            e.removeEditWatcher(&watcher);
+        }
+        return -1;
+    }
+
+    /**
+     * 在大文本开头附近交替插入和删除单个字符，返回总耗时，单位为毫秒。
+     */
+    double timeEdits(std::mt19937& rng, size_t history_limit) {
+        ukive::Editable e(std::u16string(kLargeUnits, u'a'));
+        if (history_limit != size_t(-1)) {
+            e.setHistoryLimit(history_limit);
+        }
+
+        std::uniform_int_distribution<size_t> dist(0, 4096);
+        auto start = utl::TimeUtils::upTimeNanos();
+        for (int i = 0; i < kTimedEdits; ++i) {
+            if (i % 2 == 0) {
+                e.insert(u"x", dist(rng));
+            } else {
+                e.remove(dist(rng), 1);
+            }
+        }
+        return double(utl::TimeUtils::upTimeNanos() - start) / 1000000.0;
+    }
+
+}
+
+namespace ukive {
+
+    void runEditableBenchmark() {
+        std::mt19937 rng(20240612);
+
+        int failed = fuzz(rng);
+        if (failed >= 0) {
+            LOG(Log::ERR) << "Editable undo/redo self-check failed at round " << failed << ".";
+        } else {
+            LOG(Log::INFO) << "Editable undo/redo self-check: " << kFuzzRounds
+                << " random rounds of undo-all, redo-all and undo-all match the snapshots";
+        }
+
+        double journal_ms = timeEdits(rng, size_t(-1));
+        double plain_ms = timeEdits(rng, 0);
+
+        // 每段输入的位置都不相邻，各自成为一条记录
+        Editable e(std::u16string(kLargeUnits, u'a'));
+        std::uniform_int_distribution<size_t> dist(0, kLargeUnits);
+        for (int i = 0; i < kBursts; ++i) {
+            e.setSelection(dist(rng));
+            for (int j = 0; j < kBurstLength; ++j) {
+                e.insert(u"q", Editable::USER_INPUT);
+            }
+        }
+
+        int entries = 0;
+        auto start = utl::TimeUtils::upTimeNanos();
+        while (e.undo()) {
+            ++entries;
+        }
+        double undo_ms = double(utl::TimeUtils::upTimeNanos() - start) / 1000000.0;
+
+        LOG(Log::INFO) << "Editable benchmark, " << kTimedEdits
+            << " single-character edits on " << (kLargeUnits >> 20) << "M units: "
+            << journal_ms << " ms with the journal, " << plain_ms
+            << " ms without; undoing " << entries << " entries: " << undo_ms << " ms";
+    }
+
+}
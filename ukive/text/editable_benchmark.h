@@ -0,0 +1,22 @@
+// Copyright (c) 2016 ucclkp <ucclkp@gmail.com>.
+// This file is part of ukive project.
+//
+// This program is licensed under GPLv3 license that can be
+// found in the LICENSE file.
+
+#ifndef UKIVE_TEXT_EDITABLE_BENCHMARK_H_
+#define UKIVE_TEXT_EDITABLE_BENCHMARK_H_
+
+
+namespace ukive {
+
+    /**
+     * 随机编辑后依次全部撤销、全部重做、再全部撤销，检查文本、Span 和选区
+     * 是否回到对应的状态；然后在大文本上比较开启和关闭编辑记录时的编辑耗时，
+     * 以及撤销的耗时。结果写入日志。
+     */
+    void runEditableBenchmark();
+
+}
+
+#endif  // UKIVE_TEXT_EDITABLE_BENCHMARK_H_
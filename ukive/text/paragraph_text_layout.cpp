@@ -0,0 +1,621 @@
+// Copyright (c) 2016 ucclkp <ucclkp@gmail.com>.
+// This file is part of ukive project.
+//
+// This program is licensed under GPLv3 license that can be
+// found in the LICENSE file.
+
+#include "ukive/text/paragraph_text_layout.h"
+
+#include <algorithm>
+
+#include "utils/log.h"
+
+#include "ukive/text/piece_table.h"
+#include "ukive/text/text_breaker.h"
+
+
+namespace {
+
+    const std::u16string& getFullText(const std::u16string& text) {
+        return text;
+    }
+
+    const std::u16string& getFullText(const ukive::PieceTable& text) {
+        return text.str();
+    }
+
+}
+
+namespace ukive {
+
+    ParagraphTextLayout::ParagraphTextLayout() {}
+
+    ParagraphTextLayout::~ParagraphTextLayout() {
+        destroy();
+    }
+
+    bool ParagraphTextLayout::make(
+        const std::u16string_view& text,
+        const std::u16string_view& font_name,
+        float font_size,
+        FontStyle style,
+        FontWeight weight,
+        const std::u16string_view& locale_name)
+    {
+        destroy();
+
+        font_name_ = font_name;
+        font_size_ = font_size;
+        font_style_ = style;
+        font_weight_ = weight;
+        locale_name_ = locale_name;
+
+        std::u16string str(text);
+        if (!splitParagraphs(str, 0, str.length(), true, &paragraphs_)) {
+            destroy();
+            return false;
+        }
+
+        text_length_ = str.length();
+        invalidateAllMetrics();
+        return true;
+    }
+
+    void ParagraphTextLayout::destroy() {
+        for (auto& p : paragraphs_) {
+            if (p.layout) {
+                p.layout->destroy();
+            }
+        }
+        paragraphs_.clear();
+        text_length_ = 0;
+        dirty_index_ = 0;
+        total_height_ = 0;
+    }
+
+    bool ParagraphTextLayout::update(
+        const std::u16string& text, const RangeChg& rc, Range* dirty)
+    {
+        return updateImpl(text, rc, dirty);
+    }
+
+    bool ParagraphTextLayout::update(
+        const PieceTable& text, const RangeChg& rc, Range* dirty)
+    {
+        return updateImpl(text, rc, dirty);
+    }
+
+    template <typename Text>
+    bool ParagraphTextLayout::updateImpl(
+        const Text& text, const RangeChg& rc, Range* dirty)
+    {
+        if (paragraphs_.empty() ||
+            rc.old_end() > text_length_ ||
+            text_length_ - rc.old_length + rc.new_length != text.length())
+        {
+            // 记录的文本与实际不符，全部重建
+            if (!make(getFullText(text), font_name_, font_size_, font_style_, font_weight_, locale_name_)) {
+                return false;
+            }
+            *dirty = Range(0, text.length());
+            return true;
+        }
+
+        size_t first = findParagraphByPos(rc.pos);
+        if (first > 0) {
+            // 上一段以单独的 \r 结尾时，插入的 \n 可能会与之合并
+            const auto& prev = paragraphs_[first - 1];
+            if (prev.sep_length == 1 && text[prev.start + prev.length] == u'\r') {
+                --first;
+            }
+        }
+        size_t last = findParagraphByPos(rc.old_end());
+
+        size_t start = paragraphs_[first].start;
+        size_t new_end = paragraphs_[last].end() - rc.old_length + rc.new_length;
+        bool is_last = (last + 1 == paragraphs_.size());
+
+        // 多取出一个字符，以便判断末尾的 \r 是否与之后的 \n 相连
+        auto window = text.substr(start, new_end - start + 1);
+
+        std::vector<Paragraph> made;
+        if (!splitParagraphs(window, 0, new_end - start, is_last, &made)) {
+            for (auto& p : made) {
+                p.layout->destroy();
+            }
+            return false;
+        }
+
+        if (made.empty() || made.back().end() != new_end - start) {
+            for (auto& p : made) {
+                p.layout->destroy();
+            }
+
+            DLOG(Log::WARNING) << "Unexpected paragraph boundary, rebuild all paragraphs";
+            if (!make(getFullText(text), font_name_, font_size_, font_style_, font_weight_, locale_name_)) {
+                return false;
+            }
+            *dirty = Range(0, text.length());
+            return true;
+        }
+
+        for (auto& p : made) {
+            p.start += start;
+        }
+
+        for (size_t i = first; i <= last; ++i) {
+            paragraphs_[i].layout->destroy();
+        }
+        for (size_t i = last + 1; i < paragraphs_.size(); ++i) {
+            paragraphs_[i].start = paragraphs_[i].start - rc.old_length + rc.new_length;
+        }
+
+        size_t made_count = made.size();
+        paragraphs_.erase(paragraphs_.begin() + first, paragraphs_.begin() + last + 1);
+        paragraphs_.insert(
+            paragraphs_.begin() + first,
+            std::make_move_iterator(made.begin()), std::make_move_iterator(made.end()));
+
+        text_length_ = text.length();
+        invalidateMetrics(first, first + made_count - 1);
+
+        *dirty = Range(start, new_end - start);
+        return true;
+    }
+
+    void ParagraphTextLayout::setDefaultFont(
+        const std::u16string_view& font_name,
+        float font_size,
+        FontStyle style,
+        FontWeight weight)
+    {
+        font_name_ = font_name;
+        font_size_ = font_size;
+        font_style_ = style;
+        font_weight_ = weight;
+    }
+
+    void ParagraphTextLayout::setDrawingRegion(const RectF& region) {
+        drawing_region_ = region;
+    }
+
+    void ParagraphTextLayout::setMaxWidth(float max_width) {
+        if (max_width_ == max_width) {
+            return;
+        }
+
+        max_width_ = max_width;
+        for (auto& p : paragraphs_) {
+            p.layout->setMaxWidth(max_width);
+        }
+        invalidateAllMetrics();
+    }
+
+    void ParagraphTextLayout::setMaxHeight(float max_height) {
+        if (max_height_ == max_height) {
+            return;
+        }
+
+        // 各段落自顶部依次排列，竖直方向的对齐由这里统一处理
+        max_height_ = max_height;
+        for (auto& p : paragraphs_) {
+            p.layout->setMaxHeight(max_height);
+        }
+        invalidateAllMetrics();
+    }
+
+    void ParagraphTextLayout::setFontAttributes(const FontAttributes& attrs, const Range& range) {
+        forEachInRange(range, [&attrs](Paragraph& p, const Range& local) {
+            p.layout->setFontAttributes(attrs, local);
+            return true;
+        });
+    }
+
+    void ParagraphTextLayout::setDrawingEffects(const DrawingEffects& effects, const Range& range) {
+        forEachInRange(range, [&effects](Paragraph& p, const Range& local) {
+            p.layout->setDrawingEffects(effects, local);
+            return false;
+        });
+    }
+
+    void ParagraphTextLayout::setInlineObject(TextInlineObject* tio, const Range& range) {
+        forEachInRange(range, [tio](Paragraph& p, const Range& local) {
+            p.layout->setInlineObject(tio, local);
+            return true;
+        });
+    }
+
+    void ParagraphTextLayout::setDefaultFontColor(const Color& color) {
+        font_color_ = color;
+        for (auto& p : paragraphs_) {
+            p.layout->setDefaultFontColor(color);
+        }
+    }
+
+    void ParagraphTextLayout::setHoriAlignment(Alignment align) {
+        hori_align_ = align;
+        for (auto& p : paragraphs_) {
+            p.layout->setHoriAlignment(align);
+        }
+        invalidateAllMetrics();
+    }
+
+    void ParagraphTextLayout::setVertAlignment(Alignment align) {
+        vert_align_ = align;
+    }
+
+    void ParagraphTextLayout::setTextWrapping(TextWrapping tw) {
+        if (wrapping_ == tw) {
+            return;
+        }
+
+        wrapping_ = tw;
+        for (auto& p : paragraphs_) {
+            p.layout->setTextWrapping(tw);
+        }
+        invalidateAllMetrics();
+    }
+
+    void ParagraphTextLayout::setLineSpacing(LineSpacing ls, float spacing) {
+        line_spacing_method_ = ls;
+        line_spacing_ = spacing;
+        for (auto& p : paragraphs_) {
+            p.layout->setLineSpacing(ls, spacing);
+        }
+        invalidateAllMetrics();
+    }
+
+    float ParagraphTextLayout::getMaxWidth() const {
+        return max_width_;
+    }
+
+    float ParagraphTextLayout::getMaxHeight() const {
+        return max_height_;
+    }
+
+    bool ParagraphTextLayout::getTextMetrics(TextMetrics* tm) {
+        if (paragraphs_.empty() || !ensureMetrics()) {
+            return false;
+        }
+
+        float left = paragraphs_.front().metrics.rect.x();
+        float right = paragraphs_.front().metrics.rect.right();
+        size_t line_count = 0;
+        for (const auto& p : paragraphs_) {
+            left = (std::min)(left, p.metrics.rect.x());
+            right = (std::max)(right, p.metrics.rect.right());
+            line_count += p.metrics.line_count;
+        }
+
+        tm->rect.xywh(left, getVertOffset(), right - left, total_height_);
+        tm->line_count = line_count;
+        return true;
+    }
+
+    bool ParagraphTextLayout::getLineMetrics(std::vector<LineMetrics>* lms) {
+        if (paragraphs_.empty()) {
+            return false;
+        }
+
+        std::vector<LineMetrics> sub;
+        for (const auto& p : paragraphs_) {
+            sub.clear();
+            if (!p.layout->getLineMetrics(&sub)) {
+                return false;
+            }
+
+            // 分隔符算在段落的最后一行中
+            if (!sub.empty()) {
+                sub.back().length += p.sep_length;
+            }
+            lms->insert(lms->end(), sub.begin(), sub.end());
+        }
+        return true;
+    }
+
+    bool ParagraphTextLayout::hitTestPoint(
+        float x, float y, bool* is_trailing, bool* is_inside, HitTestInfo* info)
+    {
+        if (paragraphs_.empty() || !ensureMetrics()) {
+            return false;
+        }
+
+        float offset = getVertOffset();
+        auto& p = paragraphs_[findParagraphByY(y - offset)];
+        if (!p.layout->hitTestPoint(x, y - offset - p.top, is_trailing, is_inside, info)) {
+            return false;
+        }
+
+        info->pos += p.start;
+        info->rect.offset(0, offset + p.top);
+        return true;
+    }
+
+    bool ParagraphTextLayout::hitTestTextRange(
+        size_t pos, size_t len, float org_x, float org_y, std::vector<HitTestInfo>* info)
+    {
+        if (paragraphs_.empty() || !ensureMetrics()) {
+            return false;
+        }
+
+        float offset = getVertOffset();
+        size_t index = findParagraphByPos(pos);
+
+        if (len == 0) {
+            auto& p = paragraphs_[index];
+            size_t prev_size = info->size();
+            if (!p.layout->hitTestTextRange(
+                (std::min)(pos - p.start, p.length), 0, org_x, org_y + offset + p.top, info))
+            {
+                return false;
+            }
+
+            for (size_t i = prev_size; i < info->size(); ++i) {
+                (*info)[i].pos += p.start;
+            }
+            return true;
+        }
+
+        size_t end = pos + len;
+        for (; index < paragraphs_.size() && paragraphs_[index].start < end; ++index) {
+            auto& p = paragraphs_[index];
+            size_t content_end = p.start + p.length;
+            size_t cs = (std::max)(pos, p.start);
+            size_t ce = (std::min)(end, content_end);
+
+            if (ce > cs) {
+                size_t prev_size = info->size();
+                if (!p.layout->hitTestTextRange(
+                    cs - p.start, ce - cs, org_x, org_y + offset + p.top, info))
+                {
+                    return false;
+                }
+
+                for (size_t i = prev_size; i < info->size(); ++i) {
+                    (*info)[i].pos += p.start;
+                }
+                continue;
+            }
+
+            // 只选中了分隔符，用零宽的矩形表示，以便空行也能显示选择区域
+            size_t ss = (std::max)(pos, content_end);
+            size_t se = (std::min)(end, p.end());
+            if (se > ss) {
+                PointF pt;
+                HitTestInfo ht;
+                if (!p.layout->hitTestTextPos(p.length, false, &pt, &ht)) {
+                    return false;
+                }
+
+                ht.pos = ss;
+                ht.length = se - ss;
+                ht.rect.xywh(
+                    pt.x() + org_x, ht.rect.y() + org_y + offset + p.top,
+                    0, ht.rect.height());
+                info->push_back(ht);
+            }
+        }
+        return true;
+    }
+
+    bool ParagraphTextLayout::hitTestTextPos(
+        size_t pos, bool is_trailing, PointF* pt, HitTestInfo* info)
+    {
+        if (paragraphs_.empty() || !ensureMetrics()) {
+            return false;
+        }
+
+        auto& p = paragraphs_[findParagraphByPos(pos)];
+        size_t local = pos - p.start;
+        if (local >= p.length) {
+            // 分隔符处的位置都落在段落末尾
+            local = p.length;
+            is_trailing = false;
+        }
+
+        PointF local_pt;
+        if (!p.layout->hitTestTextPos(local, is_trailing, &local_pt, info)) {
+            return false;
+        }
+
+        float offset = getVertOffset();
+        if (pt) {
+            pt->x(local_pt.x());
+            pt->y(local_pt.y() + offset + p.top);
+        }
+
+        info->pos += p.start;
+        info->rect.offset(0, offset + p.top);
+        return true;
+    }
+
+    void ParagraphTextLayout::draw(Canvas* c, float x, float y) {
+        if (paragraphs_.empty() || !ensureMetrics()) {
+            return;
+        }
+
+        float offset = getVertOffset();
+
+        size_t index = 0;
+        float bottom = 0;
+        bool is_clipped = !drawing_region_.empty();
+        if (is_clipped) {
+            index = findParagraphByY(drawing_region_.y() - offset);
+            bottom = drawing_region_.bottom() - offset;
+        }
+
+        for (; index < paragraphs_.size(); ++index) {
+            auto& p = paragraphs_[index];
+            if (is_clipped && p.top >= bottom) {
+                break;
+            }
+            p.layout->draw(c, x, y + offset + p.top);
+        }
+    }
+
+    size_t ParagraphTextLayout::getParagraphCount() const {
+        return paragraphs_.size();
+    }
+
+    bool ParagraphTextLayout::splitParagraphs(
+        const std::u16string& text, size_t start, size_t end, bool is_last,
+        std::vector<Paragraph>* out)
+    {
+        // 一次性找出所有段落的起始位置
+        BoundaryBitmap boundaries;
+        ParagraphBreaker::fill(std::u16string_view(text).substr(start), &boundaries);
+
+        size_t seg_start = start;
+        while (seg_start < end) {
+            size_t seg_end = start + boundaries.next(seg_start - start);
+
+            Paragraph p;
+            p.start = seg_start;
+            if (seg_end - p.start >= 2 &&
+                text[seg_end - 2] == u'\r' && text[seg_end - 1] == u'\n')
+            {
+                p.sep_length = 2;
+            } else if (ParagraphBreaker::isSeparator(text[seg_end - 1])) {
+                p.sep_length = 1;
+            }
+            p.length = seg_end - p.start - p.sep_length;
+            seg_start = seg_end;
+
+            if (!makeParagraph(text, &p)) {
+                return false;
+            }
+            out->push_back(std::move(p));
+        }
+
+        // 文本为空或以分隔符结尾时，末尾还有一个空段落
+        if (is_last &&
+            (out->empty() || out->back().sep_length > 0))
+        {
+            Paragraph p;
+            p.start = end;
+            if (!makeParagraph(text, &p)) {
+                return false;
+            }
+            out->push_back(std::move(p));
+        }
+        return true;
+    }
+
+    bool ParagraphTextLayout::makeParagraph(const std::u16string& text, Paragraph* p) {
+        p->layout.reset(TextLayout::create());
+        if (!p->layout->make(
+            std::u16string_view(text).substr(p->start, p->length),
+            font_name_, font_size_, font_style_, font_weight_, locale_name_))
+        {
+            p->layout.reset();
+            return false;
+        }
+
+        p->layout->setMaxWidth(max_width_);
+        p->layout->setMaxHeight(max_height_);
+        p->layout->setLineSpacing(line_spacing_method_, line_spacing_);
+        p->layout->setTextWrapping(wrapping_);
+        p->layout->setHoriAlignment(hori_align_);
+        p->layout->setVertAlignment(Alignment::START);
+        p->layout->setDefaultFontColor(font_color_);
+        return true;
+    }
+
+    void ParagraphTextLayout::invalidateMetrics(size_t first, size_t last) {
+        for (size_t i = first; i <= last && i < paragraphs_.size(); ++i) {
+            paragraphs_[i].is_metrics_valid = false;
+        }
+        dirty_index_ = (std::min)(dirty_index_, first);
+    }
+
+    void ParagraphTextLayout::invalidateAllMetrics() {
+        for (auto& p : paragraphs_) {
+            p.is_metrics_valid = false;
+        }
+        dirty_index_ = 0;
+    }
+
+    bool ParagraphTextLayout::ensureMetrics() {
+        if (dirty_index_ >= paragraphs_.size()) {
+            return true;
+        }
+
+        float top = 0;
+        if (dirty_index_ > 0) {
+            const auto& prev = paragraphs_[dirty_index_ - 1];
+            top = prev.top + prev.metrics.rect.height();
+        }
+
+        for (size_t i = dirty_index_; i < paragraphs_.size(); ++i) {
+            auto& p = paragraphs_[i];
+            if (!p.is_metrics_valid) {
+                if (!p.layout->getTextMetrics(&p.metrics)) {
+                    dirty_index_ = i;
+                    return false;
+                }
+                p.is_metrics_valid = true;
+            }
+
+            p.top = top;
+            top += p.metrics.rect.height();
+        }
+
+        total_height_ = top;
+        dirty_index_ = paragraphs_.size();
+        return true;
+    }
+
+    float ParagraphTextLayout::getVertOffset() {
+        switch (vert_align_) {
+        case Alignment::CENTER: return (max_height_ - total_height_) / 2;
+        case Alignment::END:    return max_height_ - total_height_;
+        case Alignment::START:
+        default:                return 0;
+        }
+    }
+
+    size_t ParagraphTextLayout::findParagraphByPos(size_t pos) const {
+        auto it = std::upper_bound(
+            paragraphs_.begin(), paragraphs_.end(), pos,
+            [](size_t val, const Paragraph& p) { return val < p.start; });
+        if (it == paragraphs_.begin()) {
+            return 0;
+        }
+        return size_t(it - paragraphs_.begin()) - 1;
+    }
+
+    size_t ParagraphTextLayout::findParagraphByY(float y) const {
+        auto it = std::upper_bound(
+            paragraphs_.begin(), paragraphs_.end(), y,
+            [](float val, const Paragraph& p) { return val < p.top; });
+        if (it == paragraphs_.begin()) {
+            return 0;
+        }
+        return size_t(it - paragraphs_.begin()) - 1;
+    }
+
+    template<typename F>
+    void ParagraphTextLayout::forEachInRange(const Range& range, F&& func) {
+        if (paragraphs_.empty() || range.length == 0) {
+            return;
+        }
+
+        size_t end = range.end();
+        for (size_t i = findParagraphByPos(range.pos);
+            i < paragraphs_.size() && paragraphs_[i].start < end; ++i)
+        {
+            auto& p = paragraphs_[i];
+            size_t cs = (std::max)(range.pos, p.start);
+            size_t ce = (std::min)(end, p.start + p.length);
+            if (ce <= cs) {
+                continue;
+            }
+
+            // func 返回 true 表示该操作可能改变段落的度量
+            if (func(p, Range(cs - p.start, ce - cs))) {
+                invalidateMetrics(i, i);
+            }
+        }
+    }
+
+}
@@ -0,0 +1,164 @@
+// Copyright (c) 2016 ucclkp <ucclkp@gmail.com>.
+// This file is part of ukive project.
+//
+// This program is licensed under GPLv3 license that can be
+// found in the LICENSE file.
+
+#ifndef UKIVE_TEXT_PARAGRAPH_TEXT_LAYOUT_H_
+#define UKIVE_TEXT_PARAGRAPH_TEXT_LAYOUT_H_
+
+#include <memory>
+
+#include "ukive/text/text_layout.h"
+
+
+namespace ukive {
+
+    class PieceTable;
+
+    /**
+     * 按段落分别排版的文本布局。
+     * 文本由 ParagraphBreaker 切分为段落，每个段落使用一个平台 TextLayout 排版，
+     * 段落在竖直方向上依次排列。文本发生变化时，通过 update() 只重新排版受影响的段落。
+     * 行度量和命中测试由各段落的结果拼合而成，对外的位置均为整个文本中的位置。
+     */
+    class ParagraphTextLayout : public TextLayout {
+    public:
+        ParagraphTextLayout();
+        ~ParagraphTextLayout();
+
+        bool make(
+            const std::u16string_view& text,
+            const std::u16string_view& font_name,
+            float font_size,
+            FontStyle style,
+            FontWeight weight,
+            const std::u16string_view& locale_name) override;
+        void destroy() override;
+
+        /**
+         * 根据文本变化重新排版受影响的段落。
+         * 新创建的段落使用当前的默认字体和各项设置，但不带有任何区间属性，
+         * 调用方应将 dirty 范围内的 Span 重新应用到布局上。
+         * @param text 变化后的完整文本。
+         * @param rc 文本的变化范围。
+         * @param dirty 返回重新排版的文本范围。
+         */
+        bool update(const std::u16string& text, const RangeChg& rc, Range* dirty);
+
+        /**
+         * 同上。只从 text 中取出受影响的段落，不需要连续的完整文本。
+         */
+        bool update(const PieceTable& text, const RangeChg& rc, Range* dirty);
+
+        /**
+         * 设置之后新建段落所使用的默认字体。不影响已有的段落。
+         */
+        void setDefaultFont(
+            const std::u16string_view& font_name,
+            float font_size,
+            FontStyle style,
+            FontWeight weight);
+
+        /**
+         * 设置绘制时的可见区域，位于该区域之外的段落不会被绘制。
+         * 区域为空时绘制所有段落。
+         */
+        void setDrawingRegion(const RectF& region);
+
+        void setMaxWidth(float max_width) override;
+        void setMaxHeight(float max_height) override;
+
+        void setFontAttributes(const FontAttributes& attrs, const Range& range) override;
+        void setDrawingEffects(const DrawingEffects& effects, const Range& range) override;
+        void setInlineObject(TextInlineObject* tio, const Range& range) override;
+
+        void setDefaultFontColor(const Color& color) override;
+
+        void setHoriAlignment(Alignment align) override;
+        void setVertAlignment(Alignment align) override;
+        void setTextWrapping(TextWrapping tw) override;
+        void setLineSpacing(LineSpacing ls, float spacing) override;
+
+        float getMaxWidth() const override;
+        float getMaxHeight() const override;
+
+        bool getTextMetrics(TextMetrics* tm) override;
+        bool getLineMetrics(std::vector<LineMetrics>* lms) override;
+
+        bool hitTestPoint(
+            float x, float y, bool* is_trailing, bool* is_inside, HitTestInfo* info) override;
+        bool hitTestTextRange(
+            size_t pos, size_t len, float org_x, float org_y, std::vector<HitTestInfo>* info) override;
+        bool hitTestTextPos(
+            size_t pos, bool is_trailing, PointF* pt, HitTestInfo* info) override;
+
+        void draw(Canvas* c, float x, float y) override;
+
+        size_t getParagraphCount() const;
+
+    private:
+        struct Paragraph {
+            // 段落在文本中的起始位置
+            size_t start = 0;
+            // 段落内容的长度，不含分隔符
+            size_t length = 0;
+            // 末尾分隔符的长度，最后一段为 0
+            size_t sep_length = 0;
+
+            std::unique_ptr<TextLayout> layout;
+
+            bool is_metrics_valid = false;
+            TextMetrics metrics;
+            float top = 0;
+
+            size_t end() const { return start + length + sep_length; }
+        };
+
+        template <typename Text>
+        bool updateImpl(const Text& text, const RangeChg& rc, Range* dirty);
+
+        bool splitParagraphs(
+            const std::u16string& text, size_t start, size_t end, bool is_last,
+            std::vector<Paragraph>* out);
+        bool makeParagraph(const std::u16string& text, Paragraph* p);
+
+        void invalidateMetrics(size_t first, size_t last);
+        void invalidateAllMetrics();
+        bool ensureMetrics();
+        float getVertOffset();
+
+        size_t findParagraphByPos(size_t pos) const;
+        size_t findParagraphByY(float y) const;
+
+        template<typename F>
+        void forEachInRange(const Range& range, F&& func);
+
+        std::vector<Paragraph> paragraphs_;
+        size_t text_length_ = 0;
+
+        // 从该下标起的段落需要重新计算度量
+        size_t dirty_index_ = 0;
+        float total_height_ = 0;
+
+        std::u16string font_name_;
+        float font_size_ = 0;
+        FontStyle font_style_ = FontStyle::NORMAL;
+        FontWeight font_weight_ = FontWeight::NORMAL;
+        std::u16string locale_name_;
+
+        float max_width_ = 0;
+        float max_height_ = 0;
+        Color font_color_;
+        Alignment hori_align_ = Alignment::START;
+        Alignment vert_align_ = Alignment::START;
+        TextWrapping wrapping_ = TextWrapping::NONE;
+        LineSpacing line_spacing_method_ = LineSpacing::DEFAULT;
+        float line_spacing_ = 0;
+
+        RectF drawing_region_;
+    };
+
+}
+
+#endif  // UKIVE_TEXT_PARAGRAPH_TEXT_LAYOUT_H_
@@ -0,0 +1,539 @@
+// Copyright (c) 2016 ucclkp <ucclkp@gmail.com>.
+// This file is part of ukive project.
+//
+// This program is licensed under GPLv3 license that can be
+// found in the LICENSE file.
+
+#include "ukive/text/piece_table.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "utils/log.h"
+
+#include "ukive/text/text_search.h"
+
+
+namespace {
+
+    size_t search(const std::u16string_view& text, const std::u16string_view& s) {
+        return ukive::TextSearch::get().find(text.data(), text.length(), s.data(), s.length());
+    }
+
+}
+
+namespace ukive {
+
+    // PieceTable::ChunkIterator
+    PieceTable::ChunkIterator::ChunkIterator(
+        const PieceTable* table, size_t pos, size_t end)
+        : table_(table),
+          pos_(pos),
+          end_(end)
+    {
+        if (pos >= end) {
+            return;
+        }
+
+        // 沿途记录下一次需要访问的节点，相当于从 pos 处开始的中序遍历
+        size_t skip = pos;
+        uint32_t index = table_->root_;
+        while (index != kNil) {
+            auto& node = table_->nodes_[index];
+            size_t left_len = table_->subLength(node.left);
+            if (skip < left_len) {
+                stack_.push_back(index);
+                index = node.left;
+            } else if (skip < left_len + node.length) {
+                stack_.push_back(index);
+                skip -= left_len;
+                break;
+            } else {
+                skip -= left_len + node.length;
+                index = node.right;
+            }
+        }
+
+        load(skip);
+    }
+
+    PieceTable::ChunkIterator& PieceTable::ChunkIterator::operator++() {
+        pos_ += chunk_.length();
+        chunk_ = {};
+        if (pos_ >= end_ || stack_.empty()) {
+            return *this;
+        }
+
+        uint32_t index = stack_.back();
+        stack_.pop_back();
+        pushLeft(table_->nodes_[index].right);
+        load(0);
+        return *this;
+    }
+
+    void PieceTable::ChunkIterator::pushLeft(uint32_t index) {
+        while (index != kNil) {
+            stack_.push_back(index);
+            index = table_->nodes_[index].left;
+        }
+    }
+
+    void PieceTable::ChunkIterator::load(size_t skip) {
+        if (stack_.empty()) {
+            return;
+        }
+
+        auto piece = table_->getPiece(table_->nodes_[stack_.back()]);
+        chunk_ = piece.substr(skip, end_ - pos_);
+    }
+
+
+    // PieceTable
+    PieceTable::PieceTable() {}
+
+    PieceTable::PieceTable(const std::u16string_view& text) {
+        insert(0, text);
+    }
+
+    size_t PieceTable::length() const {
+        return subLength(root_);
+    }
+
+    void PieceTable::insert(size_t pos, const std::u16string_view& text) {
+        if (text.empty()) {
+            return;
+        }
+        ubassert(pos <= length());
+        pos = (std::min)(pos, length());
+
+        // 初始文本放入原始缓冲区
+        Buffer buffer = (root_ == kNil && buffers_[ORIGINAL].empty()) ? ORIGINAL : ADDED;
+        size_t buffer_end = buffers_[buffer].length();
+        appendBuffer(buffer, text);
+
+        uint32_t l, r;
+        split(root_, pos, &l, &r);
+
+        // 连续输入时，新文本紧接在上一片段之后，直接延长该片段
+        if (buffer == ADDED && extendLast(l, buffer_end, text.length())) {
+            root_ = merge(l, r);
+        } else {
+            auto node = newNode(buffer, buffer_end, text.length());
+            root_ = merge(merge(l, node), r);
+        }
+        is_flat_valid_ = false;
+    }
+
+    void PieceTable::erase(size_t pos, size_t length) {
+        size_t total = this->length();
+        if (pos >= total || length == 0) {
+            return;
+        }
+        length = (std::min)(length, total - pos);
+
+        uint32_t l, m, r;
+        split(root_, pos, &l, &m);
+        split(m, length, &m, &r);
+        freeTree(m);
+        root_ = merge(l, r);
+        is_flat_valid_ = false;
+    }
+
+    void PieceTable::replace(size_t pos, size_t length, const std::u16string_view& text) {
+        erase(pos, length);
+        insert(pos, text);
+    }
+
+    void PieceTable::clear() {
+        for (auto& buffer : buffers_) {
+            buffer.clear();
+            buffer.shrink_to_fit();
+        }
+        for (auto& breaks : line_breaks_) {
+            breaks.clear();
+            breaks.shrink_to_fit();
+        }
+        nodes_.clear();
+        free_nodes_.clear();
+        root_ = kNil;
+
+        flat_.clear();
+        is_flat_valid_ = true;
+    }
+
+    char16_t PieceTable::at(size_t pos) const {
+        ubassert(pos < length());
+
+        uint32_t index = root_;
+        while (index != kNil) {
+            auto& node = nodes_[index];
+            size_t left_len = subLength(node.left);
+            if (pos < left_len) {
+                index = node.left;
+            } else if (pos < left_len + node.length) {
+                return buffers_[node.buffer][node.start + pos - left_len];
+            } else {
+                pos -= left_len + node.length;
+                index = node.right;
+            }
+        }
+        return 0;
+    }
+
+    std::u16string PieceTable::substr(size_t pos, size_t length) const {
+        std::u16string result;
+        for (auto it = chunks(pos, length); it.isValid(); ++it) {
+            result.append(*it);
+        }
+        return result;
+    }
+
+    void PieceTable::copy(size_t pos, size_t length, char16_t* out) const {
+        for (auto it = chunks(pos, length); it.isValid(); ++it) {
+            std::memcpy(out, it->data(), it->length() * sizeof(char16_t));
+            out += it->length();
+        }
+    }
+
+    size_t PieceTable::find(const std::u16string_view& s, size_t pos) const {
+        if (is_flat_valid_) {
+            if (pos > flat_.length()) {
+                return npos;
+            }
+            auto found = search(std::u16string_view(flat_).substr(pos), s);
+            return found == npos ? npos : pos + found;
+        }
+
+        size_t total = length();
+        if (s.empty()) {
+            return pos <= total ? pos : npos;
+        }
+        if (pos >= total || s.length() > total - pos) {
+            return npos;
+        }
+
+        // 跨越片段的匹配：保留之前文本末尾的 s.length() - 1 个字符，与下一片段的开头拼接后查找
+        size_t keep_max = s.length() - 1;
+        std::u16string carry;
+        size_t carry_pos = pos;
+        for (auto it = chunks(pos); it.isValid(); ++it) {
+            std::u16string_view chunk = *it;
+            if (!carry.empty()) {
+                auto joined = carry;
+                joined.append(chunk.substr(0, keep_max));
+                auto found = search(joined, s);
+                if (found != npos) {
+                    return carry_pos + found;
+                }
+            }
+
+            auto found = search(chunk, s);
+            if (found != npos) {
+                return it.getPos() + found;
+            }
+
+            if (chunk.length() >= keep_max) {
+                carry.assign(chunk.substr(chunk.length() - keep_max));
+            } else {
+                carry.append(chunk);
+                if (carry.length() > keep_max) {
+                    carry.erase(0, carry.length() - keep_max);
+                }
+            }
+            carry_pos = it.getPos() + chunk.length() - carry.length();
+        }
+        return npos;
+    }
+
+    void PieceTable::findAll(
+        const std::u16string_view& s, size_t pos, std::vector<size_t>* out) const
+    {
+        if (s.empty()) {
+            ubassert(false);
+            return;
+        }
+
+        if (is_flat_valid_) {
+            std::u16string_view text(flat_);
+            while (pos + s.length() <= text.length()) {
+                auto found = search(text.substr(pos), s);
+                if (found == npos) {
+                    break;
+                }
+                out->push_back(pos + found);
+                pos += found + s.length();
+            }
+            return;
+        }
+
+        for (;;) {
+            auto found = find(s, pos);
+            if (found == npos) {
+                break;
+            }
+            out->push_back(found);
+            pos = found + s.length();
+        }
+    }
+
+    PieceTable::ChunkIterator PieceTable::chunks(size_t pos, size_t length) const {
+        size_t total = this->length();
+        pos = (std::min)(pos, total);
+        size_t end = (length > total - pos) ? total : pos + length;
+        return ChunkIterator(this, pos, end);
+    }
+
+    const std::u16string& PieceTable::str() const {
+        if (!is_flat_valid_) {
+            flat_.resize(length());
+            copy(0, flat_.length(), flat_.data());
+            is_flat_valid_ = true;
+        }
+        return flat_;
+    }
+
+    size_t PieceTable::getLineCount() const {
+        return subLines(root_) + 1;
+    }
+
+    size_t PieceTable::getLineStart(size_t line) const {
+        if (line == 0) {
+            return 0;
+        }
+        if (line > subLines(root_)) {
+            return length();
+        }
+
+        // 查找第 line 个换行符
+        size_t base = 0;
+        size_t k = line;
+        uint32_t index = root_;
+        while (index != kNil) {
+            auto& node = nodes_[index];
+            size_t left_lines = subLines(node.left);
+            if (k <= left_lines) {
+                index = node.left;
+            } else if (k <= left_lines + node.lines) {
+                auto& breaks = line_breaks_[node.buffer];
+                auto first = std::lower_bound(breaks.begin(), breaks.end(), node.start);
+                size_t offset = *(first + (k - left_lines - 1)) - node.start;
+                return base + subLength(node.left) + offset + 1;
+            } else {
+                k -= left_lines + node.lines;
+                base += subLength(node.left) + node.length;
+                index = node.right;
+            }
+        }
+
+        ubassert(false);
+        return length();
+    }
+
+    size_t PieceTable::getLineAt(size_t pos) const {
+        // 统计 [0, pos) 中的换行符数
+        size_t line = 0;
+        uint32_t index = root_;
+        while (index != kNil) {
+            auto& node = nodes_[index];
+            size_t left_len = subLength(node.left);
+            if (pos < left_len) {
+                index = node.left;
+            } else if (pos < left_len + node.length) {
+                line += subLines(node.left) + countLines(node.buffer, node.start, pos - left_len);
+                break;
+            } else {
+                line += subLines(node.left) + node.lines;
+                pos -= left_len + node.length;
+                index = node.right;
+            }
+        }
+        return line;
+    }
+
+    size_t PieceTable::getPieceCount() const {
+        return nodes_.size() - free_nodes_.size();
+    }
+
+    size_t PieceTable::getTreeDepth() const {
+        size_t depth = 0;
+        if (root_ == kNil) {
+            return depth;
+        }
+
+        std::vector<std::pair<uint32_t, size_t>> stack;
+        stack.emplace_back(root_, 1);
+        while (!stack.empty()) {
+            auto cur = stack.back();
+            stack.pop_back();
+            depth = (std::max)(depth, cur.second);
+
+            auto& node = nodes_[cur.first];
+            if (node.left != kNil) {
+                stack.emplace_back(node.left, cur.second + 1);
+            }
+            if (node.right != kNil) {
+                stack.emplace_back(node.right, cur.second + 1);
+            }
+        }
+        return depth;
+    }
+
+    uint32_t PieceTable::newNode(Buffer buffer, size_t start, size_t length) {
+        // xorshift32
+        seed_ ^= seed_ << 13;
+        seed_ ^= seed_ >> 17;
+        seed_ ^= seed_ << 5;
+
+        Node node;
+        node.left = kNil;
+        node.right = kNil;
+        node.priority = seed_;
+        node.buffer = buffer;
+        node.start = start;
+        node.length = length;
+        node.lines = countLines(buffer, start, length);
+        node.sub_length = length;
+        node.sub_lines = node.lines;
+
+        if (!free_nodes_.empty()) {
+            auto index = free_nodes_.back();
+            free_nodes_.pop_back();
+            nodes_[index] = node;
+            return index;
+        }
+
+        nodes_.push_back(node);
+        return uint32_t(nodes_.size() - 1);
+    }
+
+    void PieceTable::freeTree(uint32_t index) {
+        if (index == kNil) {
+            return;
+        }
+        freeTree(nodes_[index].left);
+        freeTree(nodes_[index].right);
+        free_nodes_.push_back(index);
+    }
+
+    void PieceTable::update(uint32_t index) {
+        auto& node = nodes_[index];
+        node.sub_length = subLength(node.left) + node.length + subLength(node.right);
+        node.sub_lines = subLines(node.left) + node.lines + subLines(node.right);
+    }
+
+    size_t PieceTable::countLines(Buffer buffer, size_t start, size_t length) const {
+        auto& breaks = line_breaks_[buffer];
+        auto first = std::lower_bound(breaks.begin(), breaks.end(), start);
+        auto last = std::lower_bound(first, breaks.end(), start + length);
+        return size_t(last - first);
+    }
+
+    size_t PieceTable::subLength(uint32_t index) const {
+        return index == kNil ? 0 : nodes_[index].sub_length;
+    }
+
+    size_t PieceTable::subLines(uint32_t index) const {
+        return index == kNil ? 0 : nodes_[index].sub_lines;
+    }
+
+    void PieceTable::split(uint32_t t, size_t pos, uint32_t* l, uint32_t* r) {
+        if (t == kNil) {
+            *l = *r = kNil;
+            return;
+        }
+
+        size_t left_len = subLength(nodes_[t].left);
+        size_t node_len = nodes_[t].length;
+        if (pos <= left_len) {
+            uint32_t sub_r;
+            split(nodes_[t].left, pos, l, &sub_r);
+            nodes_[t].left = sub_r;
+            update(t);
+            *r = t;
+        } else if (pos >= left_len + node_len) {
+            uint32_t sub_l;
+            split(nodes_[t].right, pos - left_len - node_len, &sub_l, r);
+            nodes_[t].right = sub_l;
+            update(t);
+            *l = t;
+        } else {
+            // 位置落在片段内部，将片段一分为二。
+            // 后半段会挂到 t 的祖先之下，沿用 t 的优先级才能保持堆序
+            size_t offset = pos - left_len;
+            auto tail = newNode(
+                nodes_[t].buffer, nodes_[t].start + offset, node_len - offset);
+            nodes_[tail].priority = nodes_[t].priority;
+
+            auto& node = nodes_[t];
+            node.length = offset;
+            node.lines = countLines(node.buffer, node.start, offset);
+
+            uint32_t right = node.right;
+            node.right = kNil;
+            update(t);
+
+            *l = t;
+            *r = merge(tail, right);
+        }
+    }
+
+    uint32_t PieceTable::merge(uint32_t l, uint32_t r) {
+        if (l == kNil) {
+            return r;
+        }
+        if (r == kNil) {
+            return l;
+        }
+
+        if (nodes_[l].priority > nodes_[r].priority) {
+            auto right = merge(nodes_[l].right, r);
+            nodes_[l].right = right;
+            update(l);
+            return l;
+        }
+
+        auto left = merge(l, nodes_[r].left);
+        nodes_[r].left = left;
+        update(r);
+        return r;
+    }
+
+    bool PieceTable::extendLast(uint32_t t, size_t buffer_end, size_t length) {
+        if (t == kNil) {
+            return false;
+        }
+
+        auto& node = nodes_[t];
+        if (node.right != kNil) {
+            if (!extendLast(node.right, buffer_end, length)) {
+                return false;
+            }
+        } else {
+            if (node.buffer != ADDED || node.start + node.length != buffer_end) {
+                return false;
+            }
+            node.length += length;
+            node.lines = countLines(node.buffer, node.start, node.length);
+        }
+
+        update(t);
+        return true;
+    }
+
+    void PieceTable::appendBuffer(Buffer buffer, const std::u16string_view& text) {
+        auto& str = buffers_[buffer];
+        auto& breaks = line_breaks_[buffer];
+        size_t base = str.length();
+        for (size_t i = 0; i < text.length(); ++i) {
+            if (text[i] == u'\n') {
+                breaks.push_back(base + i);
+            }
+        }
+        str.append(text);
+    }
+
+    std::u16string_view PieceTable::getPiece(const Node& node) const {
+        return std::u16string_view(buffers_[node.buffer]).substr(node.start, node.length);
+    }
+
+}
@@ -0,0 +1,168 @@
+// Copyright (c) 2016 ucclkp <ucclkp@gmail.com>.
+// This file is part of ukive project.
+//
+// This program is licensed under GPLv3 license that can be
+// found in the LICENSE file.
+
+#ifndef UKIVE_TEXT_PIECE_TABLE_H_
+#define UKIVE_TEXT_PIECE_TABLE_H_
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+namespace ukive {
+
+    /**
+     * 片段表形式的文本存储。
+     * 初始文本和之后插入的文本分别保存在两个只增不减的缓冲区中，
+     * 文本由一系列指向缓冲区的片段依次连接而成，片段保存在按位置排序的平衡树（treap）中。
+     * 插入、删除和按位置访问的耗时为 O(log n)，n 为片段数，与文本长度无关。
+     * 每个缓冲区中的换行符位置在写入时记录下来，因此按行定位同样为 O(log n)。
+     * 需要连续文本时可使用 str()，其结果在下次修改前缓存。
+     */
+    class PieceTable {
+    public:
+        /**
+         * 按顺序遍历文本片段。
+         * 修改文本后，之前得到的迭代器和片段均失效。
+         */
+        class ChunkIterator {
+        public:
+            bool isValid() const { return !chunk_.empty(); }
+            const std::u16string_view& operator*() const { return chunk_; }
+            const std::u16string_view* operator->() const { return &chunk_; }
+            ChunkIterator& operator++();
+
+            // 当前片段在文本中的起始位置
+            size_t getPos() const { return pos_; }
+
+        private:
+            friend class PieceTable;
+
+            ChunkIterator(const PieceTable* table, size_t pos, size_t end);
+            void pushLeft(uint32_t index);
+            void load(size_t skip);
+
+            const PieceTable* table_;
+            std::vector<uint32_t> stack_;
+            std::u16string_view chunk_;
+            size_t pos_;
+            size_t end_;
+        };
+
+        PieceTable();
+        explicit PieceTable(const std::u16string_view& text);
+
+        PieceTable(const PieceTable&) = delete;
+        PieceTable& operator=(const PieceTable&) = delete;
+
+        size_t length() const;
+        bool empty() const { return length() == 0; }
+
+        void insert(size_t pos, const std::u16string_view& text);
+        void erase(size_t pos, size_t length);
+        void replace(size_t pos, size_t length, const std::u16string_view& text);
+        void clear();
+
+        char16_t at(size_t pos) const;
+        char16_t operator[](size_t pos) const { return at(pos); }
+        std::u16string substr(size_t pos, size_t length) const;
+        void copy(size_t pos, size_t length, char16_t* out) const;
+
+        /**
+         * 查找 s 首次出现的位置，找不到时返回 npos。
+         */
+        size_t find(const std::u16string_view& s, size_t pos = 0) const;
+
+        /**
+         * 从 pos 开始查找 s 所有不重叠的出现位置，按顺序追加到 out 中。
+         * s 不能为空。
+         */
+        void findAll(const std::u16string_view& s, size_t pos, std::vector<size_t>* out) const;
+
+        /**
+         * 从 pos 开始遍历，到 pos + length 为止。
+         */
+        ChunkIterator chunks(size_t pos = 0, size_t length = npos) const;
+
+        /**
+         * 获取连续的文本。
+         * 结果在下次修改前有效；首次调用需要复制全部文本。
+         */
+        const std::u16string& str() const;
+
+        /**
+         * 行以 \n 分隔，行数为 \n 的数量加一。
+         */
+        size_t getLineCount() const;
+        size_t getLineStart(size_t line) const;
+        size_t getLineAt(size_t pos) const;
+
+        /**
+         * 片段的数量，供诊断使用。
+         */
+        size_t getPieceCount() const;
+
+        /**
+         * 平衡树的深度，供诊断使用。
+         */
+        size_t getTreeDepth() const;
+
+        static constexpr size_t npos = std::u16string::npos;
+
+    private:
+        enum Buffer : uint8_t {
+            ORIGINAL = 0,
+            ADDED,
+            BUFFER_COUNT,
+        };
+
+        struct Node {
+            uint32_t left;
+            uint32_t right;
+            uint32_t priority;
+            Buffer buffer;
+            size_t start;
+            size_t length;
+            size_t lines;
+
+            // 以该节点为根的子树的总长度和换行符数
+            size_t sub_length;
+            size_t sub_lines;
+        };
+
+        static constexpr uint32_t kNil = UINT32_MAX;
+
+        uint32_t newNode(Buffer buffer, size_t start, size_t length);
+        void freeTree(uint32_t index);
+        void update(uint32_t index);
+        size_t countLines(Buffer buffer, size_t start, size_t length) const;
+        size_t subLength(uint32_t index) const;
+        size_t subLines(uint32_t index) const;
+
+        void split(uint32_t t, size_t pos, uint32_t* l, uint32_t* r);
+        uint32_t merge(uint32_t l, uint32_t r);
+        bool extendLast(uint32_t t, size_t buffer_end, size_t length);
+
+        void appendBuffer(Buffer buffer, const std::u16string_view& text);
+        std::u16string_view getPiece(const Node& node) const;
+
+        std::u16string buffers_[BUFFER_COUNT];
+        // 各缓冲区中换行符的位置，递增排列
+        std::vector<size_t> line_breaks_[BUFFER_COUNT];
+
+        std::vector<Node> nodes_;
+        std::vector<uint32_t> free_nodes_;
+        uint32_t root_ = kNil;
+        uint32_t seed_ = 0x9E3779B9u;
+
+        mutable std::u16string flat_;
+        mutable bool is_flat_valid_ = true;
+    };
+
+}
+
+#endif  // UKIVE_TEXT_PIECE_TABLE_H_
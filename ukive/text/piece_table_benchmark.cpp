@@ -0,0 +1,149 @@
+// Copyright (c) 2016 ucclkp <ucclkp@gmail.com>.
+// This file is part of ukive project.
+//
+// This program is licensed under GPLv3 license that can be
+// found in the LICENSE file.
+
+#include "ukive/text/piece_table_benchmark.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <random>
+#include <string>
+
+#include "utils/log.h"
+#include "utils/time_utils.h"
+
+#include "ukive/text/piece_table.h"
+
+
+namespace {
+
+    const int kFuzzOps = 200000;
+    // 约 100 MB 的 UTF-16 文本
+    const size_t kLargeUnits = 50 * 1024 * 1024;
+    // 编辑位置位于文本开头的这个范围内
+    const size_t kEditRange = 4096;
+    const int kTableEdits = 100000;
+    const int kStringEdits = 20;
+
+    std::u16string makeText(std::mt19937& rng, size_t length) {
+        const char16_t kChars[] = u"abcdefgh \n中文😀";
+        std::uniform_int_distribution<size_t> dist(0, std::size(kChars) - 2);
+        std::u16string text(length, u' ');
+        for (auto& ch : text) {
+            ch = kChars[dist(rng)];
+        }
+        return text;
+    }
+
+    /**
+     * 随机插入、删除和替换，每一步都与 std::u16string 对照。
+     * @return 第一次不一致时的操作序号，全部一致时返回 -1。
+     */
+    int fuzz(std::mt19937& rng, size_t* pieces, size_t* depth) {
+        std::u16string model = makeText(rng, 256);
+        ukive::PieceTable table(model);
+
+        for (int i = 0; i < kFuzzOps; ++i) {
+            size_t pos = std::uniform_int_distribution<size_t>(0, model.size())(rng);
+            size_t len = std::uniform_int_distribution<size_t>(0, 8)(rng);
+            len = (std::min)(len, model.size() - pos);
+            auto text = makeText(rng, std::uniform_int_distribution<size_t>(1, 8)(rng));
+
+            switch (rng() % 3) {
+            case 0:
+                table.insert(pos, text);
+                model.insert(pos, text);
+                break;
+            case 1:
+                table.erase(pos, len);
+                model.erase(pos, len);
+                break;
+            default:
+                table.replace(pos, len, text);
+                model.replace(pos, len, text);
+                break;
+            }
+
+            if (table.length() != model.size()) {
+                return i;
+            }
+            if (i % 1000 == 0) {
+                if (table.str() != model ||
+                    table.getLineCount() != size_t(std::count(model.begin(), model.end(), u'\n')) + 1)
+                {
+                    return i;
+                }
+            }
+        }
+
+        if (table.str() != model) {
+            return kFuzzOps;
+        }
+        *pieces = table.getPieceCount();
+        *depth = table.getTreeDepth();
+        return -1;
+    }
+
+    /**
+     * 对 count 个随机位置执行 edit，返回每次操作的平均耗时，单位为纳秒。
+     */
+    template <typename Edit>
+    double timeEdits(std::mt19937& rng, int count, Edit&& edit) {
+        std::uniform_int_distribution<size_t> dist(0, kEditRange);
+        auto start = utl::TimeUtils::upTimeNanos();
+        for (int i = 0; i < count; ++i) {
+            edit(dist(rng), i % 2 == 0);
+        }
+        return double(utl::TimeUtils::upTimeNanos() - start) / count;
+    }
+
+}
+
+namespace ukive {
+
+    void runPieceTableBenchmark() {
+        std::mt19937 rng(20240521);
+
+        size_t pieces = 0, depth = 0;
+        int failed = fuzz(rng, &pieces, &depth);
+        if (failed >= 0) {
+            LOG(Log::ERR) << "PieceTable self-check failed at op " << failed << ".";
+        } else {
+            LOG(Log::INFO) << "PieceTable self-check: " << kFuzzOps
+                << " random edits match std::u16string, "
+                << pieces << " pieces, tree depth " << depth
+                << " (log2 = " << int(std::log2(double(pieces) + 1)) << ")";
+        }
+
+        // 插入和删除交替进行，文本长度保持不变
+        auto text = makeText(rng, kLargeUnits);
+        const std::u16string_view kInsert = u"x";
+
+        PieceTable table(text);
+        double table_ns = timeEdits(rng, kTableEdits, [&](size_t pos, bool insert) {
+            if (insert) {
+                table.insert(pos, kInsert);
+            } else {
+                table.erase(pos, 1);
+            }
+        });
+
+        double string_ns = timeEdits(rng, kStringEdits, [&](size_t pos, bool insert) {
+            if (insert) {
+                text.insert(pos, kInsert);
+            } else {
+                text.erase(pos, 1);
+            }
+        });
+
+        LOG(Log::INFO) << "PieceTable benchmark, edits near the start of "
+            << (kLargeUnits * sizeof(char16_t) >> 20) << " MB: piece table "
+            << (table_ns / 1000.0) << " us/edit (" << table.getPieceCount()
+            << " pieces, depth " << table.getTreeDepth() << "), std::u16string "
+            << (string_ns / 1000.0) << " us/edit";
+    }
+
+}
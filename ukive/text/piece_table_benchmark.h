@@ -0,0 +1,21 @@
+// Copyright (c) 2016 ucclkp <ucclkp@gmail.com>.
+// This file is part of ukive project.
+//
+// This program is licensed under GPLv3 license that can be
+// found in the LICENSE file.
+
+#ifndef UKIVE_TEXT_PIECE_TABLE_BENCHMARK_H_
+#define UKIVE_TEXT_PIECE_TABLE_BENCHMARK_H_
+
+
+namespace ukive {
+
+    /**
+     * 用随机编辑将 PieceTable 与 std::u16string 对照检查，并记录平衡树的深度；
+     * 然后在约 100 MB 的文本上比较两者在文本开头附近编辑的耗时。结果写入日志。
+     */
+    void runPieceTableBenchmark();
+
+}
+
+#endif  // UKIVE_TEXT_PIECE_TABLE_BENCHMARK_H_
@@ -6,22 +6,40 @@
 
 #include "span.h"
 
+#include "ukive/text/span/span_tree.h"
+
 
 namespace ukive {
 
     Span::Span(size_t start, size_t end)
         : start_(start), end_(end) {}
 
+    Span::~Span() {
+        if (tree_) {
+            tree_->remove(this);
+        }
+    }
+
     void Span::resize(size_t start, size_t end) {
+        if (tree_) {
+            tree_->resize(this, start, end);
+            return;
+        }
         start_ = start;
         end_ = end;
     }
 
     size_t Span::getStart() const {
+        if (tree_) {
+            return tree_->getStart(this);
+        }
         return start_;
     }
 
     size_t Span::getEnd() const {
+        if (tree_) {
+            return tree_->getEnd(this);
+        }
         return end_;
     }
 
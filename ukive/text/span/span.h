@@ -8,14 +8,21 @@
 #define UKIVE_TEXT_SPAN_SPAN_H_
 
 #include <cstddef>
+#include <cstdint>
+#include <memory>
 
 
 namespace ukive {
 
-    class Span {
+    class SpanTree;
+
+    /**
+     * 加入 Editable 后由 shared_ptr 持有，编辑记录中以 weak_ptr 引用。
+     */
+    class Span : public std::enable_shared_from_this<Span> {
     public:
         Span(size_t start, size_t end);
-        virtual ~Span() = default;
+        virtual ~Span();
 
         enum Type {
             NONE = 0,
@@ -33,8 +40,14 @@ namespace ukive {
         size_t getEnd() const;
 
     private:
+        friend class SpanTree;
+
         size_t start_;
         size_t end_;
+
+        // 加入 SpanTree 之后，位置由 SpanTree 维护
+        SpanTree* tree_ = nullptr;
+        uint32_t node_ = 0;
     };
 
 }
@@ -0,0 +1,379 @@
+// Copyright (c) 2016 ucclkp <ucclkp@gmail.com>.
+// This file is part of ukive project.
+//
+// This program is licensed under GPLv3 license that can be
+// found in the LICENSE file.
+
+#include "ukive/text/span/span_tree.h"
+
+#include <algorithm>
+
+#include "utils/log.h"
+
+#include "ukive/text/span/span.h"
+
+
+namespace {
+
+    size_t offsetBy(size_t pos, int64_t delta) {
+        return size_t(int64_t(pos) + delta);
+    }
+
+}
+
+namespace ukive {
+
+    SpanTree::SpanTree() {}
+
+    SpanTree::~SpanTree() {
+        clear();
+    }
+
+    void SpanTree::insert(Span* span) {
+        if (span->tree_) {
+            ubassert(false);
+            return;
+        }
+
+        auto index = newNode(span, span->start_, span->end_);
+        span->tree_ = this;
+        span->node_ = index;
+        attach(index);
+    }
+
+    void SpanTree::remove(Span* span) {
+        if (span->tree_ != this) {
+            ubassert(false);
+            return;
+        }
+
+        auto index = span->node_;
+        detach(index);
+
+        // 离开树之后，位置重新由 Span 自己保存
+        span->start_ = nodes_[index].start;
+        span->end_ = nodes_[index].end;
+        span->tree_ = nullptr;
+        free_nodes_.push_back(index);
+    }
+
+    void SpanTree::clear() {
+        // 先写回所有 Span 的位置
+        std::vector<std::pair<uint32_t, int64_t>> stack;
+        if (root_ != kNil) {
+            stack.push_back({ root_, 0 });
+        }
+        while (!stack.empty()) {
+            auto [index, delta] = stack.back();
+            stack.pop_back();
+
+            auto& node = nodes_[index];
+            delta += node.delta;
+            node.span->start_ = offsetBy(node.start, delta);
+            node.span->end_ = offsetBy(node.end, delta);
+            node.span->tree_ = nullptr;
+
+            if (node.left != kNil) stack.push_back({ node.left, delta });
+            if (node.right != kNil) stack.push_back({ node.right, delta });
+        }
+
+        nodes_.clear();
+        free_nodes_.clear();
+        root_ = kNil;
+    }
+
+    void SpanTree::shift(const RangeChg& rc) {
+        if (root_ == kNil || (rc.old_length == 0 && rc.new_length == 0)) {
+            return;
+        }
+
+        // 起始位置在改动范围之后的 Span 整体平移，只记录在子树根上
+        uint32_t l, r;
+        split(root_, rc.old_end(), &l, &r);
+        if (r != kNil) {
+            nodes_[r].delta += int64_t(rc.new_length) - int64_t(rc.old_length);
+        }
+
+        // 其余的 Span 中，只有结束位置在改动位置之后的需要调整
+        shiftOverlapped(l, rc);
+
+        root_ = merge(l, r);
+        nodes_[root_].parent = kNil;
+    }
+
+    void SpanTree::query(const Range& range, std::vector<Span*>* out) const {
+        Range r(range.pos, (std::max)(range.length, size_t(1)));
+
+        std::vector<uint32_t> found;
+        query(root_, 0, r, &found);
+        std::sort(
+            found.begin(), found.end(),
+            [this](uint32_t i1, uint32_t i2) { return nodes_[i1].seq < nodes_[i2].seq; });
+
+        out->reserve(out->size() + found.size());
+        for (auto index : found) {
+            out->push_back(nodes_[index].span);
+        }
+    }
+
+    void SpanTree::queryEmpty(size_t pos, std::vector<Span*>* out) const {
+        queryEmpty(root_, 0, pos, out);
+    }
+
+    size_t SpanTree::getStart(const Span* span) const {
+        ubassert(span->tree_ == this);
+        return offsetBy(nodes_[span->node_].start, getPending(span->node_));
+    }
+
+    size_t SpanTree::getEnd(const Span* span) const {
+        ubassert(span->tree_ == this);
+        return offsetBy(nodes_[span->node_].end, getPending(span->node_));
+    }
+
+    void SpanTree::resize(Span* span, size_t start, size_t end) {
+        if (span->tree_ != this) {
+            ubassert(false);
+            return;
+        }
+
+        // 保持加入的顺序不变，只移动节点
+        auto index = span->node_;
+        detach(index);
+        nodes_[index].start = start;
+        nodes_[index].end = end;
+        attach(index);
+    }
+
+    size_t SpanTree::size() const {
+        return nodes_.size() - free_nodes_.size();
+    }
+
+    uint32_t SpanTree::newNode(Span* span, size_t start, size_t end) {
+        // xorshift32
+        seed_ ^= seed_ << 13;
+        seed_ ^= seed_ >> 17;
+        seed_ ^= seed_ << 5;
+
+        Node node;
+        node.left = kNil;
+        node.right = kNil;
+        node.parent = kNil;
+        node.priority = seed_;
+        node.span = span;
+        node.seq = next_seq_++;
+        node.start = start;
+        node.end = end;
+        node.max_end = end;
+        node.delta = 0;
+
+        if (!free_nodes_.empty()) {
+            auto index = free_nodes_.back();
+            free_nodes_.pop_back();
+            nodes_[index] = node;
+            return index;
+        }
+
+        nodes_.push_back(node);
+        return uint32_t(nodes_.size() - 1);
+    }
+
+    void SpanTree::push(uint32_t index) {
+        auto& node = nodes_[index];
+        if (node.delta == 0) {
+            return;
+        }
+
+        node.start = offsetBy(node.start, node.delta);
+        node.end = offsetBy(node.end, node.delta);
+        node.max_end = offsetBy(node.max_end, node.delta);
+        if (node.left != kNil) nodes_[node.left].delta += node.delta;
+        if (node.right != kNil) nodes_[node.right].delta += node.delta;
+        node.delta = 0;
+    }
+
+    void SpanTree::update(uint32_t index) {
+        auto& node = nodes_[index];
+        node.max_end = (std::max)({ node.end, subMaxEnd(node.left), subMaxEnd(node.right) });
+        if (node.left != kNil) nodes_[node.left].parent = index;
+        if (node.right != kNil) nodes_[node.right].parent = index;
+    }
+
+    size_t SpanTree::subMaxEnd(uint32_t index) const {
+        if (index == kNil) {
+            return 0;
+        }
+        return offsetBy(nodes_[index].max_end, nodes_[index].delta);
+    }
+
+    int64_t SpanTree::getPending(uint32_t index) const {
+        int64_t delta = 0;
+        while (index != kNil) {
+            delta += nodes_[index].delta;
+            index = nodes_[index].parent;
+        }
+        return delta;
+    }
+
+    void SpanTree::split(uint32_t t, size_t start, uint32_t* l, uint32_t* r) {
+        if (t == kNil) {
+            *l = *r = kNil;
+            return;
+        }
+
+        push(t);
+        if (nodes_[t].start < start) {
+            uint32_t sub_l;
+            split(nodes_[t].right, start, &sub_l, r);
+            nodes_[t].right = sub_l;
+            update(t);
+            *l = t;
+        } else {
+            uint32_t sub_r;
+            split(nodes_[t].left, start, l, &sub_r);
+            nodes_[t].left = sub_r;
+            update(t);
+            *r = t;
+        }
+    }
+
+    uint32_t SpanTree::merge(uint32_t l, uint32_t r) {
+        if (l == kNil) {
+            return r;
+        }
+        if (r == kNil) {
+            return l;
+        }
+
+        if (nodes_[l].priority > nodes_[r].priority) {
+            push(l);
+            auto right = merge(nodes_[l].right, r);
+            nodes_[l].right = right;
+            update(l);
+            return l;
+        }
+
+        push(r);
+        auto left = merge(l, nodes_[r].left);
+        nodes_[r].left = left;
+        update(r);
+        return r;
+    }
+
+    void SpanTree::attach(uint32_t index) {
+        auto& node = nodes_[index];
+        node.left = kNil;
+        node.right = kNil;
+        node.max_end = node.end;
+        node.delta = 0;
+
+        // 起始位置相同时，放在已有的 Span 之后
+        uint32_t l, r;
+        split(root_, node.start + 1, &l, &r);
+        root_ = merge(merge(l, index), r);
+        nodes_[root_].parent = kNil;
+    }
+
+    void SpanTree::detach(uint32_t index) {
+        // 将路径上的偏移量应用到该节点
+        std::vector<uint32_t> path;
+        for (auto i = index; i != kNil; i = nodes_[i].parent) {
+            path.push_back(i);
+        }
+        for (auto it = path.rbegin(); it != path.rend(); ++it) {
+            push(*it);
+        }
+
+        auto& node = nodes_[index];
+        auto parent = node.parent;
+        auto sub = merge(node.left, node.right);
+        if (sub != kNil) {
+            nodes_[sub].parent = parent;
+        }
+
+        if (parent == kNil) {
+            root_ = sub;
+            return;
+        }
+
+        if (nodes_[parent].left == index) {
+            nodes_[parent].left = sub;
+        } else {
+            nodes_[parent].right = sub;
+        }
+        for (auto i = parent; i != kNil; i = nodes_[i].parent) {
+            update(i);
+        }
+    }
+
+    void SpanTree::shiftOverlapped(uint32_t t, const RangeChg& rc) {
+        if (t == kNil || subMaxEnd(t) <= rc.pos) {
+            return;
+        }
+
+        push(t);
+        shiftOverlapped(nodes_[t].left, rc);
+        shiftOverlapped(nodes_[t].right, rc);
+
+        // 这里的 Span 起始位置都在 rc.old_end() 之前，调整后顺序不变
+        auto& node = nodes_[t];
+        if (node.start > rc.pos) {
+            node.start = rc.pos;
+        }
+        if (node.end > rc.pos) {
+            if (node.end >= rc.old_end()) {
+                node.end = node.end - rc.old_length + rc.new_length;
+            } else {
+                node.end = rc.new_end();
+            }
+        }
+        update(t);
+    }
+
+    void SpanTree::query(
+        uint32_t t, int64_t delta, const Range& range, std::vector<uint32_t>* out) const
+    {
+        if (t == kNil) {
+            return;
+        }
+
+        auto& node = nodes_[t];
+        delta += node.delta;
+        if (offsetBy(node.max_end, delta) <= range.pos) {
+            return;
+        }
+
+        query(node.left, delta, range, out);
+        if (offsetBy(node.start, delta) < range.end()) {
+            if (offsetBy(node.end, delta) > range.pos) {
+                out->push_back(t);
+            }
+            query(node.right, delta, range, out);
+        }
+    }
+
+    void SpanTree::queryEmpty(
+        uint32_t t, int64_t delta, size_t pos, std::vector<Span*>* out) const
+    {
+        if (t == kNil) {
+            return;
+        }
+
+        auto& node = nodes_[t];
+        delta += node.delta;
+        if (offsetBy(node.max_end, delta) < pos) {
+            return;
+        }
+
+        auto start = offsetBy(node.start, delta);
+        if (start >= pos) {
+            queryEmpty(node.left, delta, pos, out);
+        }
+        if (start == pos && offsetBy(node.end, delta) == pos) {
+            out->push_back(node.span);
+        }
+        if (start <= pos) {
+            queryEmpty(node.right, delta, pos, out);
+        }
+    }
+
+}
@@ -0,0 +1,107 @@
+// Copyright (c) 2016 ucclkp <ucclkp@gmail.com>.
+// This file is part of ukive project.
+//
+// This program is licensed under GPLv3 license that can be
+// found in the LICENSE file.
+
+#ifndef UKIVE_TEXT_SPAN_SPAN_TREE_H_
+#define UKIVE_TEXT_SPAN_SPAN_TREE_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "ukive/text/range.hpp"
+
+
+namespace ukive {
+
+    class Span;
+
+    /**
+     * Span 的区间树。
+     * Span 按起始位置保存在平衡树（treap）中，每个节点记录子树中最大的结束位置，
+     * 查找与某一区间重叠的 Span 的耗时为 O(log n + k)。
+     * 文本改动时，改动之后的 Span 只在子树上记录偏移量，不逐个修改；
+     * Span 加入树中之后，其位置由树维护，通过 Span::getStart() 等获取时才计算。
+     */
+    class SpanTree {
+    public:
+        SpanTree();
+        ~SpanTree();
+
+        SpanTree(const SpanTree&) = delete;
+        SpanTree& operator=(const SpanTree&) = delete;
+
+        void insert(Span* span);
+        void remove(Span* span);
+        void clear();
+
+        /**
+         * 根据文本改动调整 Span 的位置。
+         * 在 Span 之前或之后插入文本时，Span 不会扩大；在 Span 内部插入时会扩大。
+         * 被删除的部分从 Span 中去掉，Span 可能因此变为空。
+         */
+        void shift(const RangeChg& rc);
+
+        /**
+         * 查找与 range 重叠的 Span，按加入的顺序排列。
+         * range 为空时，查找包含 range.pos 的 Span。
+         */
+        void query(const Range& range, std::vector<Span*>* out) const;
+
+        /**
+         * 查找起始和结束位置都为 pos 的空 Span。
+         * 这些 Span 不与任何范围重叠，query() 只能找到它们中位于 range 内部的。
+         */
+        void queryEmpty(size_t pos, std::vector<Span*>* out) const;
+
+        size_t getStart(const Span* span) const;
+        size_t getEnd(const Span* span) const;
+        void resize(Span* span, size_t start, size_t end);
+
+        size_t size() const;
+
+    private:
+        struct Node {
+            uint32_t left;
+            uint32_t right;
+            uint32_t parent;
+            uint32_t priority;
+            Span* span;
+            // 加入的顺序
+            uint64_t seq;
+            size_t start;
+            size_t end;
+
+            // 子树中最大的结束位置
+            size_t max_end;
+            // 尚未应用到子树（包括该节点）上的偏移量
+            int64_t delta;
+        };
+
+        static constexpr uint32_t kNil = UINT32_MAX;
+
+        uint32_t newNode(Span* span, size_t start, size_t end);
+        void push(uint32_t index);
+        void update(uint32_t index);
+        size_t subMaxEnd(uint32_t index) const;
+        int64_t getPending(uint32_t index) const;
+
+        void split(uint32_t t, size_t start, uint32_t* l, uint32_t* r);
+        uint32_t merge(uint32_t l, uint32_t r);
+        void attach(uint32_t index);
+        void detach(uint32_t index);
+        void shiftOverlapped(uint32_t t, const RangeChg& rc);
+        void query(uint32_t t, int64_t delta, const Range& range, std::vector<uint32_t>* out) const;
+        void queryEmpty(uint32_t t, int64_t delta, size_t pos, std::vector<Span*>* out) const;
+
+        std::vector<Node> nodes_;
+        std::vector<uint32_t> free_nodes_;
+        uint32_t root_ = kNil;
+        uint32_t seed_ = 0x9E3779B9u;
+        uint64_t next_seq_ = 0;
+    };
+
+}
+
+#endif  // UKIVE_TEXT_SPAN_SPAN_TREE_H_
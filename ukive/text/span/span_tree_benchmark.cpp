@@ -0,0 +1,253 @@
+// Copyright (c) 2016 ucclkp <ucclkp@gmail.com>.
+// This file is part of ukive project.
+//
+// This program is licensed under GPLv3 license that can be
+// found in the LICENSE file.
+
+#include "ukive/text/span/span_tree_benchmark.h"
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "utils/log.h"
+#include "utils/time_utils.h"
+
+#include "ukive/text/span/span.h"
+#include "ukive/text/span/span_tree.h"
+
+
+namespace {
+
+    const int kFuzzOps = 100000;
+    const size_t kLargeSpans = 100000;
+    const size_t kLargeText = 5 * 1024 * 1024;
+    // 一次段落查询覆盖的长度
+    const size_t kParagraph = 256;
+    const int kTimedOps = 100000;
+
+    class BenchSpan : public ukive::Span {
+    public:
+        BenchSpan(size_t start, size_t end)
+            : Span(start, end) {}
+
+        Type getType() const override { return NONE; }
+    };
+
+    /**
+     * 逐个遍历的对照实现，entries 按加入的顺序排列。
+     */
+    struct ModelEntry {
+        BenchSpan* span;
+        size_t start;
+        size_t end;
+    };
+
+    void modelShift(std::vector<ModelEntry>* entries, const ukive::RangeChg& rc) {
+        if (rc.old_length == 0 && rc.new_length == 0) {
+            return;
+        }
+        for (auto& e : *entries) {
+            if (e.start >= rc.old_end()) {
+                e.start = e.start - rc.old_length + rc.new_length;
+                e.end = e.end - rc.old_length + rc.new_length;
+                continue;
+            }
+            if (e.start > rc.pos) {
+                e.start = rc.pos;
+            }
+            if (e.end > rc.pos) {
+                if (e.end >= rc.old_end()) {
+                    e.end = e.end - rc.old_length + rc.new_length;
+                } else {
+                    e.end = rc.new_end();
+                }
+            }
+        }
+    }
+
+    std::vector<ukive::Span*> modelQuery(
+        const std::vector<ModelEntry>& entries, const ukive::Range& range)
+    {
+        ukive::Range r(range.pos, (std::max)(range.length, size_t(1)));
+        std::vector<ukive::Span*> out;
+        for (auto& e : entries) {
+            if (e.start < r.end() && e.end > r.pos) {
+                out.push_back(e.span);
+            }
+        }
+        return out;
+    }
+
+    std::vector<ukive::Span*> modelQueryEmpty(
+        const std::vector<ModelEntry>& entries, size_t pos)
+    {
+        std::vector<ukive::Span*> out;
+        for (auto& e : entries) {
+            if (e.start == pos && e.end == pos) {
+                out.push_back(e.span);
+            }
+        }
+        return out;
+    }
+
+    /**
+     * 随机操作，每一步都与对照实现比较。
+     * @return 第一次不一致时的操作序号，全部一致时返回 -1。
+     */
+    int fuzz(std::mt19937& rng) {
+        size_t text_len = 1000;
+        std::vector<std::unique_ptr<BenchSpan>> spans;
+        std::vector<ModelEntry> model;
+        ukive::SpanTree tree;
+
+        auto rand = [&rng](size_t min, size_t max) {
+            return std::uniform_int_distribution<size_t>(min, max)(rng);
+        };
+        auto rand_range = [&](size_t* start, size_t* end) {
+            *start = rand(0, text_len);
+            *end = (std::min)(*start + rand(0, 16), text_len);
+        };
+
+        for (int i = 0; i < kFuzzOps; ++i) {
+            size_t start, end;
+            switch (rng() % 6) {
+            case 0:
+            {
+                // 约四分之一是空 Span
+                rand_range(&start, &end);
+                if (rng() % 4 == 0) {
+                    end = start;
+                }
+                spans.push_back(std::make_unique<BenchSpan>(start, end));
+                tree.insert(spans.back().get());
+                model.push_back({ spans.back().get(), start, end });
+                break;
+            }
+            case 1:
+            {
+                if (model.empty()) {
+                    break;
+                }
+                auto it = model.begin() + rand(0, model.size() - 1);
+                tree.remove(it->span);
+                if (it->span->getStart() != it->start || it->span->getEnd() != it->end) {
+                    return i;
+                }
+                model.erase(it);
+                break;
+            }
+            case 2:
+            {
+                if (model.empty()) {
+                    break;
+                }
+                auto& e = model[rand(0, model.size() - 1)];
+                rand_range(&start, &end);
+                e.span->resize(start, end);
+                e.start = start;
+                e.end = end;
+                break;
+            }
+            case 3:
+            {
+                size_t pos = rand(0, text_len);
+                size_t old_length = rand(0, (std::min)(text_len - pos, size_t(16)));
+                size_t new_length = rand(0, 16);
+                ukive::RangeChg rc(pos, old_length, new_length);
+                tree.shift(rc);
+                modelShift(&model, rc);
+                text_len = text_len - old_length + new_length;
+                break;
+            }
+            case 4:
+            {
+                rand_range(&start, &end);
+                ukive::Range range(start, end - start);
+                std::vector<ukive::Span*> result;
+                tree.query(range, &result);
+                if (result != modelQuery(model, range)) {
+                    return i;
+                }
+                break;
+            }
+            default:
+            {
+                // queryEmpty 按位置顺序返回，只比较集合
+                size_t pos = rand(0, text_len);
+                std::vector<ukive::Span*> result;
+                tree.queryEmpty(pos, &result);
+                auto expected = modelQueryEmpty(model, pos);
+                std::sort(result.begin(), result.end());
+                std::sort(expected.begin(), expected.end());
+                if (result != expected) {
+                    return i;
+                }
+                break;
+            }
+            }
+
+            if (tree.size() != model.size()) {
+                return i;
+            }
+            if (i % 1000 == 0) {
+                for (auto& e : model) {
+                    if (e.span->getStart() != e.start || e.span->getEnd() != e.end) {
+                        return i;
+                    }
+                }
+            }
+        }
+
+        return -1;
+    }
+
+}
+
+namespace ukive {
+
+    void runSpanTreeBenchmark() {
+        std::mt19937 rng(20240607);
+
+        int failed = fuzz(rng);
+        if (failed >= 0) {
+            LOG(Log::ERR) << "SpanTree self-check failed at op " << failed << ".";
+        } else {
+            LOG(Log::INFO) << "SpanTree self-check: " << kFuzzOps
+                << " random operations match the brute-force model";
+        }
+
+        std::uniform_int_distribution<size_t> dist(0, kLargeText - kParagraph);
+        std::vector<std::unique_ptr<BenchSpan>> spans;
+        SpanTree tree;
+        for (size_t i = 0; i < kLargeSpans; ++i) {
+            auto start = dist(rng);
+            spans.push_back(std::make_unique<BenchSpan>(start, start + rng() % 64));
+            tree.insert(spans.back().get());
+        }
+
+        // 插入和删除交替进行，文本长度保持不变
+        size_t found = 0;
+        std::vector<Span*> result;
+        auto start = utl::TimeUtils::upTimeNanos();
+        for (int i = 0; i < kTimedOps; ++i) {
+            auto pos = dist(rng);
+            if (i % 2 == 0) {
+                tree.shift(RangeChg(pos, 0, 1));
+            } else {
+                tree.shift(RangeChg(pos, 1, 0));
+            }
+
+            result.clear();
+            tree.query(Range(pos, kParagraph), &result);
+            found += result.size();
+        }
+        double ns = double(utl::TimeUtils::upTimeNanos() - start) / kTimedOps;
+
+        LOG(Log::INFO) << "SpanTree benchmark, " << kLargeSpans
+            << " spans: shift + paragraph query " << (ns / 1000.0)
+            << " us/op (" << (double(found) / kTimedOps) << " spans per query)";
+    }
+
+}
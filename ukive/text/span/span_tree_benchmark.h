@@ -0,0 +1,21 @@
+// Copyright (c) 2016 ucclkp <ucclkp@gmail.com>.
+// This file is part of ukive project.
+//
+// This program is licensed under GPLv3 license that can be
+// found in the LICENSE file.
+
+#ifndef UKIVE_TEXT_SPAN_SPAN_TREE_BENCHMARK_H_
+#define UKIVE_TEXT_SPAN_SPAN_TREE_BENCHMARK_H_
+
+
+namespace ukive {
+
+    /**
+     * 用随机的插入、移除、调整、平移和查询将 SpanTree 与逐个遍历的实现对照检查；
+     * 然后在 10 万个 Span 上测量一次平移加一次段落查询的耗时。结果写入日志。
+     */
+    void runSpanTreeBenchmark();
+
+}
+
+#endif  // UKIVE_TEXT_SPAN_SPAN_TREE_BENCHMARK_H_
@@ -6,187 +6,603 @@
 
 #include "text_breaker.h"
 
+#include <algorithm>
+
 #include "utils/strings/utfcc.h"
 
+#include "ukive/text/unicode_break_props.h"
 
-namespace ukive {
 
-    // ===== TextBreaker
-    TextBreaker::TextBreaker(const std::u16string* text)
-        : cur_(0), prev_(0), text_(text) {
-    }
+namespace {
 
-    void TextBreaker::setCur(size_t cur_pos) {
-        if (cur_pos > text_->length()) {
-            cur_pos = text_->length();
+    using namespace ukive;
+
+    inline uint32_t decode(const char16_t* s, size_t len, size_t pos, size_t* cp_len) {
+        char16_t ch = s[pos];
+        if (IS_START_SURROGATES(ch) && pos + 1 < len && IS_END_SURROGATES(s[pos + 1])) {
+            *cp_len = 2;
+            return ((uint32_t(ch) - 0xD800) << 10) + (uint32_t(s[pos + 1]) - 0xDC00) + 0x10000;
         }
-        cur_ = cur_pos;
-        prev_ = cur_;
+        *cp_len = 1;
+        return ch;
     }
 
+    // pos 是否位于代理对的中间
+    inline bool isInsidePair(const char16_t* s, size_t pos) {
+        return pos > 0 && IS_END_SURROGATES(s[pos]) && IS_START_SURROGATES(s[pos - 1]);
+    }
 
-    // ===== CharacterBreaker
-    CharacterBreaker::CharacterBreaker(const std::u16string* text)
-        : TextBreaker(text) {}
+    // 解码结束于 pos 的码点
+    inline uint32_t decodePrev(const char16_t* s, size_t pos) {
+        size_t cp_len;
+        size_t start = isInsidePair(s, pos - 1) ? pos - 2 : pos - 1;
+        return decode(s, pos, start, &cp_len);
+    }
 
-    bool CharacterBreaker::next() {
-        if (cur_ >= text_->length()) {
-            return false;
+    /**
+     * 从 pos 之前（不含 pos）向前逐个检查，返回最近的满足 is_safe 的位置。
+     * 文本开头不检查，找不到时返回 npos。
+     */
+    template <typename Pred>
+    size_t findSafe(const std::u16string_view& text, size_t pos, Pred&& is_safe) {
+        auto s = text.data();
+        size_t len = text.length();
+        // 开头可能是截断的代理对的后半部分，不能作为上一个字符
+        size_t first = (len > 0 && IS_END_SURROGATES(s[0])) ? 2 : 1;
+        for (size_t p = (std::min)(pos, len); p-- > first;) {
+            if (!isInsidePair(s, p) && is_safe(s, len, p)) {
+                return p;
+            }
         }
+        return BoundaryBitmap::npos;
+    }
 
-        prev_ = cur_;
-        char16_t ch = text_->at(cur_);
-        if (IS_START_SURROGATES(ch)) {
-            ++cur_;
-            if (cur_ >= text_->length()) {
-                return true;
-            }
 
-            ch = text_->at(cur_);
-            if (IS_END_SURROGATES(ch)) {
-                ++cur_;
-                return true;
-            }
+    // ===== 字素簇
+    // 状态为上一个字符的类别，另外记录 Extended_Pictographic 之后的
+    // Extend* ZWJ 序列（GB11）和区域指示符的奇偶（GB12、GB13）。
+    enum GraphemeState : uint8_t {
+        GS_SOT = 0,
+        GS_OTHER,
+        GS_CR,
+        GS_LF,
+        GS_CONTROL,
+        GS_EXTEND,
+        GS_ZWJ,
+        GS_RI_ODD,
+        GS_RI_EVEN,
+        GS_PREPEND,
+        GS_SPACING_MARK,
+        GS_L,
+        GS_V,
+        GS_T,
+        GS_LV,
+        GS_LVT,
+        GS_EP,
+        GS_EP_ZWJ,
+        GS_COUNT,
+    };
+
+    // Extended_Pictographic 的字符在 Grapheme_Cluster_Break 中均为 Other，
+    // 将其作为单独的输入类别
+    const uint8_t kGraphemeExtPict = GB_COUNT;
+    const uint8_t kGraphemeInputCount = GB_COUNT + 1;
+
+    const uint8_t kBreakBit = 0x80;
+
+    struct GraphemeTable {
+        uint8_t entries[GS_COUNT][kGraphemeInputCount];
+    };
+
+    constexpr bool isGraphemeJoined(uint8_t state, uint8_t in) {
+        if (state == GS_SOT) {
+            return false;
+        }
+        // GB3、GB4、GB5
+        if (state == GS_CR && in == GB_LF) {
+            return true;
+        }
+        if (state == GS_CR || state == GS_LF || state == GS_CONTROL) {
+            return false;
+        }
+        if (in == GB_CR || in == GB_LF || in == GB_CONTROL) {
+            return false;
+        }
+        // GB6、GB7、GB8
+        if (state == GS_L &&
+            (in == GB_L || in == GB_V || in == GB_LV || in == GB_LVT))
+        {
+            return true;
+        }
+        if ((state == GS_LV || state == GS_V) && (in == GB_V || in == GB_T)) {
+            return true;
+        }
+        if ((state == GS_LVT || state == GS_T) && in == GB_T) {
+            return true;
+        }
+        // GB9、GB9a、GB9b
+        if (in == GB_EXTEND || in == GB_ZWJ || in == GB_SPACING_MARK) {
             return true;
         }
+        if (state == GS_PREPEND) {
+            return true;
+        }
+        // GB11
+        if (state == GS_EP_ZWJ && in == kGraphemeExtPict) {
+            return true;
+        }
+        // GB12、GB13
+        if (state == GS_RI_ODD && in == GB_REGIONAL_INDICATOR) {
+            return true;
+        }
+        return false;
+    }
 
-        if (ch == u'\r') {
-            ++cur_;
-            if (cur_ >= text_->length()) {
-                return true;
-            }
+    constexpr uint8_t getGraphemeNextState(uint8_t state, uint8_t in) {
+        switch (in) {
+        case kGraphemeExtPict: return GS_EP;
+        case GB_EXTEND: return state == GS_EP ? GS_EP : GS_EXTEND;
+        case GB_ZWJ: return state == GS_EP ? GS_EP_ZWJ : GS_ZWJ;
+        case GB_REGIONAL_INDICATOR: return state == GS_RI_ODD ? GS_RI_EVEN : GS_RI_ODD;
+        case GB_CR: return GS_CR;
+        case GB_LF: return GS_LF;
+        case GB_CONTROL: return GS_CONTROL;
+        case GB_PREPEND: return GS_PREPEND;
+        case GB_SPACING_MARK: return GS_SPACING_MARK;
+        case GB_L: return GS_L;
+        case GB_V: return GS_V;
+        case GB_T: return GS_T;
+        case GB_LV: return GS_LV;
+        case GB_LVT: return GS_LVT;
+        default: return GS_OTHER;
+        }
+    }
 
-            ch = text_->at(cur_);
-            if (ch == u'\n') {
-                ++cur_;
-                return true;
+    constexpr GraphemeTable makeGraphemeTable() {
+        GraphemeTable table{};
+        for (uint8_t s = 0; s < GS_COUNT; ++s) {
+            for (uint8_t i = 0; i < kGraphemeInputCount; ++i) {
+                uint8_t entry = getGraphemeNextState(s, i);
+                if (!isGraphemeJoined(s, i)) {
+                    entry |= kBreakBit;
+                }
+                table.entries[s][i] = entry;
             }
-            return true;
         }
+        return table;
+    }
 
-        ++cur_;
-        return true;
+    // 状态转移表，每项的低位为下一状态，kBreakBit 表示该字符之前为边界
+    constexpr GraphemeTable kGraphemeTable = makeGraphemeTable();
+
+    /**
+     * 从 begin 开始依次找出字素簇边界，begin 视为边界。
+     * 每找到一个边界就调用 on_boundary，其返回 false 时停止。
+     */
+    struct GraphemeWalker {
+        template <typename Fn>
+        void operator()(const char16_t* s, size_t len, size_t begin, Fn&& on_boundary) const;
+    };
+
+    template <typename Fn>
+    void GraphemeWalker::operator()(
+        const char16_t* s, size_t len, size_t begin, Fn&& on_boundary) const
+    {
+        if (!on_boundary(begin) || begin >= len) {
+            return;
+        }
+
+        uint8_t state = GS_SOT;
+        size_t pos = begin;
+        while (pos < len) {
+            size_t cp_len;
+            auto props = getBreakProps(decode(s, len, pos, &cp_len));
+            uint8_t in = isExtendedPictographic(props) ? kGraphemeExtPict : uint8_t(getGraphemeBreak(props));
+
+            uint8_t entry = kGraphemeTable.entries[state][in];
+            if ((entry & kBreakBit) && pos != begin) {
+                if (!on_boundary(pos)) {
+                    return;
+                }
+            }
+            state = entry & ~kBreakBit;
+            pos += cp_len;
+        }
+        on_boundary(len);
     }
 
-    bool CharacterBreaker::prev() {
-        if (cur_ == 0) {
+
+    /**
+     * pos 之前一定是边界，且 pos 之后的状态与之前的文本无关：
+     * pos 处为 Control、CR、LF 或者非 Extended_Pictographic 的 Other，
+     * 并且 Other 之前不是 Prepend（GB9b），LF 之前不是 CR（GB3）。
+     */
+    bool isGraphemeSafe(const char16_t* s, size_t len, size_t pos) {
+        size_t cp_len;
+        auto props = getBreakProps(decode(s, len, pos, &cp_len));
+        if (isExtendedPictographic(props)) {
             return false;
         }
 
-        prev_ = cur_;
-        --cur_;
+        switch (getGraphemeBreak(props)) {
+        case GB_CONTROL:
+        case GB_CR:
+            return true;
+        case GB_LF:
+            return s[pos - 1] != u'\r';
+        case GB_OTHER:
+            return getGraphemeBreak(getBreakProps(decodePrev(s, pos))) != GB_PREPEND;
+        default:
+            return false;
+        }
+    }
 
-        char16_t ch = text_->at(cur_);
-        if (IS_END_SURROGATES(ch)) {
-            if (cur_ == 0) {
-                return true;
-            }
 
-            ch = text_->at(cur_ - 1);
-            if (IS_START_SURROGATES(ch)) {
-                --cur_;
-                return true;
+    // ===== 单词
+    inline bool isAHLetter(WordBreak wb) {
+        return wb == WB_ALETTER || wb == WB_HEBREW_LETTER;
+    }
+
+    inline bool isMidNumLetQ(WordBreak wb) {
+        return wb == WB_MID_NUM_LET || wb == WB_SINGLE_QUOTE;
+    }
+
+    inline bool isNewline(WordBreak wb) {
+        return wb == WB_CR || wb == WB_LF || wb == WB_NEWLINE;
+    }
+
+    inline bool isIgnorable(WordBreak wb) {
+        return wb == WB_EXTEND || wb == WB_FORMAT || wb == WB_ZWJ;
+    }
+
+    // 跳过 pos 处的 Extend、Format 和 ZWJ，获取之后第一个字符的类别（WB4）
+    WordBreak getWordLookahead(const char16_t* s, size_t len, size_t pos) {
+        while (pos < len) {
+            size_t cp_len;
+            auto wb = getWordBreak(getBreakProps(decode(s, len, pos, &cp_len)));
+            if (!isIgnorable(wb)) {
+                return wb;
             }
+            pos += cp_len;
+        }
+        return WB_OTHER;
+    }
+
+    /**
+     * pos 之前一定是边界，且 pos 之后的状态与之前的文本无关：
+     * pos 处不是 Extend、Format 或 ZWJ，紧邻的上一个字符为 Other、WSegSpace 或换行，
+     * 并且不是 WB3 中的 CR LF 或 WB3d 中的 WSegSpace WSegSpace。
+     * 这时 WB6 至 WB16 都不会用到 pos 之前更远的字符。
+     */
+    bool isWordSafe(const char16_t* s, size_t len, size_t pos) {
+        size_t cp_len;
+        auto cur = getWordBreak(getBreakProps(decode(s, len, pos, &cp_len)));
+        if (isIgnorable(cur)) {
+            return false;
+        }
+
+        switch (getWordBreak(getBreakProps(decodePrev(s, pos)))) {
+        case WB_OTHER:
+        case WB_LF:
+        case WB_NEWLINE:
             return true;
+        case WB_CR:
+            return cur != WB_LF;
+        case WB_WSEG_SPACE:
+            return cur != WB_WSEG_SPACE;
+        default:
+            return false;
         }
+    }
 
-        if (ch == u'\n') {
-            if (cur_ == 0) {
-                return true;
+    /**
+     * 从 begin 开始依次找出单词边界，begin 视为边界。
+     * 规则中需要向后看的部分（WB6、WB7b、WB12）只在遇到相应的标点时才向后查找。
+     */
+    struct WordWalker {
+        template <typename Fn>
+        void operator()(const char16_t* s, size_t len, size_t begin, Fn&& on_boundary) const;
+    };
+
+    template <typename Fn>
+    void WordWalker::operator()(
+        const char16_t* s, size_t len, size_t begin, Fn&& on_boundary) const
+    {
+        if (!on_boundary(begin) || begin >= len) {
+            return;
+        }
+
+        size_t cp_len;
+        size_t pos = begin;
+        auto wb = getWordBreak(getBreakProps(decode(s, len, pos, &cp_len)));
+
+        // 紧邻的上一个字符
+        WordBreak raw = wb;
+        // 按 WB4 忽略 Extend、Format 和 ZWJ 之后的上一个和上上个字符
+        WordBreak prev = wb;
+        WordBreak prev2 = WB_OTHER;
+        // 上一个字符所在的连续区域指示符的个数是否为奇数
+        bool ri_odd = wb == WB_REGIONAL_INDICATOR;
+
+        pos += cp_len;
+        while (pos < len) {
+            auto props = getBreakProps(decode(s, len, pos, &cp_len));
+            auto cur = getWordBreak(props);
+            size_t next_pos = pos + cp_len;
+
+            bool is_break;
+            if (raw == WB_CR && cur == WB_LF) {
+                is_break = false;                                           // WB3
+            } else if (isNewline(raw) || isNewline(cur)) {
+                is_break = true;                                            // WB3a、WB3b
+            } else if (raw == WB_ZWJ && isExtendedPictographic(props)) {
+                is_break = false;                                           // WB3c
+            } else if (raw == WB_WSEG_SPACE && cur == WB_WSEG_SPACE) {
+                is_break = false;                                           // WB3d
+            } else if (isIgnorable(cur)) {
+                is_break = false;                                           // WB4
+            } else if (isAHLetter(prev) && isAHLetter(cur)) {
+                is_break = false;                                           // WB5
+            } else if (isAHLetter(prev) &&
+                (cur == WB_MID_LETTER || isMidNumLetQ(cur)) &&
+                isAHLetter(getWordLookahead(s, len, next_pos)))
+            {
+                is_break = false;                                           // WB6
+            } else if (isAHLetter(prev2) &&
+                (prev == WB_MID_LETTER || isMidNumLetQ(prev)) && isAHLetter(cur))
+            {
+                is_break = false;                                           // WB7
+            } else if (prev == WB_HEBREW_LETTER && cur == WB_SINGLE_QUOTE) {
+                is_break = false;                                           // WB7a
+            } else if (prev == WB_HEBREW_LETTER && cur == WB_DOUBLE_QUOTE &&
+                getWordLookahead(s, len, next_pos) == WB_HEBREW_LETTER)
+            {
+                is_break = false;                                           // WB7b
+            } else if (prev2 == WB_HEBREW_LETTER && prev == WB_DOUBLE_QUOTE &&
+                cur == WB_HEBREW_LETTER)
+            {
+                is_break = false;                                           // WB7c
+            } else if ((prev == WB_NUMERIC || isAHLetter(prev)) && cur == WB_NUMERIC) {
+                is_break = false;                                           // WB8、WB9
+            } else if (prev == WB_NUMERIC && isAHLetter(cur)) {
+                is_break = false;                                           // WB10
+            } else if (prev2 == WB_NUMERIC &&
+                (prev == WB_MID_NUM || isMidNumLetQ(prev)) && cur == WB_NUMERIC)
+            {
+                is_break = false;                                           // WB11
+            } else if (prev == WB_NUMERIC &&
+                (cur == WB_MID_NUM || isMidNumLetQ(cur)) &&
+                getWordLookahead(s, len, next_pos) == WB_NUMERIC)
+            {
+                is_break = false;                                           // WB12
+            } else if (prev == WB_KATAKANA && cur == WB_KATAKANA) {
+                is_break = false;                                           // WB13
+            } else if ((isAHLetter(prev) || prev == WB_NUMERIC ||
+                prev == WB_KATAKANA || prev == WB_EXTEND_NUM_LET) &&
+                cur == WB_EXTEND_NUM_LET)
+            {
+                is_break = false;                                           // WB13a
+            } else if (prev == WB_EXTEND_NUM_LET &&
+                (isAHLetter(cur) || cur == WB_NUMERIC || cur == WB_KATAKANA))
+            {
+                is_break = false;                                           // WB13b
+            } else if (prev == WB_REGIONAL_INDICATOR && cur == WB_REGIONAL_INDICATOR && ri_odd) {
+                is_break = false;                                           // WB15、WB16
+            } else {
+                is_break = true;                                            // WB999
             }
 
-            ch = text_->at(cur_ - 1);
-            if (ch == u'\r') {
-                --cur_;
-                return true;
+            if (is_break && !on_boundary(pos)) {
+                return;
             }
-            return true;
-        }
 
-        return true;
+            // 换行之后的 Extend 等字符前没有可以附着的字符，不能忽略
+            if (!isIgnorable(cur) || isNewline(prev)) {
+                ri_odd = (cur == WB_REGIONAL_INDICATOR) &&
+                    !(prev == WB_REGIONAL_INDICATOR && ri_odd);
+                prev2 = prev;
+                prev = cur;
+            }
+            raw = cur;
+            pos = next_pos;
+        }
+        on_boundary(len);
     }
 
 
-    // ===== WordBreaker
-    WordBreaker::WordBreaker(const std::u16string* text)
-        : TextBreaker(text) {
+    template <typename Walker>
+    void fillBoundaries(const std::u16string_view& text, BoundaryBitmap* out, const Walker& walker) {
+        out->reset(text.length());
+        walker(text.data(), text.length(), 0, [out](size_t pos) {
+            out->set(pos);
+            return true;
+        });
     }
 
-    bool WordBreaker::next() {
-        if (cur_ >= text_->length()) {
+    template <typename Walker>
+    bool moveNext(const std::u16string& text, size_t* cur, size_t* prev, const Walker& walker) {
+        if (*cur >= text.length()) {
             return false;
         }
 
-        prev_ = cur_;
-        char16_t ch = text_->at(cur_);
-        if (IS_START_SURROGATES(ch)) {
-            ++cur_;
-            if (cur_ >= text_->length()) {
-                return true;
-            }
-
-            ch = text_->at(cur_);
-            if (IS_END_SURROGATES(ch)) {
-                ++cur_;
-                return true;
+        *prev = *cur;
+        size_t start = *cur;
+        walker(text.data(), text.length(), start, [start, cur](size_t pos) {
+            if (pos > start) {
+                *cur = pos;
+                return false;
             }
             return true;
-        }
+        });
+        return true;
+    }
 
-        if (ch == u'\r') {
-            ++cur_;
-            if (cur_ >= text_->length()) {
-                return true;
-            }
+    template <typename Walker, typename Pred>
+    bool movePrev(
+        const std::u16string& text, size_t* cur, size_t* prev,
+        const Walker& walker, Pred&& is_safe)
+    {
+        if (*cur == 0) {
+            return false;
+        }
 
-            ch = text_->at(cur_);
-            if (ch == u'\n') {
-                ++cur_;
-                return true;
+        // 从前面最近的安全边界开始向后计算，取当前位置之前的最后一个边界。
+        // 没有安全边界时从文本开头开始，例如很长的区域指示符序列。
+        size_t end = *cur;
+        size_t result = findSafe(text, end, is_safe);
+        if (result == BoundaryBitmap::npos) {
+            result = 0;
+        }
+        walker(text.data(), text.length(), result, [end, &result](size_t pos) {
+            if (pos >= end) {
+                return false;
             }
+            result = pos;
             return true;
-        }
+        });
 
-        ++cur_;
+        *prev = *cur;
+        *cur = result;
         return true;
     }
 
-    bool WordBreaker::prev() {
-        if (cur_ == 0) {
+}
+
+namespace ukive {
+
+    // ===== BoundaryBitmap
+    BoundaryBitmap::BoundaryBitmap()
+        : length_(0) {}
+
+    void BoundaryBitmap::reset(size_t length) {
+        length_ = length;
+        bits_.assign(length / 64 + 1, 0);
+    }
+
+    void BoundaryBitmap::set(size_t pos) {
+        if (pos <= length_) {
+            bits_[pos / 64] |= uint64_t(1) << (pos % 64);
+        }
+    }
+
+    bool BoundaryBitmap::test(size_t pos) const {
+        if (pos > length_) {
             return false;
         }
+        return (bits_[pos / 64] >> (pos % 64)) & 1;
+    }
 
-        prev_ = cur_;
-        --cur_;
+    size_t BoundaryBitmap::next(size_t pos) const {
+        ++pos;
+        if (pos > length_) {
+            return npos;
+        }
 
-        char16_t ch = text_->at(cur_);
-        if (IS_END_SURROGATES(ch)) {
-            if (cur_ == 0) {
-                return true;
+        size_t index = pos / 64;
+        uint64_t word = bits_[index] & (~uint64_t(0) << (pos % 64));
+        while (word == 0) {
+            ++index;
+            if (index >= bits_.size()) {
+                return npos;
             }
+            word = bits_[index];
+        }
 
-            ch = text_->at(cur_ - 1);
-            if (IS_START_SURROGATES(ch)) {
-                --cur_;
-                return true;
-            }
-            return true;
+        size_t bit = 0;
+        while (!(word & 1)) {
+            word >>= 1;
+            ++bit;
         }
+        return index * 64 + bit;
+    }
 
-        if (ch == u'\n') {
-            if (cur_ == 0) {
-                return true;
-            }
+    size_t BoundaryBitmap::prev(size_t pos) const {
+        if (pos == 0) {
+            return npos;
+        }
+        --pos;
+        if (pos > length_) {
+            pos = length_;
+        }
 
-            ch = text_->at(cur_ - 1);
-            if (ch == u'\r') {
-                --cur_;
-                return true;
+        size_t index = pos / 64;
+        size_t shift = 63 - pos % 64;
+        uint64_t word = (bits_[index] << shift) >> shift;
+        while (word == 0) {
+            if (index == 0) {
+                return npos;
             }
-            return true;
+            --index;
+            word = bits_[index];
         }
 
-        return true;
+        size_t bit = 63;
+        while (!(word >> 63)) {
+            word <<= 1;
+            --bit;
+        }
+        return index * 64 + bit;
+    }
+
+
+    // ===== TextBreaker
+    TextBreaker::TextBreaker(const std::u16string* text)
+        : cur_(0), prev_(0), text_(text) {
+    }
+
+    void TextBreaker::setCur(size_t cur_pos) {
+        if (cur_pos > text_->length()) {
+            cur_pos = text_->length();
+        }
+        cur_ = cur_pos;
+        prev_ = cur_;
+    }
+
+
+    // ===== CharacterBreaker
+    CharacterBreaker::CharacterBreaker(const std::u16string* text)
+        : TextBreaker(text) {}
+
+    // static
+    void CharacterBreaker::fill(const std::u16string_view& text, BoundaryBitmap* out) {
+        fillBoundaries(text, out, GraphemeWalker());
+    }
+
+    // static
+    size_t CharacterBreaker::findSafeBoundary(const std::u16string_view& text, size_t pos) {
+        return findSafe(text, pos, isGraphemeSafe);
+    }
+
+    bool CharacterBreaker::next() {
+        return moveNext(*text_, &cur_, &prev_, GraphemeWalker());
+    }
+
+    bool CharacterBreaker::prev() {
+        return movePrev(*text_, &cur_, &prev_, GraphemeWalker(), isGraphemeSafe);
+    }
+
+
+    // ===== WordBreaker
+    WordBreaker::WordBreaker(const std::u16string* text)
+        : TextBreaker(text) {
+    }
+
+    // static
+    void WordBreaker::fill(const std::u16string_view& text, BoundaryBitmap* out) {
+        fillBoundaries(text, out, WordWalker());
+    }
+
+    // static
+    size_t WordBreaker::findSafeBoundary(const std::u16string_view& text, size_t pos) {
+        return findSafe(text, pos, isWordSafe);
+    }
+
+    bool WordBreaker::next() {
+        return moveNext(*text_, &cur_, &prev_, WordWalker());
+    }
+
+    bool WordBreaker::prev() {
+        return movePrev(*text_, &cur_, &prev_, WordWalker(), isWordSafe);
     }
 
 
@@ -195,80 +611,77 @@ namespace ukive {
         : TextBreaker(text) {
     }
 
-    bool ParagraphBreaker::next() {
-        if (cur_ >= text_->length()) {
-            return false;
-        }
+    // static
+    bool ParagraphBreaker::isSeparator(char16_t ch) {
+        return ch == u'\n' || ch == u'\r' || ch == 0x85 || ch == 0x2029;
+    }
 
-        prev_ = cur_;
-        char16_t ch = text_->at(cur_);
-        if (IS_START_SURROGATES(ch)) {
-            ++cur_;
-            if (cur_ >= text_->length()) {
-                return true;
+    // static
+    void ParagraphBreaker::fill(const std::u16string_view& text, BoundaryBitmap* out) {
+        out->reset(text.length());
+        out->set(0);
+
+        auto s = text.data();
+        size_t len = text.length();
+        for (size_t i = 0; i < len; ++i) {
+            char16_t ch = s[i];
+            if (!isSeparator(ch)) {
+                continue;
             }
 
-            ch = text_->at(cur_);
-            if (IS_END_SURROGATES(ch)) {
-                ++cur_;
-                return true;
+            // \r\n 视为一个分隔符
+            if (ch == u'\r' && i + 1 < len && s[i + 1] == u'\n') {
+                ++i;
             }
-            return true;
+            out->set(i + 1);
+        }
+        out->set(len);
+    }
+
+    bool ParagraphBreaker::next() {
+        auto s = text_->data();
+        size_t len = text_->length();
+        if (cur_ >= len) {
+            return false;
         }
 
-        if (ch == u'\r') {
+        prev_ = cur_;
+        while (cur_ < len) {
+            char16_t ch = s[cur_];
             ++cur_;
-            if (cur_ >= text_->length()) {
-                return true;
+            if (!isSeparator(ch)) {
+                continue;
             }
 
-            ch = text_->at(cur_);
-            if (ch == u'\n') {
+            // \r\n 视为一个分隔符
+            if (ch == u'\r' && cur_ < len && s[cur_] == u'\n') {
                 ++cur_;
-                return true;
             }
-            return true;
+            break;
         }
-
-        ++cur_;
         return true;
     }
 
     bool ParagraphBreaker::prev() {
+        auto s = text_->data();
         if (cur_ == 0) {
             return false;
         }
 
         prev_ = cur_;
-        --cur_;
 
-        char16_t ch = text_->at(cur_);
-        if (IS_END_SURROGATES(ch)) {
-            if (cur_ == 0) {
-                return true;
-            }
-
-            ch = text_->at(cur_ - 1);
-            if (IS_START_SURROGATES(ch)) {
+        // 跳过上一段末尾的分隔符
+        char16_t ch = s[cur_ - 1];
+        if (isSeparator(ch)) {
+            --cur_;
+            if (ch == u'\n' && cur_ > 0 && s[cur_ - 1] == u'\r') {
                 --cur_;
-                return true;
             }
-            return true;
         }
 
-        if (ch == u'\n') {
-            if (cur_ == 0) {
-                return true;
-            }
-
-            ch = text_->at(cur_ - 1);
-            if (ch == u'\r') {
-                --cur_;
-                return true;
-            }
-            return true;
+        while (cur_ > 0 && !isSeparator(s[cur_ - 1])) {
+            --cur_;
         }
-
         return true;
     }
 
@@ -7,11 +7,49 @@
 #ifndef UKIVE_TEXT_TEXT_BREAKER_H_
 #define UKIVE_TEXT_TEXT_BREAKER_H_
 
+#include <cstdint>
 #include <string>
+#include <string_view>
+#include <vector>
 
 
 namespace ukive {
 
+    /**
+     * 文本边界的位图。
+     * 长度为 n 的文本共有 n + 1 个位置，第 i 位表示位置 i 是否为边界。
+     */
+    class BoundaryBitmap {
+    public:
+        BoundaryBitmap();
+
+        /**
+         * 清除所有边界，并设置文本长度。
+         */
+        void reset(size_t length);
+        void set(size_t pos);
+        bool test(size_t pos) const;
+
+        /**
+         * 查找 pos 之后的第一个边界，找不到时返回 npos。
+         */
+        size_t next(size_t pos) const;
+
+        /**
+         * 查找 pos 之前的最后一个边界，找不到时返回 npos。
+         */
+        size_t prev(size_t pos) const;
+
+        size_t length() const { return length_; }
+
+        static constexpr size_t npos = size_t(-1);
+
+    private:
+        std::vector<uint64_t> bits_;
+        size_t length_;
+    };
+
+
     class TextBreaker {
     public:
         explicit TextBreaker(const std::u16string* text);
@@ -31,32 +69,72 @@ namespace ukive {
     };
 
 
+    /**
+     * 按 UAX #29 中的扩展字素簇规则切分文本。
+     */
     class CharacterBreaker : public TextBreaker {
     public:
         explicit CharacterBreaker(const std::u16string* text);
 
+        /**
+         * 一次性计算 text 中所有的边界，text 的开头视为边界。
+         */
+        static void fill(const std::u16string_view& text, BoundaryBitmap* out);
+
+        /**
+         * 查找 pos 之前（不含 pos）最近的安全边界，找不到时返回 BoundaryBitmap::npos。
+         * 安全边界一定是边界，且之后的边界与它之前的文本无关，可以从这里开始计算。
+         * text 的开头不视为安全边界，因此 text 可以是从长文本中截取的一段。
+         */
+        static size_t findSafeBoundary(const std::u16string_view& text, size_t pos);
+
         bool next() override;
         bool prev() override;
     };
 
 
+    /**
+     * 按 UAX #29 中的单词边界规则切分文本。
+     * 没有使用词典，连续的表意文字之间均为边界。
+     */
     class WordBreaker : public TextBreaker {
     public:
         explicit WordBreaker(const std::u16string* text);
 
+        /**
+         * 一次性计算 text 中所有的边界，text 的开头视为边界。
+         */
+        static void fill(const std::u16string_view& text, BoundaryBitmap* out);
+
+        /**
+         * 按单词规则查找 pos 之前最近的安全边界，含义同 CharacterBreaker::findSafeBoundary()。
+         */
+        static size_t findSafeBoundary(const std::u16string_view& text, size_t pos);
+
         bool next() override;
         bool prev() override;
     };
 
 
+    /**
+     * 按段落分隔符（\n、\r、\r\n、U+0085 和 U+2029）切分文本。
+     * 每次移动后，[getPrev(), getCur()) 为一个包含末尾分隔符的段落。
+     */
     class ParagraphBreaker : public TextBreaker {
     public:
         explicit ParagraphBreaker(const std::u16string* text);
 
+        static bool isSeparator(char16_t ch);
+
+        /**
+         * 一次性计算 text 中所有段落的起始位置。
+         */
+        static void fill(const std::u16string_view& text, BoundaryBitmap* out);
+
         bool next() override;
         bool prev() override;
     };
 
 }
 
-#endif  // UKIVE_TEXT_TEXT_BREAKER_H_
\ No newline at end of file
+#endif  // UKIVE_TEXT_TEXT_BREAKER_H_
@@ -0,0 +1,108 @@
+// Copyright (c) 2016 ucclkp <ucclkp@gmail.com>.
+// This file is part of ukive project.
+//
+// This program is licensed under GPLv3 license that can be
+// found in the LICENSE file.
+
+#include "ukive/text/text_breaker_benchmark.h"
+
+#include <functional>
+#include <initializer_list>
+#include <sstream>
+#include <string>
+
+#include "utils/log.h"
+#include "utils/time_utils.h"
+
+#include "ukive/text/text_breaker.h"
+
+
+namespace {
+
+    using ukive::BoundaryBitmap;
+
+    // 每份语料的 UTF-16 码元数，即 16 MB
+    const size_t kCorpusUnits = 8 * 1024 * 1024;
+    const int kRounds = 5;
+
+    const char16_t kLatin[] =
+        u"The quick brown fox can't jump over 3.14 lazy dogs, isn't it? "
+        u"E-mail: someone@example.com, version 1,024.5 (beta)\n";
+
+    const char16_t kCJK[] =
+        u"今天天气很好，我们去公园散步吧。東京は晴れです。"
+        u"ひらがなとカタカナ、한국어 문장도 있습니다.\n";
+
+    // 肤色修饰、ZWJ 序列、国旗、变体选择符和组合附加符号
+    const char16_t kEmoji[] =
+        u"\U0001F44D\U0001F3FD \U0001F469\u200D\U0001F469\u200D\U0001F467 "
+        u"\U0001F1E8\U0001F1F3\U0001F1EF\U0001F1F5 \u2764\uFE0F "
+        u"e\u0301a\u0308 \U0001F3F3\uFE0F\u200D\U0001F308\n";
+
+    std::u16string makeCorpus(std::initializer_list<const char16_t*> parts) {
+        std::u16string corpus;
+        corpus.reserve(kCorpusUnits + 256);
+        while (corpus.size() < kCorpusUnits) {
+            for (auto p : parts) {
+                corpus.append(p);
+            }
+        }
+        corpus.resize(kCorpusUnits);
+        return corpus;
+    }
+
+    /**
+     * 对 text 执行 kRounds 次 fill，返回 MB/s。
+     */
+    double measure(
+        const std::u16string& text,
+        const std::function<void(const std::u16string_view&, BoundaryBitmap*)>& fill)
+    {
+        BoundaryBitmap bitmap;
+        // 预热
+        fill(text, &bitmap);
+
+        auto start = utl::TimeUtils::upTimeNanos();
+        for (int i = 0; i < kRounds; ++i) {
+            fill(text, &bitmap);
+        }
+        auto elapsed = utl::TimeUtils::upTimeNanos() - start;
+        if (elapsed == 0) {
+            return 0;
+        }
+        double bytes = double(text.size() * sizeof(char16_t)) * kRounds;
+        return bytes * 1000.0 / double(elapsed);
+    }
+
+}
+
+namespace ukive {
+
+    void runTextBreakerBenchmark() {
+        struct Corpus {
+            const char* name;
+            std::u16string text;
+        };
+        Corpus corpora[] = {
+            { "latin", makeCorpus({ kLatin }) },
+            { "cjk",   makeCorpus({ kCJK }) },
+            { "emoji", makeCorpus({ kEmoji }) },
+            { "mixed", makeCorpus({ kLatin, kCJK, kEmoji }) },
+        };
+
+        LOG(Log::INFO) << "TextBreaker benchmark, fill() over "
+            << (kCorpusUnits * sizeof(char16_t) >> 20) << " MB of UTF-16, MB/s:";
+        for (const auto& c : corpora) {
+            double grapheme = measure(c.text, CharacterBreaker::fill);
+            double word = measure(c.text, WordBreaker::fill);
+            double paragraph = measure(c.text, ParagraphBreaker::fill);
+
+            std::ostringstream line;
+            line << "  " << c.name << ": grapheme " << int(grapheme)
+                << ", word " << int(word)
+                << ", paragraph " << int(paragraph);
+            LOG(Log::INFO) << line.str();
+        }
+    }
+
+}
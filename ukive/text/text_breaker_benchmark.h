@@ -0,0 +1,21 @@
+// Copyright (c) 2016 ucclkp <ucclkp@gmail.com>.
+// This file is part of ukive project.
+//
+// This program is licensed under GPLv3 license that can be
+// found in the LICENSE file.
+
+#ifndef UKIVE_TEXT_TEXT_BREAKER_BENCHMARK_H_
+#define UKIVE_TEXT_TEXT_BREAKER_BENCHMARK_H_
+
+
+namespace ukive {
+
+    /**
+     * 在拉丁文、中日韩文、emoji 和混合语料上测量字素、单词和段落切分的 fill() 吞吐量，
+     * 以 UTF-16 文本的字节数计算 MB/s，结果写入日志。
+     */
+    void runTextBreakerBenchmark();
+
+}
+
+#endif  // UKIVE_TEXT_TEXT_BREAKER_BENCHMARK_H_
@@ -117,9 +117,19 @@ namespace ukive {
             }
             break;
 
-        case Keyboard::KEY_Z:  //z: undo.
+        case Keyboard::KEY_Z:  //z: undo, shift+z: redo.
             if (can_edit) {
+                if (Keyboard::isKeyPressed(Keyboard::KEY_SHIFT)) {
+                    editable->redo(Editable::Reason::USER_INPUT);
+                } else {
+                    editable->undo(Editable::Reason::USER_INPUT);
+                }
+            }
+            break;
 
+        case Keyboard::KEY_Y:  //y: redo.
+            if (can_edit) {
+                editable->redo(Editable::Reason::USER_INPUT);
             }
             break;
 
@@ -0,0 +1,191 @@
+// Copyright (c) 2016 ucclkp <ucclkp@gmail.com>.
+// This file is part of ukive project.
+//
+// This program is licensed under GPLv3 license that can be
+// found in the LICENSE file.
+
+#include "ukive/text/text_search.h"
+
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#include "ukive/system/cpu_features.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define UKIVE_TEXT_SEARCH_X86
+#endif
+
+#ifdef UKIVE_TEXT_SEARCH_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define TARGET_SSE2
+#define TARGET_AVX2
+#else
+#define TARGET_SSE2  __attribute__((target("sse2")))
+#define TARGET_AVX2  __attribute__((target("avx2")))
+#endif
+#endif
+
+
+namespace {
+
+    using ukive::TextSearch;
+
+    size_t findScalar(
+        const char16_t* text, size_t length, const char16_t* s, size_t s_length)
+    {
+        auto found = std::u16string_view(text, length).find(std::u16string_view(s, s_length));
+        return found == std::u16string_view::npos ? TextSearch::npos : found;
+    }
+
+    const TextSearch kScalarSearch = {
+        TextSearch::Level::SCALAR,
+        findScalar,
+    };
+
+#ifdef UKIVE_TEXT_SEARCH_X86
+
+    unsigned int countTrailingZeros(uint32_t val) {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward(&index, val);
+        return index;
+#else
+        return __builtin_ctz(val);
+#endif
+    }
+
+    /**
+     * 检查 mask 中的候选位置。
+     * mask 由 movemask 得到，每个字符占两位；首尾字符已经相同，只需比较中间部分。
+     */
+    size_t verifyCandidates(
+        uint32_t mask, const char16_t* text, const char16_t* s, size_t s_length)
+    {
+        while (mask) {
+            auto i = countTrailingZeros(mask) / 2;
+            if (s_length <= 2 ||
+                std::memcmp(text + i + 1, s + 1, (s_length - 2) * sizeof(char16_t)) == 0)
+            {
+                return i;
+            }
+            mask &= ~(3u << (i * 2));
+        }
+        return TextSearch::npos;
+    }
+
+    TARGET_SSE2 size_t findSSE2(
+        const char16_t* text, size_t length, const char16_t* s, size_t s_length)
+    {
+        if (s_length == 0) {
+            return 0;
+        }
+        if (s_length > length) {
+            return TextSearch::npos;
+        }
+
+        auto first = _mm_set1_epi16(short(s[0]));
+        auto last = _mm_set1_epi16(short(s[s_length - 1]));
+
+        // 可能的起始位置为 [0, count)
+        size_t count = length - s_length + 1;
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            auto bf = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + i));
+            auto bl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + i + s_length - 1));
+            auto eq = _mm_and_si128(_mm_cmpeq_epi16(first, bf), _mm_cmpeq_epi16(last, bl));
+            auto mask = uint32_t(_mm_movemask_epi8(eq));
+            if (mask) {
+                auto found = verifyCandidates(mask, text + i, s, s_length);
+                if (found != TextSearch::npos) {
+                    return i + found;
+                }
+            }
+        }
+
+        auto found = findScalar(text + i, length - i, s, s_length);
+        return found == TextSearch::npos ? found : i + found;
+    }
+
+    const TextSearch kSSE2Search = {
+        TextSearch::Level::SSE2,
+        findSSE2,
+    };
+
+    TARGET_AVX2 size_t findAVX2(
+        const char16_t* text, size_t length, const char16_t* s, size_t s_length)
+    {
+        if (s_length == 0) {
+            return 0;
+        }
+        if (s_length > length) {
+            return TextSearch::npos;
+        }
+
+        auto first = _mm256_set1_epi16(short(s[0]));
+        auto last = _mm256_set1_epi16(short(s[s_length - 1]));
+
+        size_t count = length - s_length + 1;
+        size_t i = 0;
+        for (; i + 16 <= count; i += 16) {
+            auto bf = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + i));
+            auto bl = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + i + s_length - 1));
+            auto eq = _mm256_and_si256(
+                _mm256_cmpeq_epi16(first, bf), _mm256_cmpeq_epi16(last, bl));
+            auto mask = uint32_t(_mm256_movemask_epi8(eq));
+            if (mask) {
+                auto found = verifyCandidates(mask, text + i, s, s_length);
+                if (found != TextSearch::npos) {
+                    return i + found;
+                }
+            }
+        }
+
+        auto found = findSSE2(text + i, length - i, s, s_length);
+        return found == TextSearch::npos ? found : i + found;
+    }
+
+    const TextSearch kAVX2Search = {
+        TextSearch::Level::AVX2,
+        findAVX2,
+    };
+
+#endif  // UKIVE_TEXT_SEARCH_X86
+
+}
+
+namespace ukive {
+
+    // static
+    const TextSearch& TextSearch::get() {
+        static const TextSearch* search = []() {
+            if (auto s = get(Level::AVX2)) {
+                return s;
+            }
+            if (auto s = get(Level::SSE2)) {
+                return s;
+            }
+            return &kScalarSearch;
+        }();
+        return *search;
+    }
+
+    // static
+    const TextSearch* TextSearch::get(Level level) {
+        switch (level) {
+#ifdef UKIVE_TEXT_SEARCH_X86
+        case Level::AVX2:
+            return hasAVX2() ? &kAVX2Search : nullptr;
+        case Level::SSE2:
+            return hasSSE2() ? &kSSE2Search : nullptr;
+#endif
+        case Level::SCALAR:
+            return &kScalarSearch;
+        default:
+            return nullptr;
+        }
+    }
+
+}
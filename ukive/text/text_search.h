@@ -0,0 +1,50 @@
+// Copyright (c) 2016 ucclkp <ucclkp@gmail.com>.
+// This file is part of ukive project.
+//
+// This program is licensed under GPLv3 license that can be
+// found in the LICENSE file.
+
+#ifndef UKIVE_TEXT_TEXT_SEARCH_H_
+#define UKIVE_TEXT_TEXT_SEARCH_H_
+
+#include <cstddef>
+
+
+namespace ukive {
+
+    /**
+     * UTF-16 文本的子串查找函数。
+     * 同时比较 s 的首字符和末字符，每次筛选 8 个（SSE2）或 16 个（AVX2）位置，
+     * 只在两者都相同的位置比较整个 s。
+     * 根据运行时检测到的 CPU 特性选择 AVX2、SSE2 或标量实现。
+     */
+    struct TextSearch {
+        enum class Level {
+            SCALAR,
+            SSE2,
+            AVX2,
+        };
+
+        /**
+         * 获取当前 CPU 支持的最快实现。
+         */
+        static const TextSearch& get();
+
+        /**
+         * 获取指定级别的实现。
+         * 若 CPU 不支持该级别，返回 nullptr。
+         */
+        static const TextSearch* get(Level level);
+
+        static constexpr size_t npos = size_t(-1);
+
+        Level level;
+
+        // 在 text 中查找 s 首次出现的位置，找不到时返回 npos
+        size_t (*find)(
+            const char16_t* text, size_t length, const char16_t* s, size_t s_length);
+    };
+
+}
+
+#endif  // UKIVE_TEXT_TEXT_SEARCH_H_
@@ -0,0 +1,106 @@
+// Copyright (c) 2016 ucclkp <ucclkp@gmail.com>.
+// This file is part of ukive project.
+//
+// This program is licensed under GPLv3 license that can be
+// found in the LICENSE file.
+
+#ifndef UKIVE_TEXT_UNICODE_BREAK_PROPS_H_
+#define UKIVE_TEXT_UNICODE_BREAK_PROPS_H_
+
+#include <cstdint>
+
+
+namespace ukive {
+
+    /**
+     * UAX #29 中的 Grapheme_Cluster_Break 属性。
+     */
+    enum GraphemeBreak : uint8_t {
+        GB_OTHER = 0,
+        GB_CR,
+        GB_LF,
+        GB_CONTROL,
+        GB_EXTEND,
+        GB_ZWJ,
+        GB_REGIONAL_INDICATOR,
+        GB_PREPEND,
+        GB_SPACING_MARK,
+        GB_L,
+        GB_V,
+        GB_T,
+        GB_LV,
+        GB_LVT,
+        GB_COUNT,
+    };
+
+    /**
+     * UAX #29 中的 Word_Break 属性。
+     */
+    enum WordBreak : uint8_t {
+        WB_OTHER = 0,
+        WB_CR,
+        WB_LF,
+        WB_NEWLINE,
+        WB_EXTEND,
+        WB_ZWJ,
+        WB_REGIONAL_INDICATOR,
+        WB_FORMAT,
+        WB_KATAKANA,
+        WB_HEBREW_LETTER,
+        WB_ALETTER,
+        WB_SINGLE_QUOTE,
+        WB_DOUBLE_QUOTE,
+        WB_MID_NUM_LET,
+        WB_MID_LETTER,
+        WB_MID_NUM,
+        WB_NUMERIC,
+        WB_EXTEND_NUM_LET,
+        WB_WSEG_SPACE,
+        WB_COUNT,
+    };
+
+    /**
+     * 码点的属性按两级表保存：
+     * kBreakPropIndex 以码点的高位查找 32 个码点为一组的块，
+     * kBreakPropBlocks 中保存每个码点的属性组合下标，
+     * kBreakPropClasses 为属性组合，位 0-3 为 GraphemeBreak，
+     * 位 4 为 Extended_Pictographic，位 5-9 为 WordBreak。
+     * 表只覆盖 U+0000-U+1FFFF 和 U+E0000-U+E0FFF，其余码点的属性均为默认值。
+     * 表的内容在 unicode_break_props.cpp 中，由 Unicode 字符数据库生成。
+     */
+    extern const uint16_t kBreakPropClasses[32];
+    extern const uint16_t kBreakPropIndex[4224];
+    extern const uint8_t kBreakPropBlocks[14208];
+
+    const uint32_t kBreakPropShift = 5;
+
+    inline uint16_t getBreakProps(uint32_t cp) {
+        uint32_t i;
+        if (cp < 0x20000) {
+            i = cp;
+        } else if (cp >= 0xE0000 && cp < 0xE1000) {
+            i = cp - 0xE0000 + 0x20000;
+        } else {
+            return kBreakPropClasses[0];
+        }
+
+        uint32_t block = kBreakPropIndex[i >> kBreakPropShift];
+        uint32_t offset = i & ((1u << kBreakPropShift) - 1);
+        return kBreakPropClasses[kBreakPropBlocks[(block << kBreakPropShift) + offset]];
+    }
+
+    inline GraphemeBreak getGraphemeBreak(uint16_t props) {
+        return GraphemeBreak(props & 0xF);
+    }
+
+    inline bool isExtendedPictographic(uint16_t props) {
+        return (props & 0x10) != 0;
+    }
+
+    inline WordBreak getWordBreak(uint16_t props) {
+        return WordBreak(props >> 5);
+    }
+
+}
+
+#endif  // UKIVE_TEXT_UNICODE_BREAK_PROPS_H_
@@ -245,37 +245,24 @@ namespace win {
     }
 
     void TsfInputConnection::getText(LONG start, LONG end, ULONG maxLength, WCHAR* text, ULONG* length) {
-        auto& u16_text = client_->getTICEditable()->getString();
+        auto& storage = client_->getTICEditable()->getStorage();
         auto u_start = utl::num_cast<ULONG>(start);
 
+        ULONG len;
         if (end == -1) {
-            if (u_start + maxLength <= u16_text.length()) {
-                for (ULONG i = 0; i < maxLength; ++i) {
-                    text[i] = u16_text[i + u_start];
-                }
-                *length = maxLength;
+            if (u_start + maxLength <= storage.length()) {
+                len = maxLength;
             } else {
-                auto len = utl::num_cast<ULONG>(u16_text.length() - start);
-                for (ULONG i = 0; i < len; ++i) {
-                    text[i] = u16_text[i + u_start];
-                }
-                *length = len;
+                len = utl::num_cast<ULONG>(storage.length() - start);
             }
-            return;
-        }
-
-        auto cr = utl::num_cast<ULONG>(std::abs(end - start));
-        if (cr >= maxLength) {
-            for (ULONG i = 0; i < maxLength; ++i) {
-                text[i] = u16_text[i + u_start];
-            }
-            *length = maxLength;
         } else {
-            for (ULONG i = 0; i < cr; ++i) {
-                text[i] = u16_text[i + u_start];
-            }
-            *length = cr;
+            auto cr = utl::num_cast<ULONG>(std::abs(end - start));
+            len = (std::min)(cr, maxLength);
         }
+
+        static_assert(sizeof(WCHAR) == sizeof(char16_t), "WCHAR must be 16 bits");
+        storage.copy(u_start, len, reinterpret_cast<char16_t*>(text));
+        *length = len;
     }
 
     void TsfInputConnection::setText(LONG start, LONG end, const WCHAR* text, ULONG length) {
@@ -25,10 +25,10 @@ namespace ukive {
     Button::Button(Context c, AttrsRef attrs)
         : TextView(c, attrs)
     {
-        if (attrs.find(necro::kAttrTextViewText) == attrs.end()) {
+        if (!attrs.find(necro::kAttrTextViewText)) {
             setText(u"Button");
         }
-        if (attrs.find(necro::kAttrTextViewTextSize) == attrs.end()) {
+        if (!attrs.find(necro::kAttrTextViewTextSize)) {
             setTextSize(c.dp2pxi(13));
         }
 
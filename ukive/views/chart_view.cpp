@@ -8,19 +8,60 @@
 
 #include <algorithm>
 #include <cmath>
+#include <limits>
+
+#include "utils/log.h"
 
 #include "ukive/graphics/canvas.h"
+#include "ukive/graphics/path.h"
 #include "ukive/graphics/point.hpp"
 #include "ukive/window/window.h"
 
 
+namespace {
+
+    /**
+     * 将 seq 加入单调队列。
+     * 队列中的值按 cmp 有序，队首即为窗口中的最值。
+     */
+    template <typename Get, typename Cmp>
+    void pushMono(std::deque<uint64_t>* q, uint64_t seq, Get&& get, Cmp&& cmp) {
+        auto val = get(seq);
+        while (!q->empty() && !cmp(get(q->back()), val)) {
+            q->pop_back();
+        }
+        q->push_back(seq);
+    }
+
+    void popMono(std::deque<uint64_t>* q, uint64_t seq) {
+        if (!q->empty() && q->front() == seq) {
+            q->pop_front();
+        }
+    }
+
+    // 一个像素列中的数据点
+    struct Column {
+        int col;
+        ukive::PointF first;
+        ukive::PointF last;
+        ukive::PointF min;
+        ukive::PointF max;
+        size_t min_order;
+        size_t max_order;
+    };
+
+}
+
 namespace ukive {
 
     ChartView::ChartView(Context c)
         : ChartView(c, {}) {}
 
     ChartView::ChartView(Context c, AttrsRef attrs)
-        : View(c, attrs) {}
+        : View(c, attrs)
+    {
+        resetExtents();
+    }
 
     Size ChartView::onDetermineSize(const SizeInfo& info) {
         return getPreferredSize(info, 0, 0);
@@ -37,15 +78,9 @@ namespace ukive {
             return;
         }
 
-        double left = (std::numeric_limits<double>::max)();
-        double right = std::numeric_limits<double>::lowest();
-        double top = (std::numeric_limits<double>::max)();
-        double bottom = std::numeric_limits<double>::lowest();
-        for (const auto& d : data_) {
-            left = (std::min)(left, d.x);
-            right = (std::max)(right, d.x);
-            top = (std::min)(top, d.y);
-            bottom = (std::max)(bottom, d.y);
+        double left, top, right, bottom;
+        if (!getExtents(&left, &top, &right, &bottom)) {
+            return;
         }
 
         double dw = right - left;
@@ -54,41 +89,294 @@ namespace ukive {
             return;
         }
 
-        Point prev{};
-        bool has_prev = false;
-        for (const auto& d : data_) {
-            int vx = int(node_radius + width / dw * (d.x - left));
-            int vy = int(node_radius + height / dh * (d.y - top));
-            vy = bounds.height() - vy;
+        if (is_path_dirty_ || path_bounds_ != bounds) {
+            buildLinePath(bounds, node_radius, left, top, dw, dh);
+            buildMarkers(bounds, node_radius, left, top, dw, dh);
+            path_bounds_ = bounds;
+            is_path_dirty_ = false;
+        }
 
-            if (d.draw_point) {
-                canvas->fillCircle(
-                    PointF(Point{ vx, vy }), float(node_radius), Color::Blue300);
-            }
-            if (has_prev && !d.single_point) {
-                canvas->drawLine(
-                    PointF(prev),
-                    PointF(Point{ vx, vy }),
-                    getContext().dp2px(1.5f), Color::Blue300);
-            }
+        if (line_path_) {
+            canvas->drawPath(
+                line_path_.get(), getContext().dp2px(1.5f), Color::Blue300);
+        }
 
-            if (!d.single_point) {
-                prev.set(vx, vy);
-                has_prev = true;
-            }
+        for (const auto& m : markers_) {
+            canvas->fillCircle(PointF(m), float(node_radius), Color::Blue300);
         }
     }
 
     void ChartView::addData(
         double x, double y, bool draw_point, bool single_point)
     {
-        data_.push_back({ x, y, draw_point, single_point });
+        Node node{ x, y, draw_point, single_point };
+        if (capacity_ > 0 && data_.size() == capacity_) {
+            popExtents(total_count_ - capacity_);
+            data_[head_] = node;
+            head_ = (head_ + 1) % capacity_;
+        } else {
+            data_.push_back(node);
+        }
+
+        ++total_count_;
+        pushExtents(total_count_ - 1);
+
+        is_path_dirty_ = true;
         requestDraw();
     }
 
     void ChartView::clear() {
         data_.clear();
+        head_ = 0;
+        total_count_ = 0;
+        resetExtents();
+
+        is_path_dirty_ = true;
         requestDraw();
     }
 
+    void ChartView::setCapacity(size_t capacity) {
+        if (capacity == capacity_) {
+            return;
+        }
+
+        // 按时间顺序取出要保留的数据点后重新添加
+        std::vector<Node> nodes;
+        size_t count = data_.size();
+        size_t start = (capacity > 0 && count > capacity) ? count - capacity : 0;
+        nodes.reserve(count - start);
+        for (size_t i = start; i < count; ++i) {
+            nodes.push_back(getDataAt(i));
+        }
+
+        data_.clear();
+        head_ = 0;
+        total_count_ = 0;
+        resetExtents();
+
+        capacity_ = capacity;
+        if (capacity_ > 0) {
+            data_.reserve(capacity_);
+        }
+        for (const auto& n : nodes) {
+            addData(n.x, n.y, n.draw_point, n.single_point);
+        }
+
+        is_path_dirty_ = true;
+        requestDraw();
+    }
+
+    const ChartView::Node& ChartView::getDataAt(size_t index) const {
+        ubassert(index < data_.size());
+        return data_[(head_ + index) % data_.size()];
+    }
+
+    void ChartView::pushExtents(uint64_t seq) {
+        auto& node = getNodeBySeq(seq);
+        if (capacity_ == 0) {
+            min_x_ = (std::min)(min_x_, node.x);
+            max_x_ = (std::max)(max_x_, node.x);
+            min_y_ = (std::min)(min_y_, node.y);
+            max_y_ = (std::max)(max_y_, node.y);
+            return;
+        }
+
+        auto get_x = [this](uint64_t s) { return getNodeBySeq(s).x; };
+        auto get_y = [this](uint64_t s) { return getNodeBySeq(s).y; };
+        pushMono(&min_x_q_, seq, get_x, std::less<double>());
+        pushMono(&max_x_q_, seq, get_x, std::greater<double>());
+        pushMono(&min_y_q_, seq, get_y, std::less<double>());
+        pushMono(&max_y_q_, seq, get_y, std::greater<double>());
+    }
+
+    void ChartView::popExtents(uint64_t seq) {
+        popMono(&min_x_q_, seq);
+        popMono(&max_x_q_, seq);
+        popMono(&min_y_q_, seq);
+        popMono(&max_y_q_, seq);
+    }
+
+    void ChartView::resetExtents() {
+        min_x_ = (std::numeric_limits<double>::max)();
+        max_x_ = std::numeric_limits<double>::lowest();
+        min_y_ = (std::numeric_limits<double>::max)();
+        max_y_ = std::numeric_limits<double>::lowest();
+
+        min_x_q_.clear();
+        max_x_q_.clear();
+        min_y_q_.clear();
+        max_y_q_.clear();
+    }
+
+    const ChartView::Node& ChartView::getNodeBySeq(uint64_t seq) const {
+        uint64_t oldest = total_count_ - data_.size();
+        return getDataAt(size_t(seq - oldest));
+    }
+
+    bool ChartView::getExtents(
+        double* left, double* top, double* right, double* bottom) const
+    {
+        if (data_.empty()) {
+            return false;
+        }
+
+        if (capacity_ == 0) {
+            *left = min_x_;
+            *right = max_x_;
+            *top = min_y_;
+            *bottom = max_y_;
+        } else {
+            *left = getNodeBySeq(min_x_q_.front()).x;
+            *right = getNodeBySeq(max_x_q_.front()).x;
+            *top = getNodeBySeq(min_y_q_.front()).y;
+            *bottom = getNodeBySeq(max_y_q_.front()).y;
+        }
+        return true;
+    }
+
+    void ChartView::buildLinePath(
+        const Rect& bounds, int node_radius,
+        double left, double top, double dw, double dh)
+    {
+        line_path_.reset();
+
+        double sx = (bounds.width() - node_radius * 2) / dw;
+        double sy = (bounds.height() - node_radius * 2) / dh;
+
+        std::unique_ptr<Path> path(Path::create());
+        if (!path->open()) {
+            return;
+        }
+
+        size_t point_count = 0;
+        PointF prev;
+        auto emit = [&](const PointF& p) {
+            if (point_count == 0) {
+                path->begin(p, false);
+            } else if (p.x() == prev.x() && p.y() == prev.y()) {
+                return;
+            } else {
+                path->addLine(p);
+            }
+            prev = p;
+            ++point_count;
+        };
+
+        // 按顺序输出一列中的首、尾和最值点，以保留该列的形状
+        auto flush = [&](const Column& c) {
+            emit(c.first);
+            if (c.min_order < c.max_order) {
+                emit(c.min);
+                emit(c.max);
+            } else {
+                emit(c.max);
+                emit(c.min);
+            }
+            emit(c.last);
+        };
+
+        Column cur;
+        bool has_col = false;
+        for (size_t i = 0; i < data_.size(); ++i) {
+            auto& d = getDataAt(i);
+            if (d.single_point) {
+                continue;
+            }
+
+            PointF p(
+                float(node_radius + sx * (d.x - left)),
+                float(bounds.height() - (node_radius + sy * (d.y - top))));
+            int col = int(std::floor(p.x()));
+
+            if (has_col && col == cur.col) {
+                cur.last = p;
+                if (p.y() < cur.min.y()) {
+                    cur.min = p;
+                    cur.min_order = i;
+                }
+                if (p.y() > cur.max.y()) {
+                    cur.max = p;
+                    cur.max_order = i;
+                }
+                continue;
+            }
+
+            if (has_col) {
+                flush(cur);
+            }
+            cur.col = col;
+            cur.first = cur.last = cur.min = cur.max = p;
+            cur.min_order = cur.max_order = i;
+            has_col = true;
+        }
+
+        if (has_col) {
+            flush(cur);
+        }
+
+        if (point_count < 2) {
+            path->close();
+            return;
+        }
+
+        path->end(false);
+        if (path->close()) {
+            line_path_ = std::move(path);
+        }
+    }
+
+    void ChartView::buildMarkers(
+        const Rect& bounds, int node_radius,
+        double left, double top, double dw, double dh)
+    {
+        markers_.clear();
+
+        double sx = (bounds.width() - node_radius * 2) / dw;
+        double sy = (bounds.height() - node_radius * 2) / dh;
+
+        // 一个像素列中只有一个数据点时画出该点，
+        // 有多个时只画最高和最低的点，其余的点会被折线和这两个标记覆盖
+        int cur_col = 0;
+        Point min, max;
+        bool has_col = false;
+        auto flush = [&]() {
+            markers_.push_back(min);
+            if (max.y() != min.y()) {
+                markers_.push_back(max);
+            }
+        };
+
+        for (size_t i = 0; i < data_.size(); ++i) {
+            auto& d = getDataAt(i);
+            if (!d.draw_point) {
+                continue;
+            }
+
+            int vx = int(node_radius + sx * (d.x - left));
+            int vy = bounds.height() - int(node_radius + sy * (d.y - top));
+
+            if (has_col && vx == cur_col) {
+                if (vy < min.y()) {
+                    min.set(vx, vy);
+                }
+                if (vy > max.y()) {
+                    max.set(vx, vy);
+                }
+                continue;
+            }
+
+            if (has_col) {
+                flush();
+            }
+            cur_col = vx;
+            min.set(vx, vy);
+            max = min;
+            has_col = true;
+        }
+
+        if (has_col) {
+            flush();
+        }
+    }
+
 }
@@ -7,6 +7,8 @@
 #ifndef UKIVE_VIEWS_CHART_VIEW_H_
 #define UKIVE_VIEWS_CHART_VIEW_H_
 
+#include <deque>
+#include <memory>
 #include <vector>
 
 #include "ukive/views/view.h"
@@ -14,6 +16,14 @@
 
 namespace ukive {
 
+    class Path;
+
+    /**
+     * 折线图。
+     * 设置容量后数据保存在环形缓冲区中，超出容量时丢弃最早的数据点，适合实时数据。
+     * 坐标范围随数据的增删增量维护。绘制时每个像素列只保留首、尾、最小和最大四个点，
+     * 所有线段合并为一条路径绘制。数据点标记同样按像素列抽取，每列最多绘制两个。
+     */
     class ChartView : public View {
     public:
         struct Node {
@@ -31,18 +41,59 @@ namespace ukive {
             bool draw_point = true, bool single_point = false);
         void clear();
 
-        const std::vector<Node>& getData() const {
-            return data_;
-        }
+        /**
+         * 设置最多保存的数据点数量，超出时丢弃最早的数据点。
+         * 为 0 时不限制数量。
+         */
+        void setCapacity(size_t capacity);
+
+        size_t getCapacity() const { return capacity_; }
+        size_t getDataCount() const { return data_.size(); }
+
+        /**
+         * 获取第 index 个数据点，0 为现存最早的数据点。
+         */
+        const Node& getDataAt(size_t index) const;
 
     protected:
         Size onDetermineSize(const SizeInfo& info) override;
         void onDraw(Canvas* canvas) override;
 
     private:
+        void pushExtents(uint64_t seq);
+        void popExtents(uint64_t seq);
+        void resetExtents();
+        const Node& getNodeBySeq(uint64_t seq) const;
+        bool getExtents(double* left, double* top, double* right, double* bottom) const;
+
+        void buildLinePath(
+            const Rect& bounds, int node_radius,
+            double left, double top, double dw, double dh);
+        void buildMarkers(
+            const Rect& bounds, int node_radius,
+            double left, double top, double dw, double dh);
+
         std::vector<Node> data_;
+        size_t capacity_ = 0;
+        // 环形缓冲区中最早的数据点的下标
+        size_t head_ = 0;
+        // 已添加过的数据点总数，用作数据点的序号
+        uint64_t total_count_ = 0;
+
+        // 不限制数量时直接记录最值
+        double min_x_, max_x_, min_y_, max_y_;
+
+        // 限制数量时使用单调队列维护滑动窗口上的最值，队列中保存数据点的序号
+        std::deque<uint64_t> min_x_q_, max_x_q_;
+        std::deque<uint64_t> min_y_q_, max_y_q_;
+
+        bool is_path_dirty_ = true;
+        Rect path_bounds_;
+        std::unique_ptr<Path> line_path_;
+        // 需要绘制标记的数据点的位置，与 line_path_ 一同更新
+        std::vector<Point> markers_;
     };
 
 }
 
-#endif  // UKIVE_VIEWS_CHART_VIEW_H_
\ No newline at end of file
+#endif  // UKIVE_VIEWS_CHART_VIEW_H_
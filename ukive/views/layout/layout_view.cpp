@@ -153,6 +153,7 @@ namespace ukive {
         } else {
             views_.insert(views_.begin() + index, v);
         }
+        invalidateChildIndex();
 
         ubassert(!v->isAttachedToWindow());
         if (isAttachedToWindow() && !v->isAttachedToWindow()) {
@@ -177,6 +178,7 @@ namespace ukive {
             if ((*it) == v) {
                 isolateChild(v, attached, del);
                 views_.erase(it);
+                invalidateChildIndex();
 
                 if (req_layout) {
                     requestLayout();
@@ -196,6 +198,7 @@ namespace ukive {
         bool attached = isAttachedToWindow();
         isolateChild(views_[index], attached, del);
         views_.erase(views_.begin() + index);
+        invalidateChildIndex();
 
         if (req_layout) {
             requestLayout();
@@ -211,6 +214,7 @@ namespace ukive {
             }
 
             views_.clear();
+            invalidateChildIndex();
 
             if (attached) {
                 if (req_layout) {
@@ -297,16 +301,39 @@ namespace ukive {
         return views_.size();
     }
 
-    View* LayoutView::getChildById(int id) const {
-        for (auto view : views_) {
-            if (view->getId() == id) {
-                return view;
-            }
+    View* LayoutView::getChildById(long long id) const {
+        if (is_id_index_dirty_) {
+            rebuildChildIndex();
         }
 
+        auto it = id_index_.find(id);
+        if (it != id_index_.end()) {
+            return it->second;
+        }
         return nullptr;
     }
 
+    void LayoutView::onChildIdChanged(View* child) {
+        ubassert(child->getParent() == this);
+        invalidateChildIndex();
+    }
+
+    void LayoutView::invalidateChildIndex() {
+        is_id_index_dirty_ = true;
+        onChildrenChanged();
+    }
+
+    void LayoutView::rebuildChildIndex() const {
+        id_index_.clear();
+        id_index_.reserve(views_.size());
+
+        // 逆序插入，使相同 id 时索引最小的 View 生效
+        for (auto it = views_.rbegin(); it != views_.rend(); ++it) {
+            id_index_[(*it)->getId()] = *it;
+        }
+        is_id_index_dirty_ = false;
+    }
+
     View* LayoutView::getChildAt(size_t index) const {
         return views_.at(index);
     }
@@ -7,6 +7,7 @@
 #ifndef UKIVE_VIEWS_LAYOUT_LAYOUT_VIEW_H_
 #define UKIVE_VIEWS_LAYOUT_LAYOUT_VIEW_H_
 
+#include <unordered_map>
 #include <vector>
 
 #include "utils/stl_utils.h"
@@ -88,7 +89,12 @@ namespace ukive {
 
         bool hasChildren() const;
         size_t getChildCount() const;
-        View* getChildById(int id) const;
+        /**
+         * 获取具有指定 id 的子 View。
+         * 若有多个子 View 具有相同的 id，返回索引最小的那个。
+         * 使用内部的 id 索引，平均复杂度为 O(1)。
+         */
+        View* getChildById(long long id) const;
         View* getChildAt(size_t index) const;
 
         View* findView(int id) override;
@@ -111,6 +117,11 @@ namespace ukive {
             const Size& ex_margin = {});
         void determineChildrenSize(const SizeInfo& parent_info);
 
+        /**
+         * 子 View 的 id 发生变化时由子 View 调用。
+         */
+        void onChildIdChanged(View* child);
+
         STL_VECTOR_ALL_ITERATORS(View*, views_);
 
     protected:
@@ -130,6 +141,12 @@ namespace ukive {
         virtual bool dispatchPointerEvent(InputEvent* e);
         virtual bool dispatchKeyboardEvent(InputEvent* e);
 
+        /**
+         * 子 View 集合或子 View 的 id 发生变化时调用。
+         * 子类可以在此处使自身缓存的与子 View 相关的数据失效。
+         */
+        virtual void onChildrenChanged() {}
+
         int getWrappedWidth();
         int getWrappedHeight();
         Size getWrappedSize(const SizeInfo& info);
@@ -138,6 +155,8 @@ namespace ukive {
         using super = View;
 
         void isolateChild(View* child, bool attached, bool del);
+        void invalidateChildIndex();
+        void rebuildChildIndex() const;
 
         void prepareHookingStatus(InputEvent* e);
         void updateHookingStatus(InputEvent* e);
@@ -145,6 +164,10 @@ namespace ukive {
 
         std::vector<View*> views_;
         bool is_hooked_ = false;
+
+        // id -> 子 View 的索引，在 getChildById() 时按需重建
+        mutable std::unordered_map<long long, View*> id_index_;
+        mutable bool is_id_index_dirty_ = true;
     };
 
 }
@@ -8,6 +8,7 @@
 
 #include <algorithm>
 #include <typeinfo>
+#include <unordered_map>
 
 #include "utils/log.h"
 #include "utils/strings/int_conv.hpp"
@@ -147,11 +148,111 @@ namespace ukive {
         return typeid(*lp) == typeid(RestraintLayoutInfo);
     }
 
-    void RestraintLayout::clearMeasureFlag() {
+    void RestraintLayout::onChildrenChanged() {
+        super::onChildrenChanged();
+        is_graph_dirty_ = true;
+    }
+
+    void RestraintLayout::resolveHandles() {
+        // 父 View 的 id 改变时，绑定于父 View 的 handle 的含义也会随之改变
+        bool dirty = is_graph_dirty_ || resolved_self_id_ != getId();
+        bool changed = dirty;
+
         for (auto child : *this) {
             auto li = static_cast<RestraintLayoutInfo*>(child->getExtraLayoutInfo());
-            li->is_width_determined = li->is_height_determined = false;
-            li->is_vert_layouted = li->is_hori_layouted = false;
+            if (!dirty && li->is_handle_resolved) {
+                continue;
+            }
+
+            li->start_handle_view = resolveHandle(li->hasStart(), li->start_handle_id);
+            li->top_handle_view = resolveHandle(li->hasTop(), li->top_handle_id);
+            li->end_handle_view = resolveHandle(li->hasEnd(), li->end_handle_id);
+            li->bottom_handle_view = resolveHandle(li->hasBottom(), li->bottom_handle_id);
+            li->is_handle_resolved = true;
+            changed = true;
+        }
+
+        is_graph_dirty_ = false;
+        resolved_self_id_ = getId();
+
+        if (changed) {
+            sortHandles(false, &hori_order_);
+            sortHandles(true, &vert_order_);
+        }
+    }
+
+    View* RestraintLayout::resolveHandle(bool has_handle, long long handle_id) const {
+        if (!has_handle || handle_id == getId()) {
+            return nullptr;
+        }
+
+        auto target = getChildById(handle_id);
+        if (!target) {
+            DLOG(Log::ERR) << "Cannot find the handle target: " << handle_id;
+        }
+        return target;
+    }
+
+    void RestraintLayout::sortHandles(bool vert, std::vector<View*>* order) const {
+        size_t count = getChildCount();
+        order->clear();
+        order->reserve(count);
+
+        std::unordered_map<View*, size_t> indices;
+        indices.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            indices[getChildAt(i)] = i;
+        }
+
+        // 边由 handle 的目标指向依赖它的子 View
+        std::vector<size_t> in_degrees(count, 0);
+        std::vector<std::vector<size_t>> dependents(count);
+        for (size_t i = 0; i < count; ++i) {
+            auto li = static_cast<RestraintLayoutInfo*>(getChildAt(i)->getExtraLayoutInfo());
+            View* targets[] = {
+                vert ? li->top_handle_view : li->start_handle_view,
+                vert ? li->bottom_handle_view : li->end_handle_view,
+            };
+            for (auto target : targets) {
+                if (!target) {
+                    continue;
+                }
+                auto it = indices.find(target);
+                if (it == indices.end()) {
+                    continue;
+                }
+                dependents[it->second].push_back(i);
+                ++in_degrees[i];
+            }
+        }
+
+        // Kahn 算法。入度相同时保持子 View 的原有顺序。
+        for (size_t i = 0; i < count; ++i) {
+            if (in_degrees[i] == 0) {
+                order->push_back(getChildAt(i));
+            }
+        }
+        for (size_t i = 0; i < order->size(); ++i) {
+            size_t index = indices[(*order)[i]];
+            for (auto dep : dependents[index]) {
+                if (--in_degrees[dep] == 0) {
+                    order->push_back(getChildAt(dep));
+                }
+            }
+        }
+
+        if (order->size() < count) {
+            // 存在环。将环上的 View 按原有顺序追加到末尾，它们将使用上一次的结果，
+            // 而不会像递归那样导致栈溢出。
+            DLOG(Log::ERR) << "Circular "
+                << (vert ? "vertical" : "horizontal")
+                << " handles detected in RestraintLayout: "
+                << (count - order->size()) << " views.";
+            for (size_t i = 0; i < count; ++i) {
+                if (in_degrees[i] != 0) {
+                    order->push_back(getChildAt(i));
+                }
+            }
         }
     }
 
@@ -159,45 +260,81 @@ namespace ukive {
         return v->getVisibility() != VANISHED;
     }
 
-    void RestraintLayout::measureRestrainedChildren(const SizeInfo& parent_info) {
+    void RestraintLayout::markPremeasuredChildren(const SizeInfo::Value& parent_width) {
         for (auto child : *this) {
             auto li = static_cast<RestraintLayoutInfo*>(child->getExtraLayoutInfo());
-            if (li->is_width_determined) {
-                continue;
-            }
+            li->is_in_start_chain = li->is_in_end_chain = false;
+            li->is_width_premeasured = false;
+        }
+
+        // 逆拓扑序遍历，依赖者先于目标被访问。
+        // 两端绑定于其他子 View 且需要填充的子 View 在测量宽度时，需要知道链上各个
+        // View 的实际宽度，因此这些 View 需要在水平方向的遍历中预先测量一次。
+        for (auto it = hori_order_.rbegin(); it != hori_order_.rend(); ++it) {
+            auto child = *it;
+            auto li = static_cast<RestraintLayoutInfo*>(child->getExtraLayoutInfo());
 
-            SizeInfo::Value child_width;
-            getRestrainedChildWidth(
-                child, li,
-                parent_info.width(),
-                &child_width);
+            if (li->hasHoriCouple() && isAttended(child)
+                && child->getLayoutSize().width() < 0)
+            {
+                auto start_target = li->start_handle_view;
+                auto end_target = li->end_handle_view;
+                if (start_target && start_target == end_target) {
+                    static_cast<RestraintLayoutInfo*>(
+                        start_target->getExtraLayoutInfo())->is_width_premeasured = true;
+                } else if ((start_target || end_target)
+                    && (parent_width.mode == SizeInfo::DEFINED
+                        || parent_width.mode == SizeInfo::CONTENT))
+                {
+                    li->is_in_start_chain = li->is_in_end_chain = true;
+                }
+            }
 
-            li->is_width_determined = true;
-            li->width_info = child_width;
+            if (li->is_in_start_chain && li->start_handle_view) {
+                auto target_li = static_cast<RestraintLayoutInfo*>(
+                    li->start_handle_view->getExtraLayoutInfo());
+                target_li->is_in_start_chain = true;
+                target_li->is_width_premeasured = true;
+            }
+            if (li->is_in_end_chain && li->end_handle_view) {
+                auto target_li = static_cast<RestraintLayoutInfo*>(
+                    li->end_handle_view->getExtraLayoutInfo());
+                target_li->is_in_end_chain = true;
+                target_li->is_width_premeasured = true;
+            }
         }
+    }
 
-        for (auto child : *this) {
+    void RestraintLayout::measureRestrainedChildren(const SizeInfo& parent_info) {
+        markPremeasuredChildren(parent_info.width());
+
+        // 水平方向。按拓扑序遍历时，handle 的目标总是先于该 View 被处理，
+        // 因此每个 View 只需访问一次。
+        for (auto child : hori_order_) {
             auto li = static_cast<RestraintLayoutInfo*>(child->getExtraLayoutInfo());
-            if (li->is_width_determined && li->is_height_determined) {
-                continue;
-            }
+            li->start_spacing = getLeftSpacing(li);
+            li->end_spacing = getRightSpacing(li);
 
-            SizeInfo::Value child_height;
-            if (!li->is_height_determined) {
-                getRestrainedChildHeight(
-                    child, li,
-                    parent_info.height(),
-                    &child_height);
+            getRestrainedChildWidth(child, li, parent_info.width(), &li->width_info);
 
-                li->is_height_determined = true;
-                li->height_info = child_height;
-            }
-            else {
-                child_height = li->height_info;
+            if (li->is_width_premeasured && isAttended(child)) {
+                // 让 View 预先测量自身，以便依赖它的 View 获取其宽度。
+                // 这将会使该 View 的 onDetermineSize() 方法多调用一次。
+                child->determineSize(
+                    SizeInfo(li->width_info, SizeInfo::Value(0, SizeInfo::FREEDOM)));
             }
+        }
+
+        // 垂直方向。此时所有 View 的宽度均已确定，可直接进行最终测量。
+        for (auto child : vert_order_) {
+            auto li = static_cast<RestraintLayoutInfo*>(child->getExtraLayoutInfo());
+            li->top_spacing = getTopSpacing(li);
+            li->bottom_spacing = getBottomSpacing(li);
+
+            getRestrainedChildHeight(child, li, parent_info.height(), &li->height_info);
 
             if (isAttended(child)) {
-                child->determineSize(SizeInfo(li->width_info, child_height));
+                child->determineSize(SizeInfo(li->width_info, li->height_info));
             }
         }
     }
@@ -223,9 +360,7 @@ namespace ukive {
                 rli->hori_couple_handler_type = RestraintLayoutInfo::CH_FIXED;
             } else {
                 // child 将填充 handler couple 之间的区域
-                if (rli->start_handle_id == getId()
-                    && rli->end_handle_id == getId())
-                {
+                if (!rli->start_handle_view && !rli->end_handle_view) {
                     // handler couple 绑定于父 View
                     switch (parent_width.mode) {
                     case SizeInfo::CONTENT:
@@ -270,39 +405,13 @@ namespace ukive {
                 else
                 {
                     // handler couple 没有绑定于父 View。这意味着它与其他子 View 绑定。
-                    // 此时必须先测量绑定到的 View，然后才能测量该 View。将使用
-                    // 递归完成此过程，为此需要额外的变量来记录某一 View 是否已测量。
-                    if (rli->start_handle_id == rli->end_handle_id)
+                    // 由于按拓扑序测量，绑定到的 View 此时已经预先测量过。
+                    if (rli->start_handle_view == rli->end_handle_view)
                     {
                         // 左右 Handler 绑定在同一个 View 上
                         int measured_target_width = 0;
-                        View* target = getChildById(rli->start_handle_id);
-                        auto target_li = static_cast<RestraintLayoutInfo*>(target->getExtraLayoutInfo());
-
-                        // 测量此 target view 的宽度。
-                        SizeInfo::Value target_width;
-                        if (!target_li->is_width_determined)
-                        {
-                            getRestrainedChildWidth(target, target_li, parent_width, &target_width);
-
-                            target_li->is_width_determined = true;
-                            target_li->width_info = target_width;
-                        }
-                        else
-                        {
-                            target_width = target_li->width_info;
-                        }
-
-                        SizeInfo::Value target_height(0, SizeInfo::FREEDOM);
-                        if (target_li->is_height_determined)
-                        {
-                            target_height = target_li->height_info;
-                        }
-
+                        View* target = rli->start_handle_view;
                         if (isAttended(target)) {
-                            // 让 target view 测量自身。
-                            // 这将会使 target view 的 onDetermineSize() 方法多调用一次。
-                            target->determineSize(SizeInfo(target_width, target_height));
                             measured_target_width = target->getDeterminedSize().width();
                         }
 
@@ -329,108 +438,10 @@ namespace ukive {
                         if (parent_width.mode == SizeInfo::DEFINED
                             || parent_width.mode == SizeInfo::CONTENT)
                         {
-                            // 前向遍历。
-                            int measured_start_margin = margin.start();
-                            RestraintLayoutInfo* child_li = rli;
-                            while (child_li->hasStart()
-                                && child_li->start_handle_id != this->getId())
-                            {
-                                View* target = getChildById(child_li->start_handle_id);
-                                auto target_li = static_cast<RestraintLayoutInfo*>(target->getExtraLayoutInfo());
-
-                                // 测量此 target view 的宽度。
-                                SizeInfo::Value target_width;
-                                if (!target_li->is_width_determined)
-                                {
-                                    getRestrainedChildWidth(
-                                        target, target_li, parent_width, &target_width);
-
-                                    target_li->is_width_determined = true;
-                                    target_li->width_info = target_width;
-                                }
-                                else
-                                {
-                                    target_width = target_li->width_info;
-                                }
-
-                                SizeInfo::Value target_height(0, SizeInfo::FREEDOM);
-                                if (target_li->is_height_determined)
-                                {
-                                    target_height = target_li->height_info;
-                                }
-
-                                if (isAttended(target)) {
-                                    // 让 target view 测量自身。
-                                    // 这将会使 target view 的 onDetermineSize() 方法多调用一次。
-                                    target->determineSize(SizeInfo(target_width, target_height));
-                                    auto& target_margin = target->getLayoutMargin();
-
-                                    if (child_li->start_handle_edge == RestraintLayoutInfo::END)
-                                    {
-                                        measured_start_margin += target->getDeterminedSize().width()
-                                            + (target_li->hasStart() ? target_margin.start() : 0);
-                                    }
-                                    else if (child_li->start_handle_edge == RestraintLayoutInfo::START)
-                                    {
-                                        measured_start_margin +=
-                                            (target_li->hasStart() ? target_margin.start() : 0);
-                                    }
-                                }
-
-                                child_li = target_li;
-                            }
-
-                            // 后向遍历。
-                            int measured_end_margin = margin.end();
-                            child_li = rli;
-                            while (child_li->hasEnd()
-                                && child_li->end_handle_id != this->getId())
-                            {
-                                View* target = getChildById(child_li->end_handle_id);
-                                auto target_li = static_cast<RestraintLayoutInfo*>(target->getExtraLayoutInfo());
-
-                                // 测量此 target view 的宽度。
-                                SizeInfo::Value target_width;
-                                if (!target_li->is_width_determined)
-                                {
-                                    getRestrainedChildWidth(
-                                        target, target_li, parent_width, &target_width);
-
-                                    target_li->is_width_determined = true;
-                                    target_li->width_info = target_width;
-                                }
-                                else
-                                {
-                                    target_width = target_li->width_info;
-                                }
-
-                                SizeInfo::Value target_height(0, SizeInfo::FREEDOM);
-                                if (target_li->is_height_determined)
-                                {
-                                    target_height = target_li->height_info;
-                                }
-
-                                if (isAttended(target)) {
-                                    // 让 target view 测量自身。
-                                    // 这将会使 target view 的 onDetermineSize() 方法多调用一次。
-                                    target->determineSize(SizeInfo(target_width, target_height));
-                                    auto& target_margin = target->getLayoutMargin();
-
-                                    if (child_li->end_handle_edge
-                                        == RestraintLayoutInfo::START)
-                                    {
-                                        measured_end_margin += target->getDeterminedSize().width()
-                                            + (target_li->hasEnd() ? target_margin.end() : 0);
-                                    } else if (child_li->end_handle_edge
-                                        == RestraintLayoutInfo::END)
-                                    {
-                                        measured_end_margin +=
-                                            (target_li->hasEnd() ? target_margin.end() : 0);
-                                    }
-                                }
-
-                                child_li = target_li;
-                            }
+                            // 整条链作为一个整体求解：链上各 View 占据的宽度已累计在
+                            // start_spacing 和 end_spacing 中。
+                            int measured_start_margin = margin.start() + rli->start_spacing;
+                            int measured_end_margin = margin.end() + rli->end_spacing;
 
                             child_width.val = (std::max)(0, parent_width.val - getPadding().hori()
                                 - measured_start_margin - measured_end_margin);
@@ -506,7 +517,7 @@ namespace ukive {
             // child 将填充 handler couple 之间的区域。
             else {
                 // handler couple 绑定于父 View。
-                if (rli->top_handle_id == getId() && rli->bottom_handle_id == getId())
+                if (!rli->top_handle_view && !rli->bottom_handle_view)
                 {
                     switch (parent_height.mode) {
                     case SizeInfo::CONTENT:
@@ -566,41 +577,14 @@ namespace ukive {
                     }
                 }
                 // handler couple 没有绑定于父 View。这意味着它与其他子 View 绑定。
-                // 此时必须先测量绑定到的 View，然后才能测量该 View。将使用
-                // 递归完成此过程，为此需要额外的变量来记录某一 View 是否已测量。
+                // 由于按拓扑序测量，绑定到的 View 此时已经测量完毕。
                 else {
                     // 上下 Handler 绑定在同一个 View 上。
-                    if (rli->top_handle_id == rli->bottom_handle_id)
+                    if (rli->top_handle_view == rli->bottom_handle_view)
                     {
                         int measured_target_height = 0;
-                        View* target = getChildById(rli->top_handle_id);
-                        auto target_li = static_cast<RestraintLayoutInfo*>(target->getExtraLayoutInfo());
-
-                        // 测量此 target view 的高度。
-                        SizeInfo::Value targetHeight;
-                        if (!target_li->is_height_determined)
-                        {
-                            getRestrainedChildHeight(
-                                target, target_li, parent_height, &targetHeight);
-
-                            target_li->is_height_determined = true;
-                            target_li->height_info = targetHeight;
-                        }
-                        else
-                        {
-                            targetHeight = target_li->height_info;
-                        }
-
-                        SizeInfo::Value target_width(0, SizeInfo::FREEDOM);
-                        if (target_li->is_width_determined)
-                        {
-                            target_width = target_li->width_info;
-                        }
-
+                        View* target = rli->top_handle_view;
                         if (isAttended(target)) {
-                            // 让 target view 测量自身。
-                            // 这将会使 target view 的 onDetermineSize() 方法多调用一次。
-                            target->determineSize(SizeInfo(target_width, targetHeight));
                             measured_target_height = target->getDeterminedSize().height();
                         }
 
@@ -625,100 +609,10 @@ namespace ukive {
                         if (parent_height.mode == SizeInfo::DEFINED ||
                             parent_height.mode == SizeInfo::CONTENT)
                         {
-                            // 上向遍历。
-                            int measured_top_margin = margin.top();
-                            auto child_li = rli;
-                            while (child_li->hasTop()
-                                && child_li->top_handle_id != this->getId())
-                            {
-                                View* target = getChildById(child_li->top_handle_id);
-                                auto target_li = static_cast<RestraintLayoutInfo*>(target->getExtraLayoutInfo());
-
-                                // 测量此 target view 的高度。
-                                SizeInfo::Value target_height;
-                                if (!target_li->is_height_determined)
-                                {
-                                    getRestrainedChildHeight(
-                                        target, target_li, parent_height, &target_height);
-
-                                    target_li->is_height_determined = true;
-                                    target_li->height_info = child_height;
-                                }
-                                else
-                                {
-                                    target_height = target_li->height_info;
-                                }
-
-                                SizeInfo::Value target_width(0, SizeInfo::FREEDOM);
-                                if (target_li->is_width_determined)
-                                {
-                                    target_width = target_li->width_info;
-                                }
-
-                                if (isAttended(target)) {
-                                    // 让 target view 测量自身。
-                                    // 这将会使 target view 的 onDetermineSize() 方法多调用一次。
-                                    target->determineSize(SizeInfo(target_width, target_height));
-                                    auto& target_margin = target->getLayoutMargin();
-
-                                    if (child_li->top_handle_edge == RestraintLayoutInfo::BOTTOM) {
-                                        measured_top_margin += target->getDeterminedSize().height()
-                                            + (target_li->hasTop() ? target_margin.top() : 0);
-                                    } else if (child_li->top_handle_edge == RestraintLayoutInfo::TOP) {
-                                        measured_top_margin +=
-                                            (target_li->hasTop() ? target_margin.top() : 0);
-                                    }
-                                }
-
-                                child_li = target_li;
-                            }
-
-                            // 下向遍历。
-                            int measured_bottom_margin = margin.bottom();
-                            child_li = rli;
-                            while (child_li->hasBottom() && child_li->bottom_handle_id != getId())
-                            {
-                                View* target = getChildById(child_li->bottom_handle_id);
-                                auto target_li = static_cast<RestraintLayoutInfo*>(target->getExtraLayoutInfo());
-
-                                // 测量此 target view 的高度。
-                                SizeInfo::Value target_height;
-                                if (!target_li->is_height_determined)
-                                {
-                                    getRestrainedChildHeight(
-                                        target, target_li, parent_height, &target_height);
-
-                                    target_li->is_height_determined = true;
-                                    target_li->height_info = target_height;
-                                }
-                                else
-                                {
-                                    target_height = target_li->height_info;
-                                }
-
-                                SizeInfo::Value target_width(0, SizeInfo::FREEDOM);
-                                if (target_li->is_width_determined)
-                                {
-                                    target_width = target_li->width_info;
-                                }
-
-                                if (isAttended(target)) {
-                                    // 让 target view 测量自身。
-                                    // 这将会使 target view 的 onDetermineSize() 方法多调用一次。
-                                    target->determineSize(SizeInfo(target_width, target_height));
-                                    auto& target_margin = target->getLayoutMargin();
-
-                                    if (child_li->bottom_handle_edge == RestraintLayoutInfo::TOP) {
-                                        measured_bottom_margin += target->getDeterminedSize().height()
-                                            + (target_li->hasBottom() ? target_margin.bottom() : 0);
-                                    } else if (child_li->bottom_handle_edge == RestraintLayoutInfo::BOTTOM) {
-                                        measured_bottom_margin +=
-                                            (target_li->hasBottom() ? target_margin.bottom() : 0);
-                                    }
-                                }
-
-                                child_li = target_li;
-                            }
+                            // 整条链作为一个整体求解：链上各 View 占据的高度已累计在
+                            // top_spacing 和 bottom_spacing 中。
+                            int measured_top_margin = margin.top() + rli->top_spacing;
+                            int measured_bottom_margin = margin.bottom() + rli->bottom_spacing;
 
                             // TODO: 这里不应该用 parent_height，而应该使用最后遍历到的 view
                             // 作为边界来计算。此处假定最终绑定到 parent 边界。
@@ -766,97 +660,89 @@ namespace ukive {
         *height = child_height;
     }
 
-    int RestraintLayout::getLeftSpacing(View* child, RestraintLayoutInfo* rli) {
-        int left_spacing = 0;
-        auto child_li = rli;
-        while (child_li->hasStart() && child_li->start_handle_id != getId()) {
-            View* target = getChildById(child_li->start_handle_id);
-            auto target_li = static_cast<RestraintLayoutInfo*>(target->getExtraLayoutInfo());
-            auto& margin = target->getLayoutMargin();
+    int RestraintLayout::getLeftSpacing(RestraintLayoutInfo* rli) {
+        auto target = rli->start_handle_view;
+        if (!rli->hasStart() || !target) {
+            return 0;
+        }
 
-            if (isAttended(target)) {
-                if (child_li->start_handle_edge == RestraintLayoutInfo::END) {
-                    left_spacing += target->getDeterminedSize().width()
-                        + (target_li->hasStart() ? margin.start() : 0);
-                } else if (child_li->start_handle_edge == RestraintLayoutInfo::START) {
-                    left_spacing +=
-                        (target_li->hasStart() ? margin.start() : 0);
-                }
+        auto target_li = static_cast<RestraintLayoutInfo*>(target->getExtraLayoutInfo());
+        int left_spacing = target_li->start_spacing;
+        if (isAttended(target)) {
+            auto& margin = target->getLayoutMargin();
+            if (rli->start_handle_edge == RestraintLayoutInfo::END) {
+                left_spacing += target->getDeterminedSize().width()
+                    + (target_li->hasStart() ? margin.start() : 0);
+            } else if (rli->start_handle_edge == RestraintLayoutInfo::START) {
+                left_spacing +=
+                    (target_li->hasStart() ? margin.start() : 0);
             }
-
-            child_li = target_li;
         }
 
         return left_spacing;
     }
 
-    int RestraintLayout::getTopSpacing(View* child, RestraintLayoutInfo* rli) {
-        int top_spacing = 0;
-        auto child_li = rli;
-        while (child_li->hasTop() && child_li->top_handle_id != getId()) {
-            View* target = getChildById(child_li->top_handle_id);
-            auto target_li = static_cast<RestraintLayoutInfo*>(target->getExtraLayoutInfo());
-            auto& margin = target->getLayoutMargin();
+    int RestraintLayout::getTopSpacing(RestraintLayoutInfo* rli) {
+        auto target = rli->top_handle_view;
+        if (!rli->hasTop() || !target) {
+            return 0;
+        }
 
-            if (isAttended(target)) {
-                if (child_li->top_handle_edge == RestraintLayoutInfo::BOTTOM) {
-                    top_spacing += target->getDeterminedSize().height()
-                        + (target_li->hasTop() ? margin.top() : 0);
-                } else if (child_li->top_handle_edge == RestraintLayoutInfo::TOP) {
-                    top_spacing +=
-                        (target_li->hasTop() ? margin.top() : 0);
-                }
+        auto target_li = static_cast<RestraintLayoutInfo*>(target->getExtraLayoutInfo());
+        int top_spacing = target_li->top_spacing;
+        if (isAttended(target)) {
+            auto& margin = target->getLayoutMargin();
+            if (rli->top_handle_edge == RestraintLayoutInfo::BOTTOM) {
+                top_spacing += target->getDeterminedSize().height()
+                    + (target_li->hasTop() ? margin.top() : 0);
+            } else if (rli->top_handle_edge == RestraintLayoutInfo::TOP) {
+                top_spacing +=
+                    (target_li->hasTop() ? margin.top() : 0);
             }
-
-            child_li = target_li;
         }
 
         return top_spacing;
     }
 
-    int RestraintLayout::getRightSpacing(View* child, RestraintLayoutInfo* rli) {
-        int right_spacing = 0;
-        auto child_li = rli;
-        while (child_li->hasEnd() && child_li->end_handle_id != getId()) {
-            View* target = getChildById(child_li->end_handle_id);
-            auto target_li = static_cast<RestraintLayoutInfo*>(target->getExtraLayoutInfo());
-            auto& margin = target->getLayoutMargin();
+    int RestraintLayout::getRightSpacing(RestraintLayoutInfo* rli) {
+        auto target = rli->end_handle_view;
+        if (!rli->hasEnd() || !target) {
+            return 0;
+        }
 
-            if (isAttended(target)) {
-                if (child_li->end_handle_edge == RestraintLayoutInfo::START) {
-                    right_spacing += target->getDeterminedSize().width()
-                        + (target_li->hasEnd() ? margin.end() : 0);
-                } else if (child_li->end_handle_edge == RestraintLayoutInfo::END) {
-                    right_spacing +=
-                        (target_li->hasEnd() ? margin.end() : 0);
-                }
+        auto target_li = static_cast<RestraintLayoutInfo*>(target->getExtraLayoutInfo());
+        int right_spacing = target_li->end_spacing;
+        if (isAttended(target)) {
+            auto& margin = target->getLayoutMargin();
+            if (rli->end_handle_edge == RestraintLayoutInfo::START) {
+                right_spacing += target->getDeterminedSize().width()
+                    + (target_li->hasEnd() ? margin.end() : 0);
+            } else if (rli->end_handle_edge == RestraintLayoutInfo::END) {
+                right_spacing +=
+                    (target_li->hasEnd() ? margin.end() : 0);
             }
-
-            child_li = target_li;
         }
 
         return right_spacing;
     }
 
-    int RestraintLayout::getBottomSpacing(View* child, RestraintLayoutInfo* rli) {
-        int bottom_spacing = 0;
-        auto child_li = rli;
-        while (child_li->hasBottom() && child_li->bottom_handle_id != getId()) {
-            auto target = getChildById(child_li->bottom_handle_id);
-            auto target_li = static_cast<RestraintLayoutInfo*>(target->getExtraLayoutInfo());
-            auto& margin = target->getLayoutMargin();
+    int RestraintLayout::getBottomSpacing(RestraintLayoutInfo* rli) {
+        auto target = rli->bottom_handle_view;
+        if (!rli->hasBottom() || !target) {
+            return 0;
+        }
 
-            if (isAttended(target)) {
-                if (child_li->bottom_handle_edge == RestraintLayoutInfo::TOP) {
-                    bottom_spacing += target->getDeterminedSize().height()
-                        + (target_li->hasBottom() ? margin.bottom() : 0);
-                } else if (child_li->bottom_handle_edge == RestraintLayoutInfo::BOTTOM) {
-                    bottom_spacing +=
-                        (target_li->hasBottom() ? margin.bottom() : 0);
-                }
+        auto target_li = static_cast<RestraintLayoutInfo*>(target->getExtraLayoutInfo());
+        int bottom_spacing = target_li->bottom_spacing;
+        if (isAttended(target)) {
+            auto& margin = target->getLayoutMargin();
+            if (rli->bottom_handle_edge == RestraintLayoutInfo::TOP) {
+                bottom_spacing += target->getDeterminedSize().height()
+                    + (target_li->hasBottom() ? margin.bottom() : 0);
+            } else if (rli->bottom_handle_edge == RestraintLayoutInfo::BOTTOM) {
+                bottom_spacing +=
+                    (target_li->hasBottom() ? margin.bottom() : 0);
             }
-
-            child_li = target_li;
         }
 
         return bottom_spacing;
@@ -865,14 +751,15 @@ namespace ukive {
     int RestraintLayout::measureWrappedWidth() {
         int wrapped_width = 0;
 
-        for (auto child : *this) {
+        // 垂直方向的最终测量可能改变 View 的宽度，因此按拓扑序重新累计间距。
+        for (auto child : hori_order_) {
             auto& margin = child->getLayoutMargin();
             auto li = static_cast<RestraintLayoutInfo*>(child->getExtraLayoutInfo());
 
-            int start_spacing = getLeftSpacing(child, li);
-            int end_spacing = getRightSpacing(child, li);
+            li->start_spacing = getLeftSpacing(li);
+            li->end_spacing = getRightSpacing(li);
 
-            int chain_width = start_spacing + end_spacing;
+            int chain_width = li->start_spacing + li->end_spacing;
             if (isAttended(child)) {
                 chain_width += child->getDeterminedSize().width()
                     + (li->hasStart() ? margin.start() : 0)
@@ -888,14 +775,12 @@ namespace ukive {
     int RestraintLayout::measureWrappedHeight() {
         int wrapped_height = 0;
 
-        for (auto child : *this) {
+        // 垂直方向的间距在最终测量时已按拓扑序累计，可直接使用。
+        for (auto child : vert_order_) {
             auto& margin = child->getLayoutMargin();
             auto li = static_cast<RestraintLayoutInfo*>(child->getExtraLayoutInfo());
 
-            int top_spacing = getTopSpacing(child, li);
-            int bottom_spacing = getBottomSpacing(child, li);
-
-            int chain_height = top_spacing + bottom_spacing;
+            int chain_height = li->top_spacing + li->bottom_spacing;
             if (isAttended(child)) {
                 chain_height += child->getDeterminedSize().height()
                     + (li->hasTop() ? margin.top() : 0)
@@ -907,38 +792,14 @@ namespace ukive {
         return wrapped_height;
     }
 
-    void RestraintLayout::layoutChild(
-        View* child, RestraintLayoutInfo* rli,
-        int left, int top, int right, int bottom)
-    {
-        if (!rli->is_vert_layouted) {
-            layoutChildVertical(child, rli, top, bottom);
-        }
-        if (!rli->is_hori_layouted) {
-            layoutChildHorizontal(child, rli, left, right);
-        }
-
-        Rect bounds;
-        bounds.xyrb(
-            rli->left,
-            rli->top,
-            rli->right,
-            rli->bottom);
-        child->layout(bounds);
-    }
-
     void RestraintLayout::layoutChildVertical(
         View* child, RestraintLayoutInfo* rli, int top, int bottom)
     {
         auto& margin = child->getLayoutMargin();
         int child_top = top + getPadding().top();
-        if (rli->hasTop() && rli->top_handle_id != getId()) {
-            auto target = getChildById(rli->top_handle_id);
-            auto target_li = static_cast<RestraintLayoutInfo*>(target->getExtraLayoutInfo());
-
-            if (!target_li->is_vert_layouted) {
-                layoutChildVertical(target, target_li, top, bottom);
-            }
+        if (rli->hasTop() && rli->top_handle_view) {
+            auto target_li = static_cast<RestraintLayoutInfo*>(
+                rli->top_handle_view->getExtraLayoutInfo());
 
             if (rli->top_handle_edge == RestraintLayoutInfo::BOTTOM) {
                 child_top = target_li->bottom;
@@ -948,13 +809,9 @@ namespace ukive {
         }
 
         int child_bottom = bottom - getPadding().bottom();
-        if (rli->hasBottom() && rli->bottom_handle_id != getId()) {
-            auto target = getChildById(rli->bottom_handle_id);
-            auto target_li = static_cast<RestraintLayoutInfo*>(target->getExtraLayoutInfo());
-
-            if (!target_li->is_vert_layouted) {
-                layoutChildVertical(target, target_li, top, bottom);
-            }
+        if (rli->hasBottom() && rli->bottom_handle_view) {
+            auto target_li = static_cast<RestraintLayoutInfo*>(
+                rli->bottom_handle_view->getExtraLayoutInfo());
 
             if (rli->bottom_handle_edge == RestraintLayoutInfo::TOP) {
                 child_bottom = target_li->top;
@@ -1004,7 +861,6 @@ namespace ukive {
             }
         }
 
-        rli->is_vert_layouted = true;
         rli->top = child_top;
         rli->bottom = child_bottom;
     }
@@ -1016,13 +872,9 @@ namespace ukive {
         auto& margin = child->getLayoutMargin();
 
         int child_left = left + getPadding().start();
-        if (rli->hasStart() && rli->start_handle_id != getId()) {
-            View* target = getChildById(rli->start_handle_id);
-            auto target_li = static_cast<RestraintLayoutInfo*>(target->getExtraLayoutInfo());
-
-            if (!target_li->is_hori_layouted) {
-                layoutChildHorizontal(target, target_li, left, right);
-            }
+        if (rli->hasStart() && rli->start_handle_view) {
+            auto target_li = static_cast<RestraintLayoutInfo*>(
+                rli->start_handle_view->getExtraLayoutInfo());
 
             if (rli->start_handle_edge == RestraintLayoutInfo::END) {
                 child_left = target_li->right;
@@ -1032,13 +884,9 @@ namespace ukive {
         }
 
         int child_right = right - getPadding().end();
-        if (rli->hasEnd() && rli->end_handle_id != getId()) {
-            View* target = getChildById(rli->end_handle_id);
-            auto target_li = static_cast<RestraintLayoutInfo*>(target->getExtraLayoutInfo());
-
-            if (!target_li->is_hori_layouted) {
-                layoutChildHorizontal(target, target_li, left, right);
-            }
+        if (rli->hasEnd() && rli->end_handle_view) {
+            auto target_li = static_cast<RestraintLayoutInfo*>(
+                rli->end_handle_view->getExtraLayoutInfo());
 
             if (rli->end_handle_edge == RestraintLayoutInfo::START) {
                 child_right = target_li->left;
@@ -1090,7 +938,6 @@ namespace ukive {
             }
         }
 
-        rli->is_hori_layouted = true;
         rli->left = child_left;
         rli->right = child_right;
     }
@@ -1099,9 +946,8 @@ namespace ukive {
         int final_width = 0;
         int final_height = 0;
 
-        clearMeasureFlag();
+        resolveHandles();
         measureRestrainedChildren(info);
-
         switch (info.width().mode) {
         case SizeInfo::CONTENT:
             final_width = measureWrappedWidth() + getPadding().hori();
@@ -1140,9 +986,23 @@ namespace ukive {
     void RestraintLayout::onLayout(
         const Rect& new_bounds, const Rect& old_bounds)
     {
+        resolveHandles();
+
+        for (auto child : hori_order_) {
+            auto li = static_cast<RestraintLayoutInfo*>(child->getExtraLayoutInfo());
+            layoutChildHorizontal(child, li, 0, new_bounds.width());
+        }
+        for (auto child : vert_order_) {
+            auto li = static_cast<RestraintLayoutInfo*>(child->getExtraLayoutInfo());
+            layoutChildVertical(child, li, 0, new_bounds.height());
+        }
+
         for (auto child : *this) {
             auto li = static_cast<RestraintLayoutInfo*>(child->getExtraLayoutInfo());
-            layoutChild(child, li, 0, 0, new_bounds.width(), new_bounds.height());
+
+            Rect bounds;
+            bounds.xyrb(li->left, li->top, li->right, li->bottom);
+            child->layout(bounds);
         }
     }
 
@@ -7,6 +7,8 @@
 #ifndef UKIVE_VIEWS_LAYOUT_RESTRAINT_LAYOUT_H_
 #define UKIVE_VIEWS_LAYOUT_RESTRAINT_LAYOUT_H_
 
+#include <vector>
+
 #include "ukive/views/layout/layout_view.h"
 
 
@@ -29,12 +31,29 @@ namespace ukive {
         LayoutInfo* makeExtraLayoutInfo() const override;
         LayoutInfo* makeExtraLayoutInfo(AttrsRef attrs) const override;
         bool isValidExtraLayoutInfo(LayoutInfo* lp) const override;
+        void onChildrenChanged() override;
 
     private:
-        void clearMeasureFlag();
+        using super = LayoutView;
+
+        /**
+         * 将子 View 的 handle id 解析为对应的兄弟 View，并缓存在 RestraintLayoutInfo 中。
+         * 只有在子 View 集合、子 View 的 id 或 handle 发生变化后才会重新解析，
+         * 并重新生成水平和垂直方向的拓扑序。
+         */
+        void resolveHandles();
+        View* resolveHandle(bool has_handle, long long handle_id) const;
+
+        /**
+         * 按 handle 的依赖关系对子 View 进行拓扑排序，使得 handle 的目标总在依赖它的
+         * View 之前。若存在环，输出错误并将环上的 View 按原有顺序追加到末尾。
+         * @param vert 为 true 时使用 top/bottom handle，否则使用 start/end handle。
+         */
+        void sortHandles(bool vert, std::vector<View*>* order) const;
 
         bool isAttended(View* v) const;
 
+        void markPremeasuredChildren(const SizeInfo::Value& parent_width);
         void measureRestrainedChildren(const SizeInfo& parent_info);
 
         void getRestrainedChildWidth(
@@ -45,24 +64,27 @@ namespace ukive {
             View* child, RestraintLayoutInfo* rli,
             const SizeInfo::Value& parent_height, SizeInfo::Value* height);
 
-        int getLeftSpacing(View* child, RestraintLayoutInfo* rli);
-        int getTopSpacing(View* child, RestraintLayoutInfo* rli);
-        int getRightSpacing(View* child, RestraintLayoutInfo* rli);
-        int getBottomSpacing(View* child, RestraintLayoutInfo* rli);
+        // 根据 handle 目标已累计的间距计算当前 View 在对应方向上的间距。
+        // 调用前目标必须已被处理。
+        int getLeftSpacing(RestraintLayoutInfo* rli);
+        int getTopSpacing(RestraintLayoutInfo* rli);
+        int getRightSpacing(RestraintLayoutInfo* rli);
+        int getBottomSpacing(RestraintLayoutInfo* rli);
 
         int measureWrappedWidth();
         int measureWrappedHeight();
 
-        void layoutChild(
-            View* child, RestraintLayoutInfo* rli,
-            int left, int top, int right, int bottom);
-
         void layoutChildVertical(
             View* child, RestraintLayoutInfo* rli,
             int top, int bottom);
         void layoutChildHorizontal(
             View* child, RestraintLayoutInfo* rli,
             int left, int right);
+
+        bool is_graph_dirty_ = true;
+        long long resolved_self_id_ = 0;
+        std::vector<View*> hori_order_;
+        std::vector<View*> vert_order_;
     };
 
 }
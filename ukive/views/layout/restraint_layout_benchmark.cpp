@@ -0,0 +1,217 @@
+// Copyright (c) 2016 ucclkp <ucclkp@gmail.com>.
+// This file is part of ukive project.
+//
+// This program is licensed under GPLv3 license that can be
+// found in the LICENSE file.
+
+#include "ukive/views/layout/restraint_layout_benchmark.h"
+
+#include <memory>
+
+#include "utils/log.h"
+#include "utils/time_utils.h"
+
+#include "ukive/views/layout/restraint_layout.h"
+#include "ukive/views/layout_info/restraint_layout_info.h"
+#include "ukive/window/context.h"
+
+
+namespace {
+
+    using Rlp = ukive::RestraintLayoutInfo;
+
+    const long long kParentId = 1;
+    const int kColumns = 10;
+    const int kChildSize = 20;
+    const int kRounds = 20;
+
+    enum GraphType {
+        GRID,
+        FILL_CHAIN,
+        WRAP_CHAIN,
+        WEIGHTED_CHAIN,
+    };
+
+    struct Graph {
+        const char* name;
+        GraphType type;
+    };
+
+    const Graph kGraphs[] = {
+        { "fixed grid", GRID },
+        { "CH_FILL chain", FILL_CHAIN },
+        { "CH_WRAP chain", WRAP_CHAIN },
+        { "weighted chain", WEIGHTED_CHAIN },
+    };
+
+    ukive::View* makeChild(
+        ukive::Context c, long long id, int width, int height, Rlp* li)
+    {
+        auto child = new ukive::View(c);
+        child->setId(id);
+        child->setLayoutSize(width, height);
+        child->setExtraLayoutInfo(li);
+        return child;
+    }
+
+    /**
+     * 子 View 按 kColumns 列排成网格，大小固定：
+     * 每个子 View 的 start 接在同一行的前一个之后，top 接在上一行同一列之下，
+     * 每行的最后一个同时以 end 连接到父 View。
+     * 因此垂直方向上存在长度为 count / kColumns 的链。
+     */
+    void makeGrid(ukive::RestraintLayout* layout, ukive::Context c, int count) {
+        for (int i = 0; i < count; ++i) {
+            int col = i % kColumns;
+            long long id = kParentId + 1 + i;
+
+            Rlp::Builder builder;
+            if (col == 0) {
+                builder.start(kParentId);
+            } else {
+                builder.start(id - 1, Rlp::END);
+            }
+            if (i < kColumns) {
+                builder.top(kParentId);
+            } else {
+                builder.top(id - kColumns, Rlp::BOTTOM);
+            }
+            if (col == kColumns - 1) {
+                builder.end(kParentId);
+            }
+
+            layout->addView(makeChild(c, id, kChildSize, kChildSize, builder.build()), false);
+        }
+    }
+
+    /**
+     * 子 View 排成一列，每个子 View 的 top 接在前一个之下，bottom 连接到父 View，
+     * 高度为 LS_FILL 时为 CH_FILL，为 LS_AUTO 时为 CH_WRAP；水平方向两端均连接到父 View。
+     * 每个子 View 的 handle couple 都有一端绑定于其他子 View，测量时需要知道整条链的高度。
+     */
+    void makeVertChain(
+        ukive::RestraintLayout* layout, ukive::Context c, int count, int height)
+    {
+        for (int i = 0; i < count; ++i) {
+            long long id = kParentId + 1 + i;
+
+            Rlp::Builder builder;
+            builder.start(kParentId).end(kParentId);
+            if (i == 0) {
+                builder.top(kParentId);
+            } else {
+                builder.top(id - 1, Rlp::BOTTOM);
+            }
+            builder.bottom(kParentId);
+
+            layout->addView(makeChild(c, id, ukive::View::LS_FILL, height, builder.build()), false);
+        }
+    }
+
+    /**
+     * 子 View 排成一行，每个子 View 的 start 接在前一个之后，end 连接到父 View，
+     * 宽度为 LS_FILL，权重在 1 到 3 之间循环；垂直方向两端均连接到父 View。
+     */
+    void makeWeightedChain(ukive::RestraintLayout* layout, ukive::Context c, int count) {
+        for (int i = 0; i < count; ++i) {
+            long long id = kParentId + 1 + i;
+
+            Rlp::Builder builder;
+            if (i == 0) {
+                builder.start(kParentId);
+            } else {
+                builder.start(id - 1, Rlp::END);
+            }
+            builder.end(kParentId).top(kParentId).bottom(kParentId);
+
+            auto li = builder.build();
+            li->hori_weight = float(1 + i % 3);
+            layout->addView(makeChild(c, id, ukive::View::LS_FILL, kChildSize, li), false);
+        }
+    }
+
+    ukive::RestraintLayout* makeLayout(
+        ukive::Context c, GraphType type, int count, int* width, int* height)
+    {
+        auto layout = new ukive::RestraintLayout(c);
+        layout->setId(kParentId);
+
+        switch (type) {
+        case GRID:
+            makeGrid(layout, c, count);
+            *width = kColumns * kChildSize;
+            *height = (count + kColumns - 1) / kColumns * kChildSize;
+            break;
+        case FILL_CHAIN:
+        case WRAP_CHAIN:
+            makeVertChain(
+                layout, c, count,
+                type == FILL_CHAIN ? ukive::View::LS_FILL : ukive::View::LS_AUTO);
+            *width = kChildSize;
+            *height = count * kChildSize;
+            break;
+        case WEIGHTED_CHAIN:
+        default:
+            makeWeightedChain(layout, c, count);
+            *width = count * kChildSize;
+            *height = kChildSize;
+            break;
+        }
+        return layout;
+    }
+
+    /**
+     * 所有子 View 的位置和大小的散列值，用于比较不同实现的布局结果。
+     */
+    uint64_t checksumBounds(const ukive::RestraintLayout* layout) {
+        uint64_t sum = 14695981039346656037ULL;
+        for (size_t i = 0; i < layout->getChildCount(); ++i) {
+            auto b = layout->getChildAt(i)->getBounds();
+            for (int v : { b.x(), b.y(), b.width(), b.height() }) {
+                sum = (sum ^ uint32_t(v)) * 1099511628211ULL;
+            }
+        }
+        return sum;
+    }
+
+}
+
+namespace ukive {
+
+    void runRestraintLayoutBenchmark() {
+        LOG(Log::INFO) << "RestraintLayout benchmark, measure + layout per pass:";
+
+        Context c;
+        for (auto& graph : kGraphs) {
+            for (int count : { 250, 500, 1000, 2000 }) {
+                int width, height;
+                std::unique_ptr<RestraintLayout> layout(
+                    makeLayout(c, graph.type, count, &width, &height));
+
+                SizeInfo info(
+                    SizeInfo::Value(width, SizeInfo::DEFINED),
+                    SizeInfo::Value(height, SizeInfo::DEFINED));
+
+                uint64_t elapsed = 0;
+                for (int r = 0; r < kRounds; ++r) {
+                    // 清空测量缓存，使每一轮都完整地求解
+                    for (size_t i = 0; i < layout->getChildCount(); ++i) {
+                        layout->getChildAt(i)->requestLayout();
+                    }
+
+                    auto start = utl::TimeUtils::upTimeNanos();
+                    layout->determineSize(info);
+                    layout->layout(Rect(0, 0, width, height));
+                    elapsed += utl::TimeUtils::upTimeNanos() - start;
+                }
+
+                auto pass_us = double(elapsed) / kRounds / 1000.0;
+                LOG(Log::INFO) << "  " << graph.name << ", " << count << " children: "
+                    << pass_us << " us/pass, "
+                    << (pass_us * 1000.0 / count) << " ns/child, bounds checksum "
+                    << std::hex << checksumBounds(layout.get()) << std::dec;
+            }
+        }
+    }
+
+}
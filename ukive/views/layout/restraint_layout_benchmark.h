@@ -0,0 +1,27 @@
+// Copyright (c) 2016 ucclkp <ucclkp@gmail.com>.
+// This file is part of ukive project.
+//
+// This program is licensed under GPLv3 license that can be
+// found in the LICENSE file.
+
+#ifndef UKIVE_VIEWS_LAYOUT_RESTRAINT_LAYOUT_BENCHMARK_H_
+#define UKIVE_VIEWS_LAYOUT_RESTRAINT_LAYOUT_BENCHMARK_H_
+
+
+namespace ukive {
+
+    /**
+     * 测量 RestraintLayout 在不同子 View 数量（最多 2000 个）下完整测量和布局一次的耗时，
+     * 结果写入日志。图的形状包括大小固定的网格、CH_FILL 链、CH_WRAP 链和带权重的链，
+     * 每个子 View 的耗时应基本不随数量变化。
+     *
+     * 每项结果附带所有子 View 位置和大小的校验和。与拓扑序求解之前的递归实现比较时，
+     * 将 restraint_layout.{h,cpp} 和 restraint_layout_info.{h,cpp} 换成
+     * 提交 "Solve RestraintLayout in topological order" 之前的版本后重新运行，
+     * 两次的校验和应相同。
+     */
+    void runRestraintLayoutBenchmark();
+
+}
+
+#endif  // UKIVE_VIEWS_LAYOUT_RESTRAINT_LAYOUT_BENCHMARK_H_
@@ -16,24 +16,28 @@ namespace ukive {
     RestraintLayoutInfo* RestraintLayoutInfo::startHandle(long long handle_id, Edge handle_edge) {
         start_handle_id = handle_id;
         start_handle_edge = handle_edge;
+        is_handle_resolved = false;
         return this;
     }
 
     RestraintLayoutInfo* RestraintLayoutInfo::topHandle(long long handle_id, Edge handle_edge) {
         top_handle_id = handle_id;
         top_handle_edge = handle_edge;
+        is_handle_resolved = false;
         return this;
     }
 
     RestraintLayoutInfo* RestraintLayoutInfo::endHandle(long long handle_id, Edge handle_edge) {
         end_handle_id = handle_id;
         end_handle_edge = handle_edge;
+        is_handle_resolved = false;
         return this;
     }
 
     RestraintLayoutInfo* RestraintLayoutInfo::bottomHandle(long long handle_id, Edge handle_edge) {
         bottom_handle_id = handle_id;
         bottom_handle_edge = handle_edge;
+        is_handle_resolved = false;
         return this;
     }
 
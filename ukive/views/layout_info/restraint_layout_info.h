@@ -13,6 +13,8 @@
 
 namespace ukive {
 
+    class View;
+
     class RestraintLayoutInfo : public LayoutInfo {
     public:
         enum Edge {
@@ -33,18 +35,25 @@ namespace ukive {
         ~RestraintLayoutInfo();
 
         // 保存在一次测量过程中与该 LayoutInfo 绑定的 View
-        // 的测量信息。注意记得在测量过程开始前清除该标记。
+        // 的测量信息。由 RestraintLayout 在每次测量时按拓扑序重新计算。
         SizeInfo::Value width_info;
         SizeInfo::Value height_info;
-        bool is_width_determined = false;
-        bool is_height_determined = false;
+
+        // 沿各个 handle 链累计的、链上其他 View 所占据的空间（不含自身的 margin）。
+        int start_spacing = 0;
+        int top_spacing = 0;
+        int end_spacing = 0;
+        int bottom_spacing = 0;
+
+        // 在测量宽度时是否需要预先测量该 View。
+        bool is_width_premeasured = false;
+        bool is_in_start_chain = false;
+        bool is_in_end_chain = false;
 
         // 保存在一次布局过程中与该 LayoutInfo 绑定的 View
-        // 的布局信息。注意记得在布局过程开始前清除该标记。
-        int left, right;
-        int top, bottom;
-        bool is_vert_layouted = false;
-        bool is_hori_layouted = false;
+        // 的布局信息。
+        int left = 0, right = 0;
+        int top = 0, bottom = 0;
 
         int vert_weight = 0;
         int hori_weight = 0;
@@ -64,6 +73,15 @@ namespace ukive {
         long long bottom_handle_id;
         Edge bottom_handle_edge = NONE;
 
+        // 由 RestraintLayout 解析得到的 handle 所绑定的兄弟 View。
+        // handle 未设置或绑定于父 View 时为 nullptr。
+        // 请使用 xxxHandle() 方法修改 handle，以使该缓存失效。
+        View* start_handle_view = nullptr;
+        View* top_handle_view = nullptr;
+        View* end_handle_view = nullptr;
+        View* bottom_handle_view = nullptr;
+        bool is_handle_resolved = false;
+
         RestraintLayoutInfo* startHandle(long long handle_id, Edge handle_edge);
         RestraintLayoutInfo* topHandle(long long handle_id, Edge handle_edge);
         RestraintLayoutInfo* endHandle(long long handle_id, Edge handle_edge);
@@ -33,6 +33,7 @@ namespace ukive {
         size_t pos = cur_pos_;
         int offset = cur_offset_;
         auto item_count = source_->onGetListDataCount(parent_);
+        syncHeightIndex(item_count);
 
         parent_->freezeLayout();
 
@@ -56,7 +57,7 @@ namespace ukive {
                 }
             }
 
-            auto item_size = parent_->determineItemSize(item, width);
+            auto item_size = determineItemSize(item, width);
             total_height += item_size.height();
         }
 
@@ -65,7 +66,7 @@ namespace ukive {
                 auto item = parent_->makeNewItem(i, 0);
                 column_.addItem(item, 0);
 
-                auto item_size = parent_->determineItemSize(item, width);
+                auto item_size = determineItemSize(item, width);
                 total_height += item_size.height();
 
                 ++index;
@@ -101,6 +102,7 @@ namespace ukive {
         int total_height = 0;
         auto item_count = source_->onGetListDataCount(parent_);
         auto bounds = parent_->getContentBounds();
+        syncHeightIndex(item_count);
 
         size_t pos = cur ? cur_pos_ : 0;
         int offset = cur ? cur_offset_ : 0;
@@ -115,7 +117,7 @@ namespace ukive {
             auto item = column_.getItem(index);
             ubassert(item);
 
-            auto item_size = parent_->determineItemSize(item, bounds.width());
+            auto item_size = determineItemSize(item, bounds.width());
             parent_->layoutItem(
                 item,
                 bounds.x(),  bounds.y() + total_height - offset,
@@ -153,6 +155,7 @@ namespace ukive {
         int total_height = 0;
         auto item_count = source_->onGetListDataCount(parent_);
         auto bounds = parent_->getContentBounds();
+        syncHeightIndex(item_count);
 
         pos = cur ? cur_pos_ : pos;
         offset = cur ? cur_offset_ : offset;
@@ -178,7 +181,7 @@ namespace ukive {
                 parent_->setItemData(item, i);
             }
 
-            auto item_size = parent_->determineItemSize(item, bounds.width());
+            auto item_size = determineItemSize(item, bounds.width());
             parent_->layoutItem(
                 item,
                 bounds.x(), bounds.y() + total_height - offset,
@@ -223,62 +226,13 @@ namespace ukive {
             offset = 0;
         }
 
-        auto start_pos = cur_pos_;
-        auto start_pos_offset = cur_offset_;
-        auto terminate_pos = pos;
-        auto terminate_pos_offset = offset;
-        bool front = (start_pos <= terminate_pos);
-        auto bounds = parent_->getContentBounds();
-
-        auto i = start_pos;
-        size_t index = 0;
-        int total_height = 0;
-
-        parent_->freezeLayout();
-
-        for (; (front ? (i <= terminate_pos) : (i-- > terminate_pos)); (front ? ++i : 0), ++index) {
-            auto item = column_.findAndInsertItem(index, source_->onGetListItemId(parent_, i));
-            if (!item || item->item_id != source_->onGetListItemId(parent_, i)) {
-                item = parent_->makeNewItem(i, index);
-                column_.addItem(item, index);
-            } else {
-                parent_->setItemData(item, i);
-            }
-
-            auto item_size = parent_->determineItemSize(item, bounds.width());
-            parent_->layoutItem(
-                item,
-                bounds.x(), bounds.y() + total_height + (front ? -offset : offset),
-                item_size.width(), item_size.height());
-
-            if (front) {
-                if (i == terminate_pos) {
-                    item_size.height(terminate_pos_offset);
-                }
-                if (i == start_pos) {
-                    item_size.height(item_size.height() - start_pos_offset);
-                }
-                if (i != start_pos && i != terminate_pos) {
-                    item_size.height(front ? item_size.height() : -item_size.height());
-                }
-            } else {
-                if (i == start_pos) {
-                    item_size.height(start_pos_offset);
-                }
-                if (i == terminate_pos) {
-                    item_size.height(item_size.height() - terminate_pos_offset);
-                }
-                if (i != start_pos && i != terminate_pos) {
-                    item_size.height(front ? item_size.height() : -item_size.height());
-                }
-            }
-
-            total_height += item_size.height();
-        }
+        // 通过高度索引直接换算出滚动距离，无需创建途经的所有项。
+        // 未测量过的项使用估计高度，滚动过程中填充的项会使用实际高度。
+        syncHeightIndex(item_count);
+        auto start = heights_.getOffset(cur_pos_) + cur_offset_;
+        auto terminate = heights_.getOffset(pos) + offset;
 
-        parent_->unfreezeLayout();
-
-        return -total_height;
+        return int(start - terminate);
     }
 
     int LinearListLayouter::onFillTopChildren(int dy) {
@@ -303,7 +257,7 @@ namespace ukive {
 
             auto new_item = parent_->makeNewItem(cur_data_pos, 0);
 
-            auto item_size = parent_->determineItemSize(new_item, bounds.width());
+            auto item_size = determineItemSize(new_item, bounds.width());
             parent_->layoutItem(
                 new_item,
                 bounds.x(), column_.getItemsTop() - item_size.height(),
@@ -342,12 +296,15 @@ namespace ukive {
 
         int inc_y = 0;
         int distance_y = bottom_item->getBottom() + dy - bounds.bottom();
-        while (cur_data_pos + 1 < source_->onGetListDataCount(parent_) && !column_.isBottomFilled(dy)) {
+        auto item_count = source_->onGetListDataCount(parent_);
+        syncHeightIndex(item_count);
+
+        while (cur_data_pos + 1 < item_count && !column_.isBottomFilled(dy)) {
             ++cur_data_pos;
 
             auto new_item = parent_->makeNewItem(cur_data_pos, parent_->getChildCount());
 
-            auto item_size = parent_->determineItemSize(new_item, bounds.width());
+            auto item_size = determineItemSize(new_item, bounds.width());
             parent_->layoutItem(
                 new_item,
                 bounds.x(), column_.getItemsBottom(),
@@ -379,10 +336,41 @@ namespace ukive {
 
     void LinearListLayouter::onClear() {
         column_.clear();
+        heights_.reset(0);
         cur_pos_ = 0;
         cur_offset_ = 0;
     }
 
+    void LinearListLayouter::onDataChanged() {
+        size_t count = isAvailable() ? source_->onGetListDataCount(parent_) : 0;
+        heights_.reset(count);
+    }
+
+    void LinearListLayouter::onItemInserted(size_t start_pos, size_t count) {
+        heights_.insert(start_pos, count);
+
+        // 保持当前可见的项不变
+        if (start_pos < cur_pos_) {
+            cur_pos_ += count;
+        }
+    }
+
+    void LinearListLayouter::onItemChanged(size_t start_pos, size_t count) {
+        heights_.invalidate(start_pos, count);
+    }
+
+    void LinearListLayouter::onItemRemoved(size_t start_pos, size_t count) {
+        heights_.remove(start_pos, count);
+
+        if (start_pos + count <= cur_pos_) {
+            cur_pos_ -= count;
+        } else if (start_pos <= cur_pos_) {
+            // 当前可见的第一项已被移除
+            cur_pos_ = start_pos;
+            cur_offset_ = 0;
+        }
+    }
+
     void LinearListLayouter::recordCurPositionAndOffset() {
         if (!isAvailable()) {
             return;
@@ -410,46 +398,69 @@ namespace ukive {
             return;
         }
 
-        auto item_count = column_.getItemCount();
-        if (item_count == 0) {
+        auto fv_item = column_.getFirstVisible();
+        if (!fv_item) {
             *prev = 0; *next = 0;
             return;
         }
 
-        // 计算当前已测量的 View 高度的平均值
-        int det_height = 0;
-        for (size_t i = 0; i < item_count; ++i) {
-            auto item = column_.getItem(i);
-            if (item) {
-                det_height += item->getHeight();
-            }
+        // 已测量过的项使用实际高度，从未测量过的项使用估计高度
+        syncHeightIndex(count);
+        auto prev_total_height = heights_.getOffset(fv_item->data_pos) + cur_offset_;
+        auto next_total_height = heights_.getTotalHeight() - prev_total_height;
+
+        *prev = int(prev_total_height);
+        *next = int(next_total_height);
+    }
+
+    bool LinearListLayouter::findPositionAtOffset(int offset, size_t* pos, int* item_offset) {
+        if (!isAvailable()) {
+            return false;
         }
-        int avgc_height = int((det_height + item_count - 1) / item_count);
 
-        // 计算之前的高度
-        auto f_item = column_.getFront();
-        auto fv_item = column_.getFirstVisible();
-        if (!fv_item) {
-            *prev = 0; *next = 0;
+        syncHeightIndex(source_->onGetListDataCount(parent_));
+        return heights_.findPosition(offset, pos, item_offset);
+    }
+
+    void LinearListLayouter::getPrefetchPositions(
+        bool down, int distance, size_t max_count, std::vector<size_t>* positions)
+    {
+        positions->clear();
+        if (!isAvailable() || distance <= 0 || max_count == 0) {
             return;
         }
 
-        size_t i;
-        int prev_total_height = int(cur_offset_ + f_item->data_pos * avgc_height);
-        for (i = 0; i < fv_item->data_pos - f_item->data_pos; ++i) {
-            prev_total_height += column_.getItem(i)->getHeight();
-        }
+        auto count = source_->onGetListDataCount(parent_);
+        syncHeightIndex(count);
 
-        // 计算之后的高度
-        auto l_item = column_.getRear();
+        if (down) {
+            auto rear = column_.getRear();
+            if (!rear) {
+                return;
+            }
 
-        int next_total_height = int(-cur_offset_ + (count - l_item->data_pos - 1) * avgc_height);
-        for (; i <= l_item->data_pos - f_item->data_pos; ++i) {
-            next_total_height += column_.getItem(i)->getHeight();
-        }
+            auto start = rear->data_pos + 1;
+            auto base = heights_.getOffset(start);
+            for (auto i = start; i < count && positions->size() < max_count; ++i) {
+                if (heights_.getOffset(i) - base >= distance) {
+                    break;
+                }
+                positions->push_back(i);
+            }
+        } else {
+            auto front = column_.getFront();
+            if (!front) {
+                return;
+            }
 
-        *prev = prev_total_height;
-        *next = next_total_height;
+            auto base = heights_.getOffset(front->data_pos);
+            for (auto i = front->data_pos; i-- > 0 && positions->size() < max_count;) {
+                if (base - heights_.getOffset(i + 1) >= distance) {
+                    break;
+                }
+                positions->push_back(i);
+            }
+        }
     }
 
     ListItem* LinearListLayouter::findItemFromView(View* v) {
@@ -485,6 +496,19 @@ namespace ukive {
         if (offset) *offset = cur_offset_;
     }
 
+    Size LinearListLayouter::determineItemSize(ListItem* item, int width) {
+        auto item_size = parent_->determineItemSize(item, width);
+        heights_.setHeight(item->data_pos, item_size.height());
+        return item_size;
+    }
+
+    void LinearListLayouter::syncHeightIndex(size_t item_count) {
+        // 数据源可能未通知数量的变化
+        if (heights_.getCount() != item_count) {
+            heights_.resize(item_count);
+        }
+    }
+
     void LinearListLayouter::recycleTopChildren(int dy) {
         size_t index;
         if (column_.getIndexOfFirstVisible(dy, &index)) {
@@ -8,6 +8,7 @@
 #define UKIVE_VIEWS_LIST_LINEAR_LIST_LAYOUTER_H_
 
 #include "ukive/views/list/list_columns.h"
+#include "ukive/views/list/list_height_index.h"
 #include "ukive/views/list/list_layouter.h"
 
 
@@ -29,15 +30,28 @@ namespace ukive {
         int onFillRightChildren(int dx) override;
 
         void onClear() override;
+        void onDataChanged() override;
+        void onItemInserted(size_t start_pos, size_t count) override;
+        void onItemChanged(size_t start_pos, size_t count) override;
+        void onItemRemoved(size_t start_pos, size_t count) override;
 
         void recordCurPositionAndOffset() override;
         void computeTotalHeight(int* prev, int* next) override;
+        bool findPositionAtOffset(int offset, size_t* pos, int* item_offset) override;
+        void getPrefetchPositions(
+            bool down, int distance, size_t max_count, std::vector<size_t>* positions) override;
         ListItem* findItemFromView(View* v) override;
 
         bool canScroll(Direction dir) const override;
         void getCurPosition(size_t* pos, int* offset) const override;
 
     private:
+        /**
+         * 测量列表项，并将其高度记录到高度索引中。
+         */
+        Size determineItemSize(ListItem* item, int width);
+        void syncHeightIndex(size_t item_count);
+
         void recycleTopChildren(int dy);
         void recycleBottomChildren(int dy);
 
@@ -47,6 +61,7 @@ namespace ukive {
         bool canScrollToRight() const;
 
         Column column_;
+        ListHeightIndex heights_;
 
         size_t cur_pos_;
         int cur_offset_;
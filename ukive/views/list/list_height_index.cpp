@@ -0,0 +1,183 @@
+// Copyright (c) 2016 ucclkp <ucclkp@gmail.com>.
+// This file is part of ukive project.
+//
+// This program is licensed under GPLv3 license that can be
+// found in the LICENSE file.
+
+#include "ukive/views/list/list_height_index.h"
+
+#include <algorithm>
+
+
+namespace ukive {
+
+    ListHeightIndex::ListHeightIndex() {}
+
+    void ListHeightIndex::reset(size_t count) {
+        heights_.assign(count, kUnmeasured);
+        height_tree_.assign(count + 1, 0);
+        count_tree_.assign(count + 1, 0);
+        measured_height_ = 0;
+        measured_count_ = 0;
+    }
+
+    void ListHeightIndex::resize(size_t count) {
+        if (count == heights_.size()) {
+            return;
+        }
+        heights_.resize(count, kUnmeasured);
+        rebuild();
+    }
+
+    void ListHeightIndex::insert(size_t pos, size_t count) {
+        if (count == 0) {
+            return;
+        }
+        pos = (std::min)(pos, heights_.size());
+        heights_.insert(heights_.begin() + pos, count, kUnmeasured);
+        rebuild();
+    }
+
+    void ListHeightIndex::remove(size_t pos, size_t count) {
+        if (pos >= heights_.size() || count == 0) {
+            return;
+        }
+        count = (std::min)(count, heights_.size() - pos);
+        heights_.erase(heights_.begin() + pos, heights_.begin() + pos + count);
+        rebuild();
+    }
+
+    void ListHeightIndex::invalidate(size_t pos, size_t count) {
+        size_t end = (std::min)(pos + count, heights_.size());
+        for (size_t i = pos; i < end; ++i) {
+            if (heights_[i] != kUnmeasured) {
+                update(i, -heights_[i], -1);
+                heights_[i] = kUnmeasured;
+            }
+        }
+    }
+
+    void ListHeightIndex::setHeight(size_t pos, int height) {
+        if (pos >= heights_.size()) {
+            return;
+        }
+
+        height = (std::max)(0, height);
+        int old = heights_[pos];
+        if (old == height) {
+            return;
+        }
+
+        if (old == kUnmeasured) {
+            update(pos, height, 1);
+        } else {
+            update(pos, height - old, 0);
+        }
+        heights_[pos] = height;
+    }
+
+    size_t ListHeightIndex::getCount() const {
+        return heights_.size();
+    }
+
+    int ListHeightIndex::getEstimatedHeight() const {
+        if (measured_count_ == 0) {
+            return 0;
+        }
+        return int((measured_height_ + measured_count_ - 1) / measured_count_);
+    }
+
+    int64_t ListHeightIndex::getOffset(size_t pos) const {
+        pos = (std::min)(pos, heights_.size());
+
+        int64_t height = 0;
+        int64_t count = 0;
+        for (size_t i = pos; i > 0; i -= i & (~i + 1)) {
+            height += height_tree_[i];
+            count += count_tree_[i];
+        }
+        return height + (int64_t(pos) - count) * getEstimatedHeight();
+    }
+
+    int64_t ListHeightIndex::getTotalHeight() const {
+        return measured_height_
+            + int64_t(heights_.size() - measured_count_) * getEstimatedHeight();
+    }
+
+    bool ListHeightIndex::findPosition(int64_t offset, size_t* pos, int* item_offset) const {
+        size_t size = heights_.size();
+        if (size == 0) {
+            return false;
+        }
+
+        offset = (std::max)(int64_t(0), offset);
+        int64_t estimated = getEstimatedHeight();
+
+        size_t step = 1;
+        while ((step << 1) <= size) {
+            step <<= 1;
+        }
+
+        // 在树状数组上二分。下标 next 处的节点恰好覆盖 (index, next] 区间。
+        size_t index = 0;
+        int64_t acc = 0;
+        for (; step > 0; step >>= 1) {
+            size_t next = index + step;
+            if (next > size) {
+                continue;
+            }
+
+            int64_t val = height_tree_[next]
+                + (int64_t(step) - count_tree_[next]) * estimated;
+            if (acc + val <= offset) {
+                index = next;
+                acc += val;
+            }
+        }
+
+        if (index >= size) {
+            // offset 超出总高度，定位到最后一项
+            index = size - 1;
+            acc = getOffset(index);
+        }
+
+        *pos = index;
+        *item_offset = int(offset - acc);
+        return true;
+    }
+
+    void ListHeightIndex::rebuild() {
+        size_t size = heights_.size();
+        height_tree_.assign(size + 1, 0);
+        count_tree_.assign(size + 1, 0);
+        measured_height_ = 0;
+        measured_count_ = 0;
+
+        for (size_t i = 1; i <= size; ++i) {
+            int height = heights_[i - 1];
+            if (height != kUnmeasured) {
+                height_tree_[i] += height;
+                count_tree_[i] += 1;
+                measured_height_ += height;
+                ++measured_count_;
+            }
+
+            size_t parent = i + (i & (~i + 1));
+            if (parent <= size) {
+                height_tree_[parent] += height_tree_[i];
+                count_tree_[parent] += count_tree_[i];
+            }
+        }
+    }
+
+    void ListHeightIndex::update(size_t pos, int64_t height, int count) {
+        size_t size = heights_.size();
+        for (size_t i = pos + 1; i <= size; i += i & (~i + 1)) {
+            height_tree_[i] += height;
+            count_tree_[i] += count;
+        }
+        measured_height_ += height;
+        measured_count_ = size_t(int64_t(measured_count_) + count);
+    }
+
+}
@@ -0,0 +1,88 @@
+// Copyright (c) 2016 ucclkp <ucclkp@gmail.com>.
+// This file is part of ukive project.
+//
+// This program is licensed under GPLv3 license that can be
+// found in the LICENSE file.
+
+#ifndef UKIVE_VIEWS_LIST_LIST_HEIGHT_INDEX_H_
+#define UKIVE_VIEWS_LIST_LIST_HEIGHT_INDEX_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+namespace ukive {
+
+    /**
+     * 列表项高度的前缀和索引。
+     * 使用两个树状数组分别维护已测量项的高度之和与数量，
+     * 从未测量过的项使用所有已测量项的平均高度估算。
+     * 位置与偏移之间的换算为 O(log n)；插入和删除需要重建索引，为 O(n)。
+     */
+    class ListHeightIndex {
+    public:
+        ListHeightIndex();
+
+        /**
+         * 将项目数量设为 count，并清除所有已测量的高度。
+         */
+        void reset(size_t count);
+
+        /**
+         * 将项目数量设为 count，保留前面已测量的高度。
+         */
+        void resize(size_t count);
+
+        void insert(size_t pos, size_t count);
+        void remove(size_t pos, size_t count);
+
+        /**
+         * 将 [pos, pos + count) 范围内的项标记为未测量。
+         */
+        void invalidate(size_t pos, size_t count);
+
+        /**
+         * 记录位于 pos 的项的测量高度。pos 超出范围时忽略。
+         */
+        void setHeight(size_t pos, int height);
+
+        size_t getCount() const;
+        int getEstimatedHeight() const;
+
+        /**
+         * 获取位于 pos 的项的顶部到列表顶部的距离。
+         * pos 可以等于 getCount()，此时返回总高度。
+         */
+        int64_t getOffset(size_t pos) const;
+        int64_t getTotalHeight() const;
+
+        /**
+         * 查找覆盖 offset 的项。
+         * @param offset 到列表顶部的距离。
+         * @param pos 返回该项的位置。
+         * @param item_offset 返回 offset 到该项顶部的距离。
+         * @return 列表为空时返回 false。
+         */
+        bool findPosition(int64_t offset, size_t* pos, int* item_offset) const;
+
+    private:
+        static constexpr int kUnmeasured = -1;
+
+        void rebuild();
+        void update(size_t pos, int64_t height, int count);
+
+        // 原始高度，未测量的项为 kUnmeasured
+        std::vector<int> heights_;
+
+        // 树状数组，下标从 1 开始
+        std::vector<int64_t> height_tree_;
+        std::vector<int> count_tree_;
+
+        int64_t measured_height_ = 0;
+        size_t measured_count_ = 0;
+    };
+
+}
+
+#endif  // UKIVE_VIEWS_LIST_LIST_HEIGHT_INDEX_H_
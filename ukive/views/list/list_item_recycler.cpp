@@ -80,8 +80,95 @@ namespace ukive {
         for (auto& pair : recycled_items_) {
             utl::STLDeleteElements(&pair.second);
         }
+        for (auto& pair : prefetched_items_) {
+            delete pair.second;
+        }
 
         recycled_items_.clear();
+        prefetched_items_.clear();
+    }
+
+    ListItem* ListItemRecycler::take(int item_id) {
+        auto it = recycled_items_.find(item_id);
+        if (it == recycled_items_.end() || it->second.empty()) {
+            return nullptr;
+        }
+
+        auto item = it->second.back();
+        it->second.pop_back();
+        return item;
+    }
+
+    void ListItemRecycler::setWarmCount(int item_id, size_t count) {
+        if (count == 0) {
+            warm_counts_.erase(item_id);
+        } else {
+            warm_counts_[item_id] = count;
+        }
+    }
+
+    bool ListItemRecycler::needsWarmUp(int* item_id) const {
+        for (const auto& pair : warm_counts_) {
+            auto it = recycled_items_.find(pair.first);
+            size_t count = (it == recycled_items_.end()) ? 0 : it->second.size();
+            if (count < pair.second) {
+                *item_id = pair.first;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void ListItemRecycler::addPrefetched(ListItem* item) {
+        ubassert(item);
+
+        auto& slot = prefetched_items_[item->data_pos];
+        if (slot && slot != item) {
+            addToRecycler(slot);
+        }
+
+        item->recycled = true;
+        slot = item;
+    }
+
+    bool ListItemRecycler::hasPrefetched(size_t data_pos) const {
+        return prefetched_items_.find(data_pos) != prefetched_items_.end();
+    }
+
+    ListItem* ListItemRecycler::reusePrefetched(size_t data_pos, int item_id, size_t pos) {
+        auto it = prefetched_items_.find(data_pos);
+        if (it == prefetched_items_.end()) {
+            return nullptr;
+        }
+
+        auto item = it->second;
+        prefetched_items_.erase(it);
+
+        if (item->item_id != item_id) {
+            addToRecycler(item);
+            return nullptr;
+        }
+
+        addToParent(item, pos);
+        return item;
+    }
+
+    void ListItemRecycler::evictPrefetched(size_t first, size_t last) {
+        for (auto it = prefetched_items_.begin(); it != prefetched_items_.end();) {
+            if (it->first < first || it->first > last) {
+                addToRecycler(it->second);
+                it = prefetched_items_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    void ListItemRecycler::clearPrefetched() {
+        for (auto& pair : prefetched_items_) {
+            addToRecycler(pair.second);
+        }
+        prefetched_items_.clear();
     }
 
 }
\ No newline at end of file
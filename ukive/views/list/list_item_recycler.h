@@ -31,9 +31,51 @@ namespace ukive {
         size_t getRecycledCount(int item_id);
         void clear();
 
+        /**
+         * 取出一个已回收的项，但不将其添加到父 View 中。
+         */
+        ListItem* take(int item_id);
+
+        /**
+         * 设置类型为 item_id 的项的预热数量。
+         * 预取阶段会提前创建该类型的项，使回收池中至少保有 count 个，
+         * 以避免在滚动过程中调用 ListSource::onCreateListItem()。
+         */
+        void setWarmCount(int item_id, size_t count);
+
+        /**
+         * 查找回收池中数量不足预热数量的类型。
+         */
+        bool needsWarmUp(int* item_id) const;
+
+        /**
+         * 保存一个已绑定数据但尚未添加到父 View 的项。
+         * 该项绑定的数据位置由 item->data_pos 指定。
+         */
+        void addPrefetched(ListItem* item);
+        bool hasPrefetched(size_t data_pos) const;
+
+        /**
+         * 取出位于 data_pos 的预取项，并将其添加到父 View 的 pos 位置。
+         * 若不存在或类型不符，返回 nullptr。
+         */
+        ListItem* reusePrefetched(size_t data_pos, int item_id, size_t pos);
+
+        /**
+         * 将 [first, last] 范围之外的预取项放回回收池。
+         */
+        void evictPrefetched(size_t first, size_t last);
+
+        /**
+         * 将所有预取项放回回收池。数据发生变化时应调用此方法。
+         */
+        void clearPrefetched();
+
     private:
         LayoutView* parent_;
         std::map<int, std::vector<ListItem*>> recycled_items_;
+        std::map<int, size_t> warm_counts_;
+        std::map<size_t, ListItem*> prefetched_items_;
     };
 
 }
@@ -7,6 +7,8 @@
 #ifndef UKIVE_VIEWS_LIST_LIST_LAYOUTER_H_
 #define UKIVE_VIEWS_LIST_LIST_LAYOUTER_H_
 
+#include <vector>
+
 #include "ukive/graphics/size.hpp"
 #include "ukive/views/list/list_source.h"
 #include "ukive/views/size_info.h"
@@ -40,6 +42,11 @@ namespace ukive {
             int cw, int ch, SizeInfo::Mode wm, SizeInfo::Mode hm) = 0;
         virtual int onLayoutAtPosition(bool cur) = 0;
         virtual int onDataChangedAtPosition(size_t pos, int offset, bool cur) = 0;
+
+        /**
+         * 计算从当前位置平滑滚动到指定位置所需的距离。
+         * @return 子 View 需要移动的距离，正值表示向下移动。返回 0 表示无需滚动或不支持。
+         */
         virtual int onSmoothScrollToPosition(size_t pos, int offset) = 0;
 
         virtual int onFillTopChildren(int dy) = 0;
@@ -49,8 +56,32 @@ namespace ukive {
 
         virtual void onClear() = 0;
 
+        /**
+         * 数据源的数据发生变化时调用。
+         * 调用之后会紧接着调用 onDataChangedAtPosition() 刷新列表。
+         */
+        virtual void onDataChanged() {}
+        virtual void onItemInserted(size_t start_pos, size_t count) {}
+        virtual void onItemChanged(size_t start_pos, size_t count) {}
+        virtual void onItemRemoved(size_t start_pos, size_t count) {}
+
         virtual void recordCurPositionAndOffset() = 0;
         virtual void computeTotalHeight(int* prev, int* next) = 0;
+
+        /**
+         * 查找到列表顶部的距离为 offset 的项。
+         * @return 若不支持此操作，返回 false，此时调用方应逐项滚动。
+         */
+        virtual bool findPositionAtOffset(int offset, size_t* pos, int* item_offset) { return false; }
+
+        /**
+         * 获取沿滚动方向即将进入可见区域的项的位置，按距离由近到远排列。
+         * @param down 为 true 时表示内容向上移动（即查看下方的项）。
+         * @param distance 从可见区域边缘起算的预取距离，单位为像素。
+         * @param max_count 最多获取的数量。
+         */
+        virtual void getPrefetchPositions(
+            bool down, int distance, size_t max_count, std::vector<size_t>* positions) {}
         virtual ListItem* findItemFromView(View* v) = 0;
 
         virtual bool canScroll(Direction dir) const = 0;
@@ -47,6 +47,14 @@ namespace ukive {
             LayoutView* parent, size_t position) const { return 0; }
         virtual size_t onGetListDataCount(LayoutView* parent) const = 0;
 
+        /**
+         * 位于 position 的项即将沿滚动方向进入可见区域时，在 WorkerPool 的线程中调用，
+         * 返回后才会在 UI 线程中为该项调用 onSetListItemData()。
+         * 可在此处执行耗时的数据准备工作（如图像解码），但不能访问 parent 及任何 View。
+         * 同一 ListView 的调用不会并发；ListView 更换数据源或销毁时会等待正在执行的调用结束。
+         */
+        virtual void onPrepareListItemData(LayoutView* parent, size_t position) {}
+
     private:
         ListItemChangedNotifier* notifier_;
     };
@@ -7,11 +7,15 @@
 #include "list_view.h"
 
 #include <algorithm>
+#include <chrono>
+#include <cstdlib>
 
 #include "utils/log.h"
+#include "utils/message/message.h"
 
 #include "ukive/event/input_consts.h"
 #include "ukive/event/input_event.h"
+#include "ukive/system/worker_pool.h"
 #include "ukive/window/window.h"
 #include "ukive/views/layout_info/list_layout_info.h"
 #include "ukive/views/list/list_item_recycler.h"
@@ -21,6 +25,17 @@
 #include "ukive/views/list/list_item_event_router.h"
 
 
+namespace {
+
+    // 快速滚动时，预取接下来这么多帧将要滚过的距离
+    const int kPrefetchFrames = 8;
+
+    // 每次最多预取的项数
+    const size_t kMaxPrefetchCount = 16;
+
+}
+
+
 namespace ukive {
 
     ListView::ListView(Context c)
@@ -37,9 +52,25 @@ namespace ukive {
 
         recycler_ = std::make_unique<ListItemRecycler>(this);
 
+        using namespace std::chrono_literals;
+        prefetch_budget_ = 2ms;
+
+        cycler_.setListener(this);
+        prepare_state_ = std::make_shared<PrepareState>();
+        prepare_state_->parent = this;
+        prepare_state_->cycler = &cycler_;
+
         setTouchCapturable(true);
     }
 
+    ListView::~ListView() {
+        // 等待正在执行的准备任务结束，之后的任务不会再访问本对象
+        std::lock_guard<std::mutex> lg(prepare_state_->mutex);
+        prepare_state_->source = nullptr;
+        prepare_state_->parent = nullptr;
+        prepare_state_->cycler = nullptr;
+    }
+
     LayoutInfo* ListView::makeExtraLayoutInfo() const {
         return new ListLayoutInfo();
     }
@@ -271,6 +302,16 @@ namespace ukive {
         scroll_bar_->onDraw(canvas);
     }
 
+    void ListView::onPostDraw() {
+        LayoutView::onPostDraw();
+
+        // 投递到消息队列中，在本帧绘制完成之后执行
+        if (is_prefetch_pending_) {
+            is_prefetch_pending_ = false;
+            cycler_.post(MSG_PREFETCH);
+        }
+    }
+
     void ListView::onVSync(
         uint64_t start_time, uint32_t display_freq, uint32_t real_interval)
     {
@@ -281,11 +322,39 @@ namespace ukive {
                 scroller_.finish();
             }
             requestDraw();
+
+            if (!scroller_.isFinished() && display_freq > 0) {
+                prefetch_dy_ = dy;
+                prefetch_deadline_ = start_time + std::nano::den / display_freq;
+                is_prefetch_pending_ = true;
+            }
         } else {
             stopVSync();
         }
     }
 
+    void ListView::onHandleMessage(const utl::Message& msg) {
+        switch (msg.id) {
+        case MSG_PREFETCH:
+            prefetchItems();
+            break;
+
+        case MSG_PREPARED:
+        {
+            auto pos = size_t(msg.ui1);
+            if (msg.ui2 == prepare_state_->generation.load(std::memory_order_relaxed) &&
+                preparing_positions_.erase(pos) > 0)
+            {
+                prepared_positions_.insert(pos);
+            }
+            break;
+        }
+
+        default:
+            break;
+        }
+    }
+
     void ListView::requestLayout() {
         if (is_layout_frozen_) {
             return;
@@ -313,6 +382,11 @@ namespace ukive {
         }
 
         source_ = src;
+        {
+            // 等待正在执行的准备任务结束后再更换数据源
+            std::lock_guard<std::mutex> lg(prepare_state_->mutex);
+            prepare_state_->source = src;
+        }
 
         if (source_) {
             source_->setNotifier(this);
@@ -380,6 +454,18 @@ namespace ukive {
         }
     }
 
+    void ListView::setPrefetchOptions(int distance, utl::TimeUtils::nsp budget) {
+        prefetch_distance_ = (std::max)(0, distance);
+        prefetch_budget_ = budget;
+        if (prefetch_distance_ == 0) {
+            discardPrefetched();
+        }
+    }
+
+    void ListView::setWarmCount(int item_id, size_t count) {
+        recycler_->setWarmCount(item_id, count);
+    }
+
     ListLayouter* ListView::getLayouter() const {
         return layouter_.get();
     }
@@ -430,7 +516,16 @@ namespace ukive {
 
     ListItem* ListView::makeNewItem(size_t data_pos, size_t view_index) {
         int item_id = source_->onGetListItemId(this, data_pos);
-        auto new_item = recycler_->reuse(item_id, view_index);
+
+        // 预取时已绑定过数据，直接使用
+        auto new_item = recycler_->reusePrefetched(data_pos, item_id, view_index);
+        if (new_item) {
+            static_cast<ListLayoutInfo*>(
+                new_item->item_view->getExtraLayoutInfo())->item = new_item;
+            return new_item;
+        }
+
+        new_item = recycler_->reuse(item_id, view_index);
         if (!new_item) {
             new_item = source_->onCreateListItem(this, event_router_.get(), data_pos);
             auto li = new_item->item_view->getExtraLayoutInfo();
@@ -445,6 +540,137 @@ namespace ukive {
         return new_item;
     }
 
+    ListItem* ListView::makePrefetchedItem(size_t data_pos) {
+        int item_id = source_->onGetListItemId(this, data_pos);
+        auto item = recycler_->take(item_id);
+        if (!item) {
+            item = source_->onCreateListItem(this, event_router_.get(), data_pos);
+            auto li = item->item_view->getExtraLayoutInfo();
+            if (!li || !isValidExtraLayoutInfo(li)) {
+                item->item_view->setExtraLayoutInfo(makeExtraLayoutInfo());
+            }
+        }
+
+        item->item_id = item_id;
+        item->data_pos = data_pos;
+        source_->onSetListItemData(this, event_router_.get(), item);
+        recycler_->addPrefetched(item);
+        return item;
+    }
+
+    void ListView::prefetchItems() {
+        int dy = prefetch_dy_;
+        if (!layouter_ || !source_ || prefetch_distance_ <= 0 || dy == 0) {
+            return;
+        }
+
+        prefetch_start_ = utl::TimeUtils::upTimeNanos();
+        if (isPrefetchBudgetExceeded()) {
+            return;
+        }
+
+        int distance = (std::max)(prefetch_distance_, std::abs(dy) * kPrefetchFrames);
+        layouter_->getPrefetchPositions(
+            dy < 0, distance, kMaxPrefetchCount, &prefetch_positions_);
+        if (prefetch_positions_.empty()) {
+            return;
+        }
+
+        // 滚动方向改变后，之前预取的项不再需要
+        auto range = std::minmax_element(
+            prefetch_positions_.begin(), prefetch_positions_.end());
+        recycler_->evictPrefetched(*range.first, *range.second);
+        for (auto positions : { &preparing_positions_, &prepared_positions_ }) {
+            positions->erase(positions->begin(), positions->lower_bound(*range.first));
+            positions->erase(positions->upper_bound(*range.second), positions->end());
+        }
+
+        for (auto pos : prefetch_positions_) {
+            if (recycler_->hasPrefetched(pos)) {
+                continue;
+            }
+
+            // 数据准备完成后才创建项并绑定数据
+            if (prepared_positions_.count(pos) > 0) {
+                if (isPrefetchBudgetExceeded()) {
+                    return;
+                }
+                prepared_positions_.erase(pos);
+                makePrefetchedItem(pos);
+            } else if (preparing_positions_.count(pos) == 0) {
+                prepareItemData(pos);
+            }
+        }
+
+        warmUpItems();
+    }
+
+    void ListView::prepareItemData(size_t data_pos) {
+        preparing_positions_.insert(data_pos);
+
+        auto state = prepare_state_;
+        auto generation = state->generation.load(std::memory_order_relaxed);
+        WorkerPool::getInstance()->post([state, data_pos, generation]() {
+            std::lock_guard<std::mutex> lg(state->mutex);
+            if (!state->source ||
+                state->generation.load(std::memory_order_relaxed) != generation)
+            {
+                return;
+            }
+
+            state->source->onPrepareListItemData(state->parent, data_pos);
+
+            utl::Message* msg = utl::Message::get();
+            msg->id = MSG_PREPARED;
+            msg->ui1 = data_pos;
+            msg->ui2 = generation;
+            state->cycler->post(msg);
+        });
+    }
+
+    void ListView::warmUpItems() {
+        int item_id;
+        while (recycler_->needsWarmUp(&item_id)) {
+            if (isPrefetchBudgetExceeded()) {
+                return;
+            }
+
+            // 需要一个该类型的数据位置来创建项
+            bool found = false;
+            for (auto pos : prefetch_positions_) {
+                if (source_->onGetListItemId(this, pos) == item_id) {
+                    auto item = source_->onCreateListItem(this, event_router_.get(), pos);
+                    auto li = item->item_view->getExtraLayoutInfo();
+                    if (!li || !isValidExtraLayoutInfo(li)) {
+                        item->item_view->setExtraLayoutInfo(makeExtraLayoutInfo());
+                    }
+                    item->item_id = item_id;
+                    recycler_->addToRecycler(item);
+                    found = true;
+                    break;
+                }
+            }
+
+            if (!found) {
+                return;
+            }
+        }
+    }
+
+    bool ListView::isPrefetchBudgetExceeded() const {
+        // 不能超出本帧剩余的时间，也不能超出设定的预算
+        auto now = utl::TimeUtils::upTimeNanos();
+        return now >= prefetch_deadline_ ||
+            now - prefetch_start_ >= uint64_t(prefetch_budget_.count());
+    }
+
+    void ListView::discardPrefetched() {
+        recycler_->clearPrefetched();
+        preparing_positions_.clear();
+        prepared_positions_.clear();
+        prepare_state_->generation.fetch_add(1, std::memory_order_relaxed);
+    }
+
     void ListView::setItemData(ListItem* item, size_t data_pos) {
         item->data_pos = data_pos;
         static_cast<ListLayoutInfo*>(
@@ -620,10 +846,11 @@ namespace ukive {
             return;
         }
 
-        int total_height = layouter_->onSmoothScrollToPosition(pos, offset);
-        if (total_height != 0) {
+        int dy = layouter_->onSmoothScrollToPosition(pos, offset);
+        if (dy != 0) {
             scroller_.finish();
-            recordCurPositionAndOffset();
+            scroller_.linear(0, dy, std::chrono::milliseconds(300));
+            startVSync();
         }
     }
 
@@ -632,6 +859,19 @@ namespace ukive {
         if (layouter_) {
             layouter_->computeTotalHeight(&prev, &next);
         }
+
+        // 跨度超过一屏时直接定位到目标项，避免逐项创建途经的所有项
+        size_t pos;
+        int item_offset;
+        if (layouter_ && std::abs(prev - dy) > getContentBounds().height() &&
+            layouter_->findPositionAtOffset(dy, &pos, &item_offset))
+        {
+            refreshAtPosition(pos, item_offset, false);
+            updateOverlayScrollBar();
+            requestDraw();
+            return;
+        }
+
         int final_dy = determineVerticalScroll(prev - dy);
         if (final_dy == 0) {
             return;
@@ -644,6 +884,10 @@ namespace ukive {
     }
 
     void ListView::onDataChanged() {
+        discardPrefetched();
+        if (layouter_) {
+            layouter_->onDataChanged();
+        }
         recordCurPositionAndOffset();
         refreshAtPosition(0, 0, true);
         updateOverlayScrollBar();
@@ -652,19 +896,37 @@ namespace ukive {
 
     void ListView::onItemInserted(size_t start_pos, size_t count) {
         if (count > 0) {
-            //TODO: post insert op.
+            discardPrefetched();
+            if (layouter_) {
+                layouter_->onItemInserted(start_pos, count);
+            }
+            refreshAtPosition(0, 0, true);
+            updateOverlayScrollBar();
+            requestDraw();
         }
     }
 
     void ListView::onItemChanged(size_t start_pos, size_t count) {
         if (count > 0) {
-            //TODO: post change op.
+            discardPrefetched();
+            if (layouter_) {
+                layouter_->onItemChanged(start_pos, count);
+            }
+            refreshAtPosition(0, 0, true);
+            updateOverlayScrollBar();
+            requestDraw();
         }
     }
 
     void ListView::onItemRemoved(size_t start_pos, size_t count) {
         if (count > 0) {
-            //TODO: post remove op.
+            discardPrefetched();
+            if (layouter_) {
+                layouter_->onItemRemoved(start_pos, count);
+            }
+            refreshAtPosition(0, 0, true);
+            updateOverlayScrollBar();
+            requestDraw();
         }
     }
 
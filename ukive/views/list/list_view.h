@@ -7,7 +7,14 @@
 #ifndef UKIVE_VIEWS_LIST_LIST_VIEW_H_
 #define UKIVE_VIEWS_LIST_LIST_VIEW_H_
 
+#include <atomic>
 #include <memory>
+#include <mutex>
+#include <set>
+#include <vector>
+
+#include "utils/message/cycler.h"
+#include "utils/time_utils.h"
 
 #include "ukive/animation/scroller.h"
 #include "ukive/event/velocity_calculator.h"
@@ -35,11 +42,13 @@ namespace ukive {
     class ListView :
         public LayoutView,
         public ListItemChangedNotifier,
-        public VSyncable
+        public VSyncable,
+        public utl::CyclerListener
     {
     public:
         explicit ListView(Context c);
         ListView(Context c, AttrsRef attrs);
+        ~ListView();
 
         void setSource(ListSource* src);
         void setLayouter(ListLayouter* layouter);
@@ -48,6 +57,22 @@ namespace ukive {
         void setChildRecycledListener(ListItemRecycledListener* l);
         void setItemEventRouter(ListItemEventRouter* router);
 
+        /**
+         * 设置预取参数。启用后，在滚动动画的每一帧绘制完成之后，会沿滚动方向为即将
+         * 进入可见区域的项在 WorkerPool 中调用 ListSource::onPrepareListItemData()，
+         * 准备完成的项随后在 UI 线程中提前创建并绑定数据。
+         * 快速滚动时，预取距离会按当前速度相应增大。
+         * @param distance 从可见区域边缘起算的最小预取距离，单位为像素。为 0 时禁用预取。
+         * @param budget 每一帧中预取可占用的最长时间。实际可用的时间不会超出该帧剩余的时间。
+         */
+        void setPrefetchOptions(int distance, utl::TimeUtils::nsp budget);
+
+        /**
+         * 设置类型为 item_id 的项的预热数量。参见 ListItemRecycler::setWarmCount()。
+         * 仅在启用预取时生效。
+         */
+        void setWarmCount(int item_id, size_t count);
+
         ListItem* findItemFromView(View* v) const;
 
         ListLayouter* getLayouter() const;
@@ -68,12 +93,35 @@ namespace ukive {
         bool onInputEvent(InputEvent* e) override;
         void onDraw(Canvas* canvas) override;
         void onDrawOverChildren(Canvas* canvas) override;
+        void onPostDraw() override;
 
         // VSyncCallback
         void onVSync(
             uint64_t start_time, uint32_t display_freq, uint32_t real_interval) override;
 
+        // utl::CyclerListener
+        void onHandleMessage(const utl::Message& msg) override;
+
     private:
+        enum MsgType {
+            MSG_PREFETCH = 0,
+            MSG_PREPARED,
+        };
+
+        /**
+         * 在 WorkerPool 中准备数据时所需的状态，由 ListView 与已提交的任务共享。
+         * 任务持有 mutex 调用 ListSource，因此 ListView 更换数据源或销毁时，
+         * 只需在持有 mutex 时清空 source，即可保证之后不会再有任务访问旧的数据源。
+         */
+        struct PrepareState {
+            std::mutex mutex;
+            ListSource* source = nullptr;
+            LayoutView* parent = nullptr;
+            utl::Cycler* cycler = nullptr;
+            // 数据变化时递增，旧的准备结果随之作废
+            std::atomic<uint64_t> generation{ 0 };
+        };
+
         struct SizeCache {
             bool available = false;
             int width = 0;
@@ -88,6 +136,12 @@ namespace ukive {
         void offsetChildrenVertical(int dy);
 
         ListItem* makeNewItem(size_t data_pos, size_t view_index);
+        ListItem* makePrefetchedItem(size_t data_pos);
+        void prefetchItems();
+        void prepareItemData(size_t data_pos);
+        void warmUpItems();
+        bool isPrefetchBudgetExceeded() const;
+        void discardPrefetched();
         void setItemData(ListItem* item, size_t data_pos);
         void recycleItem(ListItem* item);
 
@@ -136,6 +190,23 @@ namespace ukive {
         bool is_layout_frozen_ = false;
         bool is_sec_dim_unknown_ = false;
 
+        int prefetch_distance_ = 0;
+        utl::TimeUtils::nsp prefetch_budget_;
+        std::vector<size_t> prefetch_positions_;
+
+        // 最近一帧的滚动距离，以及本轮预取的起始时间和截止时间
+        int prefetch_dy_ = 0;
+        bool is_prefetch_pending_ = false;
+        uint64_t prefetch_start_ = 0;
+        uint64_t prefetch_deadline_ = 0;
+
+        // 已提交到 WorkerPool 以及已准备完数据的位置
+        std::set<size_t> preparing_positions_;
+        std::set<size_t> prepared_positions_;
+        std::shared_ptr<PrepareState> prepare_state_;
+
+        utl::Cycler cycler_;
+
         friend class FlowListLayouter;
         friend class GridListLayouter;
         friend class LinearListLayouter;
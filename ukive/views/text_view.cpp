@@ -190,6 +190,8 @@ namespace ukive {
         }
 
         setFocusable(is_editable_ | is_selectable_);
+        // 双击选中单词，见 performDoubleClick()
+        setDoubleClickable(is_editable_ | is_selectable_);
     }
 
     int TextView::determineWidth(const SizeInfo::Value& width) {
@@ -464,11 +466,11 @@ namespace ukive {
 
         size_t hit_pos;
         if (isTextAtPoint(x, y, &hit_pos)) {
-            for (size_t i = base_text_->getSpanCount(); i > 0; --i) {
-                auto span = base_text_->getSpan(i - 1);
-                if (span->getType() == Span::INTERACTABLE &&
-                    hit_pos >= span->getStart() && hit_pos < span->getEnd())
-                {
+            std::vector<Span*> spans;
+            base_text_->getSpans(Range(hit_pos, 0), &spans);
+            for (auto it = spans.rbegin(); it != spans.rend(); ++it) {
+                auto span = *it;
+                if (span->getType() == Span::INTERACTABLE) {
                     return static_cast<InteractableSpan*>(span)->onInputEvent(e);
                 }
             }
@@ -606,7 +608,7 @@ namespace ukive {
             text_layout_.reset();
         }
 
-        text_layout_.reset(TextLayout::create());
+        text_layout_ = std::make_unique<ParagraphTextLayout>();
         text_layout_->make(
             base_text_->getString(),
             font_family_name_,
@@ -629,17 +631,23 @@ namespace ukive {
         text_layout_->setVertAlignment(vert_alignment_);
         text_layout_->setDefaultFontColor(text_color);
 
-        applyFontAttrSpans();
-        applyOtherSpans();
+        Range range(0, base_text_->length());
+        applyFontAttrSpans(range);
+        applyOtherSpans(range);
     }
 
-    void TextView::applyFontAttrSpans() {
-        for (size_t i = 0; i < base_text_->getSpanCount(); ++i) {
-            auto span = base_text_->getSpan(i);
-
+    void TextView::applyFontAttrSpans(const Range& bounds) {
+        // 只取出与 bounds 重叠的 Span
+        std::vector<Span*> spans;
+        base_text_->getSpans(bounds, &spans);
+        for (auto span : spans) {
             Range range;
             range.pos = span->getStart();
             range.length = span->getEnd() - span->getStart();
+            range.same(bounds);
+            if (range.empty()) {
+                continue;
+            }
 
             switch (span->getType()) {
             case Span::FONT_ATTRIBUTES:
@@ -660,13 +668,18 @@ namespace ukive {
         }
     }
 
-    void TextView::applyOtherSpans() {
-        for (size_t i = 0; i < base_text_->getSpanCount(); ++i) {
-            auto span = base_text_->getSpan(i);
-
+    void TextView::applyOtherSpans(const Range& bounds) {
+        // 只取出与 bounds 重叠的 Span
+        std::vector<Span*> spans;
+        base_text_->getSpans(bounds, &spans);
+        for (auto span : spans) {
             Range range;
             range.pos = span->getStart();
             range.length = span->getEnd() - span->getStart();
+            range.same(bounds);
+            if (range.empty()) {
+                continue;
+            }
 
             switch (span->getType()) {
             case Span::DRAWING_EFFECTS:
@@ -707,9 +720,12 @@ namespace ukive {
         attrs.style = font_style_;
         attrs.weight = font_weight_;
         attrs.name = font_family_name_;
-        text_layout_->setFontAttributes(
-            attrs, Range(0, base_text_->getString().length()));
-        applyFontAttrSpans();
+
+        Range range(0, base_text_->length());
+        text_layout_->setDefaultFont(
+            font_family_name_, float(font_size_), font_style_, font_weight_);
+        text_layout_->setFontAttributes(attrs, range);
+        applyFontAttrSpans(range);
     }
 
     void TextView::locateTextBlink(size_t position) {
@@ -816,7 +832,14 @@ namespace ukive {
         }
 
         text_blink_->draw(canvas);
-        text_layout_->draw(canvas, 0, 0);
+
+        // 只绘制可见区域内的段落
+        text_layout_->setDrawingRegion(RectF(
+            float(getScrollX() - space_.start()),
+            float(getScrollY() - space_.top()),
+            float(getWidth() - getPadding().hori()),
+            float(getHeight() - getPadding().vert())));
+        canvas->drawTextLayout(0, 0, text_layout_.get());
 
         canvas->restore();
     }
@@ -1102,6 +1125,19 @@ namespace ukive {
         return result;
     }
 
+    void TextView::performDoubleClick() {
+        super::performDoubleClick();
+
+        // 双击时选中光标处的单词。拖动选择了文本时保留原选择
+        if (!(is_selectable_ || is_editable_) || hasSelection()) {
+            return;
+        }
+
+        size_t start, end;
+        base_text_->getWordRange(first_sel_, &start, &end);
+        base_text_->setSelection(start, end, Editable::Reason::USER_INPUT);
+    }
+
     bool TextView::onCheckIsTextEditor() {
         return is_editable_;
     }
@@ -1178,6 +1214,7 @@ namespace ukive {
         }
 
         is_editable_ = editable;
+        setDoubleClickable(is_editable_ | is_selectable_);
 
         if (editable) {
             setFocusable(true);
@@ -1199,6 +1236,7 @@ namespace ukive {
         }
 
         is_selectable_ = selectable;
+        setDoubleClickable(is_editable_ | is_selectable_);
 
         if (selectable) {
             setFocusable(true);
@@ -1523,9 +1561,16 @@ namespace ukive {
             l->onBeforeTextChanged(this, rc, r);
         }
 
-        auto max_width = text_layout_->getMaxWidth();
-        auto max_height = text_layout_->getMaxHeight();
-        makeNewTextLayout(max_width, max_height, isAutoWrap());
+        // 只重新排版受影响的段落，新段落上的 Span 需要重新应用
+        Range dirty;
+        if (text_layout_->update(base_text_->getStorage(), rc, &dirty)) {
+            applyFontAttrSpans(dirty);
+            applyOtherSpans(dirty);
+        } else {
+            auto max_width = text_layout_->getMaxWidth();
+            auto max_height = text_layout_->getMaxHeight();
+            makeNewTextLayout(max_width, max_height, isAutoWrap());
+        }
 
         // 开启自动换行时，如果 View 是随内容扩大的话，
         // 使用输入法在文本末尾输入文字时可能出现候选框跳变的现象，
@@ -11,6 +11,7 @@
 #include "ukive/text/editable.h"
 #include "ukive/text/text_action_menu_callback.h"
 #include "ukive/text/text_input_client.h"
+#include "ukive/text/paragraph_text_layout.h"
 #include "ukive/text/text_layout.h"
 #include "ukive/views/view.h"
 
@@ -106,6 +107,7 @@ namespace ukive {
         void onDraw(Canvas* canvas) override;
         Size onDetermineSize(const SizeInfo& info) override;
         bool onInputEvent(InputEvent* e) override;
+        void performDoubleClick() override;
 
         void onLayout(
             const Rect& new_bounds, const Rect& old_bounds) override;
@@ -165,8 +167,8 @@ namespace ukive {
         bool getTextBlinkLocation(size_t position, Rect* out) const;
         void makeNewTextLayout(float max_width, float max_height, bool auto_wrap);
 
-        void applyFontAttrSpans();
-        void applyOtherSpans();
+        void applyFontAttrSpans(const Range& bounds);
+        void applyOtherSpans(const Range& bounds);
         void refreshFontAttrs();
 
         bool canCut() const;
@@ -180,14 +182,6 @@ namespace ukive {
         void performSelectAll();
 
     private:
-        // 为支持撤销而创建的结构体（未完成）。
-        struct UndoBlock {
-            std::u16string text;
-            size_t start;
-            size_t oldEnd;
-            size_t newEnd;
-        };
-
         struct SelectionBlock {
             size_t start;
             size_t length;
@@ -195,7 +189,7 @@ namespace ukive {
         };
 
         Editable* base_text_;
-        std::unique_ptr<TextLayout> text_layout_;
+        std::unique_ptr<ParagraphTextLayout> text_layout_;
 
         TextBlink* text_blink_;
         TextActionMenu* text_action_mode_;
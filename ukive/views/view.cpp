@@ -16,6 +16,7 @@
 #include "utils/weak_bind.hpp"
 
 #include "ukive/basics/tooltip.h"
+#include "ukive/diagnostic/frame_profiler.h"
 #include "ukive/diagnostic/input_tracker.h"
 #include "ukive/diagnostic/ui_tracker.h"
 #include "ukive/event/input_event.h"
@@ -42,6 +43,11 @@
 
 namespace ukive {
 
+    uint64_t View::shadow_cache_hits_ = 0;
+    uint64_t View::shadow_cache_misses_ = 0;
+    uint64_t View::measure_cache_hits_ = 0;
+    uint64_t View::measure_cache_misses_ = 0;
+
     View::View(Context c)
         : View(c, {}) {}
 
@@ -65,11 +71,12 @@ namespace ukive {
           input_conn_(nullptr)
     {
         bool has_id = false;
-        auto it = attrs.find(necro::kAttrViewId);
-        if (it != attrs.end()) {
-            if (!utl::stoi(it->second, &id_)) {
-                LOG(Log::WARNING) << "Cannot convert View id: " << it->second;
+        auto id_item = attrs.find(necro::kAttrViewId);
+        if (id_item) {
+            if (id_item->value.type != necro::AttrValueType::INT) {
+                LOG(Log::WARNING) << "Cannot convert View id: " << attrs.getRaw(*id_item);
             } else {
+                id_ = int32_t(id_item->value.value);
                 has_id = true;
             }
         }
@@ -97,10 +104,10 @@ namespace ukive {
             (int)resolveAttrDimension(
                 c, attrs, necro::kAttrViewMinHeight, 0));
 
-        auto bg_it = attrs.find(necro::kAttrViewBackground);
-        if (bg_it != attrs.end()) {
+        auto bg_item = attrs.find(necro::kAttrViewBackground);
+        if (bg_item) {
             Element* ele;
-            if (ElementParser::parse(bg_it->second, &ele)) {
+            if (ElementParser::parse(attrs.getRaw(*bg_item), &ele)) {
                 setBackground(ele);
             }
         }
@@ -122,6 +129,18 @@ namespace ukive {
         resetForeground();
     }
 
+    // static
+    void View::getShadowCacheStats(uint64_t* hits, uint64_t* misses) {
+        *hits = shadow_cache_hits_;
+        *misses = shadow_cache_misses_;
+    }
+
+    // static
+    void View::getMeasureCacheStats(uint64_t* hits, uint64_t* misses) {
+        *hits = measure_cache_hits_;
+        *misses = measure_cache_misses_;
+    }
+
     ViewAnimator& View::animate() {
         if (!animator_) {
             animator_ = std::make_unique<ViewAnimator>(this);
@@ -138,7 +157,14 @@ namespace ukive {
     }
 
     void View::setId(long long id) {
+        if (id_ == id) {
+            return;
+        }
+
         id_ = id;
+        if (parent_) {
+            parent_->onChildIdChanged(this);
+        }
     }
 
     void View::setTag(int tag) {
@@ -226,6 +252,7 @@ namespace ukive {
             bg_element_->setCallback(this);
         }
         owned_bg_ = owned;
+        ++bg_version_;
 
         updateBackgroundState();
         requestDraw();
@@ -415,10 +442,12 @@ namespace ukive {
 
     void View::setMinimumWidth(int width) {
         min_size_.width(width);
+        clearMeasureCache();
     }
 
     void View::setMinimumHeight(int height) {
         min_size_.height(height);
+        clearMeasureCache();
     }
 
     void View::setOnClickListener(OnClickListener* l) {
@@ -870,6 +899,9 @@ namespace ukive {
     }
 
     void View::onElementRequestDraw(Element* d) {
+        if (d == bg_element_) {
+            ++bg_version_;
+        }
         requestDraw();
     }
 
@@ -893,6 +925,7 @@ namespace ukive {
 
     void View::draw(Canvas* canvas, const Rect& dirty_rect) {
         UI_TRACK_RT_START;
+        FRAME_PROFILE_VIEW_DRAW;
 
         dirty_rect_ = dirty_rect;
 
@@ -931,28 +964,22 @@ namespace ukive {
     }
 
     void View::drawNormal(Canvas* c, bool has_bg, bool has_shadow) {
-        if (has_shadow) {
-            // 将背景绘制到 bg_img 上
-            Canvas bg_off(
-                getWidth(), getHeight(),
-                c->getBuffer()->getImageOptions());
-            bg_off.beginDraw();
-            bg_off.clear();
-            bg_off.setOpacity(c->getOpacity());
-            drawBackground(&bg_off);
-            bg_off.endDraw();
-            auto buffer = static_cast<OffscreenBuffer*>(bg_off.getBuffer());
-
-            if (!shadow_effect_->setContent(buffer) ||
-                !shadow_effect_->draw(c))
-            {
-                drawBackground(c);
-            }
-        } else if (has_bg) {
+        if (has_shadow && !drawShadow(c)) {
             drawBackground(c);
         }
 
+        // 阴影不录制，背景和内容不变时直接回放
+        if (render_node_.isValid()) {
+            render_node_.replay(c, [this, c]() { dispatchDraw(c); });
+            return;
+        }
+
+        render_node_.beginRecording(c);
+        if (has_bg && !has_shadow) {
+            drawBackground(c);
+        }
         drawContent(c);
+        render_node_.endRecording(c);
     }
 
     void View::drawWithReveal(Canvas* c, bool has_bg, bool has_shadow) {
@@ -984,6 +1011,8 @@ namespace ukive {
                 offscreen.endDraw();
                 auto buffer = static_cast<OffscreenBuffer*>(offscreen.getBuffer());
 
+                // 揭露动画每帧都不同，不做缓存
+                shadow_key_ = {};
                 if (!shadow_effect_->setContent(buffer) ||
                     !shadow_effect_->draw(c))
                 {
@@ -1018,6 +1047,44 @@ namespace ukive {
         }
     }
 
+    bool View::drawShadow(Canvas* c) {
+        ShadowKey key;
+        key.width = getWidth();
+        key.height = getHeight();
+        key.radius = shadow_radius_;
+        key.bg_state = bg_element_->getState();
+        key.bg_version = bg_version_;
+        key.scale = getContext().getAutoScale();
+
+        if (key == shadow_key_ && shadow_effect_->hasCache()) {
+            ++shadow_cache_hits_;
+            return shadow_effect_->draw(c);
+        }
+
+        ++shadow_cache_misses_;
+        shadow_key_ = {};
+
+        // 将背景绘制到 bg_off 上。
+        // 缓存不随透明度变化，透明度在绘制阴影时应用。
+        Canvas bg_off(
+            getWidth(), getHeight(),
+            c->getBuffer()->getImageOptions());
+        bg_off.beginDraw();
+        bg_off.clear();
+        drawBackground(&bg_off);
+        bg_off.endDraw();
+        auto buffer = static_cast<OffscreenBuffer*>(bg_off.getBuffer());
+
+        if (!shadow_effect_->setContent(buffer) ||
+            !shadow_effect_->draw(c))
+        {
+            return false;
+        }
+
+        shadow_key_ = key;
+        return true;
+    }
+
     void View::drawContent(Canvas* c) {
         // 裁剪出可用区
         c->pushClip(RectF(
@@ -1043,7 +1110,7 @@ namespace ukive {
 
             // 绘制孩子，这里不要偏移 padding，因为 padding 信息
             // 已经包含在 bounds 里了，画布会根据 bounds 进行偏移的。
-            dispatchDraw(c);
+            render_node_.drawChildren(c, [this, c]() { dispatchDraw(c); });
 
             c->restore();
         }
@@ -1361,6 +1428,8 @@ namespace ukive {
         is_layouted_ = false;
         need_layout_ = true;
         request_layout_ = false;
+        measure_before_layout_ = false;
+        clearMeasureCache();
     }
 
     void View::resetLastHaulView() {
@@ -1393,7 +1462,8 @@ namespace ukive {
     }
 
     bool View::processPointerUp() {
-        if (!click_listener_) {
+        // 子类可以重写 perform*Click() 自行处理点击，因此不要求设置 click_listener_
+        if (!is_clkable_ && !is_dclkable_ && !is_tclkable_) {
             return true;
         }
 
@@ -1696,28 +1766,69 @@ namespace ukive {
     }
 
     void View::determineSize(const SizeInfo& info) {
-        if (is_measured_) {
-            bool is_defined_size =
-                (info.width().mode == SizeInfo::DEFINED &&
-                    info.height().mode == SizeInfo::DEFINED);
-
-            if (!request_layout_ &&
-                is_defined_size &&
-                info == saved_size_info_)
-            {
-                return;
+        // 缓存在 requestLayout() 时清空，因此命中的结果总是有效的。
+        // 在同一次布局中，包裹内容的父 View 可能以相同的参数多次测量子 View。
+        Size size;
+        if (is_measured_ && findMeasureCache(info, &size)) {
+            ++measure_cache_hits_;
+            if (determined_size_ != size || !(info == saved_size_info_)) {
+                need_layout_ = true;
             }
+
+            determined_size_ = size;
+            saved_size_info_ = info;
+            measure_before_layout_ = !(info == measured_size_info_);
+            return;
         }
 
+        ++measure_cache_misses_;
         determined_size_ = onDetermineSize(info);
         determined_size_.join(min_size_);
 
         is_measured_ = true;
         need_layout_ = true;
+        measure_before_layout_ = false;
         saved_size_info_ = info;
+        measured_size_info_ = info;
+        putMeasureCache(info, determined_size_);
+    }
+
+    bool View::findMeasureCache(const SizeInfo& info, Size* size) const {
+        for (uint8_t i = 0; i < measure_cache_count_; ++i) {
+            if (measure_cache_[i].info == info) {
+                *size = measure_cache_[i].size;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void View::putMeasureCache(const SizeInfo& info, const Size& size) {
+        // 缓存满时按先进先出替换
+        auto& entry = measure_cache_[measure_cache_next_];
+        entry.info = info;
+        entry.size = size;
+
+        measure_cache_next_ = uint8_t((measure_cache_next_ + 1) % kMeasureCacheSize);
+        if (measure_cache_count_ < kMeasureCacheSize) {
+            ++measure_cache_count_;
+        }
+    }
+
+    void View::clearMeasureCache() {
+        measure_cache_count_ = 0;
+        measure_cache_next_ = 0;
     }
 
     void View::layout(const Rect& bounds) {
+        if (measure_before_layout_) {
+            // 子 View 保留的可能是以其他参数测量的结果，按本次的参数重新测量
+            determined_size_ = onDetermineSize(saved_size_info_);
+            determined_size_.join(min_size_);
+            measured_size_info_ = saved_size_info_;
+            measure_before_layout_ = false;
+        }
+
         request_layout_ = false;
 
         auto old_bounds(bounds_);
@@ -1732,6 +1843,13 @@ namespace ukive {
             ext_bounds.extend(getBoundsExtension());
             requestDrawRelParent(ext_bounds);
 
+            // 只是平移时，显示列表仍然可用
+            if (old_bounds.width() != new_bounds.width() ||
+                old_bounds.height() != new_bounds.height())
+            {
+                render_node_.invalidate();
+            }
+
             onBoundsChanging(new_bounds, old_bounds);
             bounds_ = new_bounds;
             onBoundsChanged(new_bounds, old_bounds);
@@ -1753,17 +1871,24 @@ namespace ukive {
     }
 
     void View::requestDraw() {
-        auto ext_bounds(bounds_);
-        ext_bounds.extend(getBoundsExtension());
-        requestDrawRelParent(ext_bounds);
+        render_node_.invalidate();
+        requestDrawProperties();
     }
 
     void View::requestDraw(const Rect& rect) {
+        render_node_.invalidate();
+
         Rect bounds(rect);
         bounds.offset(bounds_.x(), bounds_.y());
         requestDrawRelParent(bounds);
     }
 
+    void View::requestDrawProperties() {
+        auto ext_bounds(bounds_);
+        ext_bounds.extend(getBoundsExtension());
+        requestDrawRelParent(ext_bounds);
+    }
+
     void View::requestDrawRelParent(const Rect& rect) {
         if (rect.empty()) {
             return;
@@ -1790,6 +1915,7 @@ namespace ukive {
 
     void View::requestLayout() {
         request_layout_ = true;
+        clearMeasureCache();
 
         if (parent_) {
             parent_->requestLayout();
@@ -2098,9 +2224,13 @@ namespace ukive {
     }
 
     void View::onContextChanged(Context::Type type, const Context& context) {
+        // 录制的图像等资源可能已失效
+        render_node_.invalidate();
+
         switch (type) {
         case Context::DPI_CHANGED:
         {
+            clearMeasureCache();
             if (Application::getOptions().is_auto_dpi_scale) {
                 if (shadow_effect_) {
                     shadow_effect_->destroy();
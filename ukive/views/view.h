@@ -14,6 +14,7 @@
 #include "ukive/graphics/rect.hpp"
 #include "ukive/graphics/padding.hpp"
 #include "ukive/graphics/cursor.h"
+#include "ukive/graphics/render_node/render_node.h"
 #include "ukive/graphics/size.hpp"
 #include "ukive/resources/attributes.h"
 #include "ukive/views/size_info.h"
@@ -60,6 +61,12 @@ namespace ukive {
         View(Context c, AttrsRef attrs);
         virtual ~View();
 
+        /**
+         * 获取所有 View 的阴影缓存命中和未命中次数，用于调试。
+         */
+        static void getShadowCacheStats(uint64_t* hits, uint64_t* misses);
+        static void getMeasureCacheStats(uint64_t* hits, uint64_t* misses);
+
         ViewAnimator& animate();
         ViewAnimatorParams& animeParams();
 
@@ -209,6 +216,13 @@ namespace ukive {
         virtual void requestDraw();
         virtual void requestDraw(const Rect& rect);
         virtual void requestDrawRelParent(const Rect& rect);
+
+        /**
+         * 请求重绘，但保留已录制的显示列表。
+         * 只有平移、透明度或动画参数发生变化时使用，重绘时不会调用 onDraw()。
+         */
+        void requestDrawProperties();
+
         virtual void requestLayout();
 
         void requestFocus();
@@ -307,9 +321,48 @@ namespace ukive {
         ViewDelegate* delegate_ = nullptr;
 
     private:
+        /**
+         * 阴影缓存的键。
+         * 任何一项变化时，都需要重新生成阴影。
+         */
+        struct ShadowKey {
+            int width = 0;
+            int height = 0;
+            int radius = 0;
+            int bg_state = 0;
+            uint32_t bg_version = 0;
+            float scale = 0;
+
+            bool operator==(const ShadowKey& rhs) const {
+                return width == rhs.width &&
+                    height == rhs.height &&
+                    radius == rhs.radius &&
+                    bg_state == rhs.bg_state &&
+                    bg_version == rhs.bg_version &&
+                    scale == rhs.scale;
+            }
+        };
+
+        /**
+         * 测量缓存中的一项。
+         * size 为 info 下的测量结果，已合并最小尺寸。
+         */
+        struct MeasureCacheEntry {
+            SizeInfo info;
+            Size size;
+        };
+
+        // 测量缓存的容量
+        static constexpr size_t kMeasureCacheSize = 4;
+
+        bool findMeasureCache(const SizeInfo& info, Size* size) const;
+        void putMeasureCache(const SizeInfo& info, const Size& size);
+        void clearMeasureCache();
+
         void drawNormal(Canvas* c, bool has_bg, bool has_shadow);
         void drawWithReveal(Canvas* c, bool has_bg, bool has_shadow);
         void drawContent(Canvas* c);
+        bool drawShadow(Canvas* c);
 
         void updateBackgroundState();
         void updateForegroundState();
@@ -367,6 +420,9 @@ namespace ukive {
         bool is_layouted_ = false;
         bool need_layout_ = false;
         bool request_layout_ = false;
+        // 从测量缓存中取得了非最近一次测量的结果，布局前需要按 saved_size_info_ 重新测量，
+        // 以便子 View 的测量结果与之一致
+        bool measure_before_layout_ = false;
 
         Window* window_ = nullptr;
         Context context_;
@@ -388,6 +444,22 @@ namespace ukive {
         std::unique_ptr<ViewAnimator> animator_;
         std::unique_ptr<ShadowEffect> shadow_effect_;
         std::unique_ptr<ViewAnimatorParams> anime_params_;
+        RenderNode render_node_;
+
+        // 背景每次请求重绘时递增，用于判断阴影缓存是否可用
+        uint32_t bg_version_ = 0;
+        ShadowKey shadow_key_;
+        static uint64_t shadow_cache_hits_;
+        static uint64_t shadow_cache_misses_;
+
+        // 测量缓存，在 requestLayout() 时清空
+        MeasureCacheEntry measure_cache_[kMeasureCacheSize];
+        uint8_t measure_cache_count_ = 0;
+        uint8_t measure_cache_next_ = 0;
+        // 最近一次调用 onDetermineSize() 时的参数
+        SizeInfo measured_size_info_;
+        static uint64_t measure_cache_hits_;
+        static uint64_t measure_cache_misses_;
         std::vector<OnViewStatusListener*> status_listeners_;
 
         Tooltip* tooltip_ = nullptr;
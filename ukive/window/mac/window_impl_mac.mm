@@ -299,15 +299,8 @@ namespace mac {
 
     void WindowImplMac::doDraw(const DirtyRegion& region) {
         if (native_view_) {
-            if (!region.rect0.empty()) {
-                auto& rect = region.rect0;
+            for (const auto& rect : region) {
                 [native_view_ setNeedsDisplayInRect:NSMakeRect(rect.x(), rect.y(), rect.width(), rect.height())];
-                //LOG(Log::INFO) << "displayRect1: [" << rect.x() << ", " << rect.y() << ", " << rect.width() << ", " << rect.height() << "]";
-            }
-            if (!region.rect1.empty()) {
-                auto& rect = region.rect1;
-                [native_view_ displayRect:NSMakeRect(rect.x(), rect.y(), rect.width(), rect.height())];
-                //LOG(Log::INFO) << "displayRect2: [" << rect.x() << ", " << rect.y() << ", " << rect.width() << ", " << rect.height() << "]";
             }
         }
     }
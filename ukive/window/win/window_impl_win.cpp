@@ -337,8 +337,9 @@ namespace win {
 
     void WindowImplWin::doDraw(const DirtyRegion& region) {
         DirtyRegion dirty_region(region);
-        ukive::scaleFromNative(this, &dirty_region.rect0);
-        ukive::scaleFromNative(this, &dirty_region.rect1);
+        for (auto& rect : dirty_region) {
+            ukive::scaleFromNative(this, &rect);
+        }
 
         delegate_->onDraw(dirty_region);
     }
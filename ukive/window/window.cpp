@@ -12,6 +12,7 @@
 
 #include "ukive/app/application.h"
 #include "ukive/basics/tooltip.h"
+#include "ukive/diagnostic/frame_profiler.h"
 #include "ukive/diagnostic/input_tracker.h"
 #include "ukive/window/window_native.h"
 #include "ukive/window/window_dpi_utils.h"
@@ -568,8 +569,9 @@ namespace ukive {
         cur_dirty_region_.setOne(getContentBounds());
 
         auto dirty_rect(cur_dirty_region_);
-        scaleToNative(impl_.get(), &dirty_rect.rect0);
-        scaleToNative(impl_.get(), &dirty_rect.rect1);
+        for (auto& rect : dirty_rect) {
+            scaleToNative(impl_.get(), &rect);
+        }
 
         impl_->invalidate(dirty_rect);
     }
@@ -585,8 +587,9 @@ namespace ukive {
         cur_dirty_region_.add(nor_rect);
 
         auto dirty_rect(cur_dirty_region_);
-        scaleToNative(impl_.get(), &dirty_rect.rect0);
-        scaleToNative(impl_.get(), &dirty_rect.rect1);
+        for (auto& rect : dirty_rect) {
+            scaleToNative(impl_.get(), &rect);
+        }
 
         impl_->invalidate(dirty_rect);
     }
@@ -888,11 +891,17 @@ namespace ukive {
         SizeInfo size_info;
         size_info.setWidth(SizeInfo::Value(width, width_mode));
         size_info.setHeight(SizeInfo::Value(height, height_mode));
-        root_layout_->determineSize(size_info);
+        {
+            FRAME_PROFILE_PHASE(DETERMINE_SIZE, "Window::determineSize");
+            root_layout_->determineSize(size_info);
+        }
 
         auto& determined_size = root_layout_->getDeterminedSize();
 
-        root_layout_->layout(Rect(x, y, determined_size.width(), determined_size.height()));
+        {
+            FRAME_PROFILE_PHASE(LAYOUT, "Window::layout");
+            root_layout_->layout(Rect(x, y, determined_size.width(), determined_size.height()));
+        }
 
         if (enable_ui_debug) {
             auto duration = utl::TimeUtils::upTimeMicros() - micro;
@@ -933,12 +942,20 @@ namespace ukive {
     }
 
     void Window::draw(const DirtyRegion& region) {
-        canvas_->beginDraw();
+        {
+            FRAME_PROFILE_PHASE(DRAW, "Window::draw");
+            canvas_->beginDraw();
 
-        drawRootView(canvas_, region.rect0);
-        drawRootView(canvas_, region.rect1);
+            for (const auto& rect : region) {
+                drawRootView(canvas_, rect);
+            }
+        }
 
-        canvas_->endDraw();
+        {
+            FRAME_PROFILE_PHASE(PRESENT, "Canvas::endDraw");
+            canvas_->endDraw();
+        }
+        FrameProfiler::getInstance()->endFrame();
     }
 
     void Window::drawWithDebug(const DirtyRegion& region) {
@@ -956,15 +973,21 @@ namespace ukive {
             micro = utl::TimeUtils::upTimeMicros();
         }
 
-        // 先在离屏画布上画
-        off_canvas_->beginDraw();
+        GPtr<ImageFrame> img;
+        {
+            FRAME_PROFILE_PHASE(DRAW, "Window::draw");
 
-        drawRootView(off_canvas_.get(), region.rect0);
-        drawRootView(off_canvas_.get(), region.rect1);
+            // 先在离屏画布上画
+            off_canvas_->beginDraw();
 
-        off_canvas_->endDraw();
+            for (const auto& rect : region) {
+                drawRootView(off_canvas_.get(), rect);
+            }
+
+            off_canvas_->endDraw();
 
-        auto img = off_canvas_->extractImage();
+            img = off_canvas_->extractImage();
+        }
 
         // 把离屏画布上的内容画到窗口上
         canvas_->beginDraw();
@@ -980,15 +1003,20 @@ namespace ukive {
             // 标出更新区域
             Color color = Color::Pink300;
             color.a = 0.4f;
-            canvas_->fillRect(RectF(region.rect0), color);
-            canvas_->fillRect(RectF(region.rect1), color);
+            for (const auto& rect : region) {
+                canvas_->fillRect(RectF(rect), color);
+            }
 
             debug_drawer_->draw(
                 bounds.x(), bounds.y(),
                 bounds.width(), bounds.height(), canvas_);
         }
 
-        canvas_->endDraw();
+        {
+            FRAME_PROFILE_PHASE(PRESENT, "Canvas::endDraw");
+            canvas_->endDraw();
+        }
+        FrameProfiler::getInstance()->endFrame();
     }
 
     void Window::drawRootView(Canvas* canvas, const Rect& rect) {
@@ -1230,11 +1258,28 @@ namespace ukive {
                     requestDraw();
                 }
             }
+        } else if (e->getEvent() == InputEvent::EVK_DOWN &&
+            e->getKeyboardKey() == Keyboard::KEY_E)
+        {
+            // 导出帧分析器记录的事件
+            bool is_shift_key_pressed = Keyboard::isKeyPressed(Keyboard::KEY_SHIFT);
+            bool is_ctrl_key_pressed = Keyboard::isKeyPressed(Keyboard::KEY_CONTROL);
+            if (debug_drawer_ && is_ctrl_key_pressed && is_shift_key_pressed) {
+                std::error_code ec;
+                auto dir = std::filesystem::temp_directory_path(ec);
+                if (!ec) {
+                    auto file_name = dir / "ukive_frame_trace.json";
+                    if (FrameProfiler::getInstance()->exportChromeTrace(file_name)) {
+                        DLOG(Log::INFO) << "Frame trace exported: " << file_name.u8string();
+                    }
+                }
+            }
         }
     }
 
     bool Window::onInputEvent(InputEvent* e) {
         INPUT_TRACK_PRINT("", e);
+        FRAME_PROFILE_PHASE(INPUT, "Window::onInputEvent");
 
         if (e->isMouseEvent()) {
             return processPointerHolder(mouse_holder_, e);
@@ -1298,8 +1343,9 @@ namespace ukive {
             cur_dirty_region_.clear();
 
             auto dirty_rect(dirty_region);
-            scaleToNative(impl_.get(), &dirty_rect.rect0);
-            scaleToNative(impl_.get(), &dirty_rect.rect1);
+            for (auto& rect : dirty_rect) {
+                scaleToNative(impl_.get(), &rect);
+            }
 
             impl_->doDraw(dirty_rect);
         }, SCHEDULE_RENDER);